@@ -128,6 +128,9 @@ case class FileDeltaColumnarWrite(
   override def nativeStatsSchema(vanilla: Seq[AttributeReference]): Seq[AttributeReference] =
     NativeFileWriteResult.nativeStatsSchema(vanilla)
 
+  override def numClusteredPartitions(writeResults: Seq[InternalRow]): Long =
+    NativeFileWriteResult.numClustered(writeResults)
+
   override def doSetupNativeTask(): Unit = {
     assert(description.path == committer.outputPath)
     val nameSpec = CreateFileNameSpec(getTaskAttemptContext, description)
@@ -171,6 +171,10 @@ object CHBackendSettings extends BackendSettingsApi with Logging {
   // If the partition keys are high cardinality, the aggregation method is slower.
   val GLUTEN_ENABLE_WINDOW_GROUP_LIMIT_TO_AGGREGATE: String =
     CHConfig.prefixOf("runtime_settings.enable_window_group_limit_to_aggregate")
+  // rank and dense_rank have no aggregate function, they are only converted when the native
+  // hash topk is enabled.
+  val GLUTEN_WINDOW_ENABLE_HASH_TOPK: String =
+    CHConfig.runtimeConfig("window.enable_hash_topk")
 
   def affinityMode: String = {
     SparkEnv.get.conf
@@ -466,7 +466,10 @@ class CHMetricsApi extends MetricsApi with Logging with LogLevelUtil {
   def genWriteFilesTransformerMetrics(sparkContext: SparkContext): Map[String, SQLMetric] =
     Map(
       "physicalWrittenBytes" -> SQLMetrics.createMetric(sparkContext, "number of written bytes"),
-      "numWrittenFiles" -> SQLMetrics.createMetric(sparkContext, "number of written files")
+      "numWrittenFiles" -> SQLMetrics.createMetric(sparkContext, "number of written files"),
+      "numClusteredPartitions" -> SQLMetrics.createMetric(
+        sparkContext,
+        "number of partitions written clustered")
     )
 
   def genWriteFilesTransformerMetricsUpdater(metrics: Map[String, SQLMetric]): MetricsUpdater = {
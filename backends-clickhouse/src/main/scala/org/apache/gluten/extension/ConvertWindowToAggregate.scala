@@ -107,8 +107,11 @@ case class ConverRowNumbertWindowToAggregateRule(spark: SparkSession)
       return false
     }
     val windowFunction = extractWindowFunction(windowExpressions(0))
+    // rank and dense_rank have no aggregate function, they are computed by the native hash topk.
     windowFunction match {
       case _: RowNumber => true
+      case _: Rank | _: DenseRank =>
+        spark.conf.get(CHBackendSettings.GLUTEN_WINDOW_ENABLE_HASH_TOPK, "true").toBoolean
       case _ => false
     }
   }
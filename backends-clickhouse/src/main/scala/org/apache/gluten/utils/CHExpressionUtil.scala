@@ -82,7 +82,7 @@ case class GetJsonObjectValidator() extends FunctionValidator {
 case class StringSplitValidator() extends FunctionValidator {
   override def doValidate(expr: Expression): Boolean = {
     val split = expr.asInstanceOf[StringSplit]
-    if (!split.regex.isInstanceOf[Literal] || !split.limit.isInstanceOf[Literal]) {
+    if (!split.limit.isInstanceOf[Literal]) {
       return false
     }
 
@@ -56,6 +56,12 @@ trait CHColumnarWrite[T <: FileCommitProtocol] {
   }
   def commitTask(writeResults: Seq[InternalRow]): Option[WriteTaskResult]
 
+  /**
+   * The number of partitions written one at a time after more partitions than
+   * `write.max_open_writers` were seen by the native writer.
+   */
+  def numClusteredPartitions(writeResults: Seq[InternalRow]): Long = 0
+
   lazy val basicWriteJobStatsTracker: WriteTaskStatsTracker = description.statsTrackers
     .find(_.isInstanceOf[BasicWriteJobStatsTracker])
     .map(_.newTaskInstance())
@@ -161,7 +167,11 @@ case class HadoopMapReduceAdapter(sparkCommitter: HadoopMapReduceCommitProtocol)
   }
 }
 
-case class NativeFileWriteResult(filename: String, partition_id: String, record_count: Long) {
+case class NativeFileWriteResult(
+    filename: String,
+    partition_id: String,
+    record_count: Long,
+    clustered: Boolean = false) {
   lazy val relativePath: String = if (CHColumnarWrite.validatedPartitionID(partition_id)) {
     s"$partition_id/$filename"
   } else {
@@ -171,9 +181,15 @@ case class NativeFileWriteResult(filename: String, partition_id: String, record_
 
 object NativeFileWriteResult {
   implicit def apply(row: InternalRow): NativeFileWriteResult = {
-    NativeFileWriteResult(row.getString(0), row.getString(1), row.getLong(2))
+    NativeFileWriteResult(
+      row.getString(0),
+      row.getString(1),
+      row.getLong(2),
+      row.getBoolean(row.numFields - 1))
   }
 
+  def numClustered(rows: Seq[InternalRow]): Long = rows.count(apply(_).clustered)
+
   /**
    * {{{
    * val schema =
@@ -183,7 +199,8 @@ object NativeFileWriteResult {
    *     StructField("record_count", LongType, false) :: <= overlap with vanilla =>
    *     min...
    *     max...
-   *     null_count...)
+   *     null_count...
+   *     StructField("clustered", BooleanType, false))
    * }}}
    */
   private val inputBasedSchema: Seq[AttributeReference] = Seq(
@@ -302,6 +319,9 @@ case class HadoopMapReduceCommitProtocolWrite(
     }
   }
 
+  override def numClusteredPartitions(writeResults: Seq[InternalRow]): Long =
+    NativeFileWriteResult.numClustered(writeResults)
+
   override def commitTask(writeResults: Seq[InternalRow]): Option[WriteTaskResult] = {
     doCollectNativeResult(writeResults).map(
       nativeWriteTaskResult => {
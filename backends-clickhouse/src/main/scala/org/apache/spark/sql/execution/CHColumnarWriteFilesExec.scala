@@ -29,6 +29,7 @@ import org.apache.spark.sql.catalyst.catalog.CatalogTypes.TablePartitionSpec
 import org.apache.spark.sql.catalyst.expressions.Attribute
 import org.apache.spark.sql.connector.write.WriterCommitMessage
 import org.apache.spark.sql.execution.datasources._
+import org.apache.spark.sql.execution.metric.SQLMetric
 import org.apache.spark.sql.execution.utils.CHExecUtil
 import org.apache.spark.sql.internal.SQLConf
 import org.apache.spark.sql.vectorized.ColumnarBatch
@@ -47,7 +48,8 @@ class CHColumnarWriteFilesRDD(
     var prev: RDD[ColumnarBatch],
     description: WriteJobDescription,
     committer: FileCommitProtocol,
-    jobTrackerID: String)
+    jobTrackerID: String,
+    metrics: Map[String, SQLMetric])
   extends RDD[WriterCommitMessage](prev) {
 
   private def reportTaskMetrics(writeTaskResult: WriteTaskResult): Unit = {
@@ -107,6 +109,9 @@ class CHColumnarWriteFilesRDD(
         // TODO: task commit time
         // TODO: get the schema from result ColumnarBatch and verify it.
         assert(!iter.hasNext)
+        metrics
+          .get("numClusteredPartitions")
+          .foreach(_ += commitProtocol.numClusteredPartitions(writeResults))
 
         val writeTaskResult = commitProtocol
           .commitTask(writeResults)
@@ -180,7 +185,7 @@ case class CHColumnarWriteFilesExec(
       // partition rdd to make sure we at least set up one write task to write the metadata.
       writeFilesForEmptyRDD(description, committer, jobTrackerID)
     } else {
-      new CHColumnarWriteFilesRDD(rdd, description, committer, jobTrackerID)
+      new CHColumnarWriteFilesRDD(rdd, description, committer, jobTrackerID, t.metrics)
     }
   }
 }
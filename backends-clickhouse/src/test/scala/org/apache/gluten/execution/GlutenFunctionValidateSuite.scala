@@ -619,6 +619,13 @@ class GlutenFunctionValidateSuite extends GlutenClickHouseWholeStageTransformerS
         | select url, parse_url(url, "PROTOCOL") from url_table order by url
       """.stripMargin
     runQueryAndCompare(sql9)(checkGlutenPlan[ProjectExecTransformer])
+
+    val sql10 =
+      """
+        | select url, parse_url(url, "HOST"), parse_url(url, "PATH"), parse_url(url, "QUERY", "x"),
+        | parse_url(url, "REF"), parse_url(url, "HOST", "x") from url_table order by url
+      """.stripMargin
+    runQueryAndCompare(sql10)(checkGlutenPlan[ProjectExecTransformer])
   }
 
   test("test decode and encode") {
@@ -17,7 +17,7 @@
 package org.apache.gluten.execution.compatibility
 
 import org.apache.gluten.config.GlutenConfig
-import org.apache.gluten.execution.{ParquetSuite, ProjectExecTransformer}
+import org.apache.gluten.execution.{FilterExecTransformerBase, GenerateExecTransformerBase, HashAggregateExecBaseTransformer, ParquetSuite, ProjectExecTransformer}
 
 import org.apache.spark.SparkConf
 import org.apache.spark.sql.catalyst.optimizer.{ConstantFolding, NullPropagation}
@@ -372,6 +372,60 @@ class GlutenClickhouseFunctionSuite extends ParquetSuite {
     }
   }
 
+  test("get_json_object shared by filter, project and generate") {
+    withTable("test_shared_json") {
+      sql("create table test_shared_json(id int, a string) using parquet")
+      val insert_sql =
+        """
+          |insert into test_shared_json
+          |select id, concat('{"a":', id, ', "b":"', id % 3, '", "c":[', id, ',', id + 1, ']}') from
+          |(SELECT explode(sequence(1, 100)) as id);
+          |""".stripMargin
+      sql(insert_sql)
+      // The rels sharing the parsed json must be offloaded and stacked in the same native plan,
+      // the hidden column itself is checked by the native parser test.
+      compareResultsAgainstVanillaSpark(
+        """
+          |select id, get_json_object(a, '$.a'), get_json_object(a, '$.c') from test_shared_json
+          |where get_json_object(a, '$.b') = '1'
+          |""".stripMargin,
+        true,
+        {
+          df =>
+            checkGlutenPlan[FilterExecTransformerBase](df)
+            checkGlutenPlan[ProjectExecTransformer](df)
+        }
+      )
+      compareResultsAgainstVanillaSpark(
+        """
+          |select id, get_json_object(a, '$.b'), c from test_shared_json
+          |lateral view explode(split(get_json_object(a, '$.a'), ',')) as c
+          |where get_json_object(a, '$.b') != '2'
+          |""".stripMargin,
+        true,
+        {
+          df =>
+            checkGlutenPlan[FilterExecTransformerBase](df)
+            checkGlutenPlan[GenerateExecTransformerBase](df)
+        }
+      )
+      // The hidden column must be dropped by the project below the aggregate
+      compareResultsAgainstVanillaSpark(
+        """
+          |select get_json_object(a, '$.a') as k, count(id) from test_shared_json
+          |where get_json_object(a, '$.b') = '1'
+          |group by k
+          |""".stripMargin,
+        true,
+        {
+          df =>
+            checkGlutenPlan[FilterExecTransformerBase](df)
+            checkGlutenPlan[HashAggregateExecBaseTransformer](df)
+        }
+      )
+    }
+  }
+
   test("GLUTEN-7545: https://github.com/apache/incubator-gluten/issues/7545") {
     withTable("regexp_test") {
       sql("create table if not exists regexp_test (id string) using parquet")
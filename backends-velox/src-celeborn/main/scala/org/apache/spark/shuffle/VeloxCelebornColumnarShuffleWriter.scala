@@ -18,7 +18,7 @@ package org.apache.spark.shuffle
 
 import org.apache.gluten.backendsapi.BackendsApiManager
 import org.apache.gluten.columnarbatch.ColumnarBatches
-import org.apache.gluten.config.{GlutenConfig, HashShuffleWriterType, RssSortShuffleWriterType, SortShuffleWriterType}
+import org.apache.gluten.config.{GlutenConfig, HashShuffleWriterType, RssSortShuffleWriterType, SortShuffleWriterType, VeloxConfig}
 import org.apache.gluten.memory.memtarget.{MemoryTarget, Spiller}
 import org.apache.gluten.runtime.Runtimes
 import org.apache.gluten.vectorized._
@@ -29,7 +29,7 @@ import org.apache.spark.memory.SparkMemoryUtil
 import org.apache.spark.scheduler.MapStatus
 import org.apache.spark.shuffle.celeborn.CelebornShuffleHandle
 import org.apache.spark.sql.vectorized.ColumnarBatch
-import org.apache.spark.util.SparkResourceUtil
+import org.apache.spark.util.{SparkDirectoryUtil, SparkResourceUtil}
 
 import org.apache.celeborn.client.ShuffleClient
 import org.apache.celeborn.common.CelebornConf
@@ -58,6 +58,19 @@ class VeloxCelebornColumnarShuffleWriter[K, V](
 
   private var splitResult: GlutenSplitResult = _
 
+  // Local directories to spill the sorted runs of the RSS sort shuffle writer, empty if disabled.
+  private lazy val localSpillDirs: String =
+    if (VeloxConfig.get.veloxRssSortShuffleWriterLocalSpill) {
+      SparkDirectoryUtil
+        .get()
+        .namespace("shuffle-write")
+        .all
+        .map(_.getAbsolutePath)
+        .mkString(",")
+    } else {
+      ""
+    }
+
   private def availableOffHeapPerTask(): Long = {
     SparkMemoryUtil.getCurrentAvailableOffHeapMemory / SparkResourceUtil.getTaskSlots(conf)
   }
@@ -115,7 +128,10 @@ class VeloxCelebornColumnarShuffleWriter[K, V](
           .add(
             dep.metrics("shuffleWallTime").value - splitResult.getTotalPushTime -
               splitResult.getTotalWriteTime -
-              splitResult.getTotalCompressTime)
+              splitResult.getTotalCompressTime - splitResult.getLocalSpillTime)
+        dep.metrics("spillTime").add(splitResult.getLocalSpillTime)
+        dep.metrics("bytesSpilled").add(splitResult.getLocalBytesSpilled)
+        context.taskMetrics().incDiskBytesSpilled(splitResult.getLocalBytesSpilled)
       case SortShuffleWriterType =>
         dep.metrics("sortTime").add(splitResult.getSortTime)
         dep.metrics("c2rTime").add(splitResult.getC2RTime)
@@ -160,6 +176,8 @@ class VeloxCelebornColumnarShuffleWriter[K, V](
           conf.get(SHUFFLE_DISK_WRITE_BUFFER_SIZE).toInt,
           conf.get(SHUFFLE_SORT_INIT_BUFFER_SIZE).toInt,
           conf.get(SHUFFLE_SORT_USE_RADIXSORT),
+          // Celeborn reads the sort shuffle with its own serializer, which expects the row layout.
+          false,
           partitionWriterHandle
         )
       case RssSortShuffleWriterType =>
@@ -170,6 +188,8 @@ class VeloxCelebornColumnarShuffleWriter[K, V](
           nativeBufferSize,
           clientPushSortMemoryThreshold,
           compressionCodec.orNull,
+          localSpillDirs,
+          clientPushBufferMaxSize,
           partitionWriterHandle
         )
       case other =>
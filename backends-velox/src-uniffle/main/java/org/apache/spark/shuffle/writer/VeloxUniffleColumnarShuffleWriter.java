@@ -20,6 +20,7 @@ import org.apache.gluten.backendsapi.BackendsApiManager;
 import org.apache.gluten.columnarbatch.ColumnarBatches;
 import org.apache.gluten.config.GlutenConfig;
 import org.apache.gluten.config.SortShuffleWriterType$;
+import org.apache.gluten.config.VeloxConfig;
 import org.apache.gluten.memory.memtarget.MemoryTarget;
 import org.apache.gluten.memory.memtarget.Spiller;
 import org.apache.gluten.runtime.Runtime;
@@ -175,6 +176,7 @@ public class VeloxUniffleColumnarShuffleWriter<K, V> extends RssShuffleWriter<K,
                     diskWriteBufferSize,
                     (int) (long) sparkConf.get(package$.MODULE$.SHUFFLE_SORT_INIT_BUFFER_SIZE()),
                     (boolean) sparkConf.get(package$.MODULE$.SHUFFLE_SORT_USE_RADIXSORT()),
+                    VeloxConfig.get().veloxSortShuffleWriterColumnarPayload(),
                     partitionWriterHandle);
           } else {
             nativeShuffleWriter =
@@ -16,6 +16,7 @@
  */
 package org.apache.gluten.datasource;
 
+import org.apache.gluten.metrics.DataSourceWriteMetrics;
 import org.apache.gluten.runtime.Runtime;
 import org.apache.gluten.runtime.RuntimeAware;
 import org.apache.gluten.utils.ConfigUtil;
@@ -49,10 +50,18 @@ public class VeloxDataSourceJniWrapper implements RuntimeAware {
 
   public native void inspectSchema(long dsHandle, long cSchemaAddress);
 
-  public native void close(long dsHandle);
+  public native DataSourceWriteMetrics close(long dsHandle);
 
   public native void writeBatch(long dsHandle, long batchHandle);
 
+  /**
+   * Splits the batch by the partition values and, if hasBucket is set, by the Spark bucket id
+   * pmod(murmur3(bucket columns), numBuckets).
+   */
   public native BlockStripes splitBlockByPartitionAndBucket(
-      long blockAddress, int[] partitionColIndice, boolean hasBucket);
+      long blockAddress,
+      int[] partitionColIndice,
+      boolean hasBucket,
+      int[] bucketColIndice,
+      int numBuckets);
 }
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.gluten.metrics;
+
+/** Metrics of writing one file by the native data source, returned when it is closed. */
+public class DataSourceWriteMetrics {
+  private final long numFlushWaits;
+  private final long flushWaitNanos;
+  private final long closeWaitNanos;
+  private final long peakInFlightBytes;
+
+  public DataSourceWriteMetrics(
+      long numFlushWaits, long flushWaitNanos, long closeWaitNanos, long peakInFlightBytes) {
+    this.numFlushWaits = numFlushWaits;
+    this.flushWaitNanos = flushWaitNanos;
+    this.closeWaitNanos = closeWaitNanos;
+    this.peakInFlightBytes = peakInFlightBytes;
+  }
+
+  public long getNumFlushWaits() {
+    return numFlushWaits;
+  }
+
+  /** Time the writer was blocked because too many bytes were not written to the file yet. */
+  public long getFlushWaitNanos() {
+    return flushWaitNanos;
+  }
+
+  public long getCloseWaitNanos() {
+    return closeWaitNanos;
+  }
+
+  public long getPeakInFlightBytes() {
+    return peakInFlightBytes;
+  }
+
+  @Override
+  public String toString() {
+    return "DataSourceWriteMetrics{numFlushWaits="
+        + numFlushWaits
+        + ", flushWaitNanos="
+        + flushWaitNanos
+        + ", closeWaitNanos="
+        + closeWaitNanos
+        + ", peakInFlightBytes="
+        + peakInFlightBytes
+        + "}";
+  }
+}
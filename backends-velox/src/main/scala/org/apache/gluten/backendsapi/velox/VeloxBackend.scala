@@ -22,6 +22,7 @@ import org.apache.gluten.config.{GlutenConfig, VeloxConfig}
 import org.apache.gluten.exception.GlutenNotSupportException
 import org.apache.gluten.execution.ValidationResult
 import org.apache.gluten.execution.WriteFilesExecTransformer
+import org.apache.gluten.execution.datasource.GlutenFormatFactory
 import org.apache.gluten.expression.WindowFunctionsBuilder
 import org.apache.gluten.extension.columnar.cost.{LegacyCoster, LongCoster, RoughCoster}
 import org.apache.gluten.extension.columnar.transition.{Convention, ConventionFunc}
@@ -32,9 +33,10 @@ import org.apache.gluten.substrait.rel.LocalFilesNode.ReadFileFormat.{DwrfReadFo
 import org.apache.gluten.utils._
 
 import org.apache.spark.sql.catalyst.catalog.BucketSpec
-import org.apache.spark.sql.catalyst.expressions.{Alias, CumeDist, DenseRank, Descending, Expression, Lag, Lead, NamedExpression, NthValue, NTile, PercentRank, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
+import org.apache.spark.sql.catalyst.expressions.{Alias, AttributeReference, CumeDist, DenseRank, Descending, Expression, Lag, Lead, NamedExpression, NthValue, NTile, PercentRank, RangeFrame, Rank, RowNumber, SortOrder, SpecialFrameBoundary, SpecifiedWindowFrame}
 import org.apache.spark.sql.catalyst.expressions.aggregate.{AggregateExpression, ApproximatePercentile, HyperLogLogPlusPlus, Percentile}
 import org.apache.spark.sql.catalyst.plans.{JoinType, LeftOuter, RightOuter}
+import org.apache.spark.sql.catalyst.plans.physical.HashPartitioning
 import org.apache.spark.sql.catalyst.util.{CaseInsensitiveMap, CharVarcharUtils}
 import org.apache.spark.sql.connector.read.Scan
 import org.apache.spark.sql.execution.{ColumnarCachedBatchSerializer, SparkPlan}
@@ -46,6 +48,7 @@ import org.apache.spark.sql.execution.datasources.parquet.{ParquetFileFormat, Pa
 import org.apache.spark.sql.hive.execution.HiveFileFormat
 import org.apache.spark.sql.internal.SQLConf
 import org.apache.spark.sql.types._
+import org.apache.spark.util.SparkVersionUtil
 
 import org.apache.hadoop.conf.Configuration
 import org.apache.hadoop.fs.Path
@@ -375,6 +378,17 @@ object VeloxBackendSettings extends BackendSettingsApi {
       }
     }
 
+    // Builds the bucket id expression the way FileFormatWriter does, and checks it against the
+    // one the writer matches, so a write the splitter can't bucket falls back here.
+    def supportsNativeBucketId(spec: BucketSpec): Boolean = {
+      val columns = fields.map(f => AttributeReference(f.name, f.dataType, f.nullable)()).toSeq
+      val bucketColumns = spec.bucketColumnNames.flatMap(c => columns.find(_.name == c))
+      val bucketIdExpression =
+        HashPartitioning(bucketColumns, spec.numBuckets).partitionIdExpression
+      bucketColumns.size == spec.bucketColumnNames.size &&
+      GlutenFormatFactory.nativeBucketSpec(bucketIdExpression, columns).isDefined
+    }
+
     def validateBucketSpec(): Option[String] = {
       val isHiveCompatibleBucketTable = bucketSpec.nonEmpty && options
         .getOrElse("__hive_compatible_bucketed_table_insertion__", "false")
@@ -385,6 +399,10 @@ object VeloxBackendSettings extends BackendSettingsApi {
       // partitioned tables.
       if (bucketSpec.isEmpty || isHiveCompatibleBucketTable) {
         None
+      } else if (SparkVersionUtil.eqSpark33 && supportsNativeBucketId(bucketSpec.get)) {
+        // The Spark 3.3 writer splits the batches natively, with the murmur3 based bucket id of
+        // Spark bucketed tables.
+        None
       } else {
         Some("Unsupported native write: non-compatible hive bucket write is not supported.")
       }
@@ -419,7 +437,7 @@ object VeloxBackendSettings extends BackendSettingsApi {
 
   override def supportWindowGroupLimitExec(rankLikeFunction: Expression): Boolean = {
     rankLikeFunction match {
-      case _: RowNumber => true
+      case _: RowNumber | _: Rank | _: DenseRank => true
       case _ => false
     }
   }
@@ -580,6 +580,9 @@ class VeloxSparkPlanExecApi extends SparkPlanExecApi {
       } else {
         HashShuffleWriterType
       }
+    } else if (VeloxConfig.get.veloxAdaptiveShuffleWriterEnabled) {
+      // The native writer chooses between hash and sort from the data. Its output is read as hash.
+      HashShuffleWriterType
     } else {
       if (
         partitioning != SinglePartition &&
@@ -662,13 +665,23 @@ class VeloxSparkPlanExecApi extends SparkPlanExecApi {
           .newInstance(schema, readBatchNumRows, numOutputRows, shuffleWriterType)
           .asInstanceOf[Serializer]
       case _ =>
+        // The sort shuffle writer with columnar payloads writes the hash shuffle layout.
+        val readerShuffleWriterType =
+          if (
+            shuffleWriterType == SortShuffleWriterType &&
+            VeloxConfig.get.veloxSortShuffleWriterColumnarPayload
+          ) {
+            HashShuffleWriterType
+          } else {
+            shuffleWriterType
+          }
         new ColumnarBatchSerializer(
           schema,
           readBatchNumRows,
           numOutputRows,
           deserializeTime,
           decompressTime,
-          shuffleWriterType)
+          readerShuffleWriterType)
     }
   }
 
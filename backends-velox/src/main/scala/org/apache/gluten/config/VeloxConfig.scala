@@ -51,6 +51,23 @@ class VeloxConfig(conf: SQLConf) extends GlutenConfig(conf) {
     ResizeRange(minSize, Int.MaxValue)
   }
 
+  def veloxAdaptiveShuffleWriterEnabled: Boolean =
+    getConf(COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_ENABLED)
+
+  def veloxAdaptiveShuffleWriterSampleBatches: Int =
+    getConf(COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_SAMPLE_BATCHES)
+
+  def veloxAdaptiveShuffleWriterSortPartitionBytes: Long =
+    getConf(COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_SORT_PARTITION_BYTES)
+
+  def veloxSortShuffleWriterColumnarPayload: Boolean =
+    getConf(COLUMNAR_VELOX_SORT_SHUFFLE_WRITER_COLUMNAR_PAYLOAD)
+
+  def veloxRssSortShuffleWriterLocalSpill: Boolean =
+    getConf(COLUMNAR_VELOX_RSS_SORT_SHUFFLE_WRITER_LOCAL_SPILL)
+
+  def parquetWriteMaxInFlightBytes: Long = getConf(PARQUET_WRITE_MAX_IN_FLIGHT_BYTES)
+
   def veloxBloomFilterMaxNumBits: Long = getConf(COLUMNAR_VELOX_BLOOM_FILTER_MAX_NUM_BITS)
 
   def castFromVarcharAddTrimNode: Boolean = getConf(CAST_FROM_VARCHAR_ADD_TRIM_NODE)
@@ -195,6 +212,34 @@ object VeloxConfig extends ConfigRegistry {
       .intConf
       .createOptional
 
+  val COLUMNAR_VELOX_PARQUET_WRITE_IO_THREADS =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.parquetWriteIOThreads")
+      .doc(
+        "The size of the thread pool shared by native Parquet writers to write their output " +
+          "asynchronously, so encoding and compression overlap with file I/O. 0 means the " +
+          "output is written on the task thread.")
+      .intConf
+      .checkValue(_ >= 0, "must be a non-negative number")
+      .createWithDefault(0)
+
+  val PARQUET_WRITE_MAX_IN_FLIGHT_BYTES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.parquetWriteMaxInFlightBytes")
+      .doc(
+        "The maximum bytes of one native Parquet writer's output which are pending on the " +
+          "asynchronous write thread pool. The writer waits when the limit is reached.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("64MB")
+
+  val COLUMNAR_VELOX_PLAN_CACHE_SIZE =
+    buildStaticConf("spark.gluten.sql.columnar.backend.velox.planCacheSize")
+      .doc(
+        "The maximum number of converted native plans cached per executor. The tasks sending " +
+          "the same Substrait plan and session config reuse the cached plan and only bind their " +
+          "own splits. 0 means the plan is converted for every task.")
+      .intConf
+      .checkValue(_ >= 0, "must be a non-negative number")
+      .createWithDefault(0)
+
   val COLUMNAR_VELOX_ASYNC_TIMEOUT =
     buildStaticConf("spark.gluten.sql.columnar.backend.velox.asyncTimeoutOnTaskStopping")
       .doc(
@@ -283,6 +328,53 @@ object VeloxConfig extends ConfigRegistry {
       .booleanConf
       .createWithDefault(true)
 
+  val COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_ENABLED =
+    buildConf("spark.gluten.sql.columnar.backend.velox.adaptiveShuffleWriter.enabled")
+      .doc(
+        "If true, the hash-based columnar shuffle samples the first input batches of each map " +
+          "task and chooses between the hash and the sort shuffle writer from the observed row " +
+          "width and rows per partition. Both writers produce the same payload layout, so the " +
+          "output is read by the hash shuffle reader. The sort shuffle thresholds on partitions " +
+          "and columns are ignored when enabled. Not used with Celeborn or Uniffle.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_SAMPLE_BATCHES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.adaptiveShuffleWriter.sampleBatches")
+      .doc("The number of input batches the adaptive shuffle writer samples before choosing.")
+      .intConf
+      .checkValue(_ > 0, "must be a positive number")
+      .createWithDefault(4)
+
+  val COLUMNAR_VELOX_ADAPTIVE_SHUFFLE_WRITER_SORT_PARTITION_BYTES =
+    buildConf("spark.gluten.sql.columnar.backend.velox.adaptiveShuffleWriter.sortPartitionBytes")
+      .doc(
+        "The adaptive shuffle writer chooses the sort shuffle writer if the average bytes of a " +
+          "partition in one input batch is below this value, or if the partition buffers of " +
+          "the hash shuffle writer are not expected to fit into the task memory.")
+      .bytesConf(ByteUnit.BYTE)
+      .createWithDefaultString("1KB")
+
+  val COLUMNAR_VELOX_SORT_SHUFFLE_WRITER_COLUMNAR_PAYLOAD =
+    buildConf("spark.gluten.sql.columnar.backend.velox.sortShuffleWriter.columnarPayload")
+      .doc(
+        "If true, the sort-based columnar shuffle writer transposes the rows of each evicted " +
+          "partition into column buffers before compression, and the output is read by the " +
+          "hash shuffle reader. This usually reduces the shuffle size and the deserialization " +
+          "cost on the reduce side. Not used with Celeborn.")
+      .booleanConf
+      .createWithDefault(false)
+
+  val COLUMNAR_VELOX_RSS_SORT_SHUFFLE_WRITER_LOCAL_SPILL =
+    buildConf("spark.gluten.sql.columnar.backend.velox.rssSortShuffleWriter.localSpill")
+      .doc(
+        "If true, the Celeborn sort-based columnar shuffle writer spills the buffered rows to " +
+          "local disks as runs sorted by partition id when the sort buffer is full or memory is " +
+          "short, instead of pushing small blocks. The runs are merged by partition id at the " +
+          "end of the map task into pushes of up to the Celeborn push buffer size.")
+      .booleanConf
+      .createWithDefault(false)
+
   val COLUMNAR_VELOX_RESIZE_BATCHES_SHUFFLE_OUTPUT =
     buildConf("spark.gluten.sql.columnar.backend.velox.resizeBatches.shuffleOutput")
       .doc(
@@ -18,21 +18,98 @@ package org.apache.gluten.execution
 
 import org.apache.gluten.backendsapi.velox.{VeloxBatchType, VeloxCarrierRowType}
 import org.apache.gluten.extension.columnar.transition.{Convention, ConventionReq, Transitions}
+import org.apache.gluten.metrics.DataSourceWriteMetrics
 
+import org.apache.spark.rdd.RDD
+import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.execution.SparkPlan
+import org.apache.spark.sql.execution.metric.{SQLMetric, SQLMetrics}
+import org.apache.spark.task.{TaskResource, TaskResources}
 
 case class VeloxColumnarToCarrierRowExec(override val child: SparkPlan)
   extends ColumnarToCarrierRowExecBase {
+  import VeloxColumnarToCarrierRowExec._
+
   override protected def fromBatchType(): Convention.BatchType = VeloxBatchType
   override def rowType0(): Convention.RowType = VeloxCarrierRowType
+
+  // The carrier rows are consumed by the native data source writers on Spark versions without
+  // the WriteFiles node, so the writers report their metrics on this node.
+  override lazy val metrics: Map[String, SQLMetric] =
+    Map(
+      "numInputBatches" -> SQLMetrics.createMetric(sparkContext, "number of input batches"),
+      "numOutputRows" -> SQLMetrics.createMetric(sparkContext, "number of output rows"),
+      "numWriteFlushWaits" -> SQLMetrics.createMetric(sparkContext, "number of write flush waits"),
+      "writeFlushWaitTime" ->
+        SQLMetrics.createNanoTimingMetric(sparkContext, "time of write flush waits"),
+      "writeCloseWaitTime" ->
+        SQLMetrics.createNanoTimingMetric(sparkContext, "time of write close waits"),
+      "peakWriteInFlightBytes" ->
+        SQLMetrics.createSizeMetric(sparkContext, "peak write in-flight bytes")
+    )
+
+  override protected def doExecute(): RDD[InternalRow] = {
+    val numWriteFlushWaits = longMetric("numWriteFlushWaits")
+    val writeFlushWaitTime = longMetric("writeFlushWaitTime")
+    val writeCloseWaitTime = longMetric("writeCloseWaitTime")
+    val peakWriteInFlightBytes = longMetric("peakWriteInFlightBytes")
+    super.doExecute().mapPartitions {
+      itr =>
+        TaskResources.addResourceIfNotRegistered(
+          WRITE_METRICS_RESOURCE_ID,
+          () =>
+            new WriteMetrics(
+              numWriteFlushWaits,
+              writeFlushWaitTime,
+              writeCloseWaitTime,
+              peakWriteInFlightBytes))
+        itr
+    }
+  }
+
   override protected def withNewChildInternal(newChild: SparkPlan): SparkPlan =
     copy(child = newChild)
 }
 
 object VeloxColumnarToCarrierRowExec {
+  private val WRITE_METRICS_RESOURCE_ID = classOf[WriteMetrics].getName
+
+  private class WriteMetrics(
+      numFlushWaits: SQLMetric,
+      flushWaitTime: SQLMetric,
+      closeWaitTime: SQLMetric,
+      peakInFlightBytes: SQLMetric)
+    extends TaskResource {
+    def update(dsMetrics: DataSourceWriteMetrics): Unit = {
+      numFlushWaits += dsMetrics.getNumFlushWaits
+      flushWaitTime += dsMetrics.getFlushWaitNanos
+      closeWaitTime += dsMetrics.getCloseWaitNanos
+      if (dsMetrics.getPeakInFlightBytes > peakInFlightBytes.value) {
+        peakInFlightBytes.set(dsMetrics.getPeakInFlightBytes)
+      }
+    }
+
+    override def release(): Unit = {}
+
+    override def resourceName(): String = WRITE_METRICS_RESOURCE_ID
+  }
+
   def enforce(child: SparkPlan): SparkPlan = {
     Transitions.enforceReq(
       child,
       ConventionReq.ofRow(ConventionReq.RowType.Is(VeloxCarrierRowType)))
   }
+
+  /**
+   * Adds the metrics of a closed native data source to the carrier row node feeding the writer in
+   * the current task. Does nothing if the rows were not produced by that node.
+   */
+  def updateWriteMetrics(dsMetrics: DataSourceWriteMetrics): Unit = {
+    if (
+      TaskResources.inSparkTask() &&
+      TaskResources.isResourceRegistered(WRITE_METRICS_RESOURCE_ID)
+    ) {
+      TaskResources.getResource[WriteMetrics](WRITE_METRICS_RESOURCE_ID).update(dsMetrics)
+    }
+  }
 }
@@ -16,15 +16,19 @@
  */
 package org.apache.spark.shuffle
 
+import org.apache.gluten.exception.ShuffleChecksumException
 import org.apache.gluten.vectorized.ColumnarBatchSerializerInstance
 
 import org.apache.spark._
 import org.apache.spark.internal.{config, Logging}
 import org.apache.spark.io.CompressionCodec
 import org.apache.spark.serializer.SerializerManager
-import org.apache.spark.storage.{BlockId, BlockManager, BlockManagerId, ShuffleBlockFetcherIterator}
+import org.apache.spark.storage.{BlockId, BlockManager, BlockManagerId, ShuffleBlockBatchId, ShuffleBlockFetcherIterator, ShuffleBlockId}
+import org.apache.spark.shuffle.ColumnarShuffleReader.{mapOutputOf, reportChecksumFailure}
 import org.apache.spark.util.CompletionIterator
 
+import scala.collection.mutable
+
 /**
  * Fetches and reads the blocks from a shuffle by requesting them from other nodes' block stores.
  */
@@ -70,12 +74,23 @@ class ColumnarShuffleReader[K, C](
 
   /** Read the combined key-values for this reduce task */
   override def read(): Iterator[Product2[K, C]] = {
+    // The location of each map output to fetch, to report a corrupted block as a fetch failure.
+    // With batch fetch, the fetched blocks are ShuffleBlockBatchIds merged from these blocks.
+    val mapOutputLocations = mutable.HashMap[(Int, Long), (BlockManagerId, Int)]()
+    val trackedBlocksByAddress = blocksByAddress.map {
+      case (address, blocks) =>
+        blocks.foreach {
+          case (blockId, _, mapIndex) =>
+            mapOutputOf(blockId).foreach(mapOutputLocations(_) = (address, mapIndex))
+        }
+        (address, blocks)
+    }
     val wrappedStreams = new ShuffleBlockFetcherIterator(
       context,
       blockManager.blockStoreClient,
       blockManager,
       mapOutputTracker,
-      blocksByAddress,
+      trackedBlocksByAddress,
       serializerManager.wrapStream,
       // Note: we use getSizeAsMb when no suffix is provided for backwards compatibility
       SparkEnv.get.conf.get(config.REDUCER_MAX_SIZE_IN_FLIGHT) * 1024 * 1024,
@@ -94,11 +109,23 @@ class ColumnarShuffleReader[K, C](
     val recordIter = dep match {
       case columnarDep: ColumnarShuffleDependency[K, _, C] =>
         // If the dependency is a ColumnarShuffleDependency, we use the columnar serializer.
-        columnarDep.serializer
-          .newInstance()
-          .asInstanceOf[ColumnarBatchSerializerInstance]
-          .deserializeStreams(wrappedStreams)
-          .asKeyValueIterator
+        // The native reader reads ahead the adjacent blocks of the same map output, so a checksum
+        // failure is attributed to the last block handed to it, which is from the same map output.
+        var currentBlockId: Option[BlockId] = None
+        val trackedStreams = wrappedStreams.map {
+          case (blockId, stream) =>
+            currentBlockId = Some(blockId)
+            (blockId, stream)
+        }
+        reportChecksumFailure(
+          columnarDep.serializer
+            .newInstance()
+            .asInstanceOf[ColumnarBatchSerializerInstance]
+            .deserializeStreams(trackedStreams)
+            .asKeyValueIterator,
+          () => currentBlockId,
+          mapOutputLocations
+        )
       case _ =>
         val serializerInstance = dep.serializer.newInstance()
         // Create a key/value iterator for each stream
@@ -125,3 +152,61 @@ class ColumnarShuffleReader[K, C](
       .asInstanceOf[Iterator[Product2[K, C]]]
   }
 }
+
+object ColumnarShuffleReader {
+
+  /** The (shuffleId, mapId) of the map output a shuffle block or a batch of blocks is read from. */
+  private[shuffle] def mapOutputOf(blockId: BlockId): Option[(Int, Long)] = blockId match {
+    case ShuffleBlockId(shuffleId, mapId, _) => Some((shuffleId, mapId))
+    case ShuffleBlockBatchId(shuffleId, mapId, _, _) => Some((shuffleId, mapId))
+    case _ => None
+  }
+
+  /**
+   * Rethrows a shuffle checksum failure from the native reader as a fetch failure of the given
+   * block, so that the scheduler recomputes the map output instead of failing the task attempts.
+   * Other failures, or a block whose map output is unknown, are rethrown as they are.
+   */
+  private[shuffle] def reportChecksumFailure[T](
+      iter: Iterator[T],
+      currentBlockId: () => Option[BlockId],
+      mapOutputLocations: collection.Map[(Int, Long), (BlockManagerId, Int)]): Iterator[T] = {
+    def rethrow[R](f: => R): R = {
+      try {
+        f
+      } catch {
+        case e: Throwable =>
+          val checksumFailure = Iterator
+            .iterate(e)(_.getCause)
+            .takeWhile(_ != null)
+            .collectFirst { case c: ShuffleChecksumException => c }
+          val failure = for {
+            c <- checksumFailure
+            blockId <- currentBlockId()
+            (shuffleId, mapId) <- mapOutputOf(blockId)
+            (address, mapIndex) <- mapOutputLocations.get((shuffleId, mapId))
+          } yield {
+            val reduceId = blockId match {
+              case ShuffleBlockBatchId(_, _, startReduceId, _) => startReduceId
+              case ShuffleBlockId(_, _, reduceId) => reduceId
+              case _ => -1
+            }
+            new FetchFailedException(
+              address,
+              shuffleId,
+              mapId,
+              mapIndex,
+              reduceId,
+              s"Corrupted shuffle block $blockId: ${c.getMessage}",
+              c)
+          }
+          throw failure.getOrElse(e)
+      }
+    }
+
+    new Iterator[T] {
+      override def hasNext: Boolean = rethrow(iter.hasNext)
+      override def next(): T = rethrow(iter.next())
+    }
+  }
+}
@@ -18,7 +18,7 @@ package org.apache.spark.shuffle
 
 import org.apache.gluten.backendsapi.BackendsApiManager
 import org.apache.gluten.columnarbatch.ColumnarBatches
-import org.apache.gluten.config.{GlutenConfig, GpuHashShuffleWriterType, HashShuffleWriterType, SortShuffleWriterType}
+import org.apache.gluten.config.{GlutenConfig, GpuHashShuffleWriterType, HashShuffleWriterType, SortShuffleWriterType, VeloxConfig}
 import org.apache.gluten.memory.memtarget.{MemoryTarget, Spiller}
 import org.apache.gluten.runtime.Runtimes
 import org.apache.gluten.vectorized._
@@ -54,6 +54,10 @@ class ColumnarShuffleWriter[K, V](
 
   protected val isSort: Boolean = dep.shuffleWriterType == SortShuffleWriterType
 
+  // The adaptive shuffle writer produces the hash shuffle layout whichever writer it chooses.
+  private val isAdaptive: Boolean =
+    dep.shuffleWriterType == HashShuffleWriterType && VeloxConfig.get.veloxAdaptiveShuffleWriterEnabled
+
   private val numPartitions: Int = dep.partitioner.numPartitions
 
   private val conf = SparkEnv.get.conf
@@ -156,7 +160,8 @@ class ColumnarShuffleWriter[K, V](
             conf.get(SHUFFLE_FILE_BUFFER_SIZE).toInt,
             tempDataFile.getAbsolutePath,
             localDirs,
-            GlutenConfig.get.columnarShuffleEnableDictionary
+            GlutenConfig.get.columnarShuffleEnableDictionary,
+            GlutenConfig.get.columnarShuffleEnableChecksum
           )
 
           nativeShuffleWriter = if (isSort) {
@@ -169,6 +174,7 @@ class ColumnarShuffleWriter[K, V](
               conf.get(SHUFFLE_DISK_WRITE_BUFFER_SIZE).toInt,
               conf.get(SHUFFLE_SORT_INIT_BUFFER_SIZE).toInt,
               conf.get(SHUFFLE_SORT_USE_RADIXSORT),
+              VeloxConfig.get.veloxSortShuffleWriterColumnarPayload,
               partitionWriterHandle
             )
           } else if (dep.shuffleWriterType == GpuHashShuffleWriterType) {
@@ -182,6 +188,22 @@ class ColumnarShuffleWriter[K, V](
               reallocThreshold,
               partitionWriterHandle
             )
+          } else if (isAdaptive) {
+            shuffleWriterJniWrapper.createAdaptiveShuffleWriter(
+              numPartitions,
+              dep.nativePartitioning.getShortName,
+              GlutenShuffleUtils.getStartPartitionId(
+                dep.nativePartitioning,
+                taskContext.partitionId),
+              nativeBufferSize,
+              reallocThreshold,
+              conf.get(SHUFFLE_DISK_WRITE_BUFFER_SIZE).toInt,
+              conf.get(SHUFFLE_SORT_INIT_BUFFER_SIZE).toInt,
+              conf.get(SHUFFLE_SORT_USE_RADIXSORT),
+              VeloxConfig.get.veloxAdaptiveShuffleWriterSampleBatches,
+              VeloxConfig.get.veloxAdaptiveShuffleWriterSortPartitionBytes,
+              partitionWriterHandle
+            )
           } else {
             shuffleWriterJniWrapper.createHashShuffleWriter(
               numPartitions,
@@ -20,12 +20,13 @@ import org.apache.gluten.backendsapi.BackendsApiManager
 import org.apache.gluten.columnarbatch.ColumnarBatches
 import org.apache.gluten.datasource.{VeloxDataSourceJniWrapper, VeloxDataSourceUtil}
 import org.apache.gluten.exception.GlutenException
-import org.apache.gluten.execution.BatchCarrierRow
+import org.apache.gluten.execution.{BatchCarrierRow, VeloxColumnarToCarrierRowExec}
 import org.apache.gluten.execution.datasource.GlutenRowSplitter
 import org.apache.gluten.memory.arrow.alloc.ArrowBufferAllocators
 import org.apache.gluten.runtime.Runtimes
 import org.apache.gluten.utils.ArrowAbiUtil
 
+import org.apache.spark.internal.Logging
 import org.apache.spark.sql.SparkSession
 import org.apache.spark.sql.catalyst.InternalRow
 import org.apache.spark.sql.execution.datasources._
@@ -40,7 +41,7 @@ import org.apache.hadoop.mapreduce.TaskAttemptContext
 
 import java.io.IOException
 
-trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
+trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase with Logging {
   def createOutputWriter(
       filePath: String,
       dataSchema: StructType,
@@ -89,7 +90,9 @@ trait VeloxFormatWriterInjects extends GlutenFormatWriterInjectsBase {
       }
 
       override def close(): Unit = {
-        datasourceJniWrapper.close(dsHandle)
+        val writeMetrics = datasourceJniWrapper.close(dsHandle)
+        logDebug(s"Velox datasource write metrics of $filePath: $writeMetrics")
+        VeloxColumnarToCarrierRowExec.updateWriteMetrics(writeMetrics)
       }
 
       // Do NOT add override keyword for compatibility on spark 3.1.
@@ -113,12 +116,40 @@ class VeloxRowSplitter extends GlutenRowSplitter {
       partitionColIndice: Array[Int],
       hasBucket: Boolean,
       reservePartitionColumns: Boolean = false): BlockStripes = {
+    if (hasBucket) {
+      throw new GlutenException(
+        "Bucketed write is only supported with the bucket id of Spark bucketed tables")
+    }
+    split(batch, partitionColIndice, hasBucket = false, Array.empty, 0)
+  }
+
+  override def supportsNativeBucketId: Boolean = true
+
+  override def splitBlockByPartitionAndBucket(
+      batch: ColumnarBatch,
+      partitionColIndice: Array[Int],
+      bucketColIndice: Array[Int],
+      numBuckets: Int): BlockStripes = {
+    split(batch, partitionColIndice, hasBucket = true, bucketColIndice, numBuckets)
+  }
+
+  private def split(
+      batch: ColumnarBatch,
+      partitionColIndice: Array[Int],
+      hasBucket: Boolean,
+      bucketColIndice: Array[Int],
+      numBuckets: Int): BlockStripes = {
     val handler = ColumnarBatches.getNativeHandle(BackendsApiManager.getBackendName, batch)
     val runtime =
       Runtimes.contextInstance(BackendsApiManager.getBackendName, "VeloxRowSplitter")
     val datasourceJniWrapper = VeloxDataSourceJniWrapper.create(runtime)
     new VeloxBlockStripes(
       datasourceJniWrapper
-        .splitBlockByPartitionAndBucket(handler, partitionColIndice, hasBucket))
+        .splitBlockByPartitionAndBucket(
+          handler,
+          partitionColIndice,
+          hasBucket,
+          bucketColIndice,
+          numBuckets))
   }
 }
@@ -16,7 +16,7 @@
  */
 package org.apache.spark.sql.execution.datasources.velox
 
-import org.apache.gluten.config.GlutenConfig
+import org.apache.gluten.config.{GlutenConfig, VeloxConfig}
 
 import org.apache.spark.sql.internal.SQLConf
 
@@ -39,6 +39,10 @@ class VeloxParquetWriterInjects extends VeloxFormatWriterInjects {
       GlutenConfig.PARQUET_BLOCK_ROWS,
       GlutenConfig.get.columnarParquetWriteBlockRows.toString)
     sparkOptions.put(GlutenConfig.PARQUET_BLOCK_ROWS, blockRows)
+    val maxInFlightBytes = options.getOrElse(
+      VeloxConfig.PARQUET_WRITE_MAX_IN_FLIGHT_BYTES.key,
+      s"${VeloxConfig.get.parquetWriteMaxInFlightBytes}B")
+    sparkOptions.put(VeloxConfig.PARQUET_WRITE_MAX_IN_FLIGHT_BYTES.key, maxInFlightBytes)
     sparkOptions.put(
       SQLConf.SESSION_LOCAL_TIMEZONE.key,
       options.getOrElse(
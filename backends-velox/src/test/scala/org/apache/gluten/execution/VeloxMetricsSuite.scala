@@ -16,7 +16,7 @@
  */
 package org.apache.gluten.execution
 
-import org.apache.gluten.config.GlutenConfig
+import org.apache.gluten.config.{GlutenConfig, VeloxConfig}
 import org.apache.gluten.sql.shims.SparkShimLoader
 
 import org.apache.spark.SparkConf
@@ -59,6 +59,7 @@ class VeloxMetricsSuite extends VeloxWholeStageTransformerSuite with AdaptiveSpa
   override protected def sparkConf: SparkConf = {
     super.sparkConf
       .set("spark.shuffle.manager", "org.apache.spark.shuffle.sort.ColumnarShuffleManager")
+      .set(VeloxConfig.COLUMNAR_VELOX_PARQUET_WRITE_IO_THREADS.key, "2")
   }
 
   test("test sort merge join metrics") {
@@ -207,6 +208,28 @@ class VeloxMetricsSuite extends VeloxWholeStageTransformerSuite with AdaptiveSpa
     }
   }
 
+  test("Write metrics of native data source") {
+    val sparkVersion = SparkShimLoader.getSparkVersion
+    if (sparkVersion.startsWith("3.2") || sparkVersion.startsWith("3.3")) {
+      withTable("metrics_write_t") {
+        withSQLConf((GlutenConfig.NATIVE_WRITER_ENABLED.key, "true")) {
+          spark.sql("create table metrics_write_t (c1 bigint, c2 bigint) using parquet")
+          val df = spark.sql("insert into table metrics_write_t select * from metrics_t2")
+          val plan =
+            df.queryExecution.executedPlan.asInstanceOf[CommandResultExec].commandPhysicalPlan
+          val carrier = find(plan) {
+            case _: VeloxColumnarToCarrierRowExec => true
+            case _ => false
+          }
+          assert(carrier.isDefined)
+          val metrics = carrier.get.metrics
+          assert(metrics("peakWriteInFlightBytes").value > 0)
+          assert(metrics("writeCloseWaitTime").value >= 0)
+        }
+      }
+    }
+  }
+
   test("File scan task input metrics") {
     createTPCHNotNullTables()
 
@@ -0,0 +1,81 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package org.apache.spark.shuffle
+
+import org.apache.gluten.exception.{GlutenException, ShuffleChecksumException}
+
+import org.apache.spark.FetchFailed
+import org.apache.spark.storage.{BlockId, BlockManagerId, RDDBlockId, ShuffleBlockBatchId, ShuffleBlockId}
+
+import org.scalatest.funsuite.AnyFunSuite
+
+class ColumnarShuffleReaderSuite extends AnyFunSuite {
+
+  private val address = BlockManagerId("exec-1", "host-1", 7337)
+  private val mapOutputLocations = Map((1, 42L) -> (address, 3))
+
+  private def fetchFailedOf(f: => Unit): FetchFailed =
+    intercept[FetchFailedException](f).toTaskFailedReason.asInstanceOf[FetchFailed]
+
+  /** An iterator which fails on the first read while the reader is on the given block. */
+  private def readCorrupted(blockId: BlockId, failure: Throwable): Iterator[Int] = {
+    val iter = new Iterator[Int] {
+      override def hasNext: Boolean = throw failure
+      override def next(): Int = throw failure
+    }
+    ColumnarShuffleReader.reportChecksumFailure(iter, () => Some(blockId), mapOutputLocations)
+  }
+
+  test("Report corrupted blocks as fetch failures with continuous blocks fetched in batch") {
+    // With fetchContinuousBlocksInBatch=true, the blocks to fetch are ShuffleBlockIds, but the
+    // fetched ones are ShuffleBlockBatchIds merged from the blocks of the same map output.
+    val batchFailure = fetchFailedOf {
+      readCorrupted(ShuffleBlockBatchId(1, 42L, 5, 8), new ShuffleChecksumException("mismatch"))
+        .hasNext
+    }
+    assert(batchFailure.bmAddress == address)
+    assert(batchFailure.shuffleId == 1)
+    assert(batchFailure.mapId == 42L)
+    assert(batchFailure.mapIndex == 3)
+    assert(batchFailure.reduceId == 5)
+
+    val blockFailure = fetchFailedOf {
+      readCorrupted(
+        ShuffleBlockId(1, 42L, 6),
+        new GlutenException("wrapped", new ShuffleChecksumException("mismatch"))).hasNext
+    }
+    assert(blockFailure.mapIndex == 3)
+    assert(blockFailure.reduceId == 6)
+  }
+
+  test("Rethrow the original exception if the block can't be located") {
+    val checksumFailure = new ShuffleChecksumException("mismatch")
+    // Unknown map output.
+    assert(intercept[ShuffleChecksumException] {
+      readCorrupted(ShuffleBlockBatchId(1, 43L, 5, 8), checksumFailure).next()
+    } eq checksumFailure)
+    // Not a shuffle block.
+    assert(intercept[ShuffleChecksumException] {
+      readCorrupted(RDDBlockId(1, 2), checksumFailure).next()
+    } eq checksumFailure)
+    // Not a checksum failure.
+    val otherFailure = new IllegalStateException("other")
+    assert(intercept[IllegalStateException] {
+      readCorrupted(ShuffleBlockId(1, 42L, 6), otherFailure).next()
+    } eq otherFailure)
+  }
+}
@@ -21,7 +21,8 @@ import org.apache.gluten.execution.VeloxWholeStageTransformerSuite
 
 import org.apache.spark.SparkConf
 import org.apache.spark.sql.Row
-import org.apache.spark.util.Utils
+import org.apache.spark.sql.execution.datasources.BucketingUtils
+import org.apache.spark.util.{SparkVersionUtil, Utils}
 
 import org.apache.hadoop.fs.Path
 import org.apache.parquet.hadoop.ParquetFileReader
@@ -163,10 +164,22 @@ class VeloxParquetWriteSuite extends VeloxWholeStageTransformerSuite with WriteU
         .range(100)
         .selectExpr("id as c1", "id % 7 as p")
         .createOrReplaceTempView("bucket_temp")
+      // Spark 3.3 splits the written batches by the bucket id natively.
       checkNativeWrite(
         "CREATE TABLE bucket USING PARQUET CLUSTERED BY (p) INTO 7 BUCKETS " +
           "AS SELECT * FROM bucket_temp",
-        expectNative = false)
+        expectNative = SparkVersionUtil.eqSpark33)
+      checkAnswer(spark.table("bucket"), spark.table("bucket_temp"))
+      val bucketIds = spark
+        .table("bucket")
+        .selectExpr("input_file_name() as file", "pmod(hash(p), 7) as bucket_id")
+        .collect()
+      assert(bucketIds.nonEmpty)
+      bucketIds.foreach {
+        row =>
+          val fileName = new Path(row.getString(0)).getName
+          assert(BucketingUtils.getBucketId(fileName).contains(row.getInt(1)))
+      }
     }
   }
 
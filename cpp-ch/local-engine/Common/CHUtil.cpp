@@ -716,7 +716,7 @@ void BackendInitializerUtil::initSettings(const SparkConfigs::ConfigMap & spark_
             settings.set(key, toField(key, value));
             LOG_DEBUG(&Poco::Logger::get("CHUtil"), "Set settings key:{} value:{}", key, value);
         }
-        else if (key == TIMER_PARSER_POLICY)
+        else if (key == TIMER_PARSER_POLICY || key == MAP_KEY_DEDUP_POLICY)
         {
             settings.set(key, value);
             LOG_DEBUG(&Poco::Logger::get("CHUtil"), "Set settings key:{} value:{}", key, value);
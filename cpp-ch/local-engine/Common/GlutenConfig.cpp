@@ -96,6 +96,8 @@ JoinConfig JoinConfig::loadFromContext(const DB::ContextPtr & context)
     config.prefer_multi_join_on_clauses = context->getConfigRef().getBool(PREFER_MULTI_JOIN_ON_CLAUSES, true);
     config.multi_join_on_clauses_build_side_rows_limit
         = context->getConfigRef().getUInt64(MULTI_JOIN_ON_CLAUSES_BUILD_SIDE_ROWS_LIMIT, 10000000);
+    config.broadcast_parallel_build_rows_threshold = context->getConfigRef().getUInt64(BROADCAST_PARALLEL_BUILD_ROWS_THRESHOLD, 5000000);
+    config.broadcast_parallel_build_partitions = context->getConfigRef().getUInt64(BROADCAST_PARALLEL_BUILD_PARTITIONS, 8);
     return config;
 }
 
@@ -149,6 +151,15 @@ WindowConfig WindowConfig::loadFromContext(const DB::ContextPtr & context)
     config.aggregate_topk_sample_rows = context->getConfigRef().getUInt64(WINDOW_AGGREGATE_TOPK_SAMPLE_ROWS, 5000);
     config.aggregate_topk_high_cardinality_threshold
         = context->getConfigRef().getDouble(WINDOW_AGGREGATE_TOPK_HIGH_CARDINALITY_THRESHOLD, 0.6);
+    config.enable_hash_topk = context->getConfigRef().getBool(WINDOW_ENABLE_HASH_TOPK, true);
+    return config;
+}
+
+PartitionedWriteConfig PartitionedWriteConfig::loadFromContext(const DB::ContextPtr & context)
+{
+    PartitionedWriteConfig config;
+    config.max_open_writers = context->getConfigRef().getUInt64(MAX_OPEN_WRITERS, 0);
+    config.fallback_buffer_bytes = context->getConfigRef().getUInt64(FALLBACK_BUFFER_BYTES, 256_MiB);
     return config;
 }
 
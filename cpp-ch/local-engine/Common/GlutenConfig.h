@@ -97,9 +97,16 @@ struct JoinConfig
     /// Only hash join supports multi join on clauses, the right table cannot be too large. If the row number of right
     /// table is larger then this limit, this transform will not work.
     inline static const String MULTI_JOIN_ON_CLAUSES_BUILD_SIDE_ROWS_LIMIT = "multi_join_on_clauses_build_side_row_limit";
+    /// If the broadcast table has at least this many rows, it is split into partitions by the join keys' hash, and the
+    /// partitions are built concurrently. 0 disables the parallel build.
+    inline static const String BROADCAST_PARALLEL_BUILD_ROWS_THRESHOLD = "broadcast_parallel_build_rows_threshold";
+    /// The number of partitions, also the number of threads, of the parallel broadcast table build.
+    inline static const String BROADCAST_PARALLEL_BUILD_PARTITIONS = "broadcast_parallel_build_partitions";
 
     bool prefer_multi_join_on_clauses = true;
     size_t multi_join_on_clauses_build_side_rows_limit = 10000000;
+    size_t broadcast_parallel_build_rows_threshold = 5000000;
+    size_t broadcast_parallel_build_partitions = 8;
 
     static JoinConfig loadFromContext(const DB::ContextPtr & context);
 };
@@ -164,11 +171,26 @@ struct WindowConfig
 public:
     inline static const String WINDOW_AGGREGATE_TOPK_SAMPLE_ROWS = "window.aggregate_topk_sample_rows";
     inline static const String WINDOW_AGGREGATE_TOPK_HIGH_CARDINALITY_THRESHOLD = "window.aggregate_topk_high_cardinality_threshold";
+    inline static const String WINDOW_ENABLE_HASH_TOPK = "window.enable_hash_topk";
     size_t aggregate_topk_sample_rows = 50000;
     double aggregate_topk_high_cardinality_threshold = 0.4;
+    // Use HashWindowGroupLimitStep rather than sort + window for high cardinality partition keys.
+    bool enable_hash_topk = true;
     static WindowConfig loadFromContext(const DB::ContextPtr & context);
 };
 
+struct PartitionedWriteConfig
+{
+    inline static const String MAX_OPEN_WRITERS = "write.max_open_writers";
+    inline static const String FALLBACK_BUFFER_BYTES = "write.fallback_buffer_bytes";
+    // The max number of partition writers kept open by a dynamic partition write, 0 means no limit. Once it's exceeded,
+    // the remaining rows are clustered by partition and written one partition at a time.
+    size_t max_open_writers = 0;
+    // The bytes of rows buffered in memory for the clustering before they are spilled to disk.
+    size_t fallback_buffer_bytes = 256_MiB;
+    static PartitionedWriteConfig loadFromContext(const DB::ContextPtr & context);
+};
+
 namespace PathConfig
 {
 inline constexpr auto USE_CURRENT_DIRECTORY_AS_TMP = "use_current_directory_as_tmp";
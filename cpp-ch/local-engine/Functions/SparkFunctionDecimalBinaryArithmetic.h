@@ -130,6 +130,40 @@ public:
         return false;
     }
 
+    /// Whether the scaled operands and the intermediate result all fit in 18 digits, so that the calculation could be done with
+    /// Int64 instead of the wider result native type, e.g. decimal(9, 2) * decimal(9, 4) whose result type is decimal(19, 6).
+    template <typename LeftDataType, typename RightDataType, typename ResultDataType>
+    static bool canCalculateWithInt64(const LeftDataType & left_type, const RightDataType & right_type, const ResultDataType & result_type)
+    {
+        size_t p1 = left_type.getPrecision();
+        size_t s1 = left_type.getScale();
+        size_t p2 = right_type.getPrecision();
+        size_t s2 = right_type.getScale();
+        size_t max_scale = getMaxScaled(s1, s2, result_type.getScale());
+
+        size_t left_digits = p1 + max_scale - s1;
+        size_t right_digits = p2 + max_scale - s2;
+        size_t result_digits;
+        if constexpr (is_multiply)
+        {
+            left_digits = p1;
+            right_digits = p2;
+            result_digits = p1 + p2;
+        }
+        else if constexpr (is_plus_minus)
+            result_digits = std::max(left_digits, right_digits) + 1;
+        else if constexpr (is_division)
+        {
+            left_digits += max_scale;
+            result_digits = left_digits;
+        }
+        else
+            result_digits = std::max(left_digits, right_digits);
+
+        constexpr size_t max_digits = DecimalUtils::max_precision<Decimal64>;
+        return left_digits <= max_digits && right_digits <= max_digits && result_digits <= max_digits;
+    }
+
     template <typename LeftDataType, typename RightDataType, typename ResultDataType>
     static ColumnPtr executeDecimal(
         const ColumnsWithTypeAndName & arguments,
@@ -140,20 +174,11 @@ public:
         using LeftFieldType = typename LeftDataType::FieldType;
         using RightFieldType = typename RightDataType::FieldType;
         using ResultFieldType = typename ResultDataType::FieldType;
-        using ColVecLeft = ColumnDecimal<LeftFieldType>;
-        using ColVecRight = ColumnDecimal<RightFieldType>;
-
-        ColumnPtr col_left = arguments[0].column;
-        ColumnPtr col_right = arguments[1].column;
 
-        const ColumnConst * col_left_const = checkAndGetColumnConst<ColVecLeft>(col_left.get());
-        const ColumnConst * col_right_const = checkAndGetColumnConst<ColVecRight>(col_right.get());
-        const ColVecLeft * col_left_vec = checkAndGetColumn<ColVecLeft>(col_left.get());
-        const ColVecRight * col_right_vec = checkAndGetColumn<ColVecRight>(col_right.get());
+        if (canCalculateWithInt64(left_type, right_type, result_type))
+            return executeDecimalImpl<LeftDataType, RightDataType, ResultDataType, Int64>(arguments, left_type, right_type, result_type);
 
-        size_t rows = col_left->size();
         size_t max_scale = getMaxScaled(left_type.getScale(), right_type.getScale(), result_type.getScale());
-
         bool calculate_with_i256 = false;
         if constexpr (Mode != OpMode::Effect)
         {
@@ -174,39 +199,46 @@ public:
         {
             /// Use Int256 for calculation
             return executeDecimalImpl<LeftDataType, RightDataType, ResultDataType, Int256>(
-                left_type, right_type, col_left_const, col_right_const, col_left_vec, col_right_vec, rows, result_type);
+                arguments, left_type, right_type, result_type);
         }
         else if constexpr (is_division)
         {
             /// Use Int128 for calculation
             return executeDecimalImpl<LeftDataType, RightDataType, ResultDataType, Int128>(
-                left_type, right_type, col_left_const, col_right_const, col_left_vec, col_right_vec, rows, result_type);
+                arguments, left_type, right_type, result_type);
         }
         else
         {
             /// Use ResultNativeType for calculation
             return executeDecimalImpl<LeftDataType, RightDataType, ResultDataType, NativeType<ResultFieldType>>(
-                left_type, right_type, col_left_const, col_right_const, col_left_vec, col_right_vec, rows, result_type);
+                arguments, left_type, right_type, result_type);
         }
     }
 
-private:
+    /// Calculate with ScaledNativeType whatever the precisions are, visible for UTs
     template <typename LeftDataType, typename RightDataType, typename ResultDataType, typename ScaledNativeType>
     static ColumnPtr executeDecimalImpl(
+        const ColumnsWithTypeAndName & arguments,
         const LeftDataType & left_type,
         const RightDataType & right_type,
-        const ColumnConst * col_left_const,
-        const ColumnConst * col_right_const,
-        const ColumnDecimal<typename LeftDataType::FieldType> * col_left_vec,
-        const ColumnDecimal<typename RightDataType::FieldType> * col_right_vec,
-        size_t rows,
         const ResultDataType & result_type)
     {
         using LeftFieldType = typename LeftDataType::FieldType;
         using RightFieldType = typename RightDataType::FieldType;
         using ResultFieldType = typename ResultDataType::FieldType;
+        using ColVecLeft = ColumnDecimal<LeftFieldType>;
+        using ColVecRight = ColumnDecimal<RightFieldType>;
         using ColVecResult = ColumnVectorOrDecimal<ResultFieldType>;
 
+        ColumnPtr col_left = arguments[0].column;
+        ColumnPtr col_right = arguments[1].column;
+
+        const ColumnConst * col_left_const = checkAndGetColumnConst<ColVecLeft>(col_left.get());
+        const ColumnConst * col_right_const = checkAndGetColumnConst<ColVecRight>(col_right.get());
+        const ColVecLeft * col_left_vec = checkAndGetColumn<ColVecLeft>(col_left.get());
+        const ColVecRight * col_right_vec = checkAndGetColumn<ColVecRight>(col_right.get());
+        size_t rows = col_left->size();
+
         size_t max_scale = getMaxScaled(left_type.getScale(), right_type.getScale(), result_type.getScale());
 
         ScaledNativeType scale_left = [&]
@@ -237,7 +269,14 @@ private:
             return DecimalUtils::scaleMultiplier<ScaledNativeType>(diff);
         }();
 
-        ScaledNativeType max_value = intExp10OfSize<ScaledNativeType>(result_type.getPrecision());
+        ScaledNativeType max_value = [&]
+        {
+            /// A result precision beyond 18 digits can't be exceeded when calculating with Int64
+            if constexpr (std::is_same_v<ScaledNativeType, Int64>)
+                if (result_type.getPrecision() > DecimalUtils::max_precision<Decimal64>)
+                    return std::numeric_limits<Int64>::max();
+            return intExp10OfSize<ScaledNativeType>(result_type.getPrecision());
+        }();
 
         auto res_vec = ColVecResult::create(rows, result_type.getScale());
         auto & res_vec_data = res_vec->getData();
@@ -296,6 +335,7 @@ private:
         return ColumnNullable::create(std::move(res_vec), std::move(res_null_map));
     }
 
+private:
         template <
             OpCase op_case,
             typename LeftFieldType,
@@ -384,7 +424,7 @@ private:
 
         res = static_cast<ResultNativeType>(c_res);
 
-        if constexpr (std::is_same_v<ScaledNativeType, Int256> || is_division)
+        if constexpr (std::is_same_v<ScaledNativeType, Int256> || std::is_same_v<ScaledNativeType, Int64> || is_division)
             return c_res > -max_value && c_res < max_value;
         else
             return true;
@@ -523,6 +563,9 @@ public:
                 using RightFieldType = typename RightDataType::FieldType;
                 using ResultFieldType = typename ResultDataType::FieldType;
 
+                if (SparkDecimalBinaryOperation<Operation, mode>::canCalculateWithInt64(left_type, right_type, result_type))
+                    return true;
+
                 size_t max_scale = SparkDecimalBinaryOperation<Operation, mode>::getMaxScaled(
                     left_type.getScale(), right_type.getScale(), result_type.getScale());
                 auto p1 = left_type.getPrecision();
@@ -563,6 +606,12 @@ public:
                 using RightNativeType = NativeType<RightFieldType>;
                 using ResultNativeType = NativeType<ResultFieldType>;
 
+                if (SparkDecimalBinaryOperation<Operation, mode>::canCalculateWithInt64(left_type, right_type, result_type))
+                {
+                    nullable_result = compileHelper<Int64>(builder, arguments, left_type, right_type, result_type);
+                    return true;
+                }
+
                 size_t max_scale = SparkDecimalBinaryOperation<Operation, mode>::getMaxScaled(
                     left_type.getScale(), right_type.getScale(), result_type.getScale());
                 auto p1 = left_type.getPrecision();
@@ -640,7 +689,9 @@ public:
             auto * zero = getNativeConstant(b, static_cast<CalculateType>(0));
             auto * is_zero = b.CreateICmpEQ(scaled_right, zero);
 
-            scaled_result = b.CreateSDiv(scaled_left, scaled_right);
+            /// Divide by one instead of zero which traps, the result is null anyway
+            auto * divisor = b.CreateSelect(is_zero, getNativeConstant(b, static_cast<CalculateType>(1)), scaled_right);
+            scaled_result = b.CreateSDiv(scaled_left, divisor);
             is_null = is_zero;
         }
         else if constexpr (is_modulo)
@@ -648,7 +699,8 @@ public:
             auto * zero = getNativeConstant(b, static_cast<CalculateType>(0));
             auto * is_zero = b.CreateICmpEQ(scaled_right, zero);
 
-            scaled_result = b.CreateSRem(scaled_left, scaled_right);
+            auto * divisor = b.CreateSelect(is_zero, getNativeConstant(b, static_cast<CalculateType>(1)), scaled_right);
+            scaled_result = b.CreateSRem(scaled_left, divisor);
             is_null = is_zero;
         }
 
@@ -662,7 +714,9 @@ public:
         }
 
         /// check overflow
-        if constexpr (std::is_same_v<CalculateType, Int256> || is_division)
+        constexpr bool is_int64 = std::is_same_v<CalculateType, Int64>;
+        if (std::is_same_v<CalculateType, Int256> || is_division
+            || (is_int64 && result_type.getPrecision() <= DecimalUtils::max_precision<Decimal64>))
         {
             auto max_value = intExp10OfSize<CalculateType>(result_type.getPrecision());
             auto * max_value_const = getNativeConstant(b, max_value);
@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <bit>
 #include <city.h>
 #include <base/types.h>
 
@@ -261,6 +262,63 @@ private:
         }
     }
 
+    /// The 4 or 8 bytes which applyNumber and applyDecimal pass to Impl::apply for a fixed width value.
+    template <typename T>
+    static auto toHashWord(const T & n)
+    {
+        if constexpr (DB::is_decimal<T>)
+            return static_cast<UInt64>(static_cast<Int64>(n.value));
+        else if constexpr (std::is_same_v<T, Float32>)
+            return n == -0.0f || isNaN(n) ? UInt32(0) : std::bit_cast<UInt32>(n);
+        else if constexpr (std::is_same_v<T, Float64>)
+            return n == -0.0 || isNaN(n) ? UInt64(0) : std::bit_cast<UInt64>(n);
+        else if constexpr (sizeof(T) <= 4)
+            return static_cast<UInt32>(static_cast<typename IntHashPromotion<T>::Type>(n));
+        else
+            return static_cast<UInt64>(n);
+    }
+
+    template <typename T>
+    static constexpr bool hasHashWord()
+    {
+        if constexpr (DB::is_decimal<T>)
+            return sizeof(typename T::NativeType) <= 8;
+        else
+            return std::is_arithmetic_v<T>;
+    }
+
+    /// Hashes a fixed width column into the running hashes. The words are hashed by the closed forms of Impl, and nulls keep
+    /// the running hash by a select instead of a branch, so that the loop could be vectorized in the AVX2/AVX512 builds.
+    template <typename FromType>
+    static void executeHashWords(
+        const FromType * from, bool from_const, const DB::NullMap * null_map, typename DB::ColumnVector<ToType>::Container & vec_to)
+    {
+        size_t size = vec_to.size();
+        ToType * to = vec_to.data();
+        if (from_const)
+        {
+            if (null_map && (*null_map)[0])
+                return;
+            const auto word = toHashWord(from[0]);
+            for (size_t i = 0; i < size; ++i)
+                to[i] = Impl::applyWord(word, to[i]);
+        }
+        else if (!null_map)
+        {
+            for (size_t i = 0; i < size; ++i)
+                to[i] = Impl::applyWord(toHashWord(from[i]), to[i]);
+        }
+        else
+        {
+            const UInt8 * nulls = null_map->data();
+            for (size_t i = 0; i < size; ++i)
+            {
+                const ToType hash = Impl::applyWord(toHashWord(from[i]), to[i]);
+                to[i] = nulls[i] ? to[i] : hash;
+            }
+        }
+    }
+
     void executeGeneric(
         const DB::IDataType * from_type,
         bool from_const,
@@ -293,9 +351,14 @@ private:
         if (!col_from)
             throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", data_column->getName(), getName());
 
-        size_t size = vec_to.size();
         const typename ColVecType::Container & vec_from = col_from->getData();
+        if constexpr (hasHashWord<FromType>())
+        {
+            executeHashWords(vec_from.data(), from_const, null_map, vec_to);
+            return;
+        }
 
+        size_t size = vec_to.size();
         auto update_hash = [&](const FromType & value, ToType & to)
         {
             if constexpr (std::is_arithmetic_v<FromType>)
@@ -550,6 +613,39 @@ struct SparkImplXxHash64
     static constexpr auto name = "sparkXxHash64";
     using ReturnType = UInt64;
     static auto apply(const char * s, size_t len, UInt64 seed) { return XXH_INLINE_XXH64(s, len, seed); }
+
+    /// Same as apply on the 4 or 8 bytes of the word, aligned with XXH64.hashInt and XXH64.hashLong of Spark.
+    static constexpr UInt64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr UInt64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr UInt64 PRIME64_3 = 0x165667B19E3779F9ULL;
+    static constexpr UInt64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr UInt64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    static ALWAYS_INLINE UInt64 fmix(UInt64 hash)
+    {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    static ALWAYS_INLINE UInt64 applyWord(UInt32 word, UInt64 seed)
+    {
+        UInt64 hash = seed + PRIME64_5 + 4;
+        hash ^= static_cast<UInt64>(word) * PRIME64_1;
+        hash = std::rotl(hash, 23) * PRIME64_2 + PRIME64_3;
+        return fmix(hash);
+    }
+
+    static ALWAYS_INLINE UInt64 applyWord(UInt64 word, UInt64 seed)
+    {
+        UInt64 hash = seed + PRIME64_5 + 8;
+        hash ^= std::rotl(word * PRIME64_2, 31) * PRIME64_1;
+        hash = std::rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+        return fmix(hash);
+    }
 };
 
 
@@ -641,6 +737,45 @@ struct SparkMurmurHash3_32
         SparkMurmurHash3_32_Impl(data, size, static_cast<UInt32>(seed), bytes);
         return h;
     }
+
+    /// Same as apply on the 4 or 8 bytes of the word, aligned with Murmur3_x86_32.hashInt and hashLong of Spark.
+    static ALWAYS_INLINE UInt32 mixK1(UInt32 k1)
+    {
+        k1 *= 0xcc9e2d51;
+        k1 = std::rotl(k1, 15);
+        k1 *= 0x1b873593;
+        return k1;
+    }
+
+    static ALWAYS_INLINE UInt32 mixH1(UInt32 h1, UInt32 k1)
+    {
+        h1 ^= k1;
+        h1 = std::rotl(h1, 13);
+        return h1 * 5 + 0xe6546b64;
+    }
+
+    static ALWAYS_INLINE UInt32 fmix(UInt32 h1, UInt32 length)
+    {
+        h1 ^= length;
+        h1 ^= h1 >> 16;
+        h1 *= 0x85ebca6b;
+        h1 ^= h1 >> 13;
+        h1 *= 0xc2b2ae35;
+        h1 ^= h1 >> 16;
+        return h1;
+    }
+
+    static ALWAYS_INLINE UInt32 applyWord(UInt32 word, UInt64 seed)
+    {
+        return fmix(mixH1(static_cast<UInt32>(seed), mixK1(word)), 4);
+    }
+
+    static ALWAYS_INLINE UInt32 applyWord(UInt64 word, UInt64 seed)
+    {
+        UInt32 h1 = mixH1(static_cast<UInt32>(seed), mixK1(static_cast<UInt32>(word)));
+        h1 = mixH1(h1, mixK1(static_cast<UInt32>(word >> 32)));
+        return fmix(h1, 8);
+    }
 };
 
 using SparkFunctionXxHash64 = SparkFunctionAnyHash<SparkImplXxHash64>;
@@ -22,6 +22,7 @@
 #include <Functions/FunctionHelpers.h>
 #include <Functions/IFunction.h>
 #include <Functions/Regexps.h>
+#include <Functions/SparkRegexpCache.h>
 #include <Interpreters/Context.h>
 #include <Common/FunctionDocumentation.h>
 
@@ -56,7 +57,6 @@ namespace
         size_t getNumberOfArguments() const override { return 0; }
 
         bool useDefaultImplementationForConstants() const override { return true; }
-        ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {1}; }
 
         bool isSuitableForShortCircuitArgumentsExecution(const DataTypesWithConstInfo & /*arguments*/) const override { return true; }
 
@@ -71,7 +71,7 @@ namespace
 
             FunctionArgumentDescriptors args{
                 {"haystack", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isString), nullptr, "String"},
-                {"pattern", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isString), isColumnConst, "const String"},
+                {"pattern", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isString), nullptr, "String"},
             };
 
             if (arguments.size() == 3)
@@ -88,11 +88,6 @@ namespace
             const ColumnPtr column_pattern = arguments[1].column;
             const ColumnPtr column_index = arguments.size() > 2 ? arguments[2].column : nullptr;
 
-            /// Check if the second argument is const column
-            const ColumnConst * col_pattern = typeid_cast<const ColumnConst *>(column_pattern.get());
-            if (!col_pattern)
-                throw Exception(ErrorCodes::ILLEGAL_COLUMN, "Second argument of function {} must be constant string", getName());
-
             /// Check if the first argument is string column(const or not)
             const ColumnString * col = nullptr;
             const ColumnConst * col_const = typeid_cast<const ColumnConst *>(column.get());
@@ -110,6 +105,26 @@ namespace
             ColumnString::Chars & res_strings_chars = res_strings.getChars();
             ColumnString::Offsets & res_strings_offsets = res_strings.getOffsets();
 
+            /// The pattern differs between rows, e.g. it comes from a joined rules table
+            const ColumnConst * col_pattern = typeid_cast<const ColumnConst *>(column_pattern.get());
+            if (!col_pattern)
+            {
+                const ColumnString * col_pattern_vec = typeid_cast<const ColumnString *>(column_pattern.get());
+                if (!col_pattern_vec)
+                    throw Exception(
+                        ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}", column_pattern->getName(), getName());
+
+                ColumnPtr full_column = column->convertToFullColumnIfConst();
+                vectorVectorPattern(
+                    typeid_cast<const ColumnString &>(*full_column),
+                    *col_pattern_vec,
+                    column_index,
+                    res_offsets,
+                    res_strings_chars,
+                    res_strings_offsets);
+                return col_res;
+            }
+
             if (col_const)
                 constantVector(
                     col_const->getValue<String>(),
@@ -197,7 +212,8 @@ namespace
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const SparkRegexp regexp = Regexps::createRegexp<false, false, false>(pattern);
+            const SparkCompiledRegexp compiled_regexp(pattern);
+            const SparkRegexp & regexp = compiled_regexp.getRegexp();
             unsigned capture = regexp.getNumberOfSubpatterns();
             if (index < 0 || index >= capture + 1)
                 throw Exception(
@@ -213,6 +229,7 @@ namespace
             res_strings_chars.reserve_exact(data.size() / 3);
             res_strings_offsets.reserve_exact(offsets.size() * 2);
 
+            SparkRegexpRowFilter row_filter(compiled_regexp, reinterpret_cast<const char *>(data.data() + data.size()));
             size_t res_offset = 0;
             size_t res_strings_offset = 0;
             size_t prev_offset = 0;
@@ -220,6 +237,13 @@ namespace
             {
                 Pos start = reinterpret_cast<const char *>(&data[prev_offset]);
                 Pos end = start + (cur_offset - prev_offset);
+                prev_offset = cur_offset;
+                if (!row_filter.mayMatch(start, end))
+                {
+                    res_offsets.push_back(res_offset);
+                    continue;
+                }
+
                 saveMatchs(
                     start,
                     end,
@@ -231,8 +255,6 @@ namespace
                     res_strings_offsets,
                     res_offset,
                     res_strings_offset);
-
-                prev_offset = cur_offset;
             }
         }
 
@@ -245,7 +267,8 @@ namespace
             ColumnString::Chars & res_strings_chars,
             ColumnString::Offsets & res_strings_offsets)
         {
-            const SparkRegexp regexp = Regexps::createRegexp<false, false, false>(pattern);
+            const SparkCompiledRegexp compiled_regexp(pattern);
+            const SparkRegexp & regexp = compiled_regexp.getRegexp();
             unsigned capture = regexp.getNumberOfSubpatterns();
 
             OptimizedRegularExpression::MatchVec matches;
@@ -255,6 +278,7 @@ namespace
             res_strings_chars.reserve_exact(data.size() / 3);
             res_strings_offsets.reserve_exact(offsets.size() * 2);
 
+            SparkRegexpRowFilter row_filter(compiled_regexp, reinterpret_cast<const char *>(data.data() + data.size()));
             size_t res_offset = 0;
             size_t res_strings_offset = 0;
             size_t prev_offset = 0;
@@ -271,6 +295,13 @@ namespace
                 size_t cur_offset = offsets[i];
                 Pos start = reinterpret_cast<const char *>(&data[prev_offset]);
                 Pos end = start + (cur_offset - prev_offset);
+                prev_offset = cur_offset;
+                if (!row_filter.mayMatch(start, end))
+                {
+                    res_offsets.push_back(res_offset);
+                    continue;
+                }
+
                 saveMatchs(
                     start,
                     end,
@@ -282,8 +313,70 @@ namespace
                     res_strings_offsets,
                     res_offset,
                     res_strings_offset);
+            }
+        }
+
+        void vectorVectorPattern(
+            const ColumnString & col,
+            const ColumnString & col_pattern,
+            const ColumnPtr & column_index,
+            ColumnArray::Offsets & res_offsets,
+            ColumnString::Chars & res_strings_chars,
+            ColumnString::Offsets & res_strings_offsets) const
+        {
+            const auto & data = col.getChars();
+            const auto & offsets = col.getOffsets();
+            res_offsets.reserve_exact(offsets.size());
+            res_strings_chars.reserve_exact(data.size() / 3);
+            res_strings_offsets.reserve_exact(offsets.size() * 2);
+
+            OptimizedRegularExpression::MatchVec matches;
+            SparkCompiledRegexpPtr compiled_regexp;
+            std::string_view prev_pattern;
+            size_t res_offset = 0;
+            size_t res_strings_offset = 0;
+            size_t prev_offset = 0;
+            for (size_t i = 0; i < offsets.size(); ++i)
+            {
+                /// Adjacent rows usually share the pattern, only look up the cache when it changes
+                std::string_view pattern = col_pattern.getDataAt(i).toView();
+                if (!compiled_regexp || pattern != prev_pattern)
+                {
+                    compiled_regexp = regexp_cache.get(String(pattern));
+                    prev_pattern = pattern;
+                }
 
+                const SparkRegexp & regexp = compiled_regexp->getRegexp();
+                unsigned capture = regexp.getNumberOfSubpatterns();
+                ssize_t index = column_index ? column_index->getInt(i) : 1;
+                if (index < 0 || index >= capture + 1)
+                    throw Exception(
+                        ErrorCodes::INDEX_OF_POSITIONAL_ARGUMENT_IS_OUT_OF_RANGE,
+                        "Index value {} is out of range, should be in [0, {})",
+                        index,
+                        capture + 1);
+
+                size_t cur_offset = offsets[i];
+                Pos start = reinterpret_cast<const char *>(&data[prev_offset]);
+                Pos end = start + (cur_offset - prev_offset);
                 prev_offset = cur_offset;
+                if (!compiled_regexp->mayMatch(start, end))
+                {
+                    res_offsets.push_back(res_offset);
+                    continue;
+                }
+
+                saveMatchs(
+                    start,
+                    end,
+                    regexp,
+                    matches,
+                    index,
+                    res_offsets,
+                    res_strings_chars,
+                    res_strings_offsets,
+                    res_offset,
+                    res_strings_offset);
             }
         }
 
@@ -370,6 +463,8 @@ namespace
                 res_offsets.push_back(res_offset);
             }
         }
+
+        mutable SparkRegexpCache regexp_cache;
     };
 }
 
@@ -15,19 +15,31 @@
  * limitations under the License.
  */
 #include <ranges>
+#include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnString.h>
+#include <Core/Settings.h>
+#include <DataTypes/DataTypeArray.h>
+#include <DataTypes/DataTypeString.h>
 #include <DataTypes/IDataType.h>
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionHelpers.h>
 #include <Functions/FunctionTokens.h>
 #include <Functions/IFunctionAdaptors.h>
 #include <Functions/Regexps.h>
+#include <Functions/SparkRegexpCache.h>
+#include <Interpreters/Context.h>
 #include <Common/assert_cast.h>
 
 
 namespace DB
 {
 
+namespace Setting
+{
+extern const SettingsBool splitby_max_substrings_includes_remaining_string;
+}
+
 namespace ErrorCodes
 {
     extern const int ILLEGAL_COLUMN;
@@ -42,11 +54,18 @@ namespace
 {
 
 using Pos = const char *;
+using local_engine::SparkCompiledRegexp;
+using local_engine::SparkCompiledRegexpPtr;
+using local_engine::SparkRegexpCache;
+using local_engine::SparkRegexpRowFilter;
 
 class SparkSplitByRegexpImpl
 {
 private:
-    Regexps::RegexpPtr re;
+    SparkCompiledRegexpPtr re;
+    /// Skips the regexp engine for the strings without the required literal of the pattern
+    std::optional<SparkRegexpRowFilter> row_filter;
+    bool row_may_match = true;
     OptimizedRegularExpression::MatchVec matches;
 
     Pos pos;
@@ -80,18 +99,42 @@ public:
                             "Must be constant string.", arguments[0].column->getName(), name);
 
         if (!col->getValue<String>().empty())
-            re = std::make_shared<OptimizedRegularExpression>(Regexps::createRegexp<false, false, false>(col->getValue<String>()));
+        {
+            re = new SparkCompiledRegexp(col->getValue<String>());
+            /// The strings of a vector column are checked in order, the required literal could be searched through the column at once
+            const ColumnString * col_str = checkAndGetColumn<ColumnString>(arguments[strings_argument_position].column.get());
+            const char * column_end = col_str ? reinterpret_cast<const char *>(col_str->getChars().end()) : nullptr;
+            row_filter.emplace(*re, column_end);
+        }
 
+        initMaxSplits(arguments, max_substrings_includes_remaining_string_);
+    }
+
+    void initMaxSplits(const ColumnsWithTypeAndName & arguments, bool max_substrings_includes_remaining_string_)
+    {
         max_substrings_includes_remaining_string = max_substrings_includes_remaining_string_;
         max_splits = extractMaxSplits(arguments, 2);
     }
 
+    /// Change the pattern, used when the pattern differs between rows. Empty pattern is represented by nullptr.
+    void setRegexp(const SparkCompiledRegexpPtr & re_)
+    {
+        if (re == re_)
+            return;
+
+        row_filter.reset();
+        re = re_;
+        if (re)
+            row_filter.emplace(*re, nullptr);
+    }
+
     /// Called for each next string.
     void set(Pos pos_, Pos end_)
     {
         pos = pos_;
         end = end_;
         splits = 0;
+        row_may_match = !row_filter || row_filter->mayMatch(pos_, end_);
     }
 
     /// Get the next token, if any, or return false.
@@ -147,7 +190,7 @@ public:
                         return false;
             }
 
-            auto res = re->match(pos, end - pos, matches);
+            auto res = row_may_match && re->getRegexp().match(pos, end - pos, matches);
             if (!res)
             {
                 token_end = end;
@@ -174,6 +217,87 @@ public:
 
 using SparkFunctionSplitByRegexp = FunctionTokens<SparkSplitByRegexpImpl>;
 
+/// splitByRegexpSpark whose pattern is not constant, the compiled regexps are kept in a bounded LRU cache keyed by pattern.
+class SparkFunctionSplitByNonConstRegexp : public IFunction
+{
+public:
+    static constexpr auto name = "splitByRegexpSpark";
+    static FunctionPtr create(ContextPtr context) { return std::make_shared<SparkFunctionSplitByNonConstRegexp>(context); }
+
+    explicit SparkFunctionSplitByNonConstRegexp(ContextPtr context)
+        : max_substrings_includes_remaining_string(context->getSettingsRef()[Setting::splitby_max_substrings_includes_remaining_string])
+    {
+    }
+
+    String getName() const override { return name; }
+    bool isVariadic() const override { return true; }
+    size_t getNumberOfArguments() const override { return 0; }
+    bool useDefaultImplementationForConstants() const override { return true; }
+    ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {2}; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+
+    DataTypePtr getReturnTypeImpl(const ColumnsWithTypeAndName & arguments) const override
+    {
+        FunctionArgumentDescriptors mandatory_args{
+            {"separator", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isString), nullptr, "String"},
+            {"s", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isString), nullptr, "String"}};
+        FunctionArgumentDescriptors optional_args{
+            {"max_substrings", static_cast<FunctionArgumentDescriptor::TypeValidator>(&isNativeInteger), isColumnConst, "const Number"}};
+        validateFunctionArguments(*this, arguments, mandatory_args, optional_args);
+        return std::make_shared<DataTypeArray>(std::make_shared<DataTypeString>());
+    }
+
+    ColumnPtr executeImpl(const ColumnsWithTypeAndName & arguments, const DataTypePtr &, size_t input_rows_count) const override
+    {
+        ColumnPtr pattern_column = arguments[0].column->convertToFullColumnIfConst();
+        ColumnPtr strings_column = arguments[1].column->convertToFullColumnIfConst();
+        const ColumnString * col_pattern = checkAndGetColumn<ColumnString>(pattern_column.get());
+        const ColumnString * col_str = checkAndGetColumn<ColumnString>(strings_column.get());
+        if (!col_pattern || !col_str)
+            throw Exception(
+                ErrorCodes::ILLEGAL_COLUMN,
+                "Illegal columns {}, {} of arguments of function {}",
+                arguments[0].column->getName(),
+                arguments[1].column->getName(),
+                getName());
+
+        SparkSplitByRegexpImpl generator;
+        generator.initMaxSplits(arguments, max_substrings_includes_remaining_string);
+
+        auto col_res = ColumnArray::create(ColumnString::create());
+        ColumnString & res_strings = assert_cast<ColumnString &>(col_res->getData());
+        ColumnArray::Offsets & res_offsets = col_res->getOffsets();
+        res_offsets.reserve_exact(input_rows_count);
+
+        std::string_view prev_pattern;
+        bool has_prev_pattern = false;
+        Pos token_begin = nullptr;
+        Pos token_end = nullptr;
+        for (size_t i = 0; i < input_rows_count; ++i)
+        {
+            /// Adjacent rows usually share the pattern, only look up the cache when it changes
+            std::string_view pattern = col_pattern->getDataAt(i).toView();
+            if (!has_prev_pattern || pattern != prev_pattern)
+            {
+                generator.setRegexp(pattern.empty() ? SparkCompiledRegexpPtr() : regexp_cache.get(String(pattern)));
+                prev_pattern = pattern;
+                has_prev_pattern = true;
+            }
+
+            std::string_view str = col_str->getDataAt(i).toView();
+            generator.set(str.data(), str.data() + str.size());
+            while (generator.get(token_begin, token_end))
+                res_strings.insertData(token_begin, token_end - token_begin);
+            res_offsets.push_back(res_strings.size());
+        }
+        return col_res;
+    }
+
+private:
+    bool max_substrings_includes_remaining_string;
+    mutable SparkRegexpCache regexp_cache;
+};
+
 /// Fallback splitByRegexp to splitByChar when its 1st argument is a trivial char for better performance
 class SparkSplitByRegexpOverloadResolver : public IFunctionOverloadResolver
 {
@@ -183,7 +307,8 @@ public:
 
     explicit SparkSplitByRegexpOverloadResolver(ContextPtr context_)
         : context(context_)
-        , split_by_regexp(SparkFunctionSplitByRegexp::create(context)) {}
+        , split_by_regexp(SparkFunctionSplitByRegexp::create(context))
+        , split_by_non_const_regexp(SparkFunctionSplitByNonConstRegexp::create(context)) {}
 
     String getName() const override { return name; }
     size_t getNumberOfArguments() const override { return SparkSplitByRegexpImpl::getNumberOfArguments(); }
@@ -194,17 +319,24 @@ public:
         if (patternIsTrivialChar(arguments))
             return FunctionFactory::instance().getImpl("splitByChar", context)->build(arguments);
         return std::make_unique<FunctionToFunctionBaseAdaptor>(
-            split_by_regexp,
+            patternIsConst(arguments) ? split_by_regexp : split_by_non_const_regexp,
             DataTypes{std::from_range_t{}, arguments | std::views::transform([](const auto & elem) { return elem.type; })},
             return_type);
     }
 
     DataTypePtr getReturnTypeImpl(const ColumnsWithTypeAndName & arguments) const override
     {
-        return split_by_regexp->getReturnTypeImpl(arguments);
+        if (patternIsConst(arguments))
+            return split_by_regexp->getReturnTypeImpl(arguments);
+        return split_by_non_const_regexp->getReturnTypeImpl(arguments);
     }
 
 private:
+    static bool patternIsConst(const ColumnsWithTypeAndName & arguments)
+    {
+        return !arguments.empty() && arguments[0].column && isColumnConst(*arguments[0].column);
+    }
+
     bool patternIsTrivialChar(const ColumnsWithTypeAndName & arguments) const
     {
         if (!arguments[0].column.get())
@@ -229,6 +361,7 @@ private:
 
     ContextPtr context;
     FunctionPtr split_by_regexp;
+    FunctionPtr split_by_non_const_regexp;
 };
 }
 
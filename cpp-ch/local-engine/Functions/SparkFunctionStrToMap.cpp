@@ -14,14 +14,19 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <bit>
 #include <memory>
 #include <ranges>
 #include <type_traits>
+#include <unordered_map>
+#include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
 #include <Columns/ColumnString.h>
 #include <Columns/ColumnVector.h>
 #include <Core/Field.h>
+#include <Core/Settings.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeMap.h>
 #include <DataTypes/DataTypeNullable.h>
@@ -33,18 +38,29 @@
 #include <Functions/IFunction.h>
 #include <Functions/IFunctionAdaptors.h>
 #include <Functions/Regexps.h>
+#include <Common/CHUtil.h>
 #include <Common/Exception.h>
 #include <Common/OptimizedRegularExpression.h>
 
 #include <Poco/Logger.h>
 #include <Common/logger_useful.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#pragma clang diagnostic ignored "-Wreserved-identifier"
+#endif
+
 namespace DB
 {
 namespace ErrorCodes
 {
 extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
 extern const int ILLEGAL_COLUMN;
+extern const int BAD_ARGUMENTS;
 }
 }
 
@@ -174,13 +190,35 @@ static bool isConstColumn(const DB::IColumn & col)
     return col.isConst();
 }
 
+/// Duplicate keys follow spark.sql.mapKeyDedupPolicy: EXCEPTION throws, LAST_WIN keeps the key at its first position with the
+/// last value.
+static bool isMapKeyDedupLastWin(const DB::ContextPtr & context)
+{
+    const auto & settings = context->getSettingsRef();
+    return settings.has(MAP_KEY_DEDUP_POLICY) && settings.get(MAP_KEY_DEDUP_POLICY).safeGet<String>() == "LAST_WIN";
+}
+
+[[noreturn]] static void throwDuplicateMapKey(std::string_view key)
+{
+    throw DB::Exception(
+        DB::ErrorCodes::BAD_ARGUMENTS,
+        "Duplicate map key {} was found, please check the input data. If you want to remove the duplicated keys, you can set "
+        "{} to LAST_WIN so that the key inserted at last takes precedence.",
+        key,
+        MAP_KEY_DEDUP_POLICY);
+}
+
 template <typename PairGenerator, typename KVGenerator>
 class SparkFunctionStrToMap : public DB::IFunction
 {
 public:
     using Pos = const char *;
     static constexpr auto name = "spark_str_to_map";
-    static DB::FunctionPtr create(const DB::ContextPtr) { return std::make_shared<SparkFunctionStrToMap<PairGenerator, KVGenerator>>(); }
+    static DB::FunctionPtr create(const DB::ContextPtr context)
+    {
+        return std::make_shared<SparkFunctionStrToMap<PairGenerator, KVGenerator>>(isMapKeyDedupLastWin(context));
+    }
+    explicit SparkFunctionStrToMap(bool last_win_ = false) : last_win(last_win_) { }
     String getName() const override { return name; }
     bool isVariadic() const override { return false; }
     size_t getNumberOfArguments() const override { return 3; }
@@ -238,13 +276,33 @@ public:
 
         DB::ColumnString::Offset prev_offset = 0;
 
+        DB::Map map;
+        /// The position of each key of the current row in map
+        std::unordered_map<std::string_view, size_t> key_positions;
+        auto add_entry = [&](std::string_view key, DB::Field value)
+        {
+            auto [it, inserted] = key_positions.emplace(key, map.size());
+            if (inserted)
+            {
+                DB::Tuple tuple(2);
+                tuple[0] = key;
+                tuple[1] = std::move(value);
+                map.emplace_back(std::move(tuple));
+            }
+            else if (last_win)
+                map[it->second].safeGet<DB::Tuple>()[1] = std::move(value);
+            else
+                throwDuplicateMapKey(key);
+        };
+
         for (size_t i = 0, n = offsets.size(); i < n; ++i)
         {
             if (null_map && (*null_map)[n] != 0)
                 col_map->insertDefault();
             else
             {
-                DB::Map map;
+                map.clear();
+                key_positions.clear();
                 Pos str_begin = reinterpret_cast<Pos>(&strs[prev_offset]);
                 Pos str_end = reinterpret_cast<Pos>(&strs[offsets[i]]);
                 LOG_TRACE(
@@ -269,9 +327,7 @@ public:
                     Pos key_end;
                     if (kv_generator.next(key_begin, key_end))
                     {
-                        DB::Tuple tuple(2);
-                        size_t key_len = key_end - key_begin;
-                        tuple[0] = key_end == str_end ? std::string_view(key_begin, key_len) : std::string_view(key_begin, key_len);
+                        std::string_view key(key_begin, key_end - key_begin);
                         auto delimiter_begin = kv_generator.getDelimiterBegin();
                         auto delimiter_end = kv_generator.getDelimiterEnd();
                         LOG_TRACE(
@@ -283,25 +339,17 @@ public:
                             delimiter_end - str_begin,
                             std::string_view(key_begin, key_end - key_begin));
                         if (delimiter_begin && delimiter_begin != str_end)
-                        {
-                            DB::Field value = pair_end == str_end ? std::string_view(delimiter_end, pair_end - delimiter_end)
-                                                                 : std::string_view(delimiter_end, pair_end - delimiter_end);
-                            tuple[1] = std::move(value);
-                        }
+                            add_entry(key, std::string_view(delimiter_end, pair_end - delimiter_end));
                         else
                         {
                             // Not found delimiter, the value should be null
-                            tuple[1] = DB::Null();
+                            add_entry(key, DB::Null());
                         }
-                        map.emplace_back(std::move(tuple));
                     }
                     else if (pair_begin == pair_end)
                     {
                         // Empty pair. key is empty string, but value is null.
-                        DB::Tuple tuple(2);
-                        tuple[0] = std::string();
-                        tuple[1] = DB::Null();
-                        map.emplace_back(std::move(tuple));
+                        add_entry({}, DB::Null());
                     }
                     else
                     {
@@ -315,6 +363,192 @@ public:
 
         return col_map;
     }
+
+private:
+    bool last_win;
+};
+
+/// str_to_map with single character delimiters which are not regular expression meta characters, e.g. str_to_map(s, ',', ':').
+/// Both delimiters are found in one SIMD scan of each row, and the keys, values and offsets are written into the children of
+/// the result ColumnMap directly. Every pair delimiter starts a new pair, the key ends at the first key value delimiter in the
+/// pair and the value is null if there is no key value delimiter. Duplicate keys are handled as in SparkFunctionStrToMap.
+class SparkFunctionStrToMapSingleChar : public DB::IFunction
+{
+public:
+    using Pos = const char *;
+    static constexpr auto name = "spark_str_to_map";
+    static DB::FunctionPtr create(const DB::ContextPtr context)
+    {
+        return std::make_shared<SparkFunctionStrToMapSingleChar>(isMapKeyDedupLastWin(context));
+    }
+    explicit SparkFunctionStrToMapSingleChar(bool last_win_) : last_win(last_win_) { }
+    String getName() const override { return name; }
+    bool isVariadic() const override { return false; }
+    size_t getNumberOfArguments() const override { return 3; }
+    bool useDefaultImplementationForConstants() const override { return true; }
+    DB::ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {1, 2}; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DB::DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+    DB::DataTypePtr getReturnTypeImpl(const DB::ColumnsWithTypeAndName & arguments) const override
+    {
+        return SparkFunctionStrToMap<TrivialCharSplitter, TrivialCharSplitter>().getReturnTypeImpl(arguments);
+    }
+
+    DB::ColumnPtr executeImpl(
+        const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr & /*result_type*/, size_t input_rows_count) const override
+    {
+        char pair_delim = (*arguments[1].column)[0].safeGet<String>()[0];
+        char kv_delim = (*arguments[2].column)[0].safeGet<String>()[0];
+        const auto * col_str = DB::checkAndGetColumn<DB::ColumnString>(arguments[0].column.get());
+        if (!col_str)
+            throw DB::Exception(
+                DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of first argument of function {}", arguments[0].column->getName(), name);
+        const auto & strs = col_str->getChars();
+        const auto & offsets = col_str->getOffsets();
+
+        /// Keys and values are no longer than the input strings
+        auto keys = DB::ColumnString::create();
+        keys->getChars().reserve(strs.size());
+        keys->getOffsets().reserve(input_rows_count);
+        auto values = DB::ColumnString::create();
+        values->getChars().reserve(strs.size());
+        values->getOffsets().reserve(input_rows_count);
+        auto values_null_map = DB::ColumnUInt8::create();
+        values_null_map->reserve(input_rows_count);
+        auto map_offsets = DB::ColumnArray::ColumnOffsets::create();
+        auto & map_offsets_data = map_offsets->getData();
+        map_offsets_data.reserve(input_rows_count);
+
+        auto & null_map_data = values_null_map->getData();
+
+        /// The pairs of the current row, a null value has value_begin == nullptr
+        struct Pair
+        {
+            std::string_view key;
+            Pos value_begin;
+            Pos value_end;
+        };
+        std::vector<Pair> row_pairs;
+        /// Only built for the rows with many pairs, the short rows are checked for duplicate keys by a linear scan.
+        std::unordered_map<std::string_view, size_t> key_positions;
+        auto add_pair = [&](Pos pair_begin, Pos pair_end, Pos kv_delim_pos)
+        {
+            Pair pair = kv_delim_pos ? Pair{std::string_view(pair_begin, kv_delim_pos - pair_begin), kv_delim_pos + 1, pair_end}
+                                     : Pair{std::string_view(pair_begin, pair_end - pair_begin), nullptr, nullptr};
+            Pair * existing = nullptr;
+            if (row_pairs.size() < min_pairs_to_index_keys)
+            {
+                for (auto & row_pair : row_pairs)
+                    if (row_pair.key == pair.key)
+                    {
+                        existing = &row_pair;
+                        break;
+                    }
+            }
+            else
+            {
+                if (key_positions.empty())
+                    for (size_t j = 0; j < row_pairs.size(); ++j)
+                        key_positions.emplace(row_pairs[j].key, j);
+                auto [it, inserted] = key_positions.emplace(pair.key, row_pairs.size());
+                if (!inserted)
+                    existing = &row_pairs[it->second];
+            }
+
+            if (!existing)
+                row_pairs.emplace_back(pair);
+            else if (last_win)
+                *existing = pair;
+            else
+                throwDuplicateMapKey(pair.key);
+        };
+
+        DB::ColumnString::Offset prev_offset = 0;
+        for (size_t i = 0; i < input_rows_count; ++i)
+        {
+            Pos str_begin = reinterpret_cast<Pos>(strs.data() + prev_offset);
+            Pos str_end = reinterpret_cast<Pos>(strs.data() + offsets[i]);
+            Pos pair_begin = str_begin;
+            Pos kv_delim_pos = nullptr;
+            row_pairs.clear();
+            key_positions.clear();
+            forEachDelimiter(
+                str_begin,
+                str_end,
+                pair_delim,
+                kv_delim,
+                [&](Pos pos)
+                {
+                    if (*pos == pair_delim)
+                    {
+                        add_pair(pair_begin, pos, kv_delim_pos);
+                        pair_begin = pos + 1;
+                        kv_delim_pos = nullptr;
+                    }
+                    else if (!kv_delim_pos)
+                        kv_delim_pos = pos;
+                });
+            add_pair(pair_begin, str_end, kv_delim_pos);
+
+            for (const auto & pair : row_pairs)
+            {
+                keys->insertData(pair.key.data(), pair.key.size());
+                if (pair.value_begin)
+                {
+                    values->insertData(pair.value_begin, pair.value_end - pair.value_begin);
+                    null_map_data.push_back(0);
+                }
+                else
+                {
+                    values->insertDefault();
+                    null_map_data.push_back(1);
+                }
+            }
+            map_offsets_data.push_back(keys->size());
+            prev_offset = offsets[i];
+        }
+
+        return DB::ColumnMap::create(
+            std::move(keys), DB::ColumnNullable::create(std::move(values), std::move(values_null_map)), std::move(map_offsets));
+    }
+
+private:
+    static constexpr size_t min_pairs_to_index_keys = 16;
+
+    bool last_win;
+
+    /// Call on_delimiter with the position of each pair delimiter or key value delimiter in [begin, end) in order
+    template <typename Callback>
+    static void forEachDelimiter(Pos begin, Pos end, char pair_delim, char kv_delim, Callback && on_delimiter)
+    {
+        Pos pos = begin;
+#ifdef __SSE2__
+        const auto pc = _mm_set1_epi8(pair_delim);
+        const auto kc = _mm_set1_epi8(kv_delim);
+        for (; pos + 15 < end; pos += 16)
+        {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pos));
+            uint32_t bit_mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, pc), _mm_cmpeq_epi8(bytes, kc)));
+            for (; bit_mask; bit_mask &= bit_mask - 1)
+                on_delimiter(pos + std::countr_zero(bit_mask));
+        }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+        const auto pc = vdupq_n_u8(pair_delim);
+        const auto kc = vdupq_n_u8(kv_delim);
+        /// Returns a 64 bit mask of nibbles (4 bits for each byte).
+        auto get_nibble_mask = [](uint8x16_t input) -> uint64_t
+        { return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(input), 4)), 0); };
+        for (; pos + 15 < end; pos += 16)
+        {
+            uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(pos));
+            uint64_t bit_mask = get_nibble_mask(vorrq_u8(vceqq_u8(bytes, pc), vceqq_u8(bytes, kc)));
+            for (; bit_mask; bit_mask &= ~(0xFULL << std::countr_zero(bit_mask)))
+                on_delimiter(pos + (std::countr_zero(bit_mask) >> 2));
+        }
+#endif
+        for (; pos < end; ++pos)
+            if (*pos == pair_delim || *pos == kv_delim)
+                on_delimiter(pos);
+    }
 };
 
 class SparkFunctionStrToMapOverloadResolver : public DB::IFunctionOverloadResolver
@@ -340,7 +574,9 @@ public:
         bool is_trivial_pair_delim = patternIsTrivialChar(arguments[1]);
         bool is_trivial_kv_delim = patternIsTrivialChar(arguments[2]);
         DB::FunctionPtr function_ptr = nullptr;
-        if (is_trivial_pair_delim && is_trivial_kv_delim)
+        if (is_trivial_pair_delim && is_trivial_kv_delim && isSingleChar(arguments[1]) && isSingleChar(arguments[2]))
+            function_ptr = SparkFunctionStrToMapSingleChar::create(context);
+        else if (is_trivial_pair_delim && is_trivial_kv_delim)
             function_ptr = trivial_function;
         else if (is_trivial_pair_delim && !is_trivial_kv_delim)
             function_ptr = SparkFunctionStrToMap<TrivialCharSplitter, RegularSplitter>::create(context);
@@ -363,6 +599,12 @@ private:
     DB::ContextPtr context;
     DB::FunctionPtr trivial_function;
 
+    static bool isSingleChar(const DB::ColumnWithTypeAndName & argument)
+    {
+        const DB::ColumnConst * col = checkAndGetColumnConstStringOrFixedString(argument.column.get());
+        return col && col->getValue<String>().size() == 1;
+    }
+
     bool patternIsTrivialChar(const DB::ColumnWithTypeAndName & argument) const
     {
         const DB::ColumnConst * col = checkAndGetColumnConstStringOrFixedString(argument.column.get());
@@ -16,8 +16,13 @@
  */
 #include <Columns/ColumnFixedString.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnTuple.h>
+#include <Columns/ColumnsNumber.h>
 #include <Columns/IColumn.h>
 #include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
+#include <DataTypes/DataTypeTuple.h>
+#include <DataTypes/DataTypesNumber.h>
 #include <Functions/FunctionFactory.h>
 #include <Functions/FunctionsStringSearchToString.h>
 #include <Functions/IFunction.h>
@@ -25,13 +30,18 @@
 #include <Poco/Logger.h>
 #include <Poco/URI.h>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <base/find_symbols.h>
 
 namespace DB
 {
 namespace ErrorCodes
 {
+    extern const int BAD_ARGUMENTS;
     extern const int ILLEGAL_COLUMN;
     extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+    extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
 }
 }
 
@@ -234,22 +244,59 @@ struct NameSparkExtractURLOneQuery
 };
 struct SparkExtractURLOneQuery
 {
+    /// Whether the query string begins at the first '?' or '#' of the url, otherwise the query part is null.
+    static bool hasQueryString(const Poco::URI & uri, const String & s)
+    {
+        String protocol_prefix = uri.getScheme() + "://";
+        DB::Pos query_string_begin = s.starts_with(protocol_prefix) ?
+            find_first_symbols<'?', '#'>(s.data(), s.data() + s.size()) :
+            find_first_symbols<'?', '#', ':'>(s.data(), s.data() + s.size());
+        return !query_string_begin || *query_string_begin == '?';
+    }
+
+    /// Find the value of key in the raw query string, the value is the part after the first '=' whose prefix is the key in
+    /// one of the '&' separated pairs.
+    static bool findValue(DB::Pos query_begin, size_t query_size, const String & key, DB::Pos & res_data, size_t & res_size)
+    {
+        DB::Pos query_end = query_begin + query_size;
+        DB::Pos query_pos = query_begin;
+        auto getMatchedValue = [&](const DB::Pos & begin_pos, const size_t len) -> bool
+        {
+            for (size_t j = 0; j < len; ++j)
+            {
+                if (*(begin_pos + j) == '=' && key.size() == j && memcmp(key.data(), begin_pos, j) == 0)
+                {
+                    res_data = begin_pos + j + 1;
+                    res_size = len - j - 1;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        for (DB::Pos pos = query_begin; pos < query_end; ++pos)
+        {
+            if (*pos == '&')
+            {
+                if (getMatchedValue(query_pos, pos - query_pos))
+                    return true;
+                query_pos = pos + 1;
+            }
+        }
+        return query_pos < query_end && getMatchedValue(query_pos, query_end - query_pos);
+    }
+
     static void vector(const DB::ColumnString & col, std::string pattern, DB::IColumn & res_col, DB::IColumn & null_map)
     {
         DB::ColumnUInt8 & null_map_col = assert_cast<DB::ColumnUInt8 &>(null_map);
         DB::PaddedPODArray<UInt8> & null_map_data = null_map_col.getData();
         for (size_t i = 0; i < col.size(); ++i)
         {
-            try 
+            try
             {
                 const String s = col.getDataAt(i).toString();
                 Poco::URI uri(s, false);
-                
-                String protocol_prefix = uri.getScheme() + "://";
-                DB::Pos query_string_begin = s.starts_with(protocol_prefix) ? 
-                    find_first_symbols<'?', '#'>(s.data(), s.data() + s.size()) :
-                    find_first_symbols<'?', '#', ':'>(s.data(), s.data() + s.size());
-                if (query_string_begin && *query_string_begin != '?')
+                if (!hasQueryString(uri, s))
                 {
                     res_col.insertDefault();
                     null_map_data[i] = 1;
@@ -257,43 +304,14 @@ struct SparkExtractURLOneQuery
                 }
 
                 const String & query = uri.getRawQuery();
-                DB::Pos query_pos = query.data();
-                auto getMatchedValue = [&](const DB::Pos & begin_pos, const size_t len) -> bool
-                {
-                    for (size_t j = 0; j < len; ++j)
-                    {
-                        if (*(begin_pos + j) == '=')
-                        {
-                            if (pattern == String(begin_pos, j))
-                            {
-                                res_col.insertData(begin_pos + j + 1, len - j - 1);
-                                return true;
-                            }
-                        }
-                    }
-                    return false;
-                };
-
-                bool matched = false;
-                for (size_t j = 0; j < query.size(); ++j)
-                {
-                    if (query.at(j) == '&')
-                    {
-                        if(getMatchedValue(query_pos, query.data() + j - query_pos))
-                        {
-                            matched = true;
-                            break;
-                        }
-                        else
-                            query_pos = query.data() + j + 1;
-                    }
-                }
-                if (!matched && query_pos < query.data() + query.size())
-                    matched = getMatchedValue(query_pos, query.data() + query.size() - query_pos);
-
-                if (!matched)
+                DB::Pos value = nullptr;
+                size_t value_size = 0;
+                bool matched = findValue(query.data(), query.size(), pattern, value, value_size);
+                if (matched)
+                    res_col.insertData(value, value_size);
+                else
                     res_col.insertDefault();
-    
+
                 null_map_data[i] = !matched;
             }
             catch (const Poco::SyntaxException &)
@@ -451,8 +469,10 @@ struct SparkExtractURLFile
         DB::Pos query_begin_pos = find_first_symbols<'?'>(protocol_delim_pos + protocol_delim.size(), data.data() + data.size());
         if (query_begin_pos && *query_begin_pos == '?')
         {
+            /// The result is copied by the caller before the next call
+            thread_local String new_res;
             const String & query = uri.getRawQuery();
-            String new_res = res.empty() && query.empty() ? "" : res + "?" + query;
+            new_res = res.empty() && query.empty() ? "" : res + "?" + query;
             res_data = new_res.data();
             res_size = new_res.size();
         }
@@ -473,7 +493,9 @@ struct SparkExtractURLAuthority
     static size_t getReserveLengthForElement() { return 25; }
     static void execute(const Poco::URI & uri, const String &, DB::Pos & res_data, size_t & res_size)
     {
-        const auto & authority = uri.getAuthority();
+        /// getAuthority() returns a temporary string, which is copied by the caller before the next call
+        thread_local String authority;
+        authority = uri.getAuthority();
         res_data = authority.data();
         res_size = authority.size();
         if (authority.empty())
@@ -509,4 +531,383 @@ REGISTER_FUNCTION(SparkFunctionURLInvalid)
 {
     factory.registerFunction<SparkFunctionURLInvalid>();
 }
+/// Tokenize the urls once into the offsets of their components, which are shared by all parse_url calls on the same url column,
+/// see SparkFunctionParseURLComponent. The delimiters are found by SIMD scans.
+///
+/// A url is tokenized only if it is scheme://[userinfo@]host[path][?query][#ref] and Poco::URI keeps all the components as
+/// they are, i.e. the scheme and the host are in lower case, and there is no port, ipv6 host or percent-encoding. The other
+/// urls are parsed by Poco::URI when a component is extracted, so the results are the same as the single component functions.
+class SparkFunctionParseURLComponents : public DB::IFunction
+{
+public:
+    static constexpr auto name = "spark_parse_url_components";
+    static DB::FunctionPtr create(DB::ContextPtr) { return std::make_shared<SparkFunctionParseURLComponents>(); }
+
+    /// Offsets of the components from the beginning of the url
+    enum Offset
+    {
+        AUTHORITY_BEGIN = 0,
+        HOST_BEGIN,
+        PATH_BEGIN,
+        PATH_END,
+        QUERY_END,
+        OFFSET_NUM
+    };
+
+    String getName() const override { return name; }
+    size_t getNumberOfArguments() const override { return 1; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DB::DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+    bool useDefaultImplementationForConstants() const override { return true; }
+    /// Nullable(Tuple) is not allowed, null urls are left to the component functions
+    bool useDefaultImplementationForNulls() const override { return false; }
+
+    static DB::DataTypePtr getComponentsType()
+    {
+        auto offset_type = std::make_shared<DB::DataTypeUInt32>();
+        DB::DataTypes types{std::make_shared<DB::DataTypeUInt8>(), offset_type, offset_type, offset_type, offset_type, offset_type};
+        DB::Strings names{"tokenized", "authority_begin", "host_begin", "path_begin", "path_end", "query_end"};
+        return std::make_shared<DB::DataTypeTuple>(types, names);
+    }
+
+    DB::DataTypePtr getReturnTypeImpl(const DB::DataTypes & arguments) const override
+    {
+        if (!isString(DB::removeNullable(arguments[0])))
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}",
+                arguments[0]->getName(), getName());
+        return getComponentsType();
+    }
+
+    DB::ColumnPtr executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr &, size_t input_rows_count) const override
+    {
+        const DB::IColumn * column = arguments[0].column.get();
+        if (const auto * nullable_column = DB::checkAndGetColumn<DB::ColumnNullable>(column))
+            column = &nullable_column->getNestedColumn();
+        const auto * col = DB::checkAndGetColumn<DB::ColumnString>(column);
+        if (!col)
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}",
+                arguments[0].column->getName(), getName());
+
+        auto tokenized_column = DB::ColumnUInt8::create(input_rows_count, 0);
+        auto & tokenized = tokenized_column->getData();
+        std::array<DB::MutableColumnPtr, OFFSET_NUM> offset_columns;
+        std::array<UInt32 *, OFFSET_NUM> offsets;
+        for (size_t i = 0; i < offset_columns.size(); ++i)
+        {
+            offset_columns[i] = DB::ColumnUInt32::create(input_rows_count, 0);
+            offsets[i] = assert_cast<DB::ColumnUInt32 &>(*offset_columns[i]).getData().data();
+        }
+
+        const auto & chars = col->getChars();
+        const auto & col_offsets = col->getOffsets();
+        size_t prev_offset = 0;
+        for (size_t i = 0; i < input_rows_count; ++i)
+        {
+            const auto * begin = reinterpret_cast<const char *>(chars.data() + prev_offset);
+            const auto * end = reinterpret_cast<const char *>(chars.data() + col_offsets[i]);
+            std::array<UInt32, OFFSET_NUM> row_offsets;
+            if (tokenize(begin, end, row_offsets))
+            {
+                tokenized[i] = 1;
+                for (size_t j = 0; j < row_offsets.size(); ++j)
+                    offsets[j][i] = row_offsets[j];
+            }
+            prev_offset = col_offsets[i];
+        }
+
+        DB::MutableColumns tuple_columns;
+        tuple_columns.emplace_back(std::move(tokenized_column));
+        for (auto & offset_column : offset_columns)
+            tuple_columns.emplace_back(std::move(offset_column));
+        return DB::ColumnTuple::create(std::move(tuple_columns));
+    }
+
+private:
+    static bool isLowerAlpha(char c) { return c >= 'a' && c <= 'z'; }
+    static bool isUpperAlpha(char c) { return c >= 'A' && c <= 'Z'; }
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static bool tokenize(DB::Pos begin, DB::Pos end, std::array<UInt32, OFFSET_NUM> & offsets)
+    {
+        DB::Pos pos = begin;
+        if (pos == end || !isLowerAlpha(*pos))
+            return false;
+        while (++pos < end && (isLowerAlpha(*pos) || isDigit(*pos) || *pos == '+' || *pos == '-' || *pos == '.'))
+            ;
+        if (end - pos < 3 || pos[0] != ':' || pos[1] != '/' || pos[2] != '/')
+            return false;
+
+        /// Poco::URI decodes the userinfo, host, path and fragment
+        if (find_first_symbols<'%'>(pos, end) != end)
+            return false;
+
+        DB::Pos authority_begin = pos + 3;
+        DB::Pos path_begin = find_first_symbols<'/', '?', '#'>(authority_begin, end);
+        DB::Pos host_begin = find_first_symbols<'@'>(authority_begin, path_begin);
+        if (host_begin == path_begin)
+            host_begin = authority_begin;
+        else if (find_first_symbols<'@'>(++host_begin, path_begin) != path_begin)
+            /// Poco::URI takes the part between the last two '@' as the userinfo
+            return false;
+
+        /// Poco::URI parses the port and the ipv6 host, and converts the host into lower case
+        for (DB::Pos p = host_begin; p < path_begin; ++p)
+            if (*p == ':' || *p == '[' || isUpperAlpha(*p))
+                return false;
+
+        DB::Pos path_end = find_first_symbols<'?', '#'>(path_begin, end);
+        DB::Pos query_end = path_end < end && *path_end == '?' ? find_first_symbols<'#'>(path_end + 1, end) : path_end;
+
+        offsets[AUTHORITY_BEGIN] = static_cast<UInt32>(authority_begin - begin);
+        offsets[HOST_BEGIN] = static_cast<UInt32>(host_begin - begin);
+        offsets[PATH_BEGIN] = static_cast<UInt32>(path_begin - begin);
+        offsets[PATH_END] = static_cast<UInt32>(path_end - begin);
+        offsets[QUERY_END] = static_cast<UInt32>(query_end - begin);
+        return true;
+    }
+};
+
+REGISTER_FUNCTION(SparkFunctionParseURLComponents)
+{
+    factory.registerFunction<SparkFunctionParseURLComponents>();
+}
+
+/// Extract one component of the urls from the result of spark_parse_url_components on the same urls.
+/// Arguments: (url, components, part[, key]), the key is only allowed for the QUERY part.
+class SparkFunctionParseURLComponent : public DB::IFunction
+{
+public:
+    static constexpr auto name = "spark_parse_url_component";
+    static DB::FunctionPtr create(DB::ContextPtr) { return std::make_shared<SparkFunctionParseURLComponent>(); }
+
+    enum class Part
+    {
+        Host,
+        Path,
+        Query,
+        Ref,
+        File,
+        Authority,
+        UserInfo
+    };
+
+    static std::optional<Part> tryParsePart(const String & part_name)
+    {
+        static const std::unordered_map<String, Part> parts
+            = {{"HOST", Part::Host},
+               {"PATH", Part::Path},
+               {"QUERY", Part::Query},
+               {"REF", Part::Ref},
+               {"FILE", Part::File},
+               {"AUTHORITY", Part::Authority},
+               {"USERINFO", Part::UserInfo}};
+        auto it = parts.find(part_name);
+        if (it == parts.end())
+            return {};
+        return it->second;
+    }
+
+    String getName() const override { return name; }
+    bool isVariadic() const override { return true; }
+    size_t getNumberOfArguments() const override { return 0; }
+    DB::ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {2, 3}; }
+    bool isSuitableForShortCircuitArgumentsExecution(const DB::DataTypesWithConstInfo & /*arguments*/) const override { return true; }
+    bool useDefaultImplementationForConstants() const override { return true; }
+
+    DB::DataTypePtr getReturnTypeImpl(const DB::ColumnsWithTypeAndName & arguments) const override
+    {
+        if (arguments.size() != 3 && arguments.size() != 4)
+            throw DB::Exception(DB::ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH, "Function {} requires 3 or 4 arguments", getName());
+        if (!isString(arguments[0].type))
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}",
+                arguments[0].type->getName(), getName());
+        if (!arguments[1].type->equals(*SparkFunctionParseURLComponents::getComponentsType()))
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}",
+                arguments[1].type->getName(), getName());
+        for (size_t i = 2; i < arguments.size(); ++i)
+            if (!isString(arguments[i].type))
+                throw DB::Exception(DB::ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT, "Illegal type {} of argument of function {}",
+                    arguments[i].type->getName(), getName());
+        return DB::makeNullable(std::make_shared<DB::DataTypeString>());
+    }
+
+    DB::ColumnPtr executeImpl(const DB::ColumnsWithTypeAndName & arguments, const DB::DataTypePtr &, size_t input_rows_count) const override
+    {
+        auto part_name = arguments[2].column->getDataAt(0).toString();
+        auto part = tryParsePart(part_name);
+        if (!part)
+            throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Unknown url part {} of function {}", part_name, getName());
+        std::optional<String> key;
+        if (arguments.size() > 3)
+        {
+            if (*part != Part::Query)
+                throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Function {} only accepts a key for the QUERY part", getName());
+            key = arguments[3].column->getDataAt(0).toString();
+        }
+
+        auto url_column = arguments[0].column->convertToFullColumnIfConst();
+        const auto * col = DB::checkAndGetColumn<DB::ColumnString>(url_column.get());
+        if (!col)
+            throw DB::Exception(DB::ErrorCodes::ILLEGAL_COLUMN, "Illegal column {} of argument of function {}",
+                arguments[0].column->getName(), getName());
+        auto components_column = arguments[1].column->convertToFullColumnIfConst();
+        const auto & components = assert_cast<const DB::ColumnTuple &>(*components_column);
+        const auto & tokenized = assert_cast<const DB::ColumnUInt8 &>(components.getColumn(0)).getData();
+        std::array<const UInt32 *, SparkFunctionParseURLComponents::OFFSET_NUM> offsets;
+        for (size_t i = 0; i < offsets.size(); ++i)
+            offsets[i] = assert_cast<const DB::ColumnUInt32 &>(components.getColumn(i + 1)).getData().data();
+
+        auto res = DB::ColumnString::create();
+        res->reserve(input_rows_count);
+        auto null_map = DB::ColumnUInt8::create(input_rows_count, 0);
+        auto & null_map_data = null_map->getData();
+        for (size_t i = 0; i < input_rows_count; ++i)
+        {
+            auto url = col->getDataAt(i);
+            bool extracted = tokenized[i] ? extractTokenized(*part, key, url.data, url.size, offsets, i, *res)
+                                          : extractWithURI(*part, key, url.toString(), *res);
+            if (!extracted)
+            {
+                res->insertDefault();
+                null_map_data[i] = 1;
+            }
+        }
+        return DB::ColumnNullable::create(std::move(res), std::move(null_map));
+    }
+
+private:
+    static bool extractTokenized(
+        Part part,
+        const std::optional<String> & key,
+        DB::Pos url,
+        size_t url_size,
+        const std::array<const UInt32 *, SparkFunctionParseURLComponents::OFFSET_NUM> & offsets,
+        size_t row,
+        DB::ColumnString & res)
+    {
+        using Components = SparkFunctionParseURLComponents;
+        DB::Pos end = url + url_size;
+        DB::Pos authority_begin = url + offsets[Components::AUTHORITY_BEGIN][row];
+        DB::Pos host_begin = url + offsets[Components::HOST_BEGIN][row];
+        DB::Pos path_begin = url + offsets[Components::PATH_BEGIN][row];
+        DB::Pos path_end = url + offsets[Components::PATH_END][row];
+        DB::Pos query_end = url + offsets[Components::QUERY_END][row];
+        bool has_query = path_end < end && *path_end == '?';
+        bool has_userinfo = host_begin - authority_begin > 1;
+
+        auto insert_not_empty = [&](DB::Pos begin, DB::Pos stop)
+        {
+            if (begin >= stop)
+                return false;
+            res.insertData(begin, stop - begin);
+            return true;
+        };
+
+        switch (part)
+        {
+            case Part::Host:
+                return insert_not_empty(host_begin, path_begin);
+            case Part::UserInfo:
+                return has_userinfo && insert_not_empty(authority_begin, host_begin - 1);
+            case Part::Authority:
+                return insert_not_empty(has_userinfo ? authority_begin : host_begin, path_begin);
+            case Part::Path:
+                res.insertData(path_begin, path_end - path_begin);
+                return true;
+            case Part::Query: {
+                if (!has_query)
+                    return false;
+                if (!key)
+                {
+                    res.insertData(path_end + 1, query_end - path_end - 1);
+                    return true;
+                }
+                DB::Pos value = nullptr;
+                size_t value_size = 0;
+                if (!SparkExtractURLOneQuery::findValue(path_end + 1, query_end - path_end - 1, *key, value, value_size))
+                    return false;
+                res.insertData(value, value_size);
+                return true;
+            }
+            case Part::Ref:
+                if (query_end == end)
+                    return false;
+                res.insertData(query_end + 1, end - query_end - 1);
+                return true;
+            case Part::File: {
+                /// Same as SparkExtractURLFile, the path is followed by '?' and the query if there is any '?' in the url
+                if (has_query)
+                {
+                    if (path_begin == path_end && query_end == path_end + 1)
+                        res.insertDefault();
+                    else
+                        res.insertData(path_begin, query_end - path_begin);
+                }
+                else if (find_first_symbols<'?'>(query_end, end) != end)
+                {
+                    String file(path_begin, path_end);
+                    if (!file.empty())
+                        file += '?';
+                    res.insertData(file.data(), file.size());
+                }
+                else
+                    res.insertData(path_begin, path_end - path_begin);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool extractWithURI(Part part, const std::optional<String> & key, const String & s, DB::ColumnString & res)
+    {
+        DB::Pos data = nullptr;
+        size_t size = 0;
+        try
+        {
+            Poco::URI uri(s, false);
+            switch (part)
+            {
+                case Part::Host:
+                    SparkExtractURLHost::execute(uri, s, data, size);
+                    break;
+                case Part::Path:
+                    SparkExtractURLPath::execute(uri, s, data, size);
+                    break;
+                case Part::Query:
+                    if (!key)
+                        SparkExtractURLQuery::execute(uri, s, data, size);
+                    else if (SparkExtractURLOneQuery::hasQueryString(uri, s))
+                    {
+                        const auto & query = uri.getRawQuery();
+                        SparkExtractURLOneQuery::findValue(query.data(), query.size(), *key, data, size);
+                    }
+                    break;
+                case Part::Ref:
+                    SparkExtractURLRef::execute(uri, s, data, size);
+                    break;
+                case Part::File:
+                    SparkExtractURLFile::execute(uri, s, data, size);
+                    break;
+                case Part::Authority:
+                    SparkExtractURLAuthority::execute(uri, s, data, size);
+                    break;
+                case Part::UserInfo:
+                    SparkExtractURLUserInfo::execute(uri, s, data, size);
+                    break;
+            }
+            if (!data)
+                return false;
+            res.insertData(data, size);
+            return true;
+        }
+        catch (const Poco::SyntaxException &)
+        {
+            return false;
+        }
+    }
+};
+
+REGISTER_FUNCTION(SparkFunctionParseURLComponent)
+{
+    factory.registerFunction<SparkFunctionParseURLComponent>();
+}
 }
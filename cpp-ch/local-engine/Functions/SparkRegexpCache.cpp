@@ -0,0 +1,43 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "SparkRegexpCache.h"
+
+#include <Functions/Regexps.h>
+
+namespace local_engine
+{
+
+SparkCompiledRegexp::SparkCompiledRegexp(const String & pattern)
+    : regexp(DB::Regexps::createRegexp<false, false, false>(pattern))
+{
+    bool is_trivial;
+    bool required_literal_is_prefix;
+    regexp.getAnalyzeResult(required_literal, is_trivial, required_literal_is_prefix);
+    if (!required_literal.empty())
+        searcher.emplace(required_literal.data(), required_literal.size());
+}
+
+SparkCompiledRegexpPtr SparkRegexpCache::get(const String & pattern)
+{
+    if (auto regexp = cache.get(pattern))
+        return regexp;
+
+    SparkCompiledRegexpPtr regexp = new SparkCompiledRegexp(pattern);
+    cache.add(pattern, regexp);
+    return regexp;
+}
+}
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optional>
+#include <Common/OptimizedRegularExpression.h>
+#include <Common/StringSearcher.h>
+#include <Poco/LRUCache.h>
+#include <Poco/SharedPtr.h>
+
+namespace local_engine
+{
+
+/// A compiled Spark regexp with the literal substring which every match of it contains. The literal is searched with the SIMD
+/// substring searcher, so that the strings without it could be skipped before running the regexp engine.
+class SparkCompiledRegexp
+{
+public:
+    explicit SparkCompiledRegexp(const String & pattern);
+    /// The searcher refers to required_literal, so it must not be copied or moved.
+    SparkCompiledRegexp(const SparkCompiledRegexp &) = delete;
+    SparkCompiledRegexp & operator=(const SparkCompiledRegexp &) = delete;
+
+    const OptimizedRegularExpression & getRegexp() const { return regexp; }
+    size_t getRequiredLiteralSize() const { return required_literal.size(); }
+    bool hasRequiredLiteral() const { return searcher.has_value(); }
+
+    /// Return the first occurrence of the required literal in [begin, end), or end if there is none.
+    const char * findRequiredLiteral(const char * begin, const char * end) const { return searcher->search(begin, end); }
+
+    /// Whether [begin, end) may contain a match
+    bool mayMatch(const char * begin, const char * end) const { return !searcher || findRequiredLiteral(begin, end) != end; }
+
+private:
+    OptimizedRegularExpression regexp;
+    String required_literal;
+    std::optional<DB::ASCIICaseSensitiveStringSearcher> searcher;
+};
+
+using SparkCompiledRegexpPtr = Poco::SharedPtr<SparkCompiledRegexp>;
+
+/// Tells whether the rows of a string column may match a constant regexp. Rows must be checked in order. Instead of searching
+/// every row, the required literal is searched through the rest of the column at once, and the found occurrence is kept until
+/// the rows reach it, so a long run of rows without the literal costs a single scan.
+class SparkRegexpRowFilter
+{
+public:
+    /// column_end is the end of the chars which all the rows are in, or nullptr if the rows are not in one buffer.
+    SparkRegexpRowFilter(const SparkCompiledRegexp & regexp_, const char * column_end_) : regexp(regexp_), column_end(column_end_) { }
+
+    bool mayMatch(const char * row_begin, const char * row_end)
+    {
+        if (!regexp.hasRequiredLiteral())
+            return true;
+        if (!column_end)
+            return regexp.mayMatch(row_begin, row_end);
+
+        if (!next_literal || next_literal < row_begin)
+            next_literal = regexp.findRequiredLiteral(row_begin, column_end);
+        return next_literal != column_end && next_literal + regexp.getRequiredLiteralSize() <= row_end;
+    }
+
+private:
+    const SparkCompiledRegexp & regexp;
+    const char * column_end;
+    const char * next_literal = nullptr;
+};
+
+/// Bounded LRU of compiled regexps keyed by pattern, for regexp functions whose pattern is not constant.
+class SparkRegexpCache
+{
+public:
+    static constexpr size_t DEFAULT_MAX_SIZE = 256;
+
+    explicit SparkRegexpCache(size_t max_size = DEFAULT_MAX_SIZE) : cache(static_cast<long>(max_size)) { }
+
+    SparkCompiledRegexpPtr get(const String & pattern);
+
+private:
+    Poco::LRUCache<String, SparkCompiledRegexp> cache;
+};
+}
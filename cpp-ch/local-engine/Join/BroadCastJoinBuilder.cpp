@@ -27,7 +27,9 @@
 #include <jni/jni_common.h>
 #include <Poco/StringTokenizer.h>
 #include <Common/CHUtil.h>
+#include <Common/GlutenConfig.h>
 #include <Common/JNIUtils.h>
+#include <Common/QueryContext.h>
 #include <Common/logger_useful.h>
 #include <DataTypes/DataTypesNumber.h>
 
@@ -228,6 +230,14 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
 
     ColumnsDescription columns_description(header.getNamesAndTypesList());
 
+    /// A large table is built in partitions concurrently, StorageJoinFromReadBuffer falls back to one partition if the join
+    /// could not be partitioned.
+    size_t build_partitions = 1;
+    auto join_config = JoinConfig::loadFromContext(QueryContext::globalContext());
+    if (!is_cross_rel_join && join_config.broadcast_parallel_build_rows_threshold && row_count > 0
+        && static_cast<size_t>(row_count) >= join_config.broadcast_parallel_build_rows_threshold)
+        build_partitions = join_config.broadcast_parallel_build_partitions;
+
     return make_shared<StorageJoinFromReadBuffer>(
         data,
         row_count,
@@ -241,7 +251,8 @@ std::shared_ptr<StorageJoinFromReadBuffer> buildJoin(
         key,
         true,
         is_null_aware_anti_join,
-        has_null_key_values);
+        has_null_key_values,
+        build_partitions);
 }
 
 void init(JNIEnv * env)
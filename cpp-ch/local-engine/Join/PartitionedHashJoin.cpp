@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "PartitionedHashJoin.h"
+
+#include <Columns/ColumnNullable.h>
+#include <DataTypes/DataTypeLowCardinality.h>
+#include <Interpreters/HashJoin/HashJoin.h>
+#include <Interpreters/TableJoin.h>
+#include <Common/Exception.h>
+#include <Common/WeakHash.h>
+#include <Common/typeid_cast.h>
+
+namespace DB
+{
+namespace ErrorCodes
+{
+extern const int LOGICAL_ERROR;
+}
+}
+
+using namespace DB;
+
+namespace local_engine
+{
+namespace
+{
+/// Chains the results of the partitions, only the last one is marked as the last block.
+class PartitionedJoinResult : public IJoinResult
+{
+public:
+    explicit PartitionedJoinResult(std::vector<JoinResultPtr> results_) : results(std::move(results_)) { }
+
+    JoinResultBlock next() override
+    {
+        auto result = results[current]->next();
+        if (result.is_last && current + 1 < results.size())
+        {
+            ++current;
+            result.is_last = false;
+        }
+        return result;
+    }
+
+private:
+    std::vector<JoinResultPtr> results;
+    size_t current = 0;
+};
+}
+
+PartitionedHashJoin::PartitionedHashJoin(
+    std::shared_ptr<DB::TableJoin> table_join_, std::vector<std::shared_ptr<DB::HashJoin>> joins_, const DB::Names & left_key_names_)
+    : table_join(table_join_), joins(std::move(joins_)), left_key_names(left_key_names_)
+{
+    if (joins.empty())
+        throw Exception(ErrorCodes::LOGICAL_ERROR, "PartitionedHashJoin requires at least one partition");
+}
+
+DB::Blocks PartitionedHashJoin::scatterByKeys(const DB::Block & block, const DB::Names & key_names, size_t partitions)
+{
+    const size_t rows = block.rows();
+    WeakHash32 hash(rows);
+    for (const auto & key_name : key_names)
+    {
+        /// Nullable and LowCardinality are removed, so that the same key value gets the same hash on both sides. The null
+        /// keys never match, any partition is fine for them.
+        auto key_column = block.getByName(key_name).column->convertToFullColumnIfConst()->convertToFullColumnIfSparse();
+        key_column = recursiveRemoveLowCardinality(key_column);
+        if (const auto * nullable_column = typeid_cast<const ColumnNullable *>(key_column.get()))
+            key_column = nullable_column->getNestedColumnPtr();
+        hash.update(key_column->getWeakHash32());
+    }
+
+    /// Use the high bits of the hash, the low bits are also used by the hash tables inside the partitions.
+    IColumn::Selector selector(rows);
+    const auto & hash_data = hash.getData();
+    for (size_t i = 0; i < rows; ++i)
+        selector[i] = (static_cast<UInt64>(hash_data[i]) * partitions) >> 32;
+
+    std::vector<MutableColumns> scattered_columns(partitions);
+    for (size_t pos = 0; pos < block.columns(); ++pos)
+    {
+        auto columns = block.getByPosition(pos).column->scatter(partitions, selector);
+        for (size_t i = 0; i < partitions; ++i)
+            scattered_columns[i].emplace_back(std::move(columns[i]));
+    }
+
+    Blocks result(partitions);
+    for (size_t i = 0; i < partitions; ++i)
+        result[i] = block.cloneWithColumns(std::move(scattered_columns[i]));
+    return result;
+}
+
+void PartitionedHashJoin::initialize(const DB::Block & sample_block)
+{
+    for (auto & join : joins)
+        join->initialize(sample_block);
+}
+
+bool PartitionedHashJoin::addBlockToJoin(const DB::Block & /*block*/, bool /*check_limits*/)
+{
+    throw Exception(ErrorCodes::LOGICAL_ERROR, "PartitionedHashJoin is already filled");
+}
+
+void PartitionedHashJoin::checkTypesOfKeys(const DB::Block & block) const
+{
+    joins[0]->checkTypesOfKeys(block);
+}
+
+DB::JoinResultPtr PartitionedHashJoin::joinBlock(DB::Block block)
+{
+    /// An empty block is also used to get the result header.
+    if (joins.size() == 1 || !block.rows())
+        return joins[0]->joinBlock(std::move(block));
+
+    auto partitioned_blocks = scatterByKeys(block, left_key_names, joins.size());
+    std::vector<JoinResultPtr> results;
+    results.reserve(joins.size());
+    for (size_t i = 0; i < joins.size(); ++i)
+    {
+        if (partitioned_blocks[i].rows())
+            results.emplace_back(joins[i]->joinBlock(std::move(partitioned_blocks[i])));
+    }
+    return std::make_unique<PartitionedJoinResult>(std::move(results));
+}
+
+size_t PartitionedHashJoin::getTotalRowCount() const
+{
+    size_t rows = 0;
+    for (const auto & join : joins)
+        rows += join->getTotalRowCount();
+    return rows;
+}
+
+size_t PartitionedHashJoin::getTotalByteCount() const
+{
+    size_t bytes = 0;
+    for (const auto & join : joins)
+        bytes += join->getTotalByteCount();
+    return bytes;
+}
+
+bool PartitionedHashJoin::alwaysReturnsEmptySet() const
+{
+    for (const auto & join : joins)
+        if (!join->alwaysReturnsEmptySet())
+            return false;
+    return true;
+}
+
+DB::JoinPipelineType PartitionedHashJoin::pipelineType() const
+{
+    return joins[0]->pipelineType();
+}
+
+DB::IBlocksStreamPtr PartitionedHashJoin::getNonJoinedBlocks(
+    const DB::Block & /*left_sample_block*/, const DB::Block & /*result_sample_block*/, UInt64 /*max_block_size*/) const
+{
+    /// Only inner and left joins are partitioned, they have no non-joined right rows to emit.
+    return nullptr;
+}
+
+}
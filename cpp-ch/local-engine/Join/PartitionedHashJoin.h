@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <Columns/IColumn.h>
+#include <Core/Block.h>
+#include <Interpreters/IJoin.h>
+
+namespace DB
+{
+class TableJoin;
+class HashJoin;
+}
+
+namespace local_engine
+{
+
+/// A filled hash join whose right table is split into partitions by the hash of the join keys, each partition is a
+/// HashJoin built on its own. Every left row is routed to the partition of its keys, so only inner and left joins without
+/// a mixed join condition could be partitioned, their result for a left row only depends on the right rows with the same keys.
+/// The rows of one left block are reordered by the partitions.
+class PartitionedHashJoin : public DB::IJoin
+{
+public:
+    PartitionedHashJoin(
+        std::shared_ptr<DB::TableJoin> table_join_, std::vector<std::shared_ptr<DB::HashJoin>> joins_, const DB::Names & left_key_names_);
+    ~PartitionedHashJoin() override = default;
+
+    /// Scatter the block into partitions by the hash of the key columns. The left and right tables must use the same
+    /// key order, the key types may only differ in Nullable and LowCardinality.
+    static DB::Blocks scatterByKeys(const DB::Block & block, const DB::Names & key_names, size_t partitions);
+
+    std::string getName() const override { return "PartitionedHashJoin"; }
+    const DB::TableJoin & getTableJoin() const override { return *table_join; }
+
+    void initialize(const DB::Block & sample_block) override;
+    bool addBlockToJoin(const DB::Block & block, bool check_limits) override;
+    void checkTypesOfKeys(const DB::Block & block) const override;
+    DB::JoinResultPtr joinBlock(DB::Block block) override;
+
+    size_t getTotalRowCount() const override;
+    size_t getTotalByteCount() const override;
+    bool alwaysReturnsEmptySet() const override;
+    bool isFilled() const override { return true; }
+    DB::JoinPipelineType pipelineType() const override;
+
+    DB::IBlocksStreamPtr
+    getNonJoinedBlocks(const DB::Block & left_sample_block, const DB::Block & result_sample_block, UInt64 max_block_size) const override;
+
+private:
+    std::shared_ptr<DB::TableJoin> table_join;
+    std::vector<std::shared_ptr<DB::HashJoin>> joins;
+    DB::Names left_key_names;
+};
+
+}
@@ -16,9 +16,12 @@
  */
 #include "StorageJoinFromReadBuffer.h"
 
+#include <algorithm>
+#include <functional>
 #include <Interpreters/Context.h>
 #include <Interpreters/HashJoin/HashJoin.h>
 #include <Interpreters/TableJoin.h>
+#include <Join/PartitionedHashJoin.h>
 #include <Common/BlockTypeUtils.h>
 #include <Common/CHUtil.h>
 #include <Common/Exception.h>
@@ -75,9 +78,14 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
     const String & comment,
     const bool overwrite_,
     bool is_null_aware_anti_join_,
-    bool has_null_key_values_)
+    bool has_null_key_values_,
+    size_t build_partitions_)
     : key_names(key_names_), use_nulls(use_nulls_), row_count(row_count_), overwrite(overwrite_), is_null_aware_anti_join(is_null_aware_anti_join_), has_null_key_value(has_null_key_values_)
 {
+    /// A left row could be routed to one partition only when its result just depends on the right rows with the same keys.
+    bool can_partition
+        = !has_mixed_join_condition && !key_names.empty() && !is_null_aware_anti_join && (isInner(kind) || isLeft(kind));
+    build_partitions = can_partition ? std::max<size_t>(build_partitions_, 1) : 1;
     is_empty_hash_table = row_count < 1;
     storage_metadata.setColumns(columns);
     storage_metadata.setConstraints(constraints);
@@ -102,8 +110,13 @@ StorageJoinFromReadBuffer::StorageJoinFromReadBuffer(
         collectAllInputs(data);
 }
 
-void StorageJoinFromReadBuffer::buildJoin(const Blocks & data, const SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join)
+void StorageJoinFromReadBuffer::buildJoin(Blocks & data, const SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join)
 {
+    if (build_partitions > 1)
+    {
+        buildPartitionedJoin(data, header, analyzed_join);
+        return;
+    }
     auto build_join = [&]
     {
         join = std::make_shared<HashJoin>(analyzed_join, header, overwrite, row_count, "", false);
@@ -115,6 +128,86 @@ void StorageJoinFromReadBuffer::buildJoin(const Blocks & data, const SharedHeade
     thread.join();
 }
 
+/// Build the right table in two phases, both run in build_partitions threads.
+/// 1. Each thread scatters a part of the input blocks by the join keys' hash, and releases the input blocks.
+/// 2. Each thread inserts all the blocks of one partition into its own HashJoin.
+void StorageJoinFromReadBuffer::buildPartitionedJoin(
+    Blocks & data, const SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join)
+{
+    const size_t partitions = build_partitions;
+    /// Record memory usage in Total Memory Tracker
+    auto run_in_threads = [&](const std::function<void(size_t)> & task)
+    {
+        std::vector<std::exception_ptr> exceptions(partitions);
+        std::vector<ThreadFromGlobalPoolNoTracingContextPropagation> threads;
+        threads.reserve(partitions);
+        try
+        {
+            for (size_t i = 0; i < partitions; ++i)
+                threads.emplace_back(
+                    [&, i]
+                    {
+                        try
+                        {
+                            task(i);
+                        }
+                        catch (...)
+                        {
+                            exceptions[i] = std::current_exception();
+                        }
+                    });
+        }
+        catch (...)
+        {
+            for (auto & thread : threads)
+                thread.join();
+            throw;
+        }
+        for (auto & thread : threads)
+            thread.join();
+        for (const auto & exception : exceptions)
+            if (exception)
+                std::rethrow_exception(exception);
+    };
+
+    /// scattered_blocks[i][p] are the blocks of partition p which are scattered by thread i.
+    std::vector<std::vector<Blocks>> scattered_blocks(partitions, std::vector<Blocks>(partitions));
+    run_in_threads(
+        [&](size_t thread_index)
+        {
+            for (size_t i = thread_index; i < data.size(); i += partitions)
+            {
+                auto blocks = PartitionedHashJoin::scatterByKeys(data[i], key_names, partitions);
+                for (size_t p = 0; p < partitions; ++p)
+                    if (blocks[p].rows())
+                        scattered_blocks[thread_index][p].emplace_back(std::move(blocks[p]));
+                data[i].clear();
+            }
+        });
+
+    /// Like ConcurrentHashJoin, the HashJoins share the same TableJoin, so create them before building concurrently.
+    partitioned_joins.clear();
+    for (size_t p = 0; p < partitions; ++p)
+        partitioned_joins.emplace_back(std::make_shared<HashJoin>(analyzed_join, header, overwrite, row_count / partitions + 1, "", false));
+
+    run_in_threads(
+        [&](size_t partition)
+        {
+            for (auto & thread_blocks : scattered_blocks)
+            {
+                for (const auto & block : thread_blocks[partition])
+                    partitioned_joins[partition]->addBlockToJoin(block, true);
+                thread_blocks[partition].clear();
+            }
+        });
+    LOG_DEBUG(
+        getLogger("StorageJoinFromReadBuffer"),
+        "Built broadcast table {} with {} rows in {} partitions",
+        storage_metadata.comment,
+        row_count,
+        partitions);
+}
+
 void StorageJoinFromReadBuffer::collectAllInputs(Blocks & data)
 {
     for (Block block : data)
@@ -167,10 +260,47 @@ DB::JoinPtr StorageJoinFromReadBuffer::getJoinLocked(std::shared_ptr<DB::TableJo
             ErrorCodes::INCOMPATIBLE_TYPE_OF_JOIN,
             "Table {} needs the same join_use_nulls setting as present in LEFT or FULL JOIN",
             storage_metadata.comment);
+    if (!partitioned_joins.empty())
+        return getPartitionedJoin(analyzed_join);
     buildJoinLazily(right_sample_block, analyzed_join);
     HashJoinPtr join_clone = std::make_shared<HashJoin>(analyzed_join, right_sample_block);
     /// reuseJoinedData will set the flag `HashJoin::from_storage_join` which is required by `FilledStep`
     join_clone->reuseJoinedData(static_cast<const HashJoin &>(*join));
     return join_clone;
 }
+
+DB::JoinPtr StorageJoinFromReadBuffer::getPartitionedJoin(std::shared_ptr<DB::TableJoin> analyzed_join)
+{
+    /// The left keys must be hashed in the same order as the right keys in the build. Every join on clause must route the
+    /// left rows to the same partition.
+    Names left_key_names;
+    for (const auto & clause : analyzed_join->getClauses())
+    {
+        Names clause_left_key_names;
+        for (const auto & key_name : key_names)
+        {
+            auto it = std::find(clause.key_names_right.begin(), clause.key_names_right.end(), key_name);
+            if (it == clause.key_names_right.end())
+                throw Exception(
+                    ErrorCodes::LOGICAL_ERROR,
+                    "Join key {} of the partitioned table {} is not in the join clause",
+                    key_name,
+                    storage_metadata.comment);
+            clause_left_key_names.emplace_back(clause.key_names_left[it - clause.key_names_right.begin()]);
+        }
+        if (!left_key_names.empty() && left_key_names != clause_left_key_names)
+            throw Exception(
+                ErrorCodes::LOGICAL_ERROR, "Join clauses of the partitioned table {} use different left keys", storage_metadata.comment);
+        left_key_names = std::move(clause_left_key_names);
+    }
+
+    std::vector<HashJoinPtr> join_clones;
+    for (const auto & partitioned_join : partitioned_joins)
+    {
+        HashJoinPtr join_clone = std::make_shared<HashJoin>(analyzed_join, right_sample_block);
+        join_clone->reuseJoinedData(*partitioned_join);
+        join_clones.emplace_back(std::move(join_clone));
+    }
+    return std::make_shared<PartitionedHashJoin>(analyzed_join, std::move(join_clones), left_key_names);
+}
 }
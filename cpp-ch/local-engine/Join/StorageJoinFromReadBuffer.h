@@ -48,7 +48,8 @@ public:
         const String & comment,
         bool overwrite_,
         bool is_null_aware_anti_join_,
-        bool has_null_key_values_);
+        bool has_null_key_values_,
+        size_t build_partitions_ = 1);
 
     bool has_null_key_value = false;
     bool is_empty_hash_table = false;
@@ -70,10 +71,15 @@ private:
     std::list<DB::Block> input_blocks;
     std::shared_ptr<DB::HashJoin> join = nullptr;
     bool is_null_aware_anti_join;
+    /// If build_partitions > 1, the right table is split by the join keys' hash and built into partitioned_joins concurrently.
+    size_t build_partitions;
+    std::vector<std::shared_ptr<DB::HashJoin>> partitioned_joins;
 
     void readAllBlocksFromInput(DB::ReadBuffer & in);
-    void buildJoin(const DB::Blocks & data, const DB::SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join);
+    void buildJoin(DB::Blocks & data, const DB::SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join);
+    void buildPartitionedJoin(DB::Blocks & data, const DB::SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join);
     void collectAllInputs(DB::Blocks & data);
     void buildJoinLazily(const DB::SharedHeader & header, std::shared_ptr<DB::TableJoin> analyzed_join);
+    DB::JoinPtr getPartitionedJoin(std::shared_ptr<DB::TableJoin> analyzed_join);
 };
 }
@@ -0,0 +1,678 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HashWindowGroupLimitStep.h"
+
+#include <algorithm>
+#include <Columns/ColumnsNumber.h>
+#include <Columns/IColumn.h>
+#include <Core/Settings.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Interpreters/Context.h>
+#include <Processors/Port.h>
+#include <Processors/ResizeProcessor.h>
+#include <Processors/Transforms/ScatterByPartitionTransform.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Common/BlockTypeUtils.h>
+#include <Common/GlutenConfig.h>
+#include <Common/QueryContext.h>
+#include <Common/SipHash.h>
+#include <Common/Stopwatch.h>
+#include <Common/formatReadable.h>
+#include <Common/logger_useful.h>
+
+namespace DB
+{
+namespace Setting
+{
+extern const SettingsUInt64 max_block_size;
+}
+namespace ErrorCodes
+{
+extern const int LOGICAL_ERROR;
+}
+}
+
+namespace local_engine
+{
+
+static DB::ITransformingStep::Traits getTraits()
+{
+    return DB::ITransformingStep::Traits{
+        {
+            .preserves_number_of_streams = false,
+            .preserves_sorting = false,
+        },
+        {
+            .preserves_number_of_rows = false,
+        }};
+}
+
+DB::Block HashWindowGroupLimitStep::buildOutputHeader(const DB::Block & input_header, const String & rank_column_name)
+{
+    auto output_header = input_header.cloneEmpty();
+    auto rank_type = std::make_shared<DB::DataTypeInt32>();
+    output_header.insert(DB::ColumnWithTypeAndName(rank_type->createColumn(), rank_type, rank_column_name));
+    return output_header;
+}
+
+HashWindowGroupLimitStep::HashWindowGroupLimitStep(
+    DB::ContextPtr context_,
+    const DB::SharedHeader & input_header_,
+    const String & function_name_,
+    const std::vector<size_t> & partition_columns_,
+    const DB::SortDescription & sort_description_,
+    size_t limit_,
+    const String & rank_column_name_)
+    : DB::ITransformingStep(input_header_, toShared(buildOutputHeader(*input_header_, rank_column_name_)), getTraits())
+    , context(context_)
+    , function_name(function_name_)
+    , partition_columns(partition_columns_)
+    , sort_description(sort_description_)
+    , limit(limit_)
+    , rank_column_name(rank_column_name_)
+{
+}
+
+void HashWindowGroupLimitStep::describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const
+{
+    if (!processors.empty())
+        DB::IQueryPlanStep::describePipeline(processors, settings);
+}
+
+void HashWindowGroupLimitStep::updateOutputHeader()
+{
+    output_header = toShared(buildOutputHeader(*input_headers.front(), rank_column_name));
+}
+
+void HashWindowGroupLimitStep::transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & /*settings*/)
+{
+    auto function = HashWindowGroupLimitTransform::parseRankFunction(function_name);
+    auto num_streams = pipeline.getNumStreams();
+    /// Rows of one window partition may come from different streams, they must be processed by the same transform.
+    if (num_streams > 1 && !partition_columns.empty())
+        scatterByPartitionKeys(pipeline);
+    else
+        pipeline.resize(1);
+    pipeline.addSimpleTransform(
+        [&](const DB::SharedHeader & header)
+        {
+            return std::make_shared<HashWindowGroupLimitTransform>(
+                context, header, output_header, function, partition_columns, sort_description, limit);
+        });
+    pipeline.resize(num_streams, true);
+}
+
+void HashWindowGroupLimitStep::scatterByPartitionKeys(DB::QueryPipelineBuilder & pipeline) const
+{
+    auto num_streams = pipeline.getNumStreams();
+    auto header = pipeline.getSharedHeader();
+    DB::ColumnNumbers key_columns(partition_columns.begin(), partition_columns.end());
+    pipeline.transform(
+        [&](DB::OutputPortRawPtrs ports)
+        {
+            DB::Processors scatters;
+            for (auto * port : ports)
+            {
+                auto scatter = std::make_shared<DB::ScatterByPartitionTransform>(header, num_streams, key_columns);
+                DB::connect(*port, scatter->getInputs().front());
+                scatters.push_back(scatter);
+            }
+            return scatters;
+        });
+    /// Merge the i-th outputs of all the scatter transforms into the i-th stream, so each stream owns a disjoint set of partitions.
+    pipeline.transform(
+        [&](DB::OutputPortRawPtrs ports)
+        {
+            DB::Processors resizes;
+            for (size_t i = 0; i < num_streams; ++i)
+            {
+                auto resize = std::make_shared<DB::ResizeProcessor>(header, num_streams, 1);
+                size_t port_index = i;
+                for (auto & input : resize->getInputs())
+                {
+                    DB::connect(*ports[port_index], input);
+                    port_index += num_streams;
+                }
+                resizes.push_back(resize);
+            }
+            return resizes;
+        });
+}
+
+HashWindowGroupLimitTransform::RankFunction HashWindowGroupLimitTransform::parseRankFunction(const String & function_name)
+{
+    if (function_name == "row_number")
+        return RankFunction::RowNumber;
+    else if (function_name == "rank")
+        return RankFunction::Rank;
+    else if (function_name == "dense_rank")
+        return RankFunction::DenseRank;
+    throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Unsupport function {} in HashWindowGroupLimit", function_name);
+}
+
+HashWindowGroupLimitTransform::HashWindowGroupLimitTransform(
+    DB::ContextPtr context_,
+    const DB::SharedHeader & input_header_,
+    const DB::SharedHeader & output_header_,
+    RankFunction function_,
+    const std::vector<size_t> & partition_columns_,
+    const DB::SortDescription & sort_description_,
+    size_t limit_)
+    : DB::IProcessor({input_header_}, {output_header_})
+    , context(context_)
+    , input_header(input_header_)
+    , output_header(output_header_)
+    , function(function_)
+    , partition_columns(partition_columns_)
+    , limit(limit_)
+    , tmp_data_disk(context_->getTempDataOnDisk())
+    , buckets(SPILL_BUCKETS)
+{
+    if (!limit)
+        throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Invalid limit: {}", limit);
+    for (const auto & sort_column : sort_description_)
+        sort_columns.emplace_back(SortColumn{
+            .position = input_header->getPositionByName(sort_column.column_name),
+            .direction = sort_column.direction,
+            .nulls_direction = sort_column.nulls_direction});
+    max_block_size = context->getSettingsRef()[DB::Setting::max_block_size];
+    spill_mem_ratio = MemoryConfig::loadFromContext(context).spill_mem_ratio;
+    // IProcessor::spillable, MemorySpillScheduler will trigger the spill by enable this flag.
+    spillable = true;
+}
+
+HashWindowGroupLimitTransform::~HashWindowGroupLimitTransform()
+{
+    LOG_INFO(
+        logger,
+        "Metrics. total_input_rows: {}, total_buffered_rows: {}, total_output_rows: {}, total_spilled_buckets: {}, total_spill_disk_bytes: "
+        "{}",
+        total_input_rows,
+        total_buffered_rows,
+        total_output_rows,
+        total_spilled_buckets,
+        total_spill_disk_bytes);
+}
+
+HashWindowGroupLimitTransform::Status HashWindowGroupLimitTransform::prepare()
+{
+    auto & output = outputs.front();
+    auto & input = inputs.front();
+    if (output.isFinished() || isCancelled())
+    {
+        input.close();
+        return Status::Finished;
+    }
+    if (has_output)
+    {
+        if (output.canPush())
+        {
+            total_output_rows += output_chunk.getNumRows();
+            output.push(std::move(output_chunk));
+            has_output = false;
+        }
+        return Status::PortFull;
+    }
+
+    if (has_input)
+        return Status::Ready;
+
+    if (!input_finished)
+    {
+        if (input.isFinished())
+        {
+            input_finished = true;
+            return Status::Ready;
+        }
+        input.setNeeded();
+        if (!input.hasData())
+            return Status::NeedData;
+        input_chunk = input.pull(true);
+        total_input_rows += input_chunk.getNumRows();
+        has_input = true;
+        return Status::Ready;
+    }
+
+    if (pending_output_chunks.empty() && next_output_bucket >= buckets.size())
+    {
+        output.finish();
+        return Status::Finished;
+    }
+    return Status::Ready;
+}
+
+void HashWindowGroupLimitTransform::work()
+{
+    if (has_input)
+    {
+        addChunk(input_chunk);
+        input_chunk = {};
+        has_input = false;
+        return;
+    }
+
+    if (!input_finished) [[unlikely]]
+        return;
+
+    while (pending_output_chunks.empty() && next_output_bucket < buckets.size())
+        emitBucket(next_output_bucket++);
+    if (!pending_output_chunks.empty())
+    {
+        output_chunk = std::move(pending_output_chunks.front());
+        pending_output_chunks.pop_front();
+        has_output = true;
+    }
+}
+
+std::vector<UInt128> HashWindowGroupLimitTransform::computePartitionKeys(const DB::Columns & input_columns, size_t rows) const
+{
+    std::vector<UInt128> keys(rows);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        SipHash hash;
+        for (auto pos : partition_columns)
+            input_columns[pos]->updateHashWithValue(i, hash);
+        keys[i] = hash.get128();
+    }
+    return keys;
+}
+
+void HashWindowGroupLimitTransform::addChunk(const DB::Chunk & chunk)
+{
+    size_t rows = chunk.getNumRows();
+    if (!rows)
+        return;
+
+    DB::Columns input_columns;
+    for (const auto & col : chunk.getColumns())
+        input_columns.push_back(col->convertToFullColumnIfConst());
+    auto keys = computePartitionKeys(input_columns, rows);
+
+    /// Use the high bits to choose the bucket, the low bits are used by the hash table inside the bucket.
+    std::vector<std::vector<UInt32>> bucket_rows(buckets.size());
+    for (size_t i = 0; i < rows; ++i)
+        bucket_rows[static_cast<UInt64>(keys[i] >> 64) % buckets.size()].push_back(static_cast<UInt32>(i));
+
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        if (bucket_rows[i].empty())
+            continue;
+        if (buckets[i].spill_stream)
+            writeRowsIntoSpilledBucket(i, input_columns, bucket_rows[i]);
+        else
+            addRowsIntoBucket(i, input_columns, keys, bucket_rows[i]);
+    }
+
+    if (isMemoryOverflow())
+    {
+        size_t spill_bucket = buckets.size();
+        size_t max_bytes = 0;
+        for (size_t i = 0; i < buckets.size(); ++i)
+        {
+            if (buckets[i].spill_stream)
+                continue;
+            auto bytes = bucketBytes(buckets[i]);
+            if (bytes > max_bytes)
+            {
+                max_bytes = bytes;
+                spill_bucket = i;
+            }
+        }
+        if (spill_bucket < buckets.size())
+            spillBucket(spill_bucket);
+        force_spill = false;
+    }
+}
+
+void HashWindowGroupLimitTransform::addRowsIntoBucket(
+    size_t bucket_index, const DB::Columns & input_columns, const std::vector<UInt128> & keys, const std::vector<UInt32> & rows)
+{
+    auto & bucket = buckets[bucket_index];
+    if (bucket.columns.empty())
+        bucket.columns = input_header->cloneEmptyColumns();
+
+    /// Drop the rows which are ranked behind the boundaries of their partitions first, the others are appended into the bucket
+    /// in one batch.
+    DB::IColumn::Filter filter(input_columns.front()->size(), 0);
+    std::vector<size_t> accepted_partitions;
+    accepted_partitions.reserve(rows.size());
+    for (auto row : rows)
+    {
+        auto partition_id = findOrAddPartition(bucket, input_columns, keys[row], row);
+        if (isBehindBoundary(bucket, bucket.partitions[partition_id], input_columns, row))
+            continue;
+        filter[row] = 1;
+        accepted_partitions.push_back(partition_id);
+    }
+    if (accepted_partitions.empty())
+        return;
+
+    size_t start_row = bucket.columns.front()->size();
+    for (size_t i = 0; i < input_columns.size(); ++i)
+    {
+        auto filtered = input_columns[i]->filter(filter, accepted_partitions.size());
+        bucket.columns[i]->insertRangeFrom(*filtered, 0, filtered->size());
+    }
+    total_buffered_rows += accepted_partitions.size();
+
+    for (size_t i = 0; i < accepted_partitions.size(); ++i)
+    {
+        auto & partition = bucket.partitions[accepted_partitions[i]];
+        partition.rows.push_back(static_cast<UInt32>(start_row + i));
+        if (partition.rows.size() >= 2 * std::max(limit, partition.kept_rows))
+            prunePartition(bucket, partition);
+    }
+
+    size_t live_rows = bucket.columns.front()->size() - bucket.garbage_rows;
+    if (bucket.garbage_rows > live_rows && bucket.garbage_rows > max_block_size)
+        compactBucket(bucket);
+}
+
+size_t HashWindowGroupLimitTransform::findOrAddPartition(Bucket & bucket, const DB::Columns & input_columns, UInt128 key, size_t row)
+{
+    if (bucket.key_columns.empty())
+        for (auto pos : partition_columns)
+            bucket.key_columns.emplace_back(input_header->getByPosition(pos).column->cloneEmpty());
+
+    using LookupResult = typename decltype(bucket.partition_index)::LookupResult;
+    LookupResult it;
+    bool inserted;
+    bucket.partition_index.emplace(key, it, inserted);
+    size_t new_partition_id = bucket.partitions.size();
+    if (inserted)
+        it->getMapped() = new_partition_id;
+    else
+    {
+        /// The hash is only used to locate the partition, the key values are compared to tell the colliding partitions apart.
+        size_t partition_id = it->getMapped();
+        while (true)
+        {
+            if (isSamePartitionKey(bucket, partition_id, input_columns, row))
+                return partition_id;
+            if (bucket.partitions[partition_id].next_same_hash == NO_PARTITION)
+                break;
+            partition_id = bucket.partitions[partition_id].next_same_hash;
+        }
+        bucket.partitions[partition_id].next_same_hash = new_partition_id;
+    }
+    bucket.partitions.emplace_back();
+    for (size_t i = 0; i < partition_columns.size(); ++i)
+        bucket.key_columns[i]->insertFrom(*input_columns[partition_columns[i]], row);
+    return new_partition_id;
+}
+
+bool HashWindowGroupLimitTransform::isSamePartitionKey(
+    const Bucket & bucket, size_t partition_id, const DB::Columns & input_columns, size_t row) const
+{
+    for (size_t i = 0; i < partition_columns.size(); ++i)
+        if (bucket.key_columns[i]->compareAt(partition_id, row, *input_columns[partition_columns[i]], 1) != 0)
+            return false;
+    return true;
+}
+
+void HashWindowGroupLimitTransform::writeRowsIntoSpilledBucket(
+    size_t bucket_index, const DB::Columns & input_columns, const std::vector<UInt32> & rows)
+{
+    auto & bucket = buckets[bucket_index];
+    DB::IColumn::Filter filter(input_columns.front()->size(), 0);
+    for (auto row : rows)
+        filter[row] = 1;
+    DB::Columns filtered_columns;
+    for (const auto & col : input_columns)
+        filtered_columns.push_back(col->filter(filter, rows.size()));
+    auto block = input_header->cloneWithColumns(std::move(filtered_columns));
+    total_spill_disk_bytes += block.bytes();
+    bucket.spill_stream.value()->write(block);
+}
+
+int HashWindowGroupLimitTransform::compareRows(
+    const DB::Columns & left_columns, size_t left_row, const DB::MutableColumns & right_columns, size_t right_row) const
+{
+    for (const auto & sort_column : sort_columns)
+    {
+        int res = left_columns[sort_column.position]->compareAt(
+            left_row, right_row, *right_columns[sort_column.position], sort_column.nulls_direction);
+        if (res)
+            return res * sort_column.direction;
+    }
+    return 0;
+}
+
+int HashWindowGroupLimitTransform::compareBucketRows(const Bucket & bucket, size_t left_row, size_t right_row) const
+{
+    for (const auto & sort_column : sort_columns)
+    {
+        const auto & column = *bucket.columns[sort_column.position];
+        int res = column.compareAt(left_row, right_row, column, sort_column.nulls_direction);
+        if (res)
+            return res * sort_column.direction;
+    }
+    return 0;
+}
+
+bool HashWindowGroupLimitTransform::isBehindBoundary(
+    const Bucket & bucket, const PartitionState & partition, const DB::Columns & input_columns, size_t row) const
+{
+    if (!partition.reached_limit)
+        return false;
+    int res = compareRows(input_columns, row, bucket.columns, partition.rows[partition.kept_rows - 1]);
+    // For row_number, ties could be dropped too since the row number among peers is nondeterministic.
+    if (function == RankFunction::RowNumber)
+        return res >= 0;
+    return res > 0;
+}
+
+std::vector<Int32> HashWindowGroupLimitTransform::prunePartition(Bucket & bucket, PartitionState & partition)
+{
+    auto & rows = partition.rows;
+    std::sort(rows.begin(), rows.end(), [&](UInt32 l, UInt32 r) { return compareBucketRows(bucket, l, r) < 0; });
+
+    std::vector<Int32> ranks;
+    ranks.reserve(std::min(rows.size(), limit));
+    Int32 rank_value = 0;
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        bool is_new_peer_group = !i || compareBucketRows(bucket, rows[i - 1], rows[i]) != 0;
+        if (function == RankFunction::RowNumber)
+            rank_value = static_cast<Int32>(i + 1);
+        else if (function == RankFunction::Rank)
+            rank_value = is_new_peer_group ? static_cast<Int32>(i + 1) : rank_value;
+        else
+            rank_value = is_new_peer_group ? rank_value + 1 : rank_value;
+        if (static_cast<size_t>(rank_value) > limit)
+            break;
+        ranks.push_back(rank_value);
+    }
+
+    bucket.garbage_rows += rows.size() - ranks.size();
+    rows.resize(ranks.size());
+    partition.kept_rows = rows.size();
+    if (function == RankFunction::DenseRank)
+        partition.reached_limit = !ranks.empty() && static_cast<size_t>(ranks.back()) == limit;
+    else
+        partition.reached_limit = rows.size() >= limit;
+    return ranks;
+}
+
+void HashWindowGroupLimitTransform::compactBucket(Bucket & bucket)
+{
+    DB::IColumn::Permutation permutation;
+    permutation.reserve(bucket.columns.front()->size() - bucket.garbage_rows);
+    for (auto & partition : bucket.partitions)
+    {
+        for (auto & row : partition.rows)
+        {
+            auto new_row = permutation.size();
+            permutation.push_back(row);
+            row = static_cast<UInt32>(new_row);
+        }
+    }
+    for (auto & column : bucket.columns)
+        column = DB::IColumn::mutate(column->permute(permutation, permutation.size()));
+    bucket.garbage_rows = 0;
+}
+
+void HashWindowGroupLimitTransform::clearBucket(Bucket & bucket)
+{
+    bucket.columns.clear();
+    bucket.key_columns.clear();
+    bucket.partition_index.clearAndShrink();
+    bucket.partitions = {};
+    bucket.garbage_rows = 0;
+}
+
+size_t HashWindowGroupLimitTransform::bucketBytes(const Bucket & bucket) const
+{
+    size_t bytes = bucket.partition_index.getBufferSizeInBytes() + bucket.partitions.capacity() * sizeof(PartitionState);
+    for (const auto & column : bucket.columns)
+        bytes += column->allocatedBytes();
+    for (const auto & column : bucket.key_columns)
+        bytes += column->allocatedBytes();
+    return bytes;
+}
+
+bool HashWindowGroupLimitTransform::isMemoryOverflow()
+{
+    if (force_spill)
+    {
+        auto stats = getMemoryStats();
+        if (stats.spillable_memory_bytes > force_spill_on_bytes * 0.8)
+            return true;
+    }
+    return currentThreadGroupMemoryUsageRatio() > spill_mem_ratio;
+}
+
+void HashWindowGroupLimitTransform::spillBucket(size_t bucket_index)
+{
+    Stopwatch watch;
+    auto & bucket = buckets[bucket_index];
+    if (!bucket.columns.empty())
+    {
+        for (auto & partition : bucket.partitions)
+            prunePartition(bucket, partition);
+        compactBucket(bucket);
+    }
+
+    bucket.spill_stream.emplace(input_header, tmp_data_disk.get());
+    size_t rows = bucket.columns.empty() ? 0 : bucket.columns.front()->size();
+    size_t spill_bytes = 0;
+    for (size_t offset = 0; offset < rows; offset += max_block_size)
+    {
+        size_t length = std::min(max_block_size, rows - offset);
+        DB::Columns columns;
+        for (const auto & column : bucket.columns)
+            columns.push_back(column->cut(offset, length));
+        auto block = input_header->cloneWithColumns(std::move(columns));
+        spill_bytes += block.bytes();
+        bucket.spill_stream.value()->write(block);
+    }
+    bucket.spill_stream.value()->flush();
+    clearBucket(bucket);
+
+    total_spilled_buckets++;
+    total_spill_disk_bytes += spill_bytes;
+    LOG_INFO(
+        logger,
+        "Spill bucket {}. rows: {}, bytes: {}, time: {} ms, current memory usage: {}",
+        bucket_index,
+        rows,
+        ReadableSize(spill_bytes),
+        watch.elapsedMilliseconds(),
+        ReadableSize(currentThreadGroupMemoryUsage()));
+}
+
+void HashWindowGroupLimitTransform::loadSpilledBucket(size_t bucket_index)
+{
+    auto & bucket = buckets[bucket_index];
+    bucket.spill_stream->finishWriting();
+    auto reader = bucket.spill_stream->getReadStream();
+    while (true)
+    {
+        auto block = reader->read();
+        if (!block.rows())
+            break;
+        auto rows = block.rows();
+        auto input_columns = block.getColumns();
+        auto keys = computePartitionKeys(input_columns, rows);
+        std::vector<UInt32> all_rows(rows);
+        for (size_t i = 0; i < rows; ++i)
+            all_rows[i] = static_cast<UInt32>(i);
+        addRowsIntoBucket(bucket_index, input_columns, keys, all_rows);
+    }
+    bucket.spill_stream.reset();
+}
+
+void HashWindowGroupLimitTransform::emitBucket(size_t bucket_index)
+{
+    auto & bucket = buckets[bucket_index];
+    if (bucket.spill_stream)
+        loadSpilledBucket(bucket_index);
+    if (bucket.columns.empty())
+        return;
+
+    DB::IColumn::Permutation permutation;
+    auto rank_column = DB::ColumnInt32::create();
+    auto flush_output = [&]()
+    {
+        if (permutation.empty())
+            return;
+        DB::Columns columns;
+        for (const auto & column : bucket.columns)
+            columns.push_back(column->permute(permutation, permutation.size()));
+        columns.push_back(std::move(rank_column));
+        auto rows = permutation.size();
+        pending_output_chunks.emplace_back(std::move(columns), rows);
+        permutation.clear();
+        rank_column = DB::ColumnInt32::create();
+    };
+
+    for (auto & partition : bucket.partitions)
+    {
+        auto ranks = prunePartition(bucket, partition);
+        for (size_t i = 0; i < ranks.size(); ++i)
+        {
+            permutation.push_back(partition.rows[i]);
+            rank_column->insertValue(ranks[i]);
+        }
+        if (permutation.size() >= max_block_size)
+            flush_output();
+    }
+    flush_output();
+    clearBucket(bucket);
+}
+
+DB::ProcessorMemoryStats HashWindowGroupLimitTransform::getMemoryStats()
+{
+    DB::ProcessorMemoryStats stats;
+    for (const auto & bucket : buckets)
+        if (!bucket.spill_stream)
+            stats.spillable_memory_bytes += bucketBytes(bucket);
+    return stats;
+}
+
+bool HashWindowGroupLimitTransform::spillOnSize(size_t bytes)
+{
+    auto stats = getMemoryStats();
+    if (stats.spillable_memory_bytes < bytes * 0.8)
+        return false;
+    force_spill = true;
+    force_spill_on_bytes = bytes;
+    return true;
+}
+
+}
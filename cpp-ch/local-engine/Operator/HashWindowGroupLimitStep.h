@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <limits>
+#include <list>
+#include <optional>
+#include <vector>
+#include <Core/Block.h>
+#include <Core/SortDescription.h>
+#include <Interpreters/Context_fwd.h>
+#include <Interpreters/TemporaryDataOnDisk.h>
+#include <Processors/Chunk.h>
+#include <Processors/IProcessor.h>
+#include <Processors/QueryPlan/IQueryPlanStep.h>
+#include <Processors/QueryPlan/ITransformingStep.h>
+#include <Poco/Logger.h>
+#include <Common/HashTable/Hash.h>
+#include <Common/HashTable/HashMap.h>
+
+namespace local_engine
+{
+
+/// Window TopK for row_number, rank and dense_rank which doesn't require sorted input.
+/// Unlike WindowGroupLimitStep, rows are grouped by the partition keys in a hash table, and each partition keeps a bounded buffer
+/// of the best rows seen so far. The output contains all input columns and the rank value column at the end. The rows of one
+/// partition are emitted together in order of the sort keys.
+class HashWindowGroupLimitStep : public DB::ITransformingStep
+{
+public:
+    explicit HashWindowGroupLimitStep(
+        DB::ContextPtr context_,
+        const DB::SharedHeader & input_header_,
+        const String & function_name_,
+        const std::vector<size_t> & partition_columns_,
+        const DB::SortDescription & sort_description_,
+        size_t limit_,
+        const String & rank_column_name_);
+    ~HashWindowGroupLimitStep() override = default;
+
+    String getName() const override { return "HashWindowGroupLimitStep"; }
+
+    void transformPipeline(DB::QueryPipelineBuilder & pipeline, const DB::BuildQueryPipelineSettings & settings) override;
+    void describePipeline(DB::IQueryPlanStep::FormatSettings & settings) const override;
+    void updateOutputHeader() override;
+
+    static DB::Block buildOutputHeader(const DB::Block & input_header, const String & rank_column_name);
+
+private:
+    DB::ContextPtr context;
+    // window function name, one of row_number, rank and dense_rank
+    String function_name;
+    std::vector<size_t> partition_columns;
+    DB::SortDescription sort_description;
+    size_t limit;
+    String rank_column_name;
+
+    /// Scatter the rows into the streams by the hash of the partition keys, keeping the transforms parallel.
+    void scatterByPartitionKeys(DB::QueryPipelineBuilder & pipeline) const;
+};
+
+class HashWindowGroupLimitTransform : public DB::IProcessor
+{
+public:
+    enum class RankFunction
+    {
+        RowNumber,
+        Rank,
+        DenseRank
+    };
+    using Status = DB::IProcessor::Status;
+
+    HashWindowGroupLimitTransform(
+        DB::ContextPtr context_,
+        const DB::SharedHeader & input_header_,
+        const DB::SharedHeader & output_header_,
+        RankFunction function_,
+        const std::vector<size_t> & partition_columns_,
+        const DB::SortDescription & sort_description_,
+        size_t limit_);
+    ~HashWindowGroupLimitTransform() override;
+
+    String getName() const override { return "HashWindowGroupLimitTransform"; }
+    Status prepare() override;
+    void work() override;
+
+    static RankFunction parseRankFunction(const String & function_name);
+
+private:
+    struct SortColumn
+    {
+        size_t position;
+        int direction;
+        int nulls_direction;
+    };
+
+    static constexpr size_t NO_PARTITION = std::numeric_limits<size_t>::max();
+
+    /// The candidate rows of one window partition. rows are positions in the owning bucket's columns.
+    struct PartitionState
+    {
+        std::vector<UInt32> rows;
+        /// Number of rows left after the last pruning. The next pruning happens when rows grows to twice of this.
+        size_t kept_rows = 0;
+        /// Whether the kept rows have reached the limit after the last pruning. If so, rows[kept_rows - 1] is the worst kept row,
+        /// and any new row ranked behind it could be dropped without buffering it.
+        bool reached_limit = false;
+        /// The next partition whose key has the same hash value as this one.
+        size_t next_same_hash = NO_PARTITION;
+    };
+
+    /// Partitions are scattered into buckets by the key hash, a bucket is the unit for spilling. All rows of one partition belong
+    /// to the same bucket, so a spilled bucket could be processed on its own once the input is finished.
+    struct Bucket
+    {
+        DB::MutableColumns columns;
+        /// The partition key values, one row for each partition.
+        DB::MutableColumns key_columns;
+        /// The first partition of each key hash value, the partitions with the same hash value are chained by next_same_hash.
+        DB::HashMap<UInt128, size_t, UInt128TrivialHash> partition_index;
+        std::vector<PartitionState> partitions;
+        size_t garbage_rows = 0;
+        std::optional<DB::TemporaryBlockStreamHolder> spill_stream;
+    };
+
+    static constexpr size_t SPILL_BUCKETS = 16;
+
+    DB::ContextPtr context;
+    DB::SharedHeader input_header;
+    DB::SharedHeader output_header;
+    RankFunction function;
+    std::vector<size_t> partition_columns;
+    std::vector<SortColumn> sort_columns;
+    size_t limit;
+    size_t max_block_size;
+    double spill_mem_ratio;
+    DB::TemporaryDataOnDiskScopePtr tmp_data_disk;
+    std::vector<Bucket> buckets;
+
+    bool has_input = false;
+    bool input_finished = false;
+    DB::Chunk input_chunk;
+    bool has_output = false;
+    DB::Chunk output_chunk;
+    std::list<DB::Chunk> pending_output_chunks;
+    size_t next_output_bucket = 0;
+
+    bool force_spill = false;
+    size_t force_spill_on_bytes = 0;
+
+    // metrics
+    size_t total_input_rows = 0;
+    size_t total_buffered_rows = 0;
+    size_t total_output_rows = 0;
+    size_t total_spilled_buckets = 0;
+    size_t total_spill_disk_bytes = 0;
+
+    Poco::Logger * logger = &Poco::Logger::get("HashWindowGroupLimitTransform");
+
+    void addChunk(const DB::Chunk & chunk);
+    std::vector<UInt128> computePartitionKeys(const DB::Columns & input_columns, size_t rows) const;
+    void addRowsIntoBucket(
+        size_t bucket_index, const DB::Columns & input_columns, const std::vector<UInt128> & keys, const std::vector<UInt32> & rows);
+    size_t findOrAddPartition(Bucket & bucket, const DB::Columns & input_columns, UInt128 key, size_t row);
+    bool isSamePartitionKey(const Bucket & bucket, size_t partition_id, const DB::Columns & input_columns, size_t row) const;
+    void writeRowsIntoSpilledBucket(size_t bucket_index, const DB::Columns & input_columns, const std::vector<UInt32> & rows);
+    int compareRows(const DB::Columns & left_columns, size_t left_row, const DB::MutableColumns & right_columns, size_t right_row) const;
+    int compareBucketRows(const Bucket & bucket, size_t left_row, size_t right_row) const;
+    bool isBehindBoundary(const Bucket & bucket, const PartitionState & partition, const DB::Columns & input_columns, size_t row) const;
+    /// Sort the candidate rows and drop the rows which are ranked out of the limit. Return the rank values of the kept rows.
+    std::vector<Int32> prunePartition(Bucket & bucket, PartitionState & partition);
+    void compactBucket(Bucket & bucket);
+    void clearBucket(Bucket & bucket);
+    size_t bucketBytes(const Bucket & bucket) const;
+
+    bool isMemoryOverflow();
+    void spillBucket(size_t bucket_index);
+    void loadSpilledBucket(size_t bucket_index);
+    void emitBucket(size_t bucket_index);
+
+    DB::ProcessorMemoryStats getMemoryStats() override;
+    bool spillOnSize(size_t bytes) override;
+};
+
+}
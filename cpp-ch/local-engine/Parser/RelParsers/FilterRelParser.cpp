@@ -27,16 +27,16 @@ FilterRelParser::FilterRelParser(ParserContextPtr parser_context_) : RelParser(p
 {
 }
 DB::QueryPlanPtr
-FilterRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & /*rel_stack_*/)
+FilterRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & rel_stack_)
 {
+    const auto & input_header = *query_plan->getCurrentHeader();
     ExpressionsRewriter rewriter(parser_context);
     substrait::Rel final_rel = rel;
-    rewriter.rewrite(final_rel);
+    auto hidden_columns = rewriter.rewrite(final_rel, input_header, rel_stack_);
 
     const auto & filter_rel = final_rel.filter();
     std::string filter_name;
 
-    const auto & input_header = *query_plan->getCurrentHeader();
     DB::ActionsDAG actions_dag{input_header.getColumnsWithTypeAndName()};
     const auto condition_node = parseExpression(actions_dag, filter_rel.condition());
     if (filter_rel.condition().has_scalar_function() || filter_rel.condition().has_literal())
@@ -52,6 +52,7 @@ FilterRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel,
         remove_filter_column = false;
     else
         input_with_condition.insert(condition_node->result_name);
+    input_with_condition.insert(hidden_columns.begin(), hidden_columns.end());
 
     actions_dag.removeUnusedActions(input_with_condition);
     NonNullableColumnsResolver non_nullable_columns_resolver(input_header, parser_context, filter_rel.condition());
@@ -63,10 +64,17 @@ FilterRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel,
     steps.emplace_back(filter_step.get());
     query_plan->addStep(std::move(filter_step));
 
-    // header maybe changed, need to rollback it
-    if (!blocksHaveEqualStructure(input_header, *query_plan->getCurrentHeader()))
+    // header maybe changed, need to rollback it. The hidden columns which the ancestors don't need are dropped.
+    DB::Block output_header;
+    for (const auto & column : input_header)
+        if (!ExpressionsRewriter::isHiddenColumn(column.name) || std::ranges::count(hidden_columns, column.name))
+            output_header.insert(column);
+    for (const auto & hidden_column : hidden_columns)
+        if (!output_header.has(hidden_column))
+            output_header.insert(query_plan->getCurrentHeader()->getByName(hidden_column));
+    if (!blocksHaveEqualStructure(output_header, *query_plan->getCurrentHeader()))
     {
-        steps.emplace_back(PlanUtil::adjustQueryPlanHeader(*query_plan, input_header, "Rollback filter header"));
+        steps.emplace_back(PlanUtil::adjustQueryPlanHeader(*query_plan, output_header, "Rollback filter header"));
     }
 
     // remove nullable
@@ -33,6 +33,7 @@
 #include <Interpreters/WindowDescription.h>
 #include <Operator/BranchStep.h>
 #include <Operator/GraceMergingAggregatedStep.h>
+#include <Operator/HashWindowGroupLimitStep.h>
 #include <Operator/WindowGroupLimitStep.h>
 #include <Parser/AdvancedParametersParseUtil.h>
 #include <Parser/RelParsers/SortParsingUtils.h>
@@ -201,12 +202,25 @@ DB::QueryPlanPtr AggregateGroupLimitRelParser::parse(
     optimize_info_str.ParseFromString(win_rel_def->advanced_extension().optimization().value());
     auto optimization_info = WindowGroupOptimizationInfo::parse(optimize_info_str.value());
     limit = static_cast<size_t>(win_rel_def->limit());
-    aggregate_function_name = getAggregateFunctionName(optimization_info.window_function);
 
     if (limit < 1)
         throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Invalid limit: {}", limit);
 
     auto win_config = WindowConfig::loadFromContext(getContext());
+    // There is no aggregate function for rank and dense_rank, they always run by the hash topk.
+    if (optimization_info.window_function != "row_number")
+    {
+        if (!win_config.enable_hash_topk)
+            throw DB::Exception(
+                DB::ErrorCodes::BAD_ARGUMENTS,
+                "{} is only supported by the hash topk, but {} is disabled",
+                optimization_info.window_function,
+                WindowConfig::WINDOW_ENABLE_HASH_TOPK);
+        steps.push_back(addHashWindowLimitStep(*current_plan, optimization_info.window_function));
+        return std::move(current_plan);
+    }
+    aggregate_function_name = getAggregateFunctionName(optimization_info.window_function);
+
     auto high_card_threshold = win_config.aggregate_topk_high_cardinality_threshold;
 
     // Aggregation doesn't perform well on high cardinality keys. We make two execution pathes here.
@@ -234,8 +248,15 @@ DB::QueryPlanPtr AggregateGroupLimitRelParser::parse(
     LOG_DEBUG(getLogger("AggregateGroupLimitRelParser"), "Aggregate topk plan:\n{}", PlanUtil::explainPlan(*aggregation_plan));
 
     auto window_plan = BranchStepHelper::createSubPlan(branch_in_header, 1);
-    addSortStep(*window_plan);
-    addWindowLimitStep(*window_plan);
+    if (win_config.enable_hash_topk)
+    {
+        addHashWindowLimitStep(*window_plan, optimization_info.window_function);
+    }
+    else
+    {
+        addSortStep(*window_plan);
+        addWindowLimitStep(*window_plan);
+    }
     auto convert_actions_dag = DB::ActionsDAG::makeConvertingActions(
         window_plan->getCurrentHeader()->getColumnsWithTypeAndName(),
         aggregation_plan->getCurrentHeader()->getColumnsWithTypeAndName(),
@@ -533,6 +554,20 @@ void AggregateGroupLimitRelParser::addWindowLimitStep(DB::QueryPlan & plan)
     plan.addStep(std::move(filter_step));
 }
 
+DB::IQueryPlanStep * AggregateGroupLimitRelParser::addHashWindowLimitStep(DB::QueryPlan & plan, const String & window_function_name)
+{
+    const auto & in_header = plan.getCurrentHeader();
+    auto partition_fields = parsePartitionFields(win_rel_def->partition_expressions());
+    auto sort_descr = parseSortFields(*in_header, win_rel_def->sorts());
+    auto rank_column_name = expression_parser->getUniqueName(window_function_name);
+    auto hash_limit_step = std::make_unique<HashWindowGroupLimitStep>(
+        getContext(), in_header, window_function_name, partition_fields, sort_descr, limit, rank_column_name);
+    hash_limit_step->setStepDescription("Hash window group limit");
+    auto * step = hash_limit_step.get();
+    plan.addStep(std::move(hash_limit_step));
+    return step;
+}
+
 void registerWindowGroupLimitRelParser(RelParserFactory & factory)
 {
     auto builder = [](ParserContextPtr parser_context) { return std::make_shared<GroupLimitRelParser>(parser_context); };
@@ -84,5 +84,7 @@ private:
 
     void addSortStep(DB::QueryPlan & plan);
     void addWindowLimitStep(DB::QueryPlan & plan);
+    /// Compute the topk by a hash table on the partition keys, it doesn't need to sort the input.
+    DB::IQueryPlanStep * addHashWindowLimitStep(DB::QueryPlan & plan, const String & window_function_name);
 };
 }
@@ -55,11 +55,11 @@ ProjectRelParser::parse(DB::QueryPlanPtr query_plan, const substrait::Rel & rel,
 }
 
 DB::QueryPlanPtr
-ProjectRelParser::parseProject(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & /*rel_stack_*/)
+ProjectRelParser::parseProject(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & rel_stack_)
 {
     ExpressionsRewriter rewriter(parser_context);
     substrait::Rel final_rel = rel;
-    rewriter.rewrite(final_rel);
+    auto hidden_columns = rewriter.rewrite(final_rel, *query_plan->getCurrentHeader(), rel_stack_);
     const auto & project_rel = final_rel.project();
     if (project_rel.expressions_size())
     {
@@ -70,6 +70,7 @@ ProjectRelParser::parseProject(DB::QueryPlanPtr query_plan, const substrait::Rel
             expressions.emplace_back(project_rel.expressions(i));
         }
         auto actions_dag = expressionsToActionsDAG(expressions, header);
+        ExpressionsRewriter::addHiddenColumnsToOutputs(actions_dag, hidden_columns);
         auto expression_step = std::make_unique<ExpressionStep>(query_plan->getCurrentHeader(), std::move(actions_dag));
         expression_step->setStepDescription("Project");
         steps.emplace_back(expression_step.get());
@@ -114,11 +115,11 @@ DB::QueryPlanPtr ProjectRelParser::parseReplicateRows(DB::QueryPlanPtr query_pla
 }
 
 DB::QueryPlanPtr
-ProjectRelParser::parseGenerate(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & /*rel_stack_*/)
+ProjectRelParser::parseGenerate(DB::QueryPlanPtr query_plan, const substrait::Rel & rel, std::list<const substrait::Rel *> & rel_stack_)
 {
     ExpressionsRewriter rewriter(parser_context);
     substrait::Rel final_rel = rel;
-    rewriter.rewrite(final_rel);
+    auto hidden_columns = rewriter.rewrite(final_rel, *query_plan->getCurrentHeader(), rel_stack_);
     const auto & generate_rel = final_rel.generate();
     if (isReplicateRows(generate_rel))
     {
@@ -133,6 +134,7 @@ ProjectRelParser::parseGenerate(DB::QueryPlanPtr query_plan, const substrait::Re
     expressions.emplace_back(generate_rel.generator());
     const auto & header = *query_plan->getCurrentHeader();
     auto actions_dag = expressionsToActionsDAG(expressions, header);
+    ExpressionsRewriter::addHiddenColumnsToOutputs(actions_dag, hidden_columns);
 
     if (!ArrayJoinHelper::findArrayJoinNode(actions_dag))
     {
@@ -66,11 +66,19 @@ protected:
         if (args[0].value().has_scalar_function()
             && args[0].value().scalar_function().function_reference() == SelfDefinedFunctionReference::GET_JSON_OBJECT)
         {
-            auto flatten_json_column_name = getFlatterJsonColumnName(args[0].value());
+            const auto & flatten_function_pb = args[0].value().scalar_function();
+            /// The json string has been parsed into a hidden column by a rel below, see GetJsonObjectFunctionWriter
+            if (flatten_function_pb.arguments_size() == 1)
+                return {
+                    parseExpression(actions_dag, flatten_function_pb.arguments(0).value()), parseExpression(actions_dag, args[1].value())};
+
+            /// The third argument is the name of the hidden column shared with the rels above
+            auto flatten_json_column_name = flatten_function_pb.arguments_size() > 2
+                ? flatten_function_pb.arguments(2).value().literal().string()
+                : getFlatterJsonColumnName(args[0].value());
             const auto * flatten_json_column_node = actions_dag.tryFindInOutputs(flatten_json_column_name);
             if (!flatten_json_column_node)
             {
-                const auto flatten_function_pb = args[0].value().scalar_function();
                 const auto * flatten_arg0 = parseExpression(actions_dag, flatten_function_pb.arguments(0).value());
                 const auto * flatten_arg1 = parseExpression(actions_dag, flatten_function_pb.arguments(1).value());
                 flatten_json_column_node = toFunctionNode(actions_dag, FlattenJSONStringOnRequiredFunction::name, flatten_json_column_name, {flatten_arg0, flatten_arg1});
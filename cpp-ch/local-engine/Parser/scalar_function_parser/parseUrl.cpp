@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "parseUrl.h"
+#include <unordered_set>
 #include <DataTypes/DataTypeString.h>
 #include <DataTypes/IDataType.h>
 #include <Common/Exception.h>
@@ -57,39 +58,18 @@ String ParseURLParser::getQueryPartName(const substrait::Expression & expr) cons
 }
 
 const static String CH_URL_PROTOL_FUNCTION = "protocol";
-const static String CH_URL_PATH_FUNCTION = "spark_parse_url_path";
-const static String CH_URL_REF_FUNCTION = "spark_parse_url_ref";
-const static String CH_URL_USERINFO_FUNCTION = "spark_parse_url_userinfo";
-const static String CH_URL_FILE_FUNCTION = "spark_parse_url_file";
-const static String CH_URL_AUTHORITY_FUNCTION = "spark_parse_url_authority";
-const static String CH_URL_HOST_FUNCTION = "spark_parse_url_host";
-const static String CH_URL_PARAMS_FUNCTION = "spark_parse_url_query";
-const static String CH_URL_ONE_PARAM_FUNCTION = "spark_parse_url_one_query";
+const static String CH_URL_COMPONENTS_FUNCTION = "spark_parse_url_components";
+const static String CH_URL_COMPONENT_FUNCTION = "spark_parse_url_component";
 const static String CH_URL_INVALID_FUNCTION = "spark_parse_url_invalid";
+const static std::unordered_set<String> URL_COMPONENT_PARTS = {"QUERY", "PATH", "HOST", "REF", "FILE", "AUTHORITY", "USERINFO"};
 String ParseURLParser::selectCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func) const
 {
     auto query_part_name = getQueryPartName(substrait_func.arguments(1).value());
-    if (query_part_name == "QUERY")
-    {
-        if (substrait_func.arguments().size() == 2)
-            return CH_URL_PARAMS_FUNCTION;
-        else
-            return CH_URL_ONE_PARAM_FUNCTION;
-    }
-    else if (query_part_name == "PROTOCOL")
+    if (query_part_name == "PROTOCOL")
         return CH_URL_PROTOL_FUNCTION;
-    else if (query_part_name == "PATH")
-        return CH_URL_PATH_FUNCTION;
-    else if (query_part_name == "HOST")
-        return CH_URL_HOST_FUNCTION;
-    else if (query_part_name == "REF")
-        return CH_URL_REF_FUNCTION;
-    else if (query_part_name == "FILE")
-        return CH_URL_FILE_FUNCTION;
-    else if (query_part_name == "AUTHORITY")
-        return CH_URL_AUTHORITY_FUNCTION;
-    else if (query_part_name == "USERINFO")
-        return CH_URL_USERINFO_FUNCTION;
+    /// Only the query part could be extracted by a key
+    else if (URL_COMPONENT_PARTS.contains(query_part_name) && (query_part_name == "QUERY" || substrait_func.arguments().size() == 2))
+        return CH_URL_COMPONENT_FUNCTION;
     else
     {
         // throw DB::Exception(DB::ErrorCodes::BAD_ARGUMENTS, "Unknown query part name {} ", query_part_name);
@@ -101,7 +81,16 @@ DB::ActionsDAG::NodeRawConstPtrs ParseURLParser::parseFunctionArguments(
     const substrait::Expression_ScalarFunction & substrait_func, DB::ActionsDAG & actions_dag) const
 {
     DB::ActionsDAG::NodeRawConstPtrs arg_nodes;
-    arg_nodes.push_back(parseExpression(actions_dag, substrait_func.arguments(0).value()));
+    const auto & url_expr = substrait_func.arguments(0).value();
+    arg_nodes.push_back(parseExpression(actions_dag, url_expr));
+    auto ch_function_name = selectCHFunctionName(substrait_func);
+    if (ch_function_name == CH_URL_INVALID_FUNCTION)
+        return arg_nodes;
+    if (ch_function_name == CH_URL_COMPONENT_FUNCTION)
+    {
+        arg_nodes.push_back(parseURLComponents(url_expr, arg_nodes[0], actions_dag));
+        arg_nodes.push_back(parseExpression(actions_dag, substrait_func.arguments(1).value()));
+    }
     for (Int32 i = 2; i < substrait_func.arguments().size(); ++i)
     {
         arg_nodes.push_back(parseExpression(actions_dag, substrait_func.arguments(i).value()));
@@ -109,6 +98,20 @@ DB::ActionsDAG::NodeRawConstPtrs ParseURLParser::parseFunctionArguments(
     return arg_nodes;
 }
 
+const DB::ActionsDAG::Node * ParseURLParser::parseURLComponents(
+    const substrait::Expression & url_expr, const DB::ActionsDAG::Node * url_node, DB::ActionsDAG & actions_dag) const
+{
+    /// Force to reuse the same components node, so the urls are tokenized once for all the parse_url calls on them
+    auto components_column_name = CH_URL_COMPONENTS_FUNCTION + "(" + url_expr.ShortDebugString() + ")";
+    const auto * components_node = actions_dag.tryFindInOutputs(components_column_name);
+    if (!components_node)
+    {
+        components_node = toFunctionNode(actions_dag, CH_URL_COMPONENTS_FUNCTION, components_column_name, {url_node});
+        actions_dag.addOrReplaceInOutputs(*components_node);
+    }
+    return components_node;
+}
+
 const DB::ActionsDAG::Node * ParseURLParser::convertNodeTypeIfNeeded(
     const substrait::Expression_ScalarFunction & substrait_func, const DB::ActionsDAG::Node * func_node, DB::ActionsDAG & actions_dag) const
 {
@@ -41,5 +41,7 @@ protected:
 private:
     String getQueryPartName(const substrait::Expression & expr) const;
     String selectCHFunctionName(const substrait::Expression_ScalarFunction & substrait_func) const;
+    const DB::ActionsDAG::Node *
+    parseURLComponents(const substrait::Expression & url_expr, const DB::ActionsDAG::Node * url_node, DB::ActionsDAG & actions_dag) const;
 };
 }
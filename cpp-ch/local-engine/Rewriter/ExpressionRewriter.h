@@ -15,6 +15,13 @@
  * limitations under the License.
  */
 #pragma once
+#include <algorithm>
+#include <list>
+#include <map>
+#include <Core/Block.h>
+#include <DataTypes/DataTypeTuple.h>
+#include <Interpreters/ActionsDAG.h>
+#include <Parser/SubstraitParserUtils.h>
 #include <Rewriter/RelRewriter.h>
 #include <Poco/Logger.h>
 #include <Common/logger_useful.h>
@@ -30,21 +37,213 @@ enum SelfDefinedFunctionReference
 /// Collect all get_json_object functions and group by json strings.
 /// Rewrite the get_json_object functions into flattenJSONStringOnRequired + sparktupleElement. This
 /// could avoid repeated parsing the same json string and save a lot of time.
+///
+/// If the input header and the ancestors of the rel are given, a json column which is read by a plain field reference is also
+/// shared with the chain of filter, project and generate rels above. The lowest rel which extracts the json column parses the
+/// fields required by the whole chain into a hidden tuple column, and the rels up to the last one extracting it keep the hidden
+/// column at the end of their outputs, so the json string is parsed once in the chain.
+///
+/// The flattenJSONStringOnRequired function in the first argument of a rewritten get_json_object has one of the forms:
+/// - (json, required_fields), parse the json string for this rel only.
+/// - (json, required_fields, hidden_column_name), parse the json string into the hidden column.
+/// - (hidden_column_reference), reuse the hidden column parsed by a rel below.
 class GetJsonObjectFunctionWriter : public RelRewriter
 {
 public:
     GetJsonObjectFunctionWriter(ParserContextPtr parser_context_) : RelRewriter(parser_context_) { }
+    GetJsonObjectFunctionWriter(
+        ParserContextPtr parser_context_, const DB::Block & input_header_, const std::list<const substrait::Rel *> & rel_stack_)
+        : RelRewriter(parser_context_), input_header(&input_header_), rel_stack(&rel_stack_)
+    {
+    }
     ~GetJsonObjectFunctionWriter() override = default;
 
     void rewrite(substrait::Rel & rel) override
     {
         prepare(rel);
+        if (input_header && rel_stack)
+            prepareSharedJsonColumns(rel);
         rewriteImpl(rel);
     }
 
+    /// The hidden columns which the rel should keep at the end of its output for the ancestors
+    const std::vector<String> & getKeptSharedJsonColumns() const { return kept_shared_json_columns; }
+
+    static constexpr auto SHARED_JSON_COLUMN_PREFIX = "__shared_json_";
+    static String getSharedJsonColumnName(const String & json_column_name) { return SHARED_JSON_COLUMN_PREFIX + json_column_name; }
+    static bool isSharedJsonColumn(const String & column_name) { return column_name.starts_with(SHARED_JSON_COLUMN_PREFIX); }
+
 private:
+    struct FieldJsonPaths
+    {
+        String json_key;
+        std::set<String> paths;
+    };
+
+    struct SharedJsonColumn
+    {
+        String name;
+        /// Parsed by this rel, otherwise it is reused from the input header at position
+        bool parse_here;
+        size_t position;
+    };
+
     std::unordered_map<String, std::set<String>> json_required_fields;
 
+    const DB::Block * input_header = nullptr;
+    const std::list<const substrait::Rel *> * rel_stack = nullptr;
+    /// Shared json columns used by this rel, keyed by the position of the json column in the input header
+    std::unordered_map<size_t, SharedJsonColumn> shared_json_columns;
+    std::vector<String> kept_shared_json_columns;
+
+    void prepareSharedJsonColumns(const substrait::Rel & rel)
+    {
+        auto local_paths = collectFieldJsonPaths(rel);
+        std::set<size_t> json_fields;
+        for (const auto & [field, _] : local_paths)
+            json_fields.insert(field);
+        for (size_t i = 0; i < input_header->columns(); ++i)
+            if (input_header->has(getSharedJsonColumnName(input_header->getByPosition(i).name)))
+                json_fields.insert(i);
+
+        for (size_t field : json_fields)
+        {
+            auto shared_name = getSharedJsonColumnName(input_header->getByPosition(field).name);
+            auto ancestor_paths = collectAncestorJsonPaths(rel, field);
+            auto local_it = local_paths.find(field);
+            if (input_header->has(shared_name))
+            {
+                const auto & shared_column = input_header->getByName(shared_name);
+                if (local_it != local_paths.end() && tupleHasElements(*shared_column.type, local_it->second.paths))
+                    shared_json_columns[field] = {shared_name, false, input_header->getPositionByName(shared_name)};
+                if (!ancestor_paths.empty())
+                    kept_shared_json_columns.push_back(shared_name);
+            }
+            else if (local_it != local_paths.end() && !ancestor_paths.empty())
+            {
+                json_required_fields[local_it->second.json_key].insert(ancestor_paths.begin(), ancestor_paths.end());
+                shared_json_columns[field] = {shared_name, true, 0};
+                kept_shared_json_columns.push_back(shared_name);
+            }
+        }
+    }
+
+    /// Follow the json column at field of the input of rel through the chain of filter, project and generate rels above, and
+    /// collect the paths which they extract from it.
+    std::set<String> collectAncestorJsonPaths(const substrait::Rel & rel, size_t field) const
+    {
+        std::set<String> res;
+        auto index = getOutputIndex(rel, field);
+        for (auto it = rel_stack->rbegin(); it != rel_stack->rend() && index; ++it)
+        {
+            const auto & ancestor = **it;
+            if (!ancestor.has_filter() && !ancestor.has_project() && !ancestor.has_generate())
+                break;
+
+            auto ancestor_paths = collectFieldJsonPaths(ancestor);
+            if (auto paths_it = ancestor_paths.find(*index); paths_it != ancestor_paths.end())
+                res.insert(paths_it->second.paths.begin(), paths_it->second.paths.end());
+            index = getOutputIndex(ancestor, *index);
+        }
+        return res;
+    }
+
+    /// The position of the input field in the output of rel, if it is passed through unchanged
+    std::optional<size_t> getOutputIndex(const substrait::Rel & rel, size_t field) const
+    {
+        auto find_field = [&](const auto & expressions) -> std::optional<size_t>
+        {
+            for (int i = 0; i < expressions.size(); ++i)
+                if (SubstraitParserUtils::getStructFieldIndex(expressions.Get(i)) == field)
+                    return i;
+            return {};
+        };
+
+        if (rel.has_filter())
+            return field;
+        if (rel.has_project())
+            return find_field(rel.project().expressions());
+        if (rel.has_generate())
+        {
+            /// replicaterows is parsed by its own steps, which don't keep the hidden columns
+            const auto & generator = rel.generate().generator();
+            if (generator.has_scalar_function()
+                && parser_context->getFunctionNameInSignature(generator.scalar_function()) == "replicaterows")
+                return {};
+            return find_field(rel.generate().child_output());
+        }
+        return {};
+    }
+
+    std::map<size_t, FieldJsonPaths> collectFieldJsonPaths(const substrait::Rel & rel) const
+    {
+        std::map<size_t, FieldJsonPaths> res;
+        if (rel.has_filter())
+            collectFieldJsonPaths(rel.filter().condition(), res);
+        if (rel.has_project())
+            for (const auto & expr : rel.project().expressions())
+                collectFieldJsonPaths(expr, res);
+        if (rel.has_generate())
+        {
+            for (const auto & expr : rel.generate().child_output())
+                collectFieldJsonPaths(expr, res);
+            collectFieldJsonPaths(rel.generate().generator(), res);
+        }
+        return res;
+    }
+
+    /// Collect the literal paths of get_json_object functions whose json string is a plain field reference
+    void collectFieldJsonPaths(const substrait::Expression & expr, std::map<size_t, FieldJsonPaths> & res) const
+    {
+        switch (expr.rex_type_case())
+        {
+            case substrait::Expression::RexTypeCase::kCast:
+                collectFieldJsonPaths(expr.cast().input(), res);
+                break;
+            case substrait::Expression::RexTypeCase::kIfThen: {
+                const auto & if_then = expr.if_then();
+                for (const auto & if_clause : if_then.ifs())
+                {
+                    collectFieldJsonPaths(if_clause.if_(), res);
+                    collectFieldJsonPaths(if_clause.then(), res);
+                }
+                collectFieldJsonPaths(if_then.else_(), res);
+                break;
+            }
+            case substrait::Expression::RexTypeCase::kSingularOrList:
+                collectFieldJsonPaths(expr.singular_or_list().value(), res);
+                break;
+            case substrait::Expression::RexTypeCase::kScalarFunction: {
+                const auto & scalar_function_pb = expr.scalar_function();
+                for (const auto & arg : scalar_function_pb.arguments())
+                    if (arg.has_value())
+                        collectFieldJsonPaths(arg.value(), res);
+
+                if (scalar_function_pb.arguments_size() != 2
+                    || parser_context->getFunctionNameInSignature(scalar_function_pb) != "get_json_object")
+                    break;
+                auto field = SubstraitParserUtils::getStructFieldIndex(scalar_function_pb.arguments(0).value());
+                const auto & json_path_pb = scalar_function_pb.arguments(1).value();
+                if (!field || !json_path_pb.has_literal() || !json_path_pb.literal().has_string())
+                    break;
+                auto & field_paths = res[*field];
+                field_paths.json_key = scalar_function_pb.arguments(0).DebugString();
+                field_paths.paths.emplace(json_path_pb.literal().string());
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    static bool tupleHasElements(const DB::IDataType & type, const std::set<String> & names)
+    {
+        const auto * tuple_type = typeid_cast<const DB::DataTypeTuple *>(&type);
+        if (!tuple_type || !tuple_type->hasExplicitNames())
+            return false;
+        return std::ranges::all_of(names, [&](const auto & name) { return tuple_type->tryGetPositionByName(name).has_value(); });
+    }
+
     /// Collect all get_json_object functions and group by json strings
     void prepare(const substrait::Rel & rel)
     {
@@ -217,6 +416,22 @@ private:
                     {
                         break;
                     }
+
+                    const SharedJsonColumn * shared_json_column = nullptr;
+                    if (auto field = SubstraitParserUtils::getStructFieldIndex(scalar_function_pb.arguments(0).value()))
+                        if (auto it = shared_json_columns.find(*field); it != shared_json_columns.end())
+                            shared_json_column = &it->second;
+                    if (shared_json_column && !shared_json_column->parse_here)
+                    {
+                        substrait::Expression reused_json_arg0;
+                        auto * reused_json_function = reused_json_arg0.mutable_scalar_function();
+                        reused_json_function->set_function_reference(SelfDefinedFunctionReference::GET_JSON_OBJECT);
+                        reused_json_function->add_arguments()->mutable_value()->CopyFrom(
+                            SubstraitParserUtils::buildStructFieldExpression(shared_json_column->position));
+                        *scalar_function_pb.mutable_arguments()->Mutable(0)->mutable_value() = reused_json_arg0;
+                        break;
+                    }
+
                     String required_fields_str;
                     int i = 0;
                     for (const auto & field : required_fields)
@@ -236,6 +451,8 @@ private:
                     arg0->CopyFrom(scalar_function_pb.arguments(0));
                     auto * arg1 = decoded_json_function.add_arguments();
                     arg1->mutable_value()->mutable_literal()->set_string(required_fields_str);
+                    if (shared_json_column)
+                        decoded_json_function.add_arguments()->mutable_value()->mutable_literal()->set_string(shared_json_column->name);
 
                     substrait::Expression new_get_json_object_arg0;
                     new_get_json_object_arg0.mutable_scalar_function()->CopyFrom(decoded_json_function);
@@ -274,6 +491,31 @@ public:
         get_json_object_rewriter.rewrite(rel);
     }
 
+    /// Rewrite rel whose input is input_header and whose ancestors are rel_stack, with the parent at the back. Expressions could
+    /// be shared with the ancestors through hidden columns, return the hidden columns which should be kept at the end of the
+    /// output of rel.
+    std::vector<String> rewrite(substrait::Rel & rel, const DB::Block & input_header, const std::list<const substrait::Rel *> & rel_stack)
+    {
+        GetJsonObjectFunctionWriter get_json_object_rewriter(parser_context, input_header, rel_stack);
+        get_json_object_rewriter.rewrite(rel);
+        return get_json_object_rewriter.getKeptSharedJsonColumns();
+    }
+
+    static bool isHiddenColumn(const String & column_name) { return GetJsonObjectFunctionWriter::isSharedJsonColumn(column_name); }
+
+    /// Append the hidden columns, which are either inputs or computed in actions_dag, to the outputs of actions_dag
+    static void addHiddenColumnsToOutputs(DB::ActionsDAG & actions_dag, const std::vector<String> & hidden_columns)
+    {
+        for (const auto & column : hidden_columns)
+        {
+            const auto & nodes = actions_dag.getNodes();
+            auto it = std::ranges::find_if(nodes, [&](const auto & node) { return node.result_name == column; });
+            if (it == nodes.end())
+                throw DB::Exception(DB::ErrorCodes::LOGICAL_ERROR, "Not found hidden column {} in actions dag", column);
+            actions_dag.addOrReplaceInOutputs(*it);
+        }
+    }
+
 private:
     ParserContextPtr parser_context;
 };
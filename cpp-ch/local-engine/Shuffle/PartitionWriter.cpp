@@ -23,9 +23,6 @@
 #include <IO/ReadBufferFromFile.h>
 #include <IO/WriteBufferFromFile.h>
 #include <IO/WriteBufferFromString.h>
-#include <Interpreters/sortBlock.h>
-#include <Processors/Merges/Algorithms/MergingSortedAlgorithm.h>
-#include <Processors/Transforms/SortingTransform.h>
 #include <Storages/IO/CompressedWriteBuffer.h>
 #include <Storages/IO/NativeWriter.h>
 #include <boost/algorithm/string/case_conv.hpp>
@@ -46,25 +43,6 @@ using namespace DB;
 
 namespace local_engine
 {
-static const String PARTITION_COLUMN_NAME = "partition";
-
-int64_t searchLastPartitionIdIndex(ColumnPtr column, size_t start, size_t partition_id)
-{
-    const auto & int64_column = checkAndGetColumn<ColumnUInt64>(*column);
-    int64_t low = start, high = int64_column.size() - 1;
-    while (low <= high)
-    {
-        int64_t mid = low + (high - low) / 2;
-        if (int64_column.get64(mid) > partition_id)
-            high = mid - 1;
-        else
-            low = mid + 1;
-        if (int64_column.get64(high) == partition_id)
-            return high;
-    }
-    return -1;
-}
-
 bool PartitionWriter::worthToSpill(size_t cache_size) const
 {
     return (options.spill_threshold > 0 && cache_size >= options.spill_threshold) ||
@@ -208,27 +186,117 @@ void SortBasedPartitionWriter::write(const PartitionInfo & info, DB::Block & blo
     Stopwatch write_time_watch;
     if (output_header.columns() == 0)
         output_header = block.cloneEmpty();
-    auto partition_column = ColumnUInt64::create();
-    partition_column->reserve(block.rows());
-    partition_column->getData().insert_assume_reserved(info.src_partition_num.begin(), info.src_partition_num.end());
-    block.insert({std::move(partition_column), std::make_shared<DataTypeUInt64>(), PARTITION_COLUMN_NAME});
-    if (sort_header.columns() == 0)
+
+    /// Group the rows by partition id with a counting sort, which is stable and linear in rows.
+    const auto & partition_ids = info.src_partition_num;
+    const size_t rows = block.rows();
+    std::vector<size_t> partition_ends(options.partition_num, 0);
+    for (size_t i = 0; i < rows; ++i)
+        ++partition_ends[partition_ids[i]];
+
+    PartitionGroupedBlock grouped_block;
+    size_t offset = 0;
+    for (size_t partition_id = 0; partition_id < options.partition_num; ++partition_id)
+    {
+        size_t length = partition_ends[partition_id];
+        if (length)
+            grouped_block.runs.push_back({partition_id, offset, length});
+        offset += length;
+        partition_ends[partition_id] = offset;
+    }
+
+    if (grouped_block.runs.size() == 1)
+        grouped_block.columns = block.getColumns();
+    else
     {
-        sort_header = block.cloneEmpty();
-        sort_description.emplace_back(SortColumnDescription(PARTITION_COLUMN_NAME));
+        IColumn::Permutation permutation(rows);
+        for (size_t i = rows; i-- > 0;)
+            permutation[--partition_ends[partition_ids[i]]] = i;
+        grouped_block.columns.reserve(block.columns());
+        for (const auto & column : block.getColumns())
+            grouped_block.columns.emplace_back(column->permute(permutation, 0));
     }
-    // partial sort
-    sortBlock(block, sort_description);
-    Chunk chunk;
-    chunk.setColumns(block.getColumns(), block.rows());
-    accumulated_blocks.emplace_back(std::move(chunk));
-    current_accumulated_bytes += accumulated_blocks.back().allocatedBytes();
-    current_accumulated_rows += accumulated_blocks.back().getNumRows();
+
+    for (const auto & column : grouped_block.columns)
+        current_accumulated_bytes += column->allocatedBytes();
+    current_accumulated_rows += rows;
+    accumulated_blocks.emplace_back(std::move(grouped_block));
     split_result->total_write_time += write_time_watch.elapsedNanoseconds();
     if (worthToSpill(current_accumulated_bytes))
         evictPartitions();
 }
 
+void SortBasedPartitionWriter::flushAccumulatedBlocks(
+    const std::function<void(size_t, DB::Block &)> & write_block, const std::function<void(size_t)> & finish_partition)
+{
+    const size_t max_block_rows = adaptiveBlockSize();
+
+    /// Index the runs of all blocks by partition id, the runs of one partition keep the order of the blocks.
+    std::vector<size_t> partition_starts(options.partition_num + 1, 0);
+    for (const auto & grouped_block : accumulated_blocks)
+        for (const auto & run : grouped_block.runs)
+            ++partition_starts[run.partition_id + 1];
+    for (size_t partition_id = 0; partition_id < options.partition_num; ++partition_id)
+        partition_starts[partition_id + 1] += partition_starts[partition_id];
+
+    std::vector<std::pair<const PartitionGroupedBlock *, const PartitionRun *>> partition_runs(partition_starts.back());
+    std::vector<size_t> positions(partition_starts.begin(), partition_starts.end() - 1);
+    for (const auto & grouped_block : accumulated_blocks)
+        for (const auto & run : grouped_block.runs)
+            partition_runs[positions[run.partition_id]++] = {&grouped_block, &run};
+
+    for (size_t partition_id = 0; partition_id < options.partition_num; ++partition_id)
+    {
+        const size_t begin = partition_starts[partition_id];
+        const size_t end = partition_starts[partition_id + 1];
+        if (begin == end)
+            continue;
+
+        size_t partition_rows = 0;
+        for (size_t i = begin; i < end; ++i)
+            partition_rows += partition_runs[i].second->length;
+
+        MutableColumns columns;
+        size_t block_rows = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto & [grouped_block, run] = partition_runs[i];
+            size_t offset = run->offset;
+            size_t remaining = run->length;
+            while (remaining)
+            {
+                if (columns.empty())
+                {
+                    columns = output_header.cloneEmptyColumns();
+                    for (auto & column : columns)
+                        column->reserve(std::min(partition_rows, max_block_rows));
+                }
+                size_t length = std::min(remaining, max_block_rows - block_rows);
+                for (size_t col = 0; col < columns.size(); ++col)
+                    columns[col]->insertRangeFrom(*grouped_block->columns[col], offset, length);
+                block_rows += length;
+                partition_rows -= length;
+                offset += length;
+                remaining -= length;
+                if (block_rows == max_block_rows)
+                {
+                    auto output_block = output_header.cloneWithColumns(std::move(columns));
+                    write_block(partition_id, output_block);
+                    columns.clear();
+                    block_rows = 0;
+                }
+            }
+        }
+        if (block_rows)
+        {
+            auto output_block = output_header.cloneWithColumns(std::move(columns));
+            write_block(partition_id, output_block);
+        }
+        finish_partition(partition_id);
+    }
+    accumulated_blocks.clear();
+}
+
 LocalPartitionWriter::LocalPartitionWriter(const SplitOptions & options)
     : PartitionWriter(options, getLogger("LocalPartitionWriter"))
     , Spillable(options)
@@ -283,66 +351,20 @@ size_t MemorySortLocalPartitionWriter::evictPartitions()
         info.spilled_file = file;
 
         Stopwatch serialization_time_watch;
-        MergeSorter sorter(toShared(sort_header), std::move(accumulated_blocks), sort_description, adaptiveBlockSize(), 0);
-        size_t cur_partition_id = 0;
-        info.partition_spill_infos[cur_partition_id] = {0, 0};
-        while (auto data = sorter.read())
-        {
-            Block serialized_block = sort_header.cloneWithColumns(data.detachColumns());
-            const auto partitions = serialized_block.getByName(PARTITION_COLUMN_NAME).column;
-            serialized_block.erase(PARTITION_COLUMN_NAME);
-            size_t row_offset = 0;
-            while (row_offset < serialized_block.rows())
+        size_t partition_start = 0;
+        flushAccumulatedBlocks(
+            [&](size_t partition_id, Block & block) { split_result->raw_partition_lengths[partition_id] += writer.write(block); },
+            [&](size_t partition_id)
             {
-                auto last_idx = searchLastPartitionIdIndex(partitions, row_offset, cur_partition_id);
-                if (last_idx < 0)
-                {
-                    auto & last = info.partition_spill_infos[cur_partition_id];
-                    compressed_output.sync();
-                    last.second = output.count() - last.first;
-                    cur_partition_id++;
-                    info.partition_spill_infos[cur_partition_id] = {last.first + last.second, 0};
-                    continue;
-                }
-
-                if (row_offset == 0 && last_idx == serialized_block.rows() - 1)
-                {
-                    auto count = writer.write(serialized_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    break;
-                }
-                else
-                {
-                    auto cut_block = serialized_block.cloneWithCutColumns(row_offset, last_idx - row_offset + 1);
-
-                    auto count = writer.write(cut_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    row_offset = last_idx + 1;
-                    if (last_idx != serialized_block.rows() - 1)
-                    {
-                        auto & last = info.partition_spill_infos[cur_partition_id];
-                        compressed_output.sync();
-                        last.second = output.count() - last.first;
-                        cur_partition_id++;
-                        info.partition_spill_infos[cur_partition_id] = {last.first + last.second, 0};
-                    }
-                }
-            }
-        }
-        compressed_output.sync();
-        auto & last = info.partition_spill_infos[cur_partition_id];
-        last.second = output.count() - last.first;
+                compressed_output.sync();
+                size_t partition_end = output.count();
+                info.partition_spill_infos[partition_id] = {partition_start, partition_end - partition_start};
+                partition_start = partition_end;
+            });
         spilled_bytes = current_accumulated_bytes;
         res = current_accumulated_bytes;
         current_accumulated_bytes = 0;
         current_accumulated_rows = 0;
-        std::erase_if(
-            info.partition_spill_infos,
-            [](const auto & item)
-            {
-                auto const & [key, value] = item;
-                return value.second == 0;
-            });
         spill_infos.emplace_back(info);
         split_result->total_compress_time += compressed_output.getCompressTime();
         split_result->total_io_time += compressed_output.getWriteTime();
@@ -376,57 +398,24 @@ size_t MemorySortCelebornPartitionWriter::evictPartitions()
         CompressedWriteBuffer compressed_output(output, codec, options.io_buffer_size);
         NativeWriter writer(compressed_output, output_header);
 
-        MergeSorter sorter(toShared(sort_header), std::move(accumulated_blocks), sort_description, adaptiveBlockSize(), 0);
-        size_t cur_partition_id = 0;
-        auto push_to_celeborn = [&]()
+        auto push_to_celeborn = [&](size_t partition_id)
         {
             compressed_output.sync();
             auto & data = output.str();
             if (!data.empty())
             {
                 Stopwatch push_time_watch;
-                celeborn_client->pushPartitionData(cur_partition_id, data.data(), data.size());
+                celeborn_client->pushPartitionData(partition_id, data.data(), data.size());
                 split_result->total_io_time += push_time_watch.elapsedNanoseconds();
-                split_result->partition_lengths[cur_partition_id] += data.size();
+                split_result->partition_lengths[partition_id] += data.size();
                 split_result->total_bytes_written += data.size();
             }
             output.restart();
         };
 
-        while (auto data = sorter.read())
-        {
-            Block serialized_block = sort_header.cloneWithColumns(data.detachColumns());
-            const auto partitions = serialized_block.getByName(PARTITION_COLUMN_NAME).column;
-            serialized_block.erase(PARTITION_COLUMN_NAME);
-            size_t row_offset = 0;
-            while (row_offset < serialized_block.rows())
-            {
-                auto last_idx = searchLastPartitionIdIndex(partitions, row_offset, cur_partition_id);
-                if (last_idx < 0)
-                {
-                    push_to_celeborn();
-                    cur_partition_id++;
-                    continue;
-                }
-
-                if (row_offset == 0 && last_idx == serialized_block.rows() - 1)
-                {
-                    auto count = writer.write(serialized_block);
-                    split_result->raw_partition_lengths[cur_partition_id] += count;
-                    break;
-                }
-                auto cut_block = serialized_block.cloneWithCutColumns(row_offset, last_idx - row_offset + 1);
-                auto count = writer.write(cut_block);
-                split_result->raw_partition_lengths[cur_partition_id] += count;
-                row_offset = last_idx + 1;
-                if (last_idx != serialized_block.rows() - 1)
-                {
-                    push_to_celeborn();
-                    cur_partition_id++;
-                }
-            }
-        }
-        push_to_celeborn();
+        flushAccumulatedBlocks(
+            [&](size_t partition_id, Block & block) { split_result->raw_partition_lengths[partition_id] += writer.write(block); },
+            push_to_celeborn);
         spilled_bytes = current_accumulated_bytes;
         res = current_accumulated_bytes;
         current_accumulated_bytes = 0;
@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <Core/Block.h>
@@ -29,7 +30,6 @@
 
 namespace DB
 {
-class MergingSortedAlgorithm;
 namespace Setting
 {
 extern const SettingsUInt64 prefer_external_sort_block_bytes;
@@ -154,6 +154,9 @@ public:
     bool useRSSPusher() const override { return false; }
 };
 
+/// Accumulates the input blocks and writes them grouped by partition id when evicting. Partition ids are small dense
+/// integers, so each block is grouped by a counting sort when it's written, and the eviction concatenates the rows of
+/// each partition from all blocks in ascending partition id without any comparison based merging.
 class SortBasedPartitionWriter : public PartitionWriter
 {
 protected:
@@ -177,15 +180,35 @@ public:
     }
 
 protected:
+    /// Rows of one partition in a grouped block.
+    struct PartitionRun
+    {
+        size_t partition_id;
+        size_t offset;
+        size_t length;
+    };
+
+    /// A block whose rows are grouped by partition id, runs are in ascending partition id and only non-empty partitions
+    /// have a run.
+    struct PartitionGroupedBlock
+    {
+        DB::Columns columns;
+        std::vector<PartitionRun> runs;
+    };
+
+    /// Emit the accumulated rows in ascending partition id. write_block is called with blocks of one partition which
+    /// have at most adaptiveBlockSize() rows, finish_partition is called after all the rows of a non-empty partition are
+    /// written. The accumulated blocks are released.
+    void flushAccumulatedBlocks(
+        const std::function<void(size_t, DB::Block &)> & write_block, const std::function<void(size_t)> & finish_partition);
+
     size_t max_merge_block_size = DB::DEFAULT_BLOCK_SIZE;
     size_t max_sort_buffer_size = 1_GiB;
     size_t max_merge_block_bytes = 0;
     size_t current_accumulated_bytes = 0;
     size_t current_accumulated_rows = 0;
-    DB::Chunks accumulated_blocks;
+    std::vector<PartitionGroupedBlock> accumulated_blocks;
     DB::Block output_header;
-    DB::Block sort_header;
-    DB::SortDescription sort_description;
 };
 
 class MemorySortLocalPartitionWriter : public SortBasedPartitionWriter, public Spillable
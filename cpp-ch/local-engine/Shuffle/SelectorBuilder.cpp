@@ -15,11 +15,17 @@
  * limitations under the License.
  */
 #include "SelectorBuilder.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnDecimal.h>
 #include <Columns/ColumnMap.h>
 #include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
+#include <Columns/ColumnsNumber.h>
 #include <DataTypes/DataTypeArray.h>
 #include <DataTypes/DataTypeNullable.h>
 #include <DataTypes/DataTypesDecimal.h>
@@ -172,12 +178,16 @@ RangeSelectorBuilder::RangeSelectorBuilder(const std::string & option, const siz
     initSortInformation(ordering_infos);
     initRangeBlock(info->get("range_bounds").extract<Poco::JSON::Array::Ptr>());
     partition_num = partition_num_;
+    initNormalizedBounds();
 }
 
 PartitionInfo RangeSelectorBuilder::build(DB::Block & block)
 {
     DB::IColumn::Selector result;
-    computePartitionIdByBinarySearch(block, result);
+    if (normalized_bounds_search)
+        computePartitionIdByNormalizedSearch(block, result);
+    else
+        computePartitionIdByBinarySearch(block, result);
     return PartitionInfo::fromSelector(std::move(result), partition_num, use_sort_shuffle);
 }
 
@@ -369,6 +379,254 @@ void RangeSelectorBuilder::computePartitionIdByBinarySearch(DB::Block & block, D
         selector.emplace_back(selected_partition);
     }
 }
+EytzingerLowerBound::EytzingerLowerBound(const std::vector<UInt64> & sorted_keys) : keys_num(sorted_keys.size())
+{
+    while ((1ULL << height) - 1 < keys_num)
+        ++height;
+    size_t tree_size = (1ULL << height) - 1;
+    /// The padding keys are the max value, they are placed after all real keys in the in-order traversal.
+    std::vector<UInt64> padded_keys(sorted_keys);
+    padded_keys.resize(tree_size, std::numeric_limits<UInt64>::max());
+    tree.resize(tree_size + 1);
+    tree_to_sorted.resize(tree_size + 1);
+    tree_to_sorted[0] = tree_size;
+    fill(padded_keys, 0, 1);
+}
+
+size_t EytzingerLowerBound::fill(const std::vector<UInt64> & sorted_keys, size_t i, size_t k)
+{
+    if (k < tree.size())
+    {
+        i = fill(sorted_keys, i, 2 * k);
+        tree[k] = sorted_keys[i];
+        tree_to_sorted[k] = i;
+        ++i;
+        i = fill(sorted_keys, i, 2 * k + 1);
+    }
+    return i;
+}
+
+size_t EytzingerLowerBound::lowerBound(UInt64 value) const
+{
+    size_t k = 1;
+    for (size_t level = 0; level < height; ++level)
+        k = 2 * k + (tree[k] < value);
+    /// Go back to the last node where we turned left, it's the first key not less than value.
+    k >>= __builtin_ffsll(~k);
+    return std::min<size_t>(tree_to_sorted[k], keys_num);
+}
+
+void EytzingerLowerBound::lowerBound(const UInt64 * values, UInt64 * results, size_t rows) const
+{
+    size_t k[BATCH_SIZE];
+    size_t i = 0;
+    for (; i + BATCH_SIZE <= rows; i += BATCH_SIZE)
+    {
+        for (size_t j = 0; j < BATCH_SIZE; ++j)
+            k[j] = 1;
+        for (size_t level = 0; level < height; ++level)
+            for (size_t j = 0; j < BATCH_SIZE; ++j)
+                k[j] = 2 * k[j] + (tree[k[j]] < values[i + j]);
+        for (size_t j = 0; j < BATCH_SIZE; ++j)
+        {
+            k[j] >>= __builtin_ffsll(~k[j]);
+            results[i + j] = std::min<size_t>(tree_to_sorted[k[j]], keys_num);
+        }
+    }
+    for (; i < rows; ++i)
+        results[i] = lowerBound(values[i]);
+}
+
+namespace
+{
+constexpr UInt64 SIGN_BIT = 1ULL << 63;
+
+/// Map a value into UInt64 whose unsigned order is the same as the value's order.
+template <typename T>
+UInt64 toNormalizedKey(T value)
+{
+    if constexpr (is_decimal<T>)
+        return toNormalizedKey(value.value);
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        /// -0.0 and 0.0 are equal in comparison.
+        Float64 v = value == 0 ? 0.0 : static_cast<Float64>(value);
+        UInt64 bits = std::bit_cast<UInt64>(v);
+        return (bits & SIGN_BIT) ? ~bits : bits | SIGN_BIT;
+    }
+    else if constexpr (std::is_signed_v<T>)
+        return static_cast<UInt64>(static_cast<Int64>(value)) ^ SIGN_BIT;
+    else
+        return static_cast<UInt64>(value);
+}
+
+template <typename ColumnType>
+bool normalizeColumnKeys(const IColumn & column, UInt64 mask, UInt64 * keys, UInt8 * fallback)
+{
+    const auto * typed_column = checkAndGetColumn<ColumnType>(&column);
+    if (!typed_column)
+        return false;
+    const auto & data = typed_column->getData();
+    for (size_t i = 0, rows = data.size(); i < rows; ++i)
+    {
+        if constexpr (std::is_floating_point_v<typename ColumnType::ValueType>)
+            fallback[i] |= std::isnan(data[i]);
+        keys[i] = toNormalizedKey(data[i]) ^ mask;
+    }
+    return true;
+}
+
+bool normalizeStringKeys(const IColumn & column, UInt64 mask, UInt64 * keys)
+{
+    const auto * string_column = checkAndGetColumn<ColumnString>(&column);
+    if (!string_column)
+        return false;
+    for (size_t i = 0, rows = string_column->size(); i < rows; ++i)
+    {
+        auto value = string_column->getDataAt(i);
+        UInt64 prefix = 0;
+        memcpy(&prefix, value.data, std::min<size_t>(value.size, sizeof(UInt64)));
+        /// Compare the prefix bytes in memcmp order.
+        keys[i] = (std::endian::native == std::endian::little ? __builtin_bswap64(prefix) : prefix) ^ mask;
+    }
+    return true;
+}
+}
+
+void RangeSelectorBuilder::initNormalizedBounds()
+{
+    if (sort_descriptions.size() != 1 || !range_bounds_block.rows())
+        return;
+    auto type_index = sort_field_types[0].inner_type->getTypeId();
+    switch (type_index)
+    {
+        case TypeIndex::UInt8:
+        case TypeIndex::Int8:
+        case TypeIndex::Int16:
+        case TypeIndex::Int32:
+        case TypeIndex::Int64:
+        case TypeIndex::Date32:
+        case TypeIndex::Float32:
+        case TypeIndex::Float64:
+        case TypeIndex::Decimal32:
+        case TypeIndex::Decimal64:
+        case TypeIndex::DateTime64:
+        case TypeIndex::String:
+            break;
+        default:
+            return;
+    }
+    normalized_key_type = type_index;
+
+    const auto & bound_column = range_bounds_block.getByPosition(0).column;
+    const IColumn * nested_bound_column = bound_column.get();
+    if (const auto * nullable_column = checkAndGetColumn<ColumnNullable>(nested_bound_column))
+    {
+        /// Nulls in the bounds are left to the generic comparator.
+        if (nullable_column->hasNull())
+        {
+            normalized_key_type.reset();
+            return;
+        }
+        nested_bound_column = &nullable_column->getNestedColumn();
+    }
+
+    auto rows = nested_bound_column->size();
+    std::vector<UInt64> keys(rows);
+    std::vector<UInt8> fallback(rows, 0);
+    if (!normalizeKeys(*nested_bound_column, keys.data(), fallback.data())
+        || std::any_of(fallback.begin(), fallback.end(), [](UInt8 v) { return v; }) || !std::is_sorted(keys.begin(), keys.end()))
+    {
+        normalized_key_type.reset();
+        return;
+    }
+    normalized_bounds = std::move(keys);
+    normalized_bounds_search = std::make_unique<EytzingerLowerBound>(normalized_bounds);
+}
+
+bool RangeSelectorBuilder::normalizeKeys(const DB::IColumn & column, UInt64 * keys, UInt8 * fallback) const
+{
+    UInt64 mask = sort_descriptions[0].direction < 0 ? std::numeric_limits<UInt64>::max() : 0;
+    switch (*normalized_key_type)
+    {
+        case TypeIndex::UInt8:
+            return normalizeColumnKeys<ColumnUInt8>(column, mask, keys, fallback);
+        case TypeIndex::Int8:
+            return normalizeColumnKeys<ColumnInt8>(column, mask, keys, fallback);
+        case TypeIndex::Int16:
+            return normalizeColumnKeys<ColumnInt16>(column, mask, keys, fallback);
+        case TypeIndex::Int32:
+        case TypeIndex::Date32:
+            return normalizeColumnKeys<ColumnInt32>(column, mask, keys, fallback);
+        case TypeIndex::Int64:
+            return normalizeColumnKeys<ColumnInt64>(column, mask, keys, fallback);
+        case TypeIndex::Float32:
+            return normalizeColumnKeys<ColumnFloat32>(column, mask, keys, fallback);
+        case TypeIndex::Float64:
+            return normalizeColumnKeys<ColumnFloat64>(column, mask, keys, fallback);
+        case TypeIndex::Decimal32:
+            return normalizeColumnKeys<ColumnDecimal<Decimal32>>(column, mask, keys, fallback);
+        case TypeIndex::Decimal64:
+            return normalizeColumnKeys<ColumnDecimal<Decimal64>>(column, mask, keys, fallback);
+        case TypeIndex::DateTime64:
+            return normalizeColumnKeys<ColumnDecimal<DateTime64>>(column, mask, keys, fallback);
+        case TypeIndex::String:
+            return normalizeStringKeys(column, mask, keys);
+        default:
+            return false;
+    }
+}
+
+void RangeSelectorBuilder::computePartitionIdByNormalizedSearch(DB::Block & block, DB::IColumn::Selector & selector)
+{
+    auto total_rows = block.rows();
+    auto input_columns = block.getColumns();
+    auto key_position = sorting_key_columns[0];
+    input_columns[key_position] = input_columns[key_position]->convertToFullColumnIfConst();
+
+    PaddedPODArray<UInt64> keys(total_rows);
+    PaddedPODArray<UInt8> fallback(total_rows, 0);
+    const IColumn * key_column = input_columns[key_position].get();
+    if (const auto * nullable_column = checkAndGetColumn<ColumnNullable>(key_column))
+    {
+        const auto & null_map = nullable_column->getNullMapData();
+        memcpy(fallback.data(), null_map.data(), total_rows);
+        key_column = &nullable_column->getNestedColumn();
+    }
+    if (!normalizeKeys(*key_column, keys.data(), fallback.data())) [[unlikely]]
+    {
+        computePartitionIdByBinarySearch(block, selector);
+        return;
+    }
+
+    selector.resize(total_rows);
+    normalized_bounds_search->lowerBound(keys.data(), selector.data(), total_rows);
+
+    const auto & bounds_columns = range_bounds_block.getColumns();
+    auto max_part = bounds_columns[0]->size();
+    if (bounds_columns[0]->isNullable() && !input_columns[key_position]->isNullable())
+        input_columns[key_position] = makeNullable(input_columns[key_position]);
+    bool exact_keys = *normalized_key_type != TypeIndex::String;
+    for (size_t r = 0; r < total_rows; ++r)
+    {
+        if (fallback[r]) [[unlikely]]
+        {
+            auto ret = binarySearchBound(bounds_columns, 0, max_part - 1, input_columns, sorting_key_columns, r);
+            selector[r] = ret >= 0 ? ret : max_part;
+        }
+        else if (!exact_keys && selector[r] < max_part && normalized_bounds[selector[r]] == keys[r])
+        {
+            /// The row has the same prefix with some bounds, compare it with them again.
+            size_t l = selector[r];
+            size_t u = l;
+            while (u < max_part && normalized_bounds[u] == keys[r])
+                ++u;
+            auto ret = binarySearchBound(bounds_columns, l, u - 1, input_columns, sorting_key_columns, r);
+            selector[r] = ret >= 0 ? ret : u;
+        }
+    }
+}
+
 namespace
 {
 int doCompareAt(const ColumnPtr & lhs, size_t n, size_t m, const IColumn & rhs, int nan_direction_hint)
@@ -16,6 +16,7 @@
  */
 #pragma once
 #include <memory>
+#include <optional>
 #include <vector>
 #include <Columns/IColumn.h>
 #include <Core/Block.h>
@@ -78,6 +79,30 @@ private:
     DB::FunctionBasePtr hash_function;
 };
 
+/// Branch-free lower bound search over sorted UInt64 keys laid out in Eytzinger (BFS) order. The tree is padded to a complete
+/// binary tree, so every search walks the same number of levels, and a batch of searches could run in lockstep to overlap the
+/// memory latency of different rows.
+class EytzingerLowerBound
+{
+public:
+    explicit EytzingerLowerBound(const std::vector<UInt64> & sorted_keys);
+
+    /// The index of the first key which is not less than value, or the number of keys if there is none.
+    size_t lowerBound(UInt64 value) const;
+    void lowerBound(const UInt64 * values, UInt64 * results, size_t rows) const;
+
+private:
+    static constexpr size_t BATCH_SIZE = 16;
+    size_t keys_num;
+    size_t height = 0;
+    /// 1-based, tree[0] is unused.
+    std::vector<UInt64> tree;
+    /// Map the tree node to the index in the sorted keys. 0 is the virtual node when all keys are less than the value.
+    std::vector<UInt64> tree_to_sorted;
+
+    size_t fill(const std::vector<UInt64> & sorted_keys, size_t i, size_t k);
+};
+
 class RangeSelectorBuilder : public SelectorBuilder
 {
 public:
@@ -85,6 +110,11 @@ public:
     ~RangeSelectorBuilder() override = default;
     PartitionInfo build(DB::Block & block) override;
 
+    /// Visible for UTs. The normalized search is only available when hasNormalizedBounds() returns true.
+    bool hasNormalizedBounds() const { return normalized_bounds_search != nullptr; }
+    void computePartitionIdByNormalizedSearch(DB::Block & block, DB::IColumn::Selector & selector);
+    void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
+
 private:
     DB::SortDescription sort_descriptions;
     std::vector<size_t> sorting_key_columns;
@@ -110,7 +140,17 @@ private:
     template <typename T>
     void safeInsertFloatValue(const Poco::Dynamic::Var & field_value, DB::MutableColumnPtr & col);
 
-    void computePartitionIdByBinarySearch(DB::Block & block, DB::IColumn::Selector & selector);
+    /// For a single sort key of numeric, date, decimal or string type, the range bounds are normalized into order-preserving UInt64
+    /// keys, then the partition ids are found by EytzingerLowerBound. Numeric keys are normalized exactly. Strings are normalized by
+    /// their first 8 bytes, the rows tied with some bounds on the prefix, null rows and NaN rows are resolved by the generic comparator.
+    std::optional<DB::TypeIndex> normalized_key_type;
+    std::vector<UInt64> normalized_bounds;
+    std::unique_ptr<EytzingerLowerBound> normalized_bounds_search;
+
+    void initNormalizedBounds();
+    /// Return false if the column type doesn't match the normalized key type.
+    bool normalizeKeys(const DB::IColumn & column, UInt64 * keys, UInt8 * fallback) const;
+
     int compareRow(
         const DB::Columns & columns,
         const std::vector<size_t> & required_columns,
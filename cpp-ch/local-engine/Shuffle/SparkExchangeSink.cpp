@@ -112,7 +112,7 @@ SparkExchangeManager::SparkExchangeManager(const Block& header, const String & s
         jmethodID celeborn_push_partition_data_method =
             GetMethodID(env, celeborn_partition_pusher_class, "pushPartitionData", "(I[BI)I");
         CLEAN_JNIENV
-        celeborn_client = std::make_unique<CelebornClient>(rss_pusher, celeborn_push_partition_data_method);
+        celeborn_client = std::make_unique<JniCelebornClient>(rss_pusher, celeborn_push_partition_data_method);
         use_rss = true;
     }
     if (!partitioner_creators.contains(short_name))
@@ -145,15 +145,15 @@ static std::shared_ptr<PartitionWriter> createPartitionWriter(const SplitOptions
 
 void SparkExchangeManager::initSinks(size_t num)
 {
-    if (num > 1 && celeborn_client)
-    {
-        throw Exception(DB::ErrorCodes::BAD_ARGUMENTS, "CelebornClient can't be used with multiple sinks");
-    }
     sinks.resize(num);
     partition_writers.resize(num);
     for (size_t i = 0; i < num; ++i)
     {
-        partition_writers[i] = createPartitionWriter(options, use_sort_shuffle, std::move(celeborn_client));
+        /// Every sink splits, compresses and pushes its own partition buffers with a dedicated client.
+        std::unique_ptr<CelebornClient> sink_celeborn_client;
+        if (celeborn_client)
+            sink_celeborn_client = celeborn_client->clone();
+        partition_writers[i] = createPartitionWriter(options, use_sort_shuffle, std::move(sink_celeborn_client));
         sinks[i] = std::make_shared<SparkExchangeSink>(toShared(input_header), partitioner_creator(options), partition_writers[i], output_columns_indicies, use_sort_shuffle);
     }
 }
@@ -18,13 +18,21 @@
 
 #include <Columns/ColumnArray.h>
 #include <Columns/ColumnConst.h>
+#include <Columns/ColumnDecimal.h>
 #include <Columns/ColumnMap.h>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnString.h>
 #include <Columns/ColumnTuple.h>
 #include <Columns/ColumnsCommon.h>
+#include <Columns/ColumnsNumber.h>
+#include <Core/Defines.h>
+#include <DataTypes/DataTypeString.h>
 #include <Interpreters/castColumn.h>
+#include <Interpreters/sortBlock.h>
 #include <QueryPipeline/QueryPipeline.h>
 #include <Poco/URI.h>
 #include <Common/DebugUtils.h>
+#include <Common/NaNUtils.h>
 #include <Common/logger_useful.h>
 
 namespace local_engine
@@ -37,6 +45,367 @@ const std::string SparkPartitionedBaseSink::DEFAULT_PARTITION_NAME{"__HIVE_DEFAU
 const std::string SparkPartitionedBaseSink::BUCKET_COLUMN_NAME{"__bucket_value__"};
 const std::vector<std::string> FileNameGenerator::SUPPORT_PLACEHOLDERS{"{id}", "{bucket}"};
 
+namespace
+{
+/// Min and max of the rows which are neither null nor NaN. Returns false if there is no such row. The loop is branchless so that
+/// it could be vectorized.
+template <bool has_null_map, typename T>
+bool minMaxOfFixed(const T * data, const UInt8 * null_map, size_t rows, T & min, T & max)
+{
+    T lo = std::numeric_limits<T>::max();
+    T hi = std::numeric_limits<T>::lowest();
+    size_t valid_rows = 0;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const T value = data[i];
+        bool valid = !isNaN(value);
+        if constexpr (has_null_map)
+            valid = valid && !null_map[i];
+        lo = valid && value < lo ? value : lo;
+        hi = valid && value > hi ? value : hi;
+        valid_rows += valid;
+    }
+    if (!valid_rows)
+        return false;
+    min = lo;
+    max = hi;
+    return true;
+}
+
+template <typename ColumnType>
+bool tryMinMaxOfFixed(const IColumn & column, const UInt8 * null_map, Field & min, Field & max)
+{
+    const auto * typed_column = typeid_cast<const ColumnType *>(&column);
+    if (!typed_column)
+        return false;
+
+    using ValueType = typename ColumnType::ValueType;
+    using Native = NativeType<ValueType>;
+    const auto * data = reinterpret_cast<const Native *>(typed_column->getData().data());
+    Native lo{};
+    Native hi{};
+    bool found = null_map ? minMaxOfFixed<true>(data, null_map, column.size(), lo, hi)
+                          : minMaxOfFixed<false>(data, null_map, column.size(), lo, hi);
+    if (!found)
+    {
+        min = Field();
+        max = Field();
+    }
+    else if constexpr (is_decimal<ValueType>)
+    {
+        min = DecimalField<ValueType>(ValueType(lo), typed_column->getScale());
+        max = DecimalField<ValueType>(ValueType(hi), typed_column->getScale());
+    }
+    else
+    {
+        min = static_cast<NearestFieldType<ValueType>>(lo);
+        max = static_cast<NearestFieldType<ValueType>>(hi);
+    }
+    return true;
+}
+
+bool tryMinMaxOfString(const IColumn & column, const UInt8 * null_map, Field & min, Field & max)
+{
+    const auto * string_column = typeid_cast<const ColumnString *>(&column);
+    if (!string_column)
+        return false;
+
+    std::string_view lo;
+    std::string_view hi;
+    bool found = false;
+    for (size_t i = 0; i < string_column->size(); ++i)
+    {
+        if (null_map && null_map[i])
+            continue;
+        const auto value = string_column->getDataAt(i).toView();
+        if (!found)
+        {
+            lo = hi = value;
+            found = true;
+        }
+        else if (value < lo)
+            lo = value;
+        else if (value > hi)
+            hi = value;
+    }
+    min = found ? Field(String(lo)) : Field();
+    max = found ? Field(String(hi)) : Field();
+    return true;
+}
+
+bool tryMinMax(const IColumn & column, const UInt8 * null_map, Field & min, Field & max)
+{
+    return tryMinMaxOfFixed<ColumnInt8>(column, null_map, min, max) || tryMinMaxOfFixed<ColumnInt16>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnInt32>(column, null_map, min, max) || tryMinMaxOfFixed<ColumnInt64>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnUInt8>(column, null_map, min, max) || tryMinMaxOfFixed<ColumnUInt16>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnUInt32>(column, null_map, min, max) || tryMinMaxOfFixed<ColumnUInt64>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnFloat32>(column, null_map, min, max) || tryMinMaxOfFixed<ColumnFloat64>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnDecimal<Decimal32>>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnDecimal<Decimal64>>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnDecimal<Decimal128>>(column, null_map, min, max)
+        || tryMinMaxOfFixed<ColumnDecimal<DateTime64>>(column, null_map, min, max) || tryMinMaxOfString(column, null_map, min, max);
+}
+}
+
+void computeColumnStats(const IColumn & column, Field & min, Field & max, Int64 & null_count)
+{
+    null_count = 0;
+    if (const auto * nullable_column = typeid_cast<const ColumnNullable *>(&column))
+    {
+        const auto & null_map = nullable_column->getNullMapData();
+        null_count = static_cast<Int64>(countBytesInFilter(null_map));
+        if (tryMinMax(nullable_column->getNestedColumn(), null_count ? null_map.data() : nullptr, min, max))
+            return;
+    }
+    else
+    {
+        if (tryMinMax(column, nullptr, min, max))
+            return;
+        if (column.onlyNull())
+            null_count = static_cast<Int64>(column.size());
+    }
+    /// Fallback for the other types, e.g. UUID and the nested types.
+    column.getExtremes(min, max);
+}
+
+void SparkPartitionedBaseSink::consume(Chunk & chunk)
+{
+    if (!write_config_.max_open_writers || !chunk.getNumRows())
+    {
+        PartitionedSink::consume(chunk);
+        return;
+    }
+
+    /// With the limit the open writers are driven here rather than by PartitionedSink, which would compute the key again.
+    auto partition_key = partition_strategy_->computePartitionKey(chunk)->convertToFullColumnIfConst();
+    if (!fallback_)
+    {
+        const size_t rows = partition_key->size();
+        IColumn::Selector selector(rows);
+        std::vector<std::string_view> partition_ids;
+        std::unordered_map<std::string_view, size_t> partition_indexes;
+        size_t new_partitions = 0;
+        for (size_t i = 0; i < rows; ++i)
+        {
+            auto key = partition_key->getDataAt(i).toView();
+            auto [it, inserted] = partition_indexes.try_emplace(key, partition_ids.size());
+            if (inserted)
+            {
+                partition_ids.push_back(key);
+                new_partitions += !open_writers_.contains(key);
+            }
+            selector[i] = it->second;
+        }
+        if (open_writers_.size() + new_partitions <= write_config_.max_open_writers)
+        {
+            writeToOpenPartitions(chunk, partition_ids, selector);
+            return;
+        }
+        startFallback();
+    }
+    bufferForClustering(chunk, partition_key);
+}
+
+void SparkPartitionedBaseSink::writeToOpenPartitions(
+    Chunk & chunk, const std::vector<std::string_view> & partition_ids, const IColumn::Selector & selector)
+{
+    const auto & header = getHeader();
+    auto columns = chunk.detachColumns();
+    for (auto & column : columns)
+        column = column->convertToFullColumnIfConst();
+
+    std::vector<MutableColumns> scattered_columns(partition_ids.size());
+    if (partition_ids.size() == 1)
+    {
+        for (auto & column : columns)
+            scattered_columns[0].emplace_back(IColumn::mutate(std::move(column)));
+    }
+    else
+    {
+        for (const auto & column : columns)
+        {
+            auto partition_columns = column->scatter(partition_ids.size(), selector);
+            for (size_t i = 0; i < partition_ids.size(); ++i)
+                scattered_columns[i].emplace_back(std::move(partition_columns[i]));
+        }
+    }
+
+    for (size_t i = 0; i < partition_ids.size(); ++i)
+    {
+        auto it = open_writers_.find(partition_ids[i]);
+        if (it == open_writers_.end())
+        {
+            String partition_id(partition_ids[i]);
+            auto writer = std::make_unique<PartitionWriter>(createSinkForPartition(partition_id));
+            it = open_writers_.emplace(std::move(partition_id), std::move(writer)).first;
+        }
+        it->second->executor.push(header.cloneWithColumns(std::move(scattered_columns[i])));
+    }
+}
+
+void SparkPartitionedBaseSink::finishOpenWriters()
+{
+    for (auto & [_, writer] : open_writers_)
+        writer->executor.finish();
+    open_writers_.clear();
+}
+
+struct SparkPartitionedBaseSink::SortedRunCursor
+{
+    /// Empty for the rows still buffered in memory.
+    std::optional<TemporaryBlockStreamReaderHolder> reader;
+    Block block;
+    ColumnPtr partition_key;
+    size_t row = 0;
+
+    bool hasRows() const { return row < block.rows(); }
+
+    void setBlock(Block next_block)
+    {
+        block = std::move(next_block);
+        row = 0;
+        if (!block.rows())
+            return;
+        auto key_position = block.getPositionByName(PARTITION_KEY_COLUMN_NAME);
+        partition_key = block.getByPosition(key_position).column;
+        block.erase(key_position);
+    }
+
+    /// Skips the rows, and reads the next block of the run once the current one is consumed.
+    void skip(size_t rows)
+    {
+        row += rows;
+        if (!hasRows() && reader)
+            setBlock((*reader)->read());
+    }
+};
+
+void SparkPartitionedBaseSink::onFinish()
+{
+    if (!fallback_)
+    {
+        finishOpenWriters();
+        PartitionedSink::onFinish();
+        return;
+    }
+
+    writeClustered();
+    LOG_INFO(
+        getLogger("SparkPartitionedBaseSink"),
+        "Wrote {} partitions clustered by the partition key, spilled {} sorted runs of {} bytes",
+        clustered_partitions_,
+        spilled_runs_.size(),
+        spilled_bytes_);
+    spilled_runs_.clear();
+}
+
+void SparkPartitionedBaseSink::startFallback()
+{
+    LOG_INFO(
+        getLogger("SparkPartitionedBaseSink"),
+        "More than {} partitions are written, cluster the remaining rows by partition",
+        write_config_.max_open_writers);
+    /// Close the open writers to release their buffers. Rows of these partitions seen later are written into new files.
+    finishOpenWriters();
+    fallback_ = true;
+}
+
+void SparkPartitionedBaseSink::bufferForClustering(Chunk & chunk, const ColumnPtr & partition_key)
+{
+    const auto & header = getHeader();
+    auto columns = chunk.detachColumns();
+    Block block;
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        const auto & column = header.getByPosition(i);
+        block.insert({columns[i]->convertToFullColumnIfConst(), column.type, column.name});
+    }
+    block.insert({partition_key, std::make_shared<DataTypeString>(), PARTITION_KEY_COLUMN_NAME});
+
+    cluster_buffer_bytes_ += block.allocatedBytes();
+    cluster_buffer_.emplace_back(std::move(block));
+    if (cluster_buffer_bytes_ > write_config_.fallback_buffer_bytes)
+        spillClusterBuffer();
+}
+
+Block SparkPartitionedBaseSink::sortClusterBuffer()
+{
+    auto block = concatenateBlocks(cluster_buffer_);
+    cluster_buffer_.clear();
+    cluster_buffer_bytes_ = 0;
+    sortBlock(block, SortDescription{SortColumnDescription(PARTITION_KEY_COLUMN_NAME)});
+    return block;
+}
+
+void SparkPartitionedBaseSink::spillClusterBuffer()
+{
+    if (cluster_buffer_.empty())
+        return;
+
+    auto block = sortClusterBuffer();
+    auto tmp_data_disk = context_->getTempDataOnDisk();
+    auto & run = spilled_runs_.emplace_back(toShared(block.cloneEmpty()), tmp_data_disk.get());
+    /// Write the run in slices, so that it could be read back one slice at a time while merging.
+    for (size_t start = 0; start < block.rows(); start += DEFAULT_BLOCK_SIZE)
+    {
+        auto slice = block.cloneWithCutColumns(start, std::min<size_t>(DEFAULT_BLOCK_SIZE, block.rows() - start));
+        spilled_bytes_ += slice.bytes();
+        run->write(slice);
+    }
+    run->flush();
+    run.finishWriting();
+}
+
+void SparkPartitionedBaseSink::writeClustered()
+{
+    std::vector<SortedRunCursor> cursors;
+    cursors.reserve(spilled_runs_.size() + 1);
+    for (auto & run : spilled_runs_)
+    {
+        auto & cursor = cursors.emplace_back();
+        cursor.reader.emplace(run.getReadStream());
+        cursor.setBlock((*cursor.reader)->read());
+    }
+    if (!cluster_buffer_.empty())
+        cursors.emplace_back().setBlock(sortClusterBuffer());
+
+    std::optional<PartitionWriter> writer;
+    String current_key;
+    while (true)
+    {
+        /// There are only a few runs, a linear scan for the smallest key is enough.
+        SortedRunCursor * min_cursor = nullptr;
+        for (auto & cursor : cursors)
+        {
+            if (!cursor.hasRows())
+                continue;
+            if (!min_cursor || cursor.partition_key->compareAt(cursor.row, min_cursor->row, *min_cursor->partition_key, 1) < 0)
+                min_cursor = &cursor;
+        }
+        if (!min_cursor)
+            break;
+
+        auto & cursor = *min_cursor;
+        auto key = cursor.partition_key->getDataAt(cursor.row);
+        size_t end = cursor.row + 1;
+        while (end < cursor.block.rows() && cursor.partition_key->getDataAt(end) == key)
+            ++end;
+
+        if (!writer || key != StringRef(current_key))
+        {
+            if (writer)
+                writer->executor.finish();
+            current_key = key.toString();
+            writer.emplace(createSinkForPartition(current_key));
+            ++clustered_partitions_;
+        }
+        writer->executor.push(cursor.block.cloneWithCutColumns(cursor.row, end - cursor.row));
+        cursor.skip(end - cursor.row);
+    }
+    if (writer)
+        writer->executor.finish();
+}
+
 /// For Nullable(Map(K, V)) or Nullable(Array(T)), if the i-th row is null, we must make sure its nested data is empty.
 /// It is for ORC/Parquet writing compatiability. For more details, refer to
 /// https://github.com/apache/incubator-gluten/issues/8022 and https://github.com/apache/incubator-gluten/issues/8021
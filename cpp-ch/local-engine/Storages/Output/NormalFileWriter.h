@@ -20,6 +20,7 @@
 #include <Core/Block.h>
 #include <Core/Field.h>
 #include <Interpreters/Context.h>
+#include <Interpreters/TemporaryDataOnDisk.h>
 #include <Parsers/ASTFunction.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Parsers/ASTLiteral.h>
@@ -27,6 +28,7 @@
 #include <Processors/Executors/PushingPipelineExecutor.h>
 #include <Processors/ISimpleTransform.h>
 #include <Processors/Sinks/SinkToStorage.h>
+#include <QueryPipeline/QueryPipeline.h>
 #include <Storages/NativeOutputWriter.h>
 #include <Storages/Output/OutputFormatFile.h>
 #include <Storages/PartitionedSink.h>
@@ -35,6 +37,7 @@
 #include <Common/BlockTypeUtils.h>
 #include <Common/CHUtil.h>
 #include <Common/FieldAccurateComparison.h>
+#include <Common/GlutenConfig.h>
 
 namespace local_engine
 {
@@ -65,6 +68,11 @@ private:
 OutputFormatFilePtr createOutputFormatFile(
     const DB::ContextPtr & context, const std::string & file_uri, const DB::Block & preferred_schema, const std::string & format_hint);
 
+/// Computes min, max and null count of a column in one pass. Numeric, decimal and string columns, nullable or not, are scanned
+/// by typed loops over the raw data, other columns fall back to IColumn::getExtremes. min and max are Null if the column has no
+/// value other than nulls.
+void computeColumnStats(const DB::IColumn & column, DB::Field & min, DB::Field & max, Int64 & null_count);
+
 struct DeltaStats
 {
     size_t row_count;
@@ -158,27 +166,21 @@ struct DeltaStats
             if (partition_index.contains(col))
                 continue;
 
-            const auto & column = columns[col];
+            DB::Field min_value, max_value;
             Int64 null_count = 0;
-            if (const auto * nullable_column = typeid_cast<const DB::ColumnNullable *>(column.get()))
-            {
-                const auto & null_map = nullable_column->getNullMapData();
-                null_count = std::ranges::count_if(null_map, [](UInt8 value) { return value != 0; });
-            }
+            computeColumnStats(*columns[col], min_value, max_value, null_count);
             this->null_count[i] += null_count;
 
-            DB::Field min_value, max_value;
-            column->getExtremes(min_value, max_value);
-
-            assert(min[i].isNull() || min_value.getType() == min[i].getType());
-            assert(max[i].isNull() || max_value.getType() == max[i].getType());
+            assert(min[i].isNull() || min_value.isNull() || min_value.getType() == min[i].getType());
+            assert(max[i].isNull() || max_value.isNull() || max_value.getType() == max[i].getType());
 
-            if (!initialized())
+            /// A chunk of nulls only leaves min and max as they are.
+            if (!initialized() || min[i].isNull())
             {
                 min[i] = min_value;
                 max[i] = max_value;
             }
-            else
+            else if (!min_value.isNull())
             {
                 min[i] = accurateLess(min[i], min_value) ? min[i] : min_value;
                 max[i] = accurateLess(max[i], max_value) ? max_value : max[i];
@@ -251,6 +253,8 @@ class WriteStats : public WriteStatsBase
         record_count,
         stats_column_start = record_count + 1
     };
+    /// The last column tells whether the file was written while clustering the rows by partition.
+    static constexpr auto CLUSTERED_COLUMN_NAME = "clustered";
     static DB::ColumnsWithTypeAndName statsHeaderBase()
     {
         return {{STRING(), "filename"}, {STRING(), "partition_id"}, {BIGINT(), "record_count"}};
@@ -270,16 +274,21 @@ public:
     }
     static std::shared_ptr<WriteStats> create(const DB::SharedHeader & input, const DB::Names & partition)
     {
-        return std::make_shared<WriteStats>(input, toShared(DeltaStats::statsHeader(*input, partition, statsHeaderBase())));
+        auto header = DeltaStats::statsHeader(*input, partition, statsHeaderBase());
+        header.insert({UINT8(), CLUSTERED_COLUMN_NAME});
+        return std::make_shared<WriteStats>(input, toShared(std::move(header)));
     }
 
     String getName() const override { return "WriteStats"; }
 
-    void collectStats(const String & filename, const String & partition_dir, const DeltaStats & stats) const
+    /// visible for UTs
+    DB::Block collectedStats() { return getOutputPort().getHeader().cloneWithColumns(std::move(columns_)); }
+
+    void collectStats(const String & filename, const String & partition_dir, const DeltaStats & stats, bool clustered) const
     {
         const std::string & partition = partition_dir.empty() ? WriteStatsBase::NO_PARTITION_ID : partition_dir;
         size_t columnSize = stats.n_stats_cols;
-        assert(columns_.size() == stats_column_start + columnSize * 3);
+        assert(columns_.size() == stats_column_start + columnSize * 3 + 1);
 
         columns_[ColumnIndex::filename]->insertData(filename.c_str(), filename.size());
         columns_[partition_id]->insertData(partition.c_str(), partition.size());
@@ -294,6 +303,7 @@ public:
             auto & nullCountData = static_cast<DB::ColumnVector<Int64> &>(*columns_[(columnSize * 2) + offset]).getData();
             nullCountData.emplace_back(stats.null_count[i]);
         }
+        static_cast<DB::ColumnVector<UInt8> &>(*columns_.back()).getData().emplace_back(clustered);
     }
 };
 
@@ -352,6 +362,7 @@ class SubstraitFileSink final : public DB::SinkToStorage
     OutputFormatFile::OutputFormatPtr output_format_;
     std::shared_ptr<WriteStats> stats_;
     DeltaStats delta_stats_;
+    const bool clustered_;
 
     static std::string makeAbsoluteFilename(const std::string & base_path, const std::string & partition_id, const std::string & relative)
     {
@@ -370,7 +381,8 @@ public:
         const std::string & format_hint,
         const DB::SharedHeader header,
         const std::shared_ptr<WriteStatsBase> & stats,
-        const DeltaStats & delta_stats)
+        const DeltaStats & delta_stats,
+        bool clustered = false)
         : SinkToStorage(header)
         , partition_id_(partition_id)
         , bucketed_write_(bucketed_write)
@@ -378,6 +390,7 @@ public:
         , format_file_(createOutputFormatFile(context, makeAbsoluteFilename(base_path, partition_id, relative), *header, format_hint))
         , stats_(std::dynamic_pointer_cast<WriteStats>(stats))
         , delta_stats_(delta_stats)
+        , clustered_(clustered)
     {
     }
 
@@ -412,7 +425,7 @@ protected:
             output_format_.reset();
             assert(delta_stats_.row_count > 0);
             if (stats_)
-                stats_->collectStats(relative_path_, partition_id_, delta_stats_);
+                stats_->collectStats(relative_path_, partition_id_, delta_stats_, clustered_);
         }
     }
     void onCancel() noexcept override
@@ -474,7 +487,49 @@ public:
         return DB::makeASTFunction("concat", std::move(arguments));
     }
 
+    void consume(DB::Chunk & chunk) override;
+    void onFinish() override;
+
+    /// Whether more partitions than write.max_open_writers were seen, and the rows are clustered by partition.
+    bool fallbackToClustering() const { return fallback_; }
+
 private:
+    static constexpr auto PARTITION_KEY_COLUMN_NAME = "__partition_key__";
+
+    /// Reads the rows of a run sorted by the partition key.
+    struct SortedRunCursor;
+
+    /// The writer of one partition. PartitionedSink drives the partition sinks as a friend, here they are pushed through a
+    /// pipeline of their own.
+    struct PartitionWriter
+    {
+        DB::QueryPipeline pipeline;
+        DB::PushingPipelineExecutor executor;
+
+        explicit PartitionWriter(DB::SinkPtr sink) : pipeline(std::move(sink)), executor(pipeline) { executor.start(); }
+    };
+
+    /// Lets the open writers be looked up by the partition ids viewing the partition key column.
+    struct PartitionIdHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view partition_id) const { return std::hash<std::string_view>{}(partition_id); }
+    };
+
+    /// Splits the chunk by the partition of each row given by the selector, and writes the rows to the open writers.
+    void writeToOpenPartitions(
+        DB::Chunk & chunk, const std::vector<std::string_view> & partition_ids, const DB::IColumn::Selector & selector);
+    void finishOpenWriters();
+    void startFallback();
+    void bufferForClustering(DB::Chunk & chunk, const DB::ColumnPtr & partition_key);
+    /// Concatenates the buffered rows and sorts them by the partition key.
+    DB::Block sortClusterBuffer();
+    /// Spills the buffered rows as one sorted run.
+    void spillClusterBuffer();
+    /// Merges the sorted runs and the buffered rows by the partition key, writes one partition at a time and closes each
+    /// writer before the next one. Only one block of each run is kept in memory.
+    void writeClustered();
+
     static std::shared_ptr<DB::IPartitionStrategy>
     make_partition_strategy(const DB::ContextPtr & context, const DB::Names & partition_columns, const DB::Block & input_header)
     {
@@ -502,23 +557,46 @@ private:
 
     virtual DB::SinkPtr createSinkForPartition(const String & partition_id, const String & bucket) = 0;
 
+    SparkPartitionedBaseSink(
+        const std::shared_ptr<DB::IPartitionStrategy> & partition_strategy,
+        const DB::ContextPtr & context,
+        const DB::Names & partition_by,
+        const DB::SharedHeader & input_header,
+        const std::shared_ptr<WriteStatsBase> & stats)
+        : PartitionedSink(partition_strategy, context, input_header)
+        , context_(context)
+        , stats_(stats)
+        , empty_delta_stats_(DeltaStats::create(*input_header, partition_by))
+        , bucketed_write_(isBucketedWrite(*input_header))
+        , partition_strategy_(partition_strategy)
+        , write_config_(PartitionedWriteConfig::loadFromContext(context))
+    {
+    }
+
 protected:
     DB::ContextPtr context_;
     std::shared_ptr<WriteStatsBase> stats_;
     DeltaStats empty_delta_stats_;
     bool bucketed_write_;
 
+private:
+    std::shared_ptr<DB::IPartitionStrategy> partition_strategy_;
+    PartitionedWriteConfig write_config_;
+    std::unordered_map<String, std::unique_ptr<PartitionWriter>, PartitionIdHash, std::equal_to<>> open_writers_;
+    bool fallback_ = false;
+    DB::Blocks cluster_buffer_;
+    size_t cluster_buffer_bytes_ = 0;
+    std::vector<DB::TemporaryBlockStreamHolder> spilled_runs_;
+    size_t spilled_bytes_ = 0;
+    size_t clustered_partitions_ = 0;
+
 public:
     SparkPartitionedBaseSink(
         const DB::ContextPtr & context,
         const DB::Names & partition_by,
         const DB::SharedHeader & input_header,
         const std::shared_ptr<WriteStatsBase> & stats)
-        : PartitionedSink(make_partition_strategy(context, partition_by, *input_header), context, input_header)
-        , context_(context)
-        , stats_(stats)
-        , empty_delta_stats_(DeltaStats::create(*input_header, partition_by))
-        , bucketed_write_(isBucketedWrite(*input_header))
+        : SparkPartitionedBaseSink(make_partition_strategy(context, partition_by, *input_header), context, partition_by, input_header, stats)
     {
     }
 };
@@ -558,7 +636,16 @@ public:
         const auto partition_path = fmt::format("{}/{}", partition_id, filename);
         validatePartitionKey(partition_path, true);
         return std::make_shared<SubstraitFileSink>(
-            context_, base_path_, partition_id, bucketed_write, filename, format_hint_, sample_block_, stats_, empty_delta_stats_);
+            context_,
+            base_path_,
+            partition_id,
+            bucketed_write,
+            filename,
+            format_hint_,
+            sample_block_,
+            stats_,
+            empty_delta_stats_,
+            fallbackToClustering());
     }
     String getName() const override { return "SubstraitPartitionedFileSink"; }
 };
@@ -15,15 +15,54 @@
  * limitations under the License.
  */
 #pragma once
+#include <memory>
+#include <mutex>
 #include <jni.h>
 #include <Common/JNIUtils.h>
 
 namespace local_engine
 {
-class CelebornClient {
+/// Pushes the partition data of a map task to Celeborn. Every sink gets its own client cloned from the first one, the
+/// clients prepare their data concurrently. The pushes of all the clients of a map task are serialized by one lock, since
+/// the Celeborn shuffle client shares the push state and the data batches of a map task between its pushes.
+class CelebornClient
+{
 public:
-    CelebornClient(jobject java_celeborn_pusher_, jmethodID java_celeborn_push_partition_data_method_)
-        : java_celeborn_push_partition_data_method(java_celeborn_push_partition_data_method_) {
+    virtual ~CelebornClient() = default;
+
+    size_t pushPartitionData(size_t partition_id, char * bytes, size_t size)
+    {
+        prepare(bytes, size);
+        std::lock_guard lock(*push_mutex);
+        return push(partition_id, bytes, size);
+    }
+
+    /// Create a client for another sink which pushes to the same pusher.
+    virtual std::unique_ptr<CelebornClient> clone() const = 0;
+
+protected:
+    explicit CelebornClient(std::shared_ptr<std::mutex> push_mutex_) : push_mutex(std::move(push_mutex_)) { }
+
+    /// Called outside of the push lock, e.g. to copy the data into the JVM.
+    virtual void prepare(char * /*bytes*/, size_t /*size*/) { }
+    /// Called under the push lock, returns the bytes pushed to Celeborn.
+    virtual size_t push(size_t partition_id, char * bytes, size_t size) = 0;
+
+    /// Shared by the clients cloned for the sinks of the same map task.
+    std::shared_ptr<std::mutex> push_mutex;
+};
+
+/// Pushes by org.apache.spark.shuffle.CelebornPartitionPusher. Each client owns its own byte array, so that the data is
+/// copied into the JVM outside of the push lock.
+class JniCelebornClient final : public CelebornClient
+{
+public:
+    JniCelebornClient(
+        jobject java_celeborn_pusher_,
+        jmethodID java_celeborn_push_partition_data_method_,
+        std::shared_ptr<std::mutex> push_mutex_ = std::make_shared<std::mutex>())
+        : CelebornClient(std::move(push_mutex_)), java_celeborn_push_partition_data_method(java_celeborn_push_partition_data_method_)
+    {
         GET_JNIENV(env)
         java_celeborn_pusher = env->NewGlobalRef(java_celeborn_pusher_);
         array_ = env->NewByteArray(1024 * 1024);
@@ -31,14 +70,26 @@ public:
         CLEAN_JNIENV
     }
 
-    ~CelebornClient() {
+    ~JniCelebornClient() override
+    {
         GET_JNIENV(env)
         env->DeleteGlobalRef(java_celeborn_pusher);
         env->DeleteGlobalRef(array_);
         CLEAN_JNIENV
     }
 
-    size_t pushPartitionData(size_t partitionId, char* bytes, size_t size) {
+    std::unique_ptr<CelebornClient> clone() const override
+    {
+        return std::make_unique<JniCelebornClient>(java_celeborn_pusher, java_celeborn_push_partition_data_method, push_mutex);
+    }
+
+    jobject java_celeborn_pusher;
+    jmethodID java_celeborn_push_partition_data_method;
+    jbyteArray array_;
+
+protected:
+    void prepare(char * bytes, size_t size) override
+    {
         GET_JNIENV(env)
         size_t length = env->GetArrayLength(array_);
         auto int_size = static_cast<jint>(size);
@@ -48,16 +99,17 @@ public:
             array_ = env->NewByteArray(int_size);
             array_ = static_cast<jbyteArray>(env->NewGlobalRef(array_));
         }
-        env->SetByteArrayRegion(array_, 0, int_size, reinterpret_cast<jbyte*>(bytes));
-        jint celeborn_bytes =
-            env->CallIntMethod(java_celeborn_pusher, java_celeborn_push_partition_data_method, partitionId, array_, int_size);
+        env->SetByteArrayRegion(array_, 0, int_size, reinterpret_cast<jbyte *>(bytes));
         CLEAN_JNIENV
-        return celeborn_bytes;
     }
 
-    jobject java_celeborn_pusher;
-    jmethodID java_celeborn_push_partition_data_method;
-    jbyteArray array_;
+    size_t push(size_t partition_id, char * /*bytes*/, size_t size) override
+    {
+        GET_JNIENV(env)
+        jint celeborn_bytes = env->CallIntMethod(
+            java_celeborn_pusher, java_celeborn_push_partition_data_method, partition_id, array_, static_cast<jint>(size));
+        CLEAN_JNIENV
+        return celeborn_bytes;
+    }
 };
 }
-
@@ -648,10 +648,14 @@ local_engine::SplitterHolder * buildAndExecuteShuffle(
         splitter = new local_engine::SplitterHolder{
             .exchange_manager = std::make_unique<local_engine::SparkExchangeManager>(
                 current_executor.value()->getHeader().cloneEmpty(), name, options, rss_pusher)};
-        // TODO support multiple sinks
-        splitter->exchange_manager->initSinks(1);
-        current_executor.value()->setSinks([&](auto & pipeline_builder)
-                                           { splitter->exchange_manager->setSinksToPipeline(pipeline_builder); });
+        // TODO support multiple sinks for local shuffle
+        current_executor.value()->setSinks(
+            [&](auto & pipeline_builder)
+            {
+                // Celeborn partition writers push the partitions of each sink independently, keep the parallelism of the pipeline.
+                splitter->exchange_manager->initSinks(rss_pusher ? std::max<size_t>(pipeline_builder.getNumStreams(), 1) : 1);
+                splitter->exchange_manager->setSinksToPipeline(pipeline_builder);
+            });
         // execute pipeline
         current_executor.value()->execute();
     }
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Columns/ColumnDecimal.h>
+#include <Core/Block.h>
+#include <Core/DecimalFunctions.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <DataTypes/DataTypeFactory.h>
+#include <Functions/FunctionFactory.h>
+#include <benchmark/benchmark.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+
+namespace
+{
+ColumnWithTypeAndName createDecimalColumn(const String & type_str, const String & name, size_t rows, Int64 modulus)
+{
+    auto type = DataTypeFactory::instance().get(type_str);
+    auto scale = getDecimalScale(*type);
+    auto column = type->createColumn();
+    for (size_t i = 0; i < rows; ++i)
+    {
+        Int64 value = static_cast<Int64>(i * 7919) % modulus;
+        if (getDecimalPrecision(*type) <= DecimalUtils::max_precision<Decimal32>)
+            column->insert(DecimalField<Decimal32>(static_cast<Int32>(value), scale));
+        else
+            column->insert(DecimalField<Decimal64>(value, scale));
+    }
+    return ColumnWithTypeAndName(std::move(column), type, name);
+}
+
+/// Run a spark decimal arithmetic function over two vector columns, the third argument is a constant which gives the result type.
+void runDecimalArithmetic(
+    benchmark::State & state, const String & function_name, const String & left_type, const String & right_type, const String & result_type)
+{
+    constexpr size_t rows = 65536;
+    auto left = createDecimalColumn(left_type, "left", rows, 999999999);
+    auto right = createDecimalColumn(right_type, "right", rows, 999999999);
+    auto type = DataTypeFactory::instance().get(result_type);
+    ColumnWithTypeAndName result(type->createColumnConstWithDefaultValue(rows), type, "result");
+    ColumnsWithTypeAndName arguments{left, right, result};
+
+    auto function = FunctionFactory::instance().get(function_name, local_engine::QueryContext::globalContext());
+    auto executable = function->build(arguments);
+    for (auto _ : state)
+    {
+        auto res = executable->execute(arguments, executable->getResultType(), rows, false);
+        benchmark::DoNotOptimize(res);
+    }
+}
+}
+
+/// decimal(9, 2) * decimal(9, 4) fits in 18 digits and is calculated with Int64 although the result type is decimal(19, 6)
+static void BM_SparkDecimalMultiply_Int64(benchmark::State & state)
+{
+    runDecimalArithmetic(state, "sparkDecimalMultiply", "Decimal(9, 2)", "Decimal(9, 4)", "Decimal(19, 6)");
+}
+
+/// decimal(12, 2) * decimal(10, 4) needs 22 digits and is calculated with Int128
+static void BM_SparkDecimalMultiply_Int128(benchmark::State & state)
+{
+    runDecimalArithmetic(state, "sparkDecimalMultiply", "Decimal(12, 2)", "Decimal(10, 4)", "Decimal(23, 6)");
+}
+
+static void BM_SparkDecimalPlus_Int64(benchmark::State & state)
+{
+    runDecimalArithmetic(state, "sparkDecimalPlus", "Decimal(12, 2)", "Decimal(10, 4)", "Decimal(15, 4)");
+}
+
+static void BM_SparkDecimalPlus_Int128(benchmark::State & state)
+{
+    runDecimalArithmetic(state, "sparkDecimalPlus", "Decimal(18, 2)", "Decimal(10, 4)", "Decimal(21, 4)");
+}
+
+BENCHMARK(BM_SparkDecimalMultiply_Int64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparkDecimalMultiply_Int128)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparkDecimalPlus_Int64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparkDecimalPlus_Int128)->Unit(benchmark::kMicrosecond);
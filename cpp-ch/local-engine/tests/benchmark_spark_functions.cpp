@@ -33,6 +33,7 @@
 #include <Common/QueryContext.h>
 #include <Common/TargetSpecific.h>
 #include <DataTypes/DataTypeNullable.h>
+#include <DataTypes/DataTypeString.h>
 
 #if USE_MULTITARGET_CODE
 #include <immintrin.h>
@@ -1487,4 +1488,37 @@ BENCHMARK_TEMPLATE(BM_myFilterToIndicesAVX512, UInt64);
 */
 
 
+static void runSparkStrToMap(benchmark::State & state, const String & pair_delim, const String & kv_delim)
+{
+    constexpr size_t rows = 65536;
+    auto type = std::make_shared<DataTypeString>();
+    auto column = type->createColumn();
+    for (size_t i = 0; i < rows; ++i)
+        column->insert(fmt::format("app:{},os:android,ver:{}.{},ch:store_{},uid:{}", i % 13, i % 7, i % 5, i % 97, i));
+    ColumnsWithTypeAndName arguments
+        = {ColumnWithTypeAndName(std::move(column), type, "str"),
+           ColumnWithTypeAndName(type->createColumnConst(rows, pair_delim), type, "pair_delim"),
+           ColumnWithTypeAndName(type->createColumnConst(rows, kv_delim), type, "kv_delim")};
+    auto function = FunctionFactory::instance().get("spark_str_to_map", local_engine::QueryContext::globalContext())->build(arguments);
+    for (auto _ : state)
+    {
+        auto result = function->execute(arguments, function->getResultType(), rows, false);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+static void BM_SparkStrToMap_SingleCharDelimiters(benchmark::State & state)
+{
+    runSparkStrToMap(state, ",", ":");
+}
+
+/// The same delimiters escaped in regular expressions
+static void BM_SparkStrToMap_RegexDelimiters(benchmark::State & state)
+{
+    runSparkStrToMap(state, "\\,", "\\:");
+}
+
+BENCHMARK(BM_SparkStrToMap_SingleCharDelimiters);
+BENCHMARK(BM_SparkStrToMap_RegexDelimiters);
+
 #endif
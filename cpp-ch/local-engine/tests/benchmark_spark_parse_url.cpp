@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Columns/IColumn.h>
+#include <Core/Block.h>
+#include <Functions/FunctionFactory.h>
+#include <benchmark/benchmark.h>
+#include <Common/BlockTypeUtils.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+
+namespace
+{
+constexpr size_t rows = 65536;
+
+ColumnWithTypeAndName createURLColumn()
+{
+    auto type = local_engine::STRING();
+    auto column = type->createColumn();
+    for (size_t i = 0; i < rows; ++i)
+        column->insert(fmt::format("https://www{}.example.com/shop/item/{}?k={}&ref=campaign_{}#top", i % 17, i, i % 1000, i % 31));
+    return ColumnWithTypeAndName(std::move(column), type, "url");
+}
+
+ColumnWithTypeAndName createConstString(const String & value, const String & name)
+{
+    auto type = local_engine::STRING();
+    return ColumnWithTypeAndName(type->createColumnConst(rows, value), type, name);
+}
+
+ColumnWithTypeAndName executeFunction(const String & function_name, const ColumnsWithTypeAndName & arguments)
+{
+    auto function = FunctionFactory::instance().get(function_name, local_engine::QueryContext::globalContext())->build(arguments);
+    return {function->execute(arguments, function->getResultType(), rows, false), function->getResultType(), function_name};
+}
+}
+
+/// parse_url(u, 'HOST'), parse_url(u, 'PATH') and parse_url(u, 'QUERY', 'k') by the single component functions, each of them
+/// parses the urls again
+static void BM_SparkParseURL_SingleComponents(benchmark::State & state)
+{
+    auto url = createURLColumn();
+    auto key = createConstString("k", "key");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_host", {url}));
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_path", {url}));
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_one_query", {url, key}));
+    }
+}
+
+/// The same calls sharing the urls tokenized by spark_parse_url_components
+static void BM_SparkParseURL_SharedComponents(benchmark::State & state)
+{
+    auto url = createURLColumn();
+    auto key = createConstString("k", "key");
+    auto host = createConstString("HOST", "part");
+    auto path = createConstString("PATH", "part");
+    auto query = createConstString("QUERY", "part");
+    for (auto _ : state)
+    {
+        auto components = executeFunction("spark_parse_url_components", {url});
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_component", {url, components, host}));
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_component", {url, components, path}));
+        benchmark::DoNotOptimize(executeFunction("spark_parse_url_component", {url, components, query, key}));
+    }
+}
+
+BENCHMARK(BM_SparkParseURL_SingleComponents)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SparkParseURL_SharedComponents)->Unit(benchmark::kMillisecond);
@@ -14,12 +14,16 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+#include <map>
 #include <Core/Settings.h>
 #include <DataTypes/DataTypeFactory.h>
 #include <Functions/FunctionFactory.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/HashJoin/HashJoin.h>
 #include <Interpreters/TableJoin.h>
+#include <Join/PartitionedHashJoin.h>
+#include <Join/StorageJoinFromReadBuffer.h>
 #include <Parsers/ASTIdentifier.h>
 #include <Processors/Executors/PipelineExecutor.h>
 #include <Processors/Executors/PullingPipelineExecutor.h>
@@ -152,3 +156,200 @@ TEST(TestJoin, simple)
     executor.pull(res);
     debug::headBlock(res);
 }
+
+TEST(TestJoin, PartitionedHashJoinScatterByKeys)
+{
+    /// The right keys are not nullable, the left keys are nullable with nulls, the same key must go to the same partition.
+    auto int_type = DataTypeFactory::instance().get("Int64");
+    auto nullable_type = DataTypeFactory::instance().get("Nullable(Int64)");
+    auto right_key = int_type->createColumn();
+    auto left_key = nullable_type->createColumn();
+    for (Int64 i = 0; i < 1000; ++i)
+    {
+        right_key->insert(i * 7919);
+        left_key->insert(i * 7919);
+        left_key->insert(Field());
+    }
+    Block right({ColumnWithTypeAndName(std::move(right_key), int_type, "r")});
+    Block left({ColumnWithTypeAndName(std::move(left_key), nullable_type, "l")});
+
+    const size_t partitions = 4;
+    auto right_blocks = PartitionedHashJoin::scatterByKeys(right, {"r"}, partitions);
+    auto left_blocks = PartitionedHashJoin::scatterByKeys(left, {"l"}, partitions);
+    ASSERT_EQ(right_blocks.size(), partitions);
+    ASSERT_EQ(left_blocks.size(), partitions);
+
+    std::map<Int64, size_t> right_partition_of_key;
+    size_t right_rows = 0;
+    for (size_t p = 0; p < partitions; ++p)
+    {
+        /// The keys should be spread over all partitions.
+        EXPECT_GT(right_blocks[p].rows(), 0);
+        right_rows += right_blocks[p].rows();
+        const auto & column = right_blocks[p].getByPosition(0).column;
+        for (size_t i = 0; i < column->size(); ++i)
+            right_partition_of_key[column->getInt(i)] = p;
+    }
+    EXPECT_EQ(right_rows, 1000);
+
+    size_t left_rows = 0;
+    for (size_t p = 0; p < partitions; ++p)
+    {
+        left_rows += left_blocks[p].rows();
+        const auto & column = left_blocks[p].getByPosition(0).column;
+        for (size_t i = 0; i < column->size(); ++i)
+        {
+            Field key = (*column)[i];
+            if (!key.isNull())
+                EXPECT_EQ(right_partition_of_key[key.safeGet<Int64>()], p);
+        }
+    }
+    EXPECT_EQ(left_rows, 2000);
+}
+
+namespace
+{
+std::shared_ptr<StorageJoinFromReadBuffer>
+buildStorageJoin(const Block & right, const Names & key_names, JoinKind kind, JoinStrictness strictness, size_t build_partitions)
+{
+    /// Several blocks like a broadcast relation, they are released by the partitioned build.
+    Blocks data;
+    for (size_t offset = 0; offset < right.rows(); offset += 300)
+        data.emplace_back(right.cloneWithCutColumns(offset, std::min<size_t>(300, right.rows() - offset)));
+    return std::make_shared<StorageJoinFromReadBuffer>(
+        data,
+        right.rows(),
+        key_names,
+        true,
+        kind,
+        strictness,
+        false,
+        ColumnsDescription(right.getNamesAndTypesList()),
+        ConstraintsDescription(),
+        "test_storage_join",
+        true,
+        false,
+        false,
+        build_partitions);
+}
+
+/// Each clause is a list of (left key, right key), like the ones collected by JoinRelParser.
+std::shared_ptr<TableJoin> analyzedJoin(
+    JoinKind kind, JoinStrictness strictness, const Block & right, const std::vector<std::vector<std::pair<String, String>>> & clauses)
+{
+    auto context = QueryContext::globalContext();
+    auto table_join
+        = std::make_shared<TableJoin>(context->getSettingsRef(), context->getGlobalTemporaryVolume(), context->getTempDataOnDisk());
+    table_join->setKind(kind);
+    table_join->setStrictness(strictness);
+    table_join->setColumnsFromJoinedTable(right.getNamesAndTypesList());
+    for (const auto & column : table_join->columnsFromJoinedTable())
+        table_join->addJoinedColumn(column);
+    for (const auto & keys : clauses)
+    {
+        table_join->addDisjunct();
+        for (const auto & [left_key, right_key] : keys)
+            table_join->getClauses().back().addKey(left_key, right_key, false);
+    }
+    return table_join;
+}
+
+/// Join the left block through a FilledJoinStep as JoinRelParser does, the rows are sorted since the partitioned join reorders them.
+std::vector<String> joinedRows(const JoinPtr & join, const Block & left)
+{
+    auto context = QueryContext::globalContext();
+    QueryPlan plan;
+    plan.addStep(std::make_unique<ReadFromPreparedSource>(Pipe(std::make_shared<SourceFromSingleChunk>(toShared(left)))));
+    plan.addStep(std::make_unique<FilledJoinStep>(plan.getCurrentHeader(), join, 8192));
+    auto pipeline = QueryPipelineBuilder::getPipeline(
+        std::move(*plan.buildQueryPipeline(QueryPlanOptimizationSettings{context}, BuildQueryPipelineSettings{context})));
+    PullingPipelineExecutor executor(pipeline);
+
+    std::vector<String> rows;
+    Block block;
+    while (executor.pull(block))
+    {
+        for (size_t row = 0; row < block.rows(); ++row)
+        {
+            String row_string;
+            for (const auto & column : block)
+                row_string += column.name + "=" + toString((*column.column)[row]) + ",";
+            rows.emplace_back(std::move(row_string));
+        }
+    }
+    std::ranges::sort(rows);
+    return rows;
+}
+}
+
+TEST(TestJoin, PartitionedStorageJoinSameAsSinglePartition)
+{
+    QueryContext::globalMutableContext()->setSetting("join_use_nulls", true);
+    auto & factory = DataTypeFactory::instance();
+
+    /// The right table has null keys and duplicated keys, r_k1 = i % 600 so that r_k2 is always r_k1 % 5.
+    auto right_k1_type = factory.get("Nullable(Int64)");
+    auto right_k2_type = factory.get("String");
+    auto value_type = factory.get("Int64");
+    auto right_k1 = right_k1_type->createColumn();
+    auto right_k2 = right_k2_type->createColumn();
+    auto right_v = value_type->createColumn();
+    for (Int64 i = 0; i < 2000; ++i)
+    {
+        right_k1->insert(i % 97 ? Field(i % 600) : Field());
+        right_k2->insert(std::to_string(i % 5));
+        right_v->insert(i);
+    }
+    Block right(
+        {ColumnWithTypeAndName(std::move(right_k1), right_k1_type, "r_k1"),
+         ColumnWithTypeAndName(std::move(right_k2), right_k2_type, "r_k2"),
+         ColumnWithTypeAndName(std::move(right_v), value_type, "r_v")});
+
+    /// The left keys are Nullable and LowCardinality(Nullable) with nulls, the keys' order differs from the right table.
+    auto left_k1_type = factory.get("Nullable(Int64)");
+    auto left_k2_type = factory.get("LowCardinality(Nullable(String))");
+    auto left_k2 = left_k2_type->createColumn();
+    auto left_v = value_type->createColumn();
+    auto left_k1 = left_k1_type->createColumn();
+    for (Int64 i = 0; i < 3000; ++i)
+    {
+        left_k2->insert(i % 31 ? Field(std::to_string(i % 6)) : Field());
+        left_v->insert(i);
+        left_k1->insert(i % 53 ? Field(i % 800) : Field());
+    }
+    Block left(
+        {ColumnWithTypeAndName(std::move(left_k2), left_k2_type, "l_k2"),
+         ColumnWithTypeAndName(std::move(left_v), value_type, "l_v"),
+         ColumnWithTypeAndName(std::move(left_k1), left_k1_type, "l_k1")});
+
+    const Names key_names{"r_k1", "r_k2"};
+    const std::vector<std::vector<std::pair<String, String>>> clauses{{{"l_k1", "r_k1"}, {"l_k2", "r_k2"}}};
+    for (const auto & [kind, strictness] : std::vector<std::pair<JoinKind, JoinStrictness>>{
+             {JoinKind::Inner, JoinStrictness::All},
+             {JoinKind::Left, JoinStrictness::All},
+             {JoinKind::Left, JoinStrictness::Semi},
+             {JoinKind::Left, JoinStrictness::Anti}})
+    {
+        const String join_name = fmt::format("{} {}", toString(kind), toString(strictness));
+        auto single = buildStorageJoin(right, key_names, kind, strictness, 1);
+        auto partitioned = buildStorageJoin(right, key_names, kind, strictness, 4);
+
+        auto single_join = single->getJoinLocked(analyzedJoin(kind, strictness, right, clauses), QueryContext::globalContext());
+        auto partitioned_join = partitioned->getJoinLocked(analyzedJoin(kind, strictness, right, clauses), QueryContext::globalContext());
+        EXPECT_EQ(partitioned_join->getName(), "PartitionedHashJoin") << join_name;
+        EXPECT_EQ(partitioned_join->getTotalRowCount(), single_join->getTotalRowCount()) << join_name;
+
+        auto expected = joinedRows(single_join, left);
+        EXPECT_FALSE(expected.empty()) << join_name;
+        EXPECT_EQ(joinedRows(partitioned_join, left), expected) << join_name;
+    }
+
+    /// Every join on clause must route a left row to the same partition, the clauses with different left keys are rejected.
+    auto partitioned = buildStorageJoin(right, key_names, JoinKind::Inner, JoinStrictness::All, 4);
+    const std::vector<std::vector<std::pair<String, String>>> different_left_keys{
+        {{"l_k1", "r_k1"}, {"l_k2", "r_k2"}}, {{"l_v", "r_k1"}, {"l_k2", "r_k2"}}};
+    EXPECT_THROW(
+        partitioned->getJoinLocked(
+            analyzedJoin(JoinKind::Inner, JoinStrictness::All, right, different_left_keys), QueryContext::globalContext()),
+        Exception);
+}
@@ -36,3 +36,22 @@ TEST(Hash, SparkMurmurHash3_32)
         EXPECT_EQ(static_cast<Int32>(result), -1346355085);
     }
 }
+
+TEST(Hash, SparkHashWords)
+{
+    std::vector<UInt64> words = {0, 1, 42, 0xc8, 0x7fffffff, 0x80000000, 0xffffffff, 0x123456789abcdefULL, 0xffffffffffffffffULL};
+    for (UInt64 seed : {UInt64(42), UInt64(0), UInt64(0xdeadbeef)})
+    {
+        for (UInt64 word : words)
+        {
+            auto word32 = static_cast<UInt32>(word);
+            EXPECT_EQ(SparkMurmurHash3_32::applyWord(word32, seed), SparkMurmurHash3_32::apply(reinterpret_cast<const char *>(&word32), 4, seed));
+            EXPECT_EQ(SparkMurmurHash3_32::applyWord(word, seed), SparkMurmurHash3_32::apply(reinterpret_cast<const char *>(&word), 8, seed));
+            EXPECT_EQ(SparkImplXxHash64::applyWord(word32, seed), SparkImplXxHash64::apply(reinterpret_cast<const char *>(&word32), 4, seed));
+            EXPECT_EQ(SparkImplXxHash64::applyWord(word, seed), SparkImplXxHash64::apply(reinterpret_cast<const char *>(&word), 8, seed));
+        }
+    }
+
+    /// hash(1) of Spark
+    EXPECT_EQ(static_cast<Int32>(SparkMurmurHash3_32::applyWord(UInt32(1), 42)), -559580957);
+}
@@ -17,13 +17,18 @@
 #include <incbin.h>
 #include <testConfig.h>
 #include <Core/Settings.h>
+#include <Functions/SparkFunctionGetJsonObject.h>
 #include <Interpreters/Context.h>
 #include <Parser/LocalExecutor.h>
 #include <Parser/ParserContext.h>
 #include <Parser/SerializedPlanParser.h>
 #include <Parser/SubstraitParserUtils.h>
 #include <Parser/TypeParser.h>
+#include <Processors/QueryPlan/ExpressionStep.h>
+#include <Processors/QueryPlan/FilterStep.h>
+#include <Processors/QueryPlan/QueryPlan.h>
 #include <QueryPipeline/QueryPipelineBuilder.h>
+#include <Rewriter/ExpressionRewriter.h>
 #include <gtest/gtest.h>
 #include <tests/utils/gluten_test_util.h>
 #include <Common/CHUtil.h>
@@ -100,3 +105,63 @@ TEST(TypeParser, SchemaTest)
     EXPECT_EQ(1, block.columns());
     debug::headBlock(block);
 }
+
+namespace
+{
+bool hasSharedJsonColumn(const Block & header)
+{
+    return std::ranges::any_of(header, [](const auto & column) { return ExpressionsRewriter::isHiddenColumn(column.name); });
+}
+
+size_t countFlattenJSONFunctions(const ActionsDAG & actions_dag)
+{
+    return std::ranges::count_if(
+        actions_dag.getNodes(),
+        [](const auto & node)
+        {
+            return node.type == ActionsDAG::ActionType::FUNCTION
+                && node.function_base->getName() == FlattenJSONStringOnRequiredFunction::name;
+        });
+}
+}
+
+/// filter(get_json_object(a, '$.b') = '1') -> project(get_json_object(a, '$.a'), id) -> aggregate(group by the first column)
+INCBIN(_shared_get_json_object_plan, SOURCE_DIR "/utils/extern-local-engine/tests/json/shared_get_json_object.json");
+TEST(ExpressionsRewriter, SharedGetJsonObject)
+{
+    const std::string split = R"({"items":[{"uriFile":"file:///foo","length":"84633","parquet":{},"schema":{},"metadataColumns":[{}]}]})";
+    const auto plan = local_engine::JsonStringToMessage<substrait::Plan>(EMBEDDED_PLAN(_shared_get_json_object_plan));
+    auto parser_context = ParserContext::build(QueryContext::globalContext(), plan);
+    SerializedPlanParser parser(parser_context);
+    parser.addSplitInfo(local_engine::JsonStringToBinary<substrait::ReadRel::LocalFiles>(split));
+    auto query_plan = parser.parse(plan);
+
+    size_t flatten_json_functions = 0;
+    bool filter_outputs_shared_json = false;
+    bool project_outputs_shared_json = true;
+    std::vector<const QueryPlan::Node *> nodes{query_plan->getRootNode()};
+    while (!nodes.empty())
+    {
+        const auto * node = nodes.back();
+        nodes.pop_back();
+        nodes.insert(nodes.end(), node->children.begin(), node->children.end());
+
+        if (const auto * filter_step = typeid_cast<const FilterStep *>(node->step.get()))
+        {
+            flatten_json_functions += countFlattenJSONFunctions(filter_step->getExpression());
+            filter_outputs_shared_json = hasSharedJsonColumn(*filter_step->getOutputHeader());
+        }
+        else if (const auto * expression_step = typeid_cast<const ExpressionStep *>(node->step.get()))
+        {
+            flatten_json_functions += countFlattenJSONFunctions(expression_step->getExpression());
+            if (expression_step->getStepDescription() == "Project")
+                project_outputs_shared_json = hasSharedJsonColumn(*expression_step->getOutputHeader());
+        }
+    }
+
+    /// The filter parses both paths into the hidden column, the project reads '$.a' from it and drops it before the aggregate
+    EXPECT_EQ(1, flatten_json_functions);
+    EXPECT_TRUE(filter_outputs_shared_json);
+    EXPECT_FALSE(project_outputs_shared_json);
+    EXPECT_FALSE(hasSharedJsonColumn(*query_plan->getCurrentHeader()));
+}
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include <Columns/ColumnNullable.h>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypeNullable.h>
+#include <Parser/TypeParser.h>
+#include <Shuffle/SelectorBuilder.h>
+#include <gtest/gtest.h>
+#include <fmt/ranges.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// A range bound value, and how it is written in the options json.
+struct RangeBound
+{
+    Field value;
+    String json;
+};
+
+String rangeOptions(const String & data_type, int direction, bool is_nullable, const std::vector<RangeBound> & bounds)
+{
+    std::vector<String> rows;
+    for (const auto & bound : bounds)
+        rows.push_back(fmt::format(R"([{{"is_null":false,"value":{}}}])", bound.json));
+    return fmt::format(
+        R"({{"ordering":[{{"column_ref":0,"column_name":"key","direction":{},"data_type":"{}","is_nullable":{}}}],)"
+        R"("range_bounds":[{}]}})",
+        direction,
+        data_type,
+        is_nullable,
+        fmt::join(rows, ","));
+}
+
+/// Check the normalized search against the generic comparator for all the sort directions and null orders, with and without
+/// nullable keys. ascending_bounds must be sorted ascending, the input contains the bounds and input_values.
+void expectSameAsBinarySearch(
+    const String & data_type, const std::vector<RangeBound> & ascending_bounds, const std::vector<Field> & input_values)
+{
+    auto type = TypeParser::getCHTypeByName(data_type);
+    auto column = type->createColumn();
+    for (const auto & bound : ascending_bounds)
+        column->insert(bound.value);
+    for (const auto & value : input_values)
+        column->insert(value);
+    ColumnPtr key_column = std::move(column);
+
+    auto null_map = ColumnUInt8::create(key_column->size(), 0);
+    for (size_t i = 3; i < key_column->size(); i += 7)
+        null_map->getData()[i] = 1;
+    ColumnPtr nullable_key_column = ColumnNullable::create(key_column, std::move(null_map));
+
+    /// 1, 2 are ascending and 3, 4 are descending, each with nulls first and last.
+    for (int direction = 1; direction <= 4; ++direction)
+    {
+        auto bounds = ascending_bounds;
+        if (direction > 2)
+            std::reverse(bounds.begin(), bounds.end());
+        for (bool is_nullable : {false, true})
+        {
+            RangeSelectorBuilder builder(rangeOptions(data_type, direction, is_nullable, bounds), bounds.size() + 1);
+            ASSERT_TRUE(builder.hasNormalizedBounds()) << data_type;
+            Block block({is_nullable ? ColumnWithTypeAndName(nullable_key_column, makeNullable(type), "key")
+                                     : ColumnWithTypeAndName(key_column, type, "key")});
+            IColumn::Selector normalized;
+            IColumn::Selector expected;
+            builder.computePartitionIdByNormalizedSearch(block, normalized);
+            builder.computePartitionIdByBinarySearch(block, expected);
+            ASSERT_EQ(normalized.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+                EXPECT_EQ(normalized[i], expected[i]) << data_type << ", direction: " << direction << ", nullable: " << is_nullable
+                                                      << ", row: " << i;
+        }
+    }
+}
+}
+
+TEST(EytzingerLowerBound, SameAsStdLowerBound)
+{
+    std::mt19937_64 rng(42);
+    for (size_t keys_num : {1, 2, 3, 7, 8, 100, 1023, 1024, 1025})
+    {
+        std::vector<UInt64> keys(keys_num);
+        for (auto & key : keys)
+            key = rng() % 10000;
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        EytzingerLowerBound search(keys);
+
+        std::vector<UInt64> values(1000);
+        for (auto & value : values)
+            value = rng() % 10100;
+        values.push_back(0);
+        values.push_back(std::numeric_limits<UInt64>::max());
+        std::vector<UInt64> results(values.size());
+        search.lowerBound(values.data(), results.data(), values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            auto expected = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), values[i]) - keys.begin());
+            EXPECT_EQ(search.lowerBound(values[i]), expected);
+            EXPECT_EQ(results[i], expected);
+        }
+    }
+}
+
+TEST(RangeSelectorBuilder, NormalizedSearchSameAsBinarySearchForNumbers)
+{
+    std::mt19937_64 rng(42);
+    std::vector<Int64> bound_values(64);
+    for (auto & value : bound_values)
+        value = static_cast<Int64>(rng() % 20000) - 10000;
+    std::sort(bound_values.begin(), bound_values.end());
+    bound_values.erase(std::unique(bound_values.begin(), bound_values.end()), bound_values.end());
+    std::vector<RangeBound> long_bounds;
+    for (auto value : bound_values)
+        long_bounds.push_back({Field(value), std::to_string(value)});
+    std::vector<Field> long_values;
+    for (size_t i = 0; i < 1000; ++i)
+        long_values.emplace_back(static_cast<Int64>(rng() % 22000) - 11000);
+    long_values.emplace_back(std::numeric_limits<Int64>::min());
+    long_values.emplace_back(std::numeric_limits<Int64>::max());
+    expectSameAsBinarySearch("LongType", long_bounds, long_values);
+
+    std::vector<RangeBound> double_bounds
+        = {{Field(-1e10), "-1e10"}, {Field(-2.5), "-2.5"}, {Field(0.0), "0.0"}, {Field(1.5), "1.5"}, {Field(1e300), "1e300"}};
+    std::vector<Field> double_values
+        = {Field(-0.0),
+           Field(std::numeric_limits<Float64>::quiet_NaN()),
+           Field(-std::numeric_limits<Float64>::quiet_NaN()),
+           Field(std::numeric_limits<Float64>::infinity()),
+           Field(-std::numeric_limits<Float64>::infinity()),
+           Field(-3.0),
+           Field(1.0),
+           Field(2.0),
+           Field(std::numeric_limits<Float64>::denorm_min())};
+    expectSameAsBinarySearch("DoubleType", double_bounds, double_values);
+}
+
+TEST(RangeSelectorBuilder, NormalizedSearchSameAsBinarySearchForStrings)
+{
+    /// Many bounds share the first 8 bytes, they are only told apart by the generic comparator.
+    std::vector<String> bound_values = {"", "a", "abcdefgh", "abcdefgh0", "abcdefgh1", "abcdefgh2", "abcdefghz", "b"};
+    std::vector<RangeBound> bounds;
+    for (const auto & value : bound_values)
+        bounds.push_back({Field(value), "\"" + value + "\""});
+    std::vector<Field> values
+        = {Field(String("abcdefg")),
+           Field(String("abcdefgh")),
+           Field(String("abcdefgh00")),
+           Field(String("abcdefgh10")),
+           Field(String("abcdefgh3")),
+           Field(String("abcdefgi")),
+           Field(String("b")),
+           Field(String("b\0\0", 3)),
+           Field(String("c")),
+           Field(String(""))};
+    expectSameAsBinarySearch("StringType", bounds, values);
+}
+
+TEST(RangeSelectorBuilder, NormalizedSearchSameAsBinarySearchForDecimalsAndDates)
+{
+    std::vector<RangeBound> decimal_bounds
+        = {{Field(DecimalField<Decimal64>(-123456, 2)), "\"-1234.56\""},
+           {Field(DecimalField<Decimal64>(0, 2)), "\"0.00\""},
+           {Field(DecimalField<Decimal64>(1050, 2)), "\"10.50\""},
+           {Field(DecimalField<Decimal64>(99999999, 2)), "\"999999.99\""}};
+    std::vector<Field> decimal_values;
+    for (Int64 value : {-999999999L, -123457L, -1L, 1049L, 1051L, 99999998L, 9999999999L})
+        decimal_values.emplace_back(DecimalField<Decimal64>(value, 2));
+    expectSameAsBinarySearch("DecimalType(12,2)", decimal_bounds, decimal_values);
+
+    std::vector<RangeBound> date_bounds = {{Field(-719162), "-719162"}, {Field(0), "0"}, {Field(19000), "19000"}};
+    std::vector<Field> date_values = {Field(-719163), Field(-1), Field(1), Field(18999), Field(19001), Field(2932896)};
+    expectSameAsBinarySearch("DateType", date_bounds, date_values);
+
+    std::vector<RangeBound> timestamp_bounds
+        = {{Field(DecimalField<DateTime64>(-1000000, 6)), "-1000000"},
+           {Field(DecimalField<DateTime64>(0, 6)), "0"},
+           {Field(DecimalField<DateTime64>(1700000000000000, 6)), "1700000000000000"}};
+    std::vector<Field> timestamp_values;
+    for (Int64 value : {-1000001L, -999999L, 1L, 1699999999999999L, 1700000000000001L})
+        timestamp_values.emplace_back(DecimalField<DateTime64>(value, 6));
+    expectSameAsBinarySearch("TimestampType", timestamp_bounds, timestamp_values);
+}
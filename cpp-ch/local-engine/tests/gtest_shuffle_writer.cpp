@@ -0,0 +1,239 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <Columns/ColumnsNumber.h>
+#include <Compression/CompressedReadBuffer.h>
+#include <IO/ReadBufferFromString.h>
+#include <Shuffle/PartitionWriter.h>
+#include <Shuffle/SelectorBuilder.h>
+#include <Storages/IO/NativeReader.h>
+#include <gtest/gtest.h>
+#include <jni/CelebornClient.h>
+#include <Common/BlockTypeUtils.h>
+#include <Common/assert_cast.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+/// The data pushed to each partition, shared by the clients cloned from one client.
+struct PushedPartitions
+{
+    explicit PushedPartitions(size_t partitions) : data(partitions) { }
+
+    std::vector<std::vector<String>> data;
+    /// The pushes in progress of all the partitions, they must never overlap.
+    std::atomic<size_t> pushing = 0;
+    std::atomic<size_t> overlapped_pushes = 0;
+    /// The partition ids in push order.
+    std::vector<size_t> order;
+};
+
+/// Keeps the pushed data in memory instead of pushing it to Celeborn.
+class MemoryCelebornClient final : public CelebornClient
+{
+public:
+    explicit MemoryCelebornClient(
+        std::shared_ptr<PushedPartitions> pushed_, std::shared_ptr<std::mutex> push_mutex_ = std::make_shared<std::mutex>())
+        : CelebornClient(std::move(push_mutex_)), pushed(std::move(pushed_))
+    {
+    }
+
+    std::unique_ptr<CelebornClient> clone() const override { return std::make_unique<MemoryCelebornClient>(pushed, push_mutex); }
+
+protected:
+    /// Not synchronized by itself like the Celeborn shuffle client, it relies on the push lock of CelebornClient.
+    size_t push(size_t partition_id, char * bytes, size_t size) override
+    {
+        if (pushed->pushing++)
+            ++pushed->overlapped_pushes;
+        /// Widen the window, so that the pushes without the lock would overlap.
+        std::this_thread::yield();
+        pushed->data[partition_id].emplace_back(bytes, size);
+        pushed->order.push_back(partition_id);
+        --pushed->pushing;
+        return size;
+    }
+
+private:
+    std::shared_ptr<PushedPartitions> pushed;
+};
+
+/// Decode the compressed native blocks of the pushes, and return the values of the first column.
+std::vector<Int64> readPushedValues(const std::vector<String> & pushes)
+{
+    std::vector<Int64> values;
+    for (const auto & data : pushes)
+    {
+        ReadBufferFromString in(data);
+        CompressedReadBuffer compressed_in(in);
+        NativeReader reader(compressed_in);
+        for (auto block = reader.read(); block.rows(); block = reader.read())
+        {
+            const auto & column = *block.getByPosition(0).column;
+            for (size_t i = 0; i < column.size(); ++i)
+                values.push_back(column.getInt(i));
+        }
+    }
+    return values;
+}
+
+Block idBlock(Int64 first_id, size_t rows)
+{
+    auto column = ColumnInt64::create(rows);
+    std::iota(column->getData().begin(), column->getData().end(), first_id);
+    return Block{{std::move(column), BIGINT(), "id"}};
+}
+}
+
+TEST(CelebornPartitionWriter, MultipleSinksPushConcurrently)
+{
+    constexpr size_t sinks = 4;
+    constexpr size_t partitions = 16;
+    constexpr size_t blocks_per_sink = 8;
+    constexpr size_t block_rows = 1000;
+
+    SplitOptions options;
+    options.partition_num = partitions;
+    /// Evict several times while writing, so that the sinks push at the same time.
+    options.spill_threshold = 16 * 1024;
+
+    auto pushed = std::make_shared<PushedPartitions>(partitions);
+    MemoryCelebornClient client(pushed);
+    const Block header = idBlock(0, 0);
+    std::vector<SplitResult> split_results(sinks);
+    std::vector<std::shared_ptr<PartitionWriter>> writers;
+    for (size_t i = 0; i < sinks; ++i)
+    {
+        if (i % 2)
+            writers.emplace_back(std::make_shared<CelebornPartitionWriter>(options, client.clone()));
+        else
+            writers.emplace_back(std::make_shared<MemorySortCelebornPartitionWriter>(options, client.clone()));
+        writers.back()->initialize(&split_results[i], header);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t sink = 0; sink < sinks; ++sink)
+    {
+        threads.emplace_back(
+            [&, sink]
+            {
+                for (size_t i = 0; i < blocks_per_sink; ++i)
+                {
+                    auto block = idBlock((sink * blocks_per_sink + i) * block_rows, block_rows);
+                    const auto & ids = assert_cast<const ColumnInt64 &>(*block.getByPosition(0).column).getData();
+                    IColumn::Selector selector(block_rows);
+                    for (size_t row = 0; row < block_rows; ++row)
+                        selector[row] = ids[row] % partitions;
+                    writers[sink]->write(PartitionInfo::fromSelector(std::move(selector), partitions, false), block);
+                }
+                writers[sink]->evictPartitions();
+            });
+    }
+    for (auto & thread : threads)
+        thread.join();
+
+    EXPECT_EQ(0, pushed->overlapped_pushes.load());
+    std::vector<Int64> all_ids;
+    for (size_t partition_id = 0; partition_id < partitions; ++partition_id)
+    {
+        UInt64 pushed_bytes = 0;
+        for (const auto & data : pushed->data[partition_id])
+            pushed_bytes += data.size();
+        UInt64 written_bytes = 0;
+        for (const auto & split_result : split_results)
+            written_bytes += split_result.partition_lengths[partition_id];
+        EXPECT_EQ(written_bytes, pushed_bytes) << partition_id;
+
+        for (auto id : readPushedValues(pushed->data[partition_id]))
+        {
+            EXPECT_EQ(partition_id, id % partitions);
+            all_ids.push_back(id);
+        }
+    }
+    std::ranges::sort(all_ids);
+    std::vector<Int64> expected_ids(sinks * blocks_per_sink * block_rows);
+    std::iota(expected_ids.begin(), expected_ids.end(), 0);
+    EXPECT_EQ(expected_ids, all_ids);
+}
+
+TEST(MemorySortPartitionWriter, GroupRowsByPartition)
+{
+    constexpr size_t partitions = 64;
+    SplitOptions options;
+    options.partition_num = partitions;
+    options.spill_threshold = 0;
+    /// Less rows than a partition has in a block, so the rows of a partition are written in several blocks.
+    options.split_size = 16;
+
+    auto pushed = std::make_shared<PushedPartitions>(partitions);
+    SplitResult split_result;
+    MemorySortCelebornPartitionWriter writer(options, std::make_unique<MemoryCelebornClient>(pushed));
+    writer.initialize(&split_result, idBlock(0, 0));
+
+    std::vector<std::vector<Int64>> expected(partitions);
+    Int64 next_id = 0;
+    auto write = [&](size_t rows, const std::function<size_t(Int64)> & partition_of)
+    {
+        auto block = idBlock(next_id, rows);
+        IColumn::Selector selector(rows);
+        for (size_t row = 0; row < rows; ++row, ++next_id)
+        {
+            selector[row] = partition_of(next_id);
+            expected[selector[row]].push_back(next_id);
+        }
+        writer.write(PartitionInfo::fromSelector(std::move(selector), partitions, false), block);
+    };
+    /// Every eviction pushes each non-empty partition once, in ascending partition id.
+    size_t pushed_before = 0;
+    auto evict = [&]()
+    {
+        writer.evictPartitions();
+        std::vector<size_t> evicted(pushed->order.begin() + pushed_before, pushed->order.end());
+        pushed_before = pushed->order.size();
+        EXPECT_FALSE(evicted.empty());
+        EXPECT_TRUE(std::ranges::adjacent_find(evicted, std::ranges::greater_equal{}) == evicted.end());
+    };
+
+    /// The writer runs on a thread out of any thread group, so it only evicts when it's asked to. Only the partitions
+    /// which are multiples of 3 get rows, the others stay empty.
+    std::thread(
+        [&]
+        {
+            write(300, [](Int64 id) { return id % 20 * 3; });
+            write(10, [](Int64) { return 9; });
+            write(200, [](Int64 id) { return id % 7 * 3; });
+            evict();
+            write(300, [](Int64 id) { return (id * 13) % 20 * 3; });
+            evict();
+        })
+        .join();
+
+    for (size_t partition_id = 0; partition_id < partitions; ++partition_id)
+    {
+        if (expected[partition_id].empty())
+            EXPECT_TRUE(pushed->data[partition_id].empty()) << partition_id;
+        /// The rows of a partition keep their input order across the blocks and the evictions.
+        EXPECT_EQ(expected[partition_id], readPushedValues(pushed->data[partition_id])) << partition_id;
+    }
+}
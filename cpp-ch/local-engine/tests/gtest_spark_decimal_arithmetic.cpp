@@ -0,0 +1,226 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "config.h"
+
+#include <Columns/ColumnDecimal.h>
+#include <DataTypes/DataTypesDecimal.h>
+#include <Functions/FunctionFactory.h>
+#include <Functions/SparkFunctionDecimalBinaryArithmetic.h>
+#include <gtest/gtest.h>
+#include <Common/QueryContext.h>
+#include <Common/assert_cast.h>
+
+#if USE_EMBEDDED_COMPILER
+#include <Interpreters/JIT/CHJIT.h>
+#include <Interpreters/JIT/compileFunction.h>
+#endif
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+ColumnWithTypeAndName decimalColumn(UInt32 precision, UInt32 scale, const std::vector<Int64> & values, const String & name)
+{
+    auto column = ColumnDecimal<Decimal64>::create(0, scale);
+    for (auto value : values)
+        column->getData().push_back(value);
+    return ColumnWithTypeAndName(std::move(column), std::make_shared<DataTypeDecimal64>(precision, scale), name);
+}
+
+/// The third argument only gives the result type.
+template <typename ResultDataType>
+ColumnsWithTypeAndName arithmeticArguments(
+    const ColumnWithTypeAndName & left, const ColumnWithTypeAndName & right, UInt32 result_precision, UInt32 result_scale)
+{
+    auto type = std::make_shared<ResultDataType>(result_precision, result_scale);
+    return {left, right, ColumnWithTypeAndName(type->createColumnConstWithDefaultValue(left.column->size()), type, "result")};
+}
+
+void expectSameRows(const IColumn & expected, const IColumn & result, const String & path)
+{
+    ASSERT_EQ(expected.size(), result.size()) << path;
+    for (size_t i = 0; i < expected.size(); ++i)
+        EXPECT_EQ(expected[i], result[i]) << path << " at row " << i;
+}
+
+/// The interpreted and the JIT paths of the function must both calculate the arguments with Int64, and get the same results as
+/// calculating them with WideType.
+template <typename Operation, typename ResultDataType, typename WideType = Int128>
+ColumnPtr executeWithInt64(const String & function_name, const ColumnsWithTypeAndName & arguments)
+{
+    using Calculation = SparkDecimalBinaryOperation<Operation, OpMode::Default>;
+    const auto & left_type = assert_cast<const DataTypeDecimal64 &>(*arguments[0].type);
+    const auto & right_type = assert_cast<const DataTypeDecimal64 &>(*arguments[1].type);
+    const auto & result_type = assert_cast<const ResultDataType &>(*arguments[2].type);
+    EXPECT_TRUE(Calculation::canCalculateWithInt64(left_type, right_type, result_type)) << function_name;
+
+    const size_t rows = arguments[0].column->size();
+    auto expected = Calculation::template executeDecimalImpl<DataTypeDecimal64, DataTypeDecimal64, ResultDataType, WideType>(
+        arguments, left_type, right_type, result_type);
+
+    auto function = FunctionFactory::instance().get(function_name, QueryContext::globalContext())->build(arguments);
+    auto result = function->execute(arguments, function->getResultType(), rows, false);
+    expectSameRows(*expected, *result, function_name + " interpreted");
+
+#if USE_EMBEDDED_COMPILER
+    EXPECT_TRUE(function->isCompilable()) << function_name;
+    CHJIT jit;
+    auto compiled = compileFunction(jit, *function);
+    auto jit_result = function->getResultType()->createColumn()->cloneResized(rows);
+    std::vector<ColumnData> columns;
+    Columns full_columns;
+    for (const auto & argument : arguments)
+    {
+        full_columns.emplace_back(argument.column->convertToFullColumnIfConst());
+        columns.emplace_back(getColumnData(full_columns.back().get()));
+    }
+    columns.emplace_back(getColumnData(jit_result.get()));
+    compiled.compiled_function(rows, columns.data());
+    jit.deleteCompiledModule(compiled.compiled_module);
+    expectSameRows(*expected, *jit_result, function_name + " jit");
+#endif
+
+    return result;
+}
+}
+
+TEST(SparkDecimalArithmetic, CanCalculateWithInt64UpTo18Digits)
+{
+    using Plus = SparkDecimalBinaryOperation<DecimalPlusImpl, OpMode::Default>;
+    using Multiply = SparkDecimalBinaryOperation<DecimalMultiplyImpl, OpMode::Default>;
+    using Divide = SparkDecimalBinaryOperation<DecimalDivideImpl, OpMode::Default>;
+
+    EXPECT_TRUE(Plus::canCalculateWithInt64(DataTypeDecimal64(17, 0), DataTypeDecimal64(17, 0), DataTypeDecimal64(18, 0)));
+    EXPECT_FALSE(Plus::canCalculateWithInt64(DataTypeDecimal64(18, 0), DataTypeDecimal64(1, 0), DataTypeDecimal128(19, 0)));
+    /// The scale of the result widens the operands
+    EXPECT_FALSE(Plus::canCalculateWithInt64(DataTypeDecimal64(17, 0), DataTypeDecimal64(10, 0), DataTypeDecimal64(18, 1)));
+
+    EXPECT_TRUE(Multiply::canCalculateWithInt64(DataTypeDecimal64(9, 2), DataTypeDecimal64(9, 4), DataTypeDecimal128(19, 6)));
+    EXPECT_FALSE(Multiply::canCalculateWithInt64(DataTypeDecimal64(9, 2), DataTypeDecimal64(10, 4), DataTypeDecimal128(20, 6)));
+
+    /// The dividend is scaled up twice by the max scale
+    EXPECT_TRUE(Divide::canCalculateWithInt64(DataTypeDecimal64(5, 2), DataTypeDecimal64(3, 1), DataTypeDecimal64(10, 6)));
+    EXPECT_FALSE(Divide::canCalculateWithInt64(DataTypeDecimal64(9, 2), DataTypeDecimal64(3, 1), DataTypeDecimal64(14, 6)));
+}
+
+TEST(SparkDecimalArithmetic, Int64SameAsWiderTypes)
+{
+    constexpr Int64 max17 = 99999999999999999;
+    constexpr Int64 max9 = 999999999;
+
+    /// The result precision is 18 digits, just not overflowed
+    auto plus = executeWithInt64<DecimalPlusImpl, DataTypeDecimal64>(
+        "sparkDecimalPlus",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(17, 0, {max17, -max17, 5}, "left"), decimalColumn(17, 0, {max17, -max17, -7}, "right"), 18, 0));
+    EXPECT_EQ((*plus)[0], Field(DecimalField<Decimal64>(2 * max17, 0)));
+    EXPECT_EQ((*plus)[1], Field(DecimalField<Decimal64>(-2 * max17, 0)));
+
+    /// The result precision is beyond 18 digits, but the product of two 9 digits operands still fits in Int64
+    auto multiply = executeWithInt64<DecimalMultiplyImpl, DataTypeDecimal128>(
+        "sparkDecimalMultiply",
+        arithmeticArguments<DataTypeDecimal128>(
+            decimalColumn(9, 2, {max9, -max9, 123456789, 0}, "left"), decimalColumn(9, 4, {max9, max9, -987654321, 5}, "right"), 19, 6));
+    EXPECT_EQ((*multiply)[0], Field(DecimalField<Decimal128>(Int128(max9) * max9, 6)));
+    EXPECT_EQ((*multiply)[1], Field(DecimalField<Decimal128>(-Int128(max9) * max9, 6)));
+
+    executeWithInt64<DecimalMinusImpl, DataTypeDecimal64>(
+        "sparkDecimalMinus",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(16, 2, {max17 / 10, -max17 / 10, 1}, "left"),
+            decimalColumn(16, 1, {-max17 / 10, max17 / 10, 3}, "right"),
+            18,
+            2));
+
+    executeWithInt64<DecimalModuloImpl, DataTypeDecimal64>(
+        "sparkDecimalModulo",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(10, 2, {max9, -max9, 12345, 7}, "left"), decimalColumn(5, 3, {3, 7, -999, 0}, "right"), 5, 3));
+}
+
+TEST(SparkDecimalArithmetic, Int64RescaleResult)
+{
+    /// 1.23 + 0.0199 = 1.2499, and 123.45 * 0.0101 = 1.246845, the extra digits are truncated to the result scale of 2
+    auto plus = executeWithInt64<DecimalPlusImpl, DataTypeDecimal64>(
+        "sparkDecimalPlus",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(10, 2, {123, -123}, "left"), decimalColumn(10, 4, {199, -199}, "right"), 12, 2));
+    EXPECT_EQ((*plus)[0], Field(DecimalField<Decimal64>(124, 2)));
+    EXPECT_EQ((*plus)[1], Field(DecimalField<Decimal64>(-124, 2)));
+
+    auto multiply = executeWithInt64<DecimalMultiplyImpl, DataTypeDecimal64>(
+        "sparkDecimalMultiply",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(9, 2, {12345, -12345}, "left"), decimalColumn(9, 4, {101, 101}, "right"), 10, 2));
+    EXPECT_EQ((*multiply)[0], Field(DecimalField<Decimal64>(124, 2)));
+    EXPECT_EQ((*multiply)[1], Field(DecimalField<Decimal64>(-124, 2)));
+
+    /// 1.00 / 3.0 and 2.00 / 3.0 with 6 digits scale
+    auto divide = executeWithInt64<DecimalDivideImpl, DataTypeDecimal64>(
+        "sparkDecimalDivide",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(5, 2, {100, 200, -200, 99999}, "left"), decimalColumn(3, 1, {30, 30, 30, 1}, "right"), 10, 6));
+    EXPECT_EQ((*divide)[0], Field(DecimalField<Decimal64>(333333, 6)));
+    EXPECT_EQ((*divide)[3], Field(DecimalField<Decimal64>(9999900000, 6)));
+
+    /// Same operands with a result precision beyond 18 digits
+    executeWithInt64<DecimalDivideImpl, DataTypeDecimal128>(
+        "sparkDecimalDivide",
+        arithmeticArguments<DataTypeDecimal128>(
+            decimalColumn(5, 2, {100, 200, -200, 99999}, "left"), decimalColumn(3, 1, {30, 30, 30, 1}, "right"), 19, 6));
+}
+
+TEST(SparkDecimalArithmetic, Int64OverflowAndDivideByZero)
+{
+    constexpr Int64 max17 = 99999999999999999;
+    constexpr Int64 max9 = 999999999;
+
+    /// Calculating with Int128 doesn't check the overflow of plus and multiply, their overflow is compared with Int256 instead.
+    auto plus = executeWithInt64<DecimalPlusImpl, DataTypeDecimal64, Int256>(
+        "sparkDecimalPlus",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(17, 0, {max17, -max17, max17}, "left"), decimalColumn(17, 0, {1, -1, 0}, "right"), 17, 0));
+    EXPECT_TRUE((*plus)[0].isNull());
+    EXPECT_TRUE((*plus)[1].isNull());
+    EXPECT_EQ((*plus)[2], Field(DecimalField<Decimal64>(max17, 0)));
+
+    auto multiply = executeWithInt64<DecimalMultiplyImpl, DataTypeDecimal64, Int256>(
+        "sparkDecimalMultiply",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(9, 2, {max9, -max9, 12345}, "left"), decimalColumn(9, 4, {max9, max9, 101}, "right"), 10, 2));
+    EXPECT_TRUE((*multiply)[0].isNull());
+    EXPECT_TRUE((*multiply)[1].isNull());
+    EXPECT_FALSE((*multiply)[2].isNull());
+
+    auto divide = executeWithInt64<DecimalDivideImpl, DataTypeDecimal64>(
+        "sparkDecimalDivide",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(5, 2, {99999, 100, 100, -99999, 0}, "left"), decimalColumn(3, 2, {1, 3, 0, -1, 0}, "right"), 6, 2));
+    EXPECT_TRUE((*divide)[0].isNull());
+    EXPECT_EQ((*divide)[1], Field(DecimalField<Decimal64>(3333, 2)));
+    EXPECT_TRUE((*divide)[2].isNull());
+    EXPECT_TRUE((*divide)[3].isNull());
+    EXPECT_TRUE((*divide)[4].isNull());
+
+    auto modulo = executeWithInt64<DecimalModuloImpl, DataTypeDecimal64>(
+        "sparkDecimalModulo",
+        arithmeticArguments<DataTypeDecimal64>(
+            decimalColumn(10, 2, {12345, 12345}, "left"), decimalColumn(5, 3, {0, 1000}, "right"), 5, 3));
+    EXPECT_TRUE((*modulo)[0].isNull());
+    EXPECT_EQ((*modulo)[1], Field(DecimalField<Decimal64>(450, 3)));
+}
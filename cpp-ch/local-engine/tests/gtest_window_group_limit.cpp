@@ -0,0 +1,249 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <list>
+#include <map>
+#include <Columns/ColumnsNumber.h>
+#include <DataTypes/DataTypesNumber.h>
+#include <Interpreters/Context.h>
+#include <Operator/HashWindowGroupLimitStep.h>
+#include <Processors/Executors/PullingPipelineExecutor.h>
+#include <Processors/ISource.h>
+#include <Processors/QueryPlan/Optimizations/QueryPlanOptimizationSettings.h>
+#include <Processors/QueryPlan/QueryPlan.h>
+#include <Processors/QueryPlan/ReadFromPreparedSource.h>
+#include <Processors/Sources/SourceFromSingleChunk.h>
+#include <QueryPipeline/Pipe.h>
+#include <QueryPipeline/QueryPipeline.h>
+#include <QueryPipeline/QueryPipelineBuilder.h>
+#include <gtest/gtest.h>
+#include <Common/BlockTypeUtils.h>
+#include <Common/QueryContext.h>
+
+using namespace DB;
+using namespace local_engine;
+
+namespace
+{
+using WindowResult = std::map<Int32, std::vector<std::pair<Int32, Int32>>>;
+
+Block buildBlock(const std::vector<std::pair<Int32, Int32>> & input, size_t offset, size_t length)
+{
+    auto int_type = std::make_shared<DataTypeInt32>();
+    auto key_column = ColumnInt32::create();
+    auto value_column = ColumnInt32::create();
+    for (size_t i = offset; i < offset + length; ++i)
+    {
+        key_column->insertValue(input[i].first);
+        value_column->insertValue(input[i].second);
+    }
+    ColumnsWithTypeAndName columns
+        = {ColumnWithTypeAndName(std::move(key_column), int_type, "key"), ColumnWithTypeAndName(std::move(value_column), int_type, "value")};
+    return Block(columns);
+}
+
+SortDescription valueDescending()
+{
+    SortDescription sort_description;
+    sort_description.emplace_back("value", -1, 1);
+    return sort_description;
+}
+
+/// Collect the (value, rank) pairs of each key, the rows of one key are emitted together in order of the value.
+WindowResult pullResult(QueryPipeline & pipeline)
+{
+    PullingPipelineExecutor executor(pipeline);
+    WindowResult result;
+    Block res;
+    while (executor.pull(res))
+    {
+        for (size_t i = 0; i < res.rows(); ++i)
+        {
+            auto key = static_cast<Int32>(res.getByPosition(0).column->getInt(i));
+            auto value = static_cast<Int32>(res.getByPosition(1).column->getInt(i));
+            auto rank = static_cast<Int32>(res.getByPosition(2).column->getInt(i));
+            result[key].emplace_back(value, rank);
+        }
+    }
+    return result;
+}
+
+/// Run the hash topk over (key, value) pairs which are ordered by value descending in each key. The input is split into
+/// num_streams sources.
+WindowResult runHashWindowGroupLimit(
+    const String & function_name, size_t limit, const std::vector<std::pair<Int32, Int32>> & input, size_t num_streams = 1)
+{
+    auto context = QueryContext::globalContext();
+    Pipes pipes;
+    size_t stream_rows = (input.size() + num_streams - 1) / num_streams;
+    for (size_t offset = 0; offset < input.size(); offset += stream_rows)
+    {
+        auto block = buildBlock(input, offset, std::min(stream_rows, input.size() - offset));
+        pipes.emplace_back(std::make_shared<SourceFromSingleChunk>(toShared(block)));
+    }
+
+    QueryPlan plan;
+    plan.addStep(std::make_unique<ReadFromPreparedSource>(Pipe::unitePipes(std::move(pipes))));
+    plan.addStep(std::make_unique<HashWindowGroupLimitStep>(
+        context, plan.getCurrentHeader(), function_name, std::vector<size_t>{0}, valueDescending(), limit, "rank"));
+
+    auto pipeline = plan.buildQueryPipeline(QueryPlanOptimizationSettings{context}, BuildQueryPipelineSettings{context});
+    auto executable_pipe = QueryPipelineBuilder::getPipeline(std::move(*pipeline));
+    executable_pipe.setNumThreads(num_streams);
+    return pullResult(executable_pipe);
+}
+
+/// Asks the transform to spill before each chunk is pushed to it, so every chunk after the first one spills a bucket.
+class SpillingChunksSource : public ISource
+{
+public:
+    SpillingChunksSource(SharedHeader header_, std::list<Chunk> chunks_, IProcessor * spill_target_)
+        : ISource(header_), chunks(std::move(chunks_)), spill_target(spill_target_)
+    {
+    }
+    String getName() const override { return "SpillingChunksSource"; }
+
+protected:
+    Chunk generate() override
+    {
+        if (chunks.empty())
+            return {};
+        if (spill_target)
+            spill_target->spillOnSize(1);
+        auto chunk = std::move(chunks.front());
+        chunks.pop_front();
+        return chunk;
+    }
+
+private:
+    std::list<Chunk> chunks;
+    IProcessor * spill_target;
+};
+
+WindowResult runHashWindowGroupLimitTransform(
+    const String & function_name, size_t limit, const std::vector<std::pair<Int32, Int32>> & input, size_t chunk_rows, bool spill)
+{
+    auto context = QueryContext::globalContext();
+    auto header = toShared(buildBlock(input, 0, 0));
+    std::list<Chunk> chunks;
+    for (size_t offset = 0; offset < input.size(); offset += chunk_rows)
+    {
+        auto block = buildBlock(input, offset, std::min(chunk_rows, input.size() - offset));
+        chunks.emplace_back(block.getColumns(), block.rows());
+    }
+
+    auto output_header = toShared(HashWindowGroupLimitStep::buildOutputHeader(*header, "rank"));
+    auto transform = std::make_shared<HashWindowGroupLimitTransform>(
+        context,
+        header,
+        output_header,
+        HashWindowGroupLimitTransform::parseRankFunction(function_name),
+        std::vector<size_t>{0},
+        valueDescending(),
+        limit);
+    Pipe pipe(std::make_shared<SpillingChunksSource>(header, std::move(chunks), spill ? transform.get() : nullptr));
+    pipe.addTransform(transform);
+    QueryPipeline pipeline(std::move(pipe));
+    return pullResult(pipeline);
+}
+
+std::vector<std::pair<Int32, Int32>> buildInput()
+{
+    std::vector<std::pair<Int32, Int32>> input;
+    for (Int32 i = 0; i < 10000; ++i)
+        input.emplace_back(i % 97, (i * 7919) % 13);
+    return input;
+}
+}
+
+TEST(HashWindowGroupLimit, RowNumber)
+{
+    auto result = runHashWindowGroupLimit("row_number", 3, buildInput());
+    ASSERT_EQ(result.size(), 97);
+    for (const auto & [key, rows] : result)
+    {
+        ASSERT_EQ(rows.size(), 3);
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            EXPECT_EQ(rows[i].second, static_cast<Int32>(i + 1));
+            EXPECT_EQ(rows[i].first, 12);
+        }
+    }
+}
+
+TEST(HashWindowGroupLimit, RankAndDenseRank)
+{
+    auto input = buildInput();
+    std::map<Int32, std::vector<Int32>> expected_values;
+    for (const auto & [key, value] : input)
+        expected_values[key].push_back(value);
+
+    auto rank_result = runHashWindowGroupLimit("rank", 4, input);
+    auto dense_rank_result = runHashWindowGroupLimit("dense_rank", 4, input);
+    ASSERT_EQ(rank_result.size(), expected_values.size());
+    ASSERT_EQ(dense_rank_result.size(), expected_values.size());
+    for (auto & [key, values] : expected_values)
+    {
+        std::sort(values.begin(), values.end(), std::greater<Int32>());
+        std::vector<std::pair<Int32, Int32>> expected_rank;
+        std::vector<std::pair<Int32, Int32>> expected_dense_rank;
+        Int32 rank = 0;
+        Int32 dense_rank = 0;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (!i || values[i] != values[i - 1])
+            {
+                rank = static_cast<Int32>(i + 1);
+                dense_rank++;
+            }
+            if (rank <= 4)
+                expected_rank.emplace_back(values[i], rank);
+            if (dense_rank <= 4)
+                expected_dense_rank.emplace_back(values[i], dense_rank);
+        }
+        EXPECT_EQ(rank_result[key], expected_rank);
+        EXPECT_EQ(dense_rank_result[key], expected_dense_rank);
+    }
+}
+
+TEST(HashWindowGroupLimit, SpilledSameAsInMemory)
+{
+    /// Many partitions with ties, so that every bucket has rows in each chunk and the ranks depend on the spilled rows.
+    std::vector<std::pair<Int32, Int32>> input;
+    for (Int32 i = 0; i < 50000; ++i)
+        input.emplace_back((i * 31) % 1013, (i * 7919) % 37);
+
+    for (const auto * function_name : {"row_number", "rank", "dense_rank"})
+    {
+        auto in_memory = runHashWindowGroupLimitTransform(function_name, 5, input, 1000, false);
+        auto spilled = runHashWindowGroupLimitTransform(function_name, 5, input, 1000, true);
+        ASSERT_EQ(in_memory.size(), 1013) << function_name;
+        EXPECT_EQ(spilled, in_memory) << function_name;
+    }
+}
+
+TEST(HashWindowGroupLimit, MultipleStreams)
+{
+    auto input = buildInput();
+    for (const auto * function_name : {"row_number", "rank", "dense_rank"})
+    {
+        auto single_stream = runHashWindowGroupLimit(function_name, 4, input);
+        auto multiple_streams = runHashWindowGroupLimit(function_name, 4, input, 4);
+        ASSERT_EQ(single_stream.size(), 97) << function_name;
+        EXPECT_EQ(multiple_streams, single_stream) << function_name;
+    }
+}
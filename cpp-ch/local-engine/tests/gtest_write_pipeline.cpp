@@ -15,9 +15,11 @@
  * limitations under the License.
  */
 
+#include <filesystem>
 #include <incbin.h>
 #include <testConfig.h>
 #include <Core/Settings.h>
+#include <DataTypes/DataTypesDecimal.h>
 #include <Disks/ObjectStorages/HDFS/HDFSObjectStorage.h>
 #include <Interpreters/Context.h>
 #include <Interpreters/ExpressionActions.h>
@@ -36,6 +38,8 @@
 #include <substrait/plan.pb.h>
 #include <tests/utils/gluten_test_util.h>
 #include <Poco/StringTokenizer.h>
+#include <Poco/Util/LayeredConfiguration.h>
+#include <Poco/Util/MapConfiguration.h>
 #include <Common/DebugUtils.h>
 #include <Common/QueryContext.h>
 
@@ -240,4 +244,131 @@ TEST(WritePipeline, ComputePartitionedExpression)
     EXPECT_EQ("s_nationkey=1/name=one", partition_by_result_column->getDataAt(0));
     EXPECT_EQ("s_nationkey=2/name=two", partition_by_result_column->getDataAt(1));
     EXPECT_EQ("s_nationkey=3/name=three", partition_by_result_column->getDataAt(2));
-}
\ No newline at end of file
+}
+
+namespace
+{
+/// Overrides the configs of the global context, the original configs are restored on exit.
+class ScopedGlobalConfig
+{
+public:
+    explicit ScopedGlobalConfig(const std::map<String, String> & overrides)
+        : original(const_cast<Poco::Util::AbstractConfiguration *>(&QueryContext::globalContext()->getConfigRef()), true)
+    {
+        Poco::AutoPtr<Poco::Util::MapConfiguration> override_config(new Poco::Util::MapConfiguration());
+        for (const auto & [key, value] : overrides)
+            override_config->setString(key, value);
+        Poco::AutoPtr<Poco::Util::LayeredConfiguration> config(new Poco::Util::LayeredConfiguration());
+        config->add(override_config, 0);
+        config->add(original, 1);
+        QueryContext::globalMutableContext()->setConfig(config);
+    }
+    ~ScopedGlobalConfig() { QueryContext::globalMutableContext()->setConfig(original); }
+
+private:
+    Poco::AutoPtr<Poco::Util::AbstractConfiguration> original;
+};
+
+Chunk partitionedChunk(size_t first_row, size_t rows, size_t partitions)
+{
+    auto id_col = INT()->createColumn();
+    auto part_col = STRING()->createColumn();
+    for (size_t i = first_row; i < first_row + rows; ++i)
+    {
+        id_col->insert(static_cast<Int32>(i));
+        part_col->insert(fmt::format("p{}", i % partitions));
+    }
+    MutableColumns columns;
+    columns.push_back(std::move(id_col));
+    columns.push_back(std::move(part_col));
+    return {std::move(columns), rows};
+}
+}
+
+TEST(WritePipeline, ClusterPartitionsBeyondMaxOpenWriters)
+{
+    constexpr size_t partitions = 20;
+    constexpr size_t chunks = 5;
+    constexpr size_t chunk_rows = 100;
+    /// Every buffered chunk is spilled, so the rows of a partition are merged from several sorted runs.
+    ScopedGlobalConfig config{{{PartitionedWriteConfig::MAX_OPEN_WRITERS, "4"}, {PartitionedWriteConfig::FALLBACK_BUFFER_BYTES, "1"}}};
+
+    const std::string base_path = "/tmp/test_table/test_clustered";
+    std::filesystem::remove_all(base_path);
+    const auto context = DB::Context::createCopy(QueryContext::globalContext());
+    const auto header = toShared(Block{{INT(), "id"}, {STRING(), "part"}});
+    const Names partition_by{"part"};
+    auto stats = WriteStats::create(header, partition_by);
+    SubstraitPartitionedFileSink sink(
+        context, partition_by, header, header, "file://" + base_path, FileNameGenerator("{id}.parquet"), "parquet", stats);
+
+    /// The first chunk has 3 partitions, they are written by the open writers.
+    auto chunk = partitionedChunk(0, 3, partitions);
+    sink.consume(chunk);
+    EXPECT_FALSE(sink.fallbackToClustering());
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        chunk = partitionedChunk(3 + i * chunk_rows, chunk_rows, partitions);
+        sink.consume(chunk);
+    }
+    EXPECT_TRUE(sink.fallbackToClustering());
+    sink.onFinish();
+
+    auto result = stats->collectedStats();
+    const auto & partition_ids = *result.getByName("partition_id").column;
+    const auto & record_counts = *result.getByName("record_count").column;
+    const auto & clustered = *result.getByName("clustered").column;
+
+    Int64 total_rows = 0;
+    std::map<String, size_t> clustered_files;
+    std::map<String, Int64> clustered_rows;
+    for (size_t row = 0; row < result.rows(); ++row)
+    {
+        total_rows += record_counts.getInt(row);
+        if (!clustered.getBool(row))
+            continue;
+        const auto partition = partition_ids.getDataAt(row).toString();
+        ++clustered_files[partition];
+        clustered_rows[partition] += record_counts.getInt(row);
+    }
+    EXPECT_EQ(3 + chunks * chunk_rows, total_rows);
+    /// Each partition gets a single file from the clustered rows, although its rows are spilled into every run.
+    EXPECT_EQ(partitions, clustered_files.size());
+    for (size_t i = 0; i < partitions; ++i)
+    {
+        const auto partition = fmt::format("part=p{}", i);
+        EXPECT_EQ(1, clustered_files[partition]) << partition;
+        EXPECT_EQ(chunks * chunk_rows / partitions, clustered_rows[partition]) << partition;
+    }
+}
+
+TEST(WritePipeline, ComputeColumnStats)
+{
+    auto check = [](const DataTypePtr & type, const std::vector<Field> & values)
+    {
+        auto column = type->createColumn();
+        for (const auto & value : values)
+            column->insert(value);
+
+        Field min, max;
+        Int64 null_count = -1;
+        computeColumnStats(*column, min, max, null_count);
+
+        Field expected_min, expected_max;
+        column->getExtremes(expected_min, expected_max);
+        EXPECT_EQ(expected_min, min) << type->getName();
+        EXPECT_EQ(expected_max, max) << type->getName();
+        EXPECT_EQ(std::ranges::count_if(values, [](const Field & value) { return value.isNull(); }), null_count) << type->getName();
+    };
+
+    check(BIGINT(), {Int64(3), Int64(-7), Int64(5)});
+    check(wrapNullableType(BIGINT()), {Int64(3), Field(), Int64(-7), Field()});
+    check(wrapNullableType(INT8()), {Field(), Field()});
+    check(DOUBLE(), {Float64(1.5), std::numeric_limits<Float64>::quiet_NaN(), Float64(-2.5)});
+    check(wrapNullableType(DOUBLE()), {Float64(1.5), Field(), Float64(-2.5)});
+    check(wrapNullableType(STRING()), {String("b"), Field(), String("a"), String("c")});
+    check(wrapNullableType(UINT16()), {UInt64(10), Field(), UInt64(5)});
+    check(
+        wrapNullableType(std::make_shared<DataTypeDecimal64>(15, 2)),
+        {DecimalField<Decimal64>(123, 2), Field(), DecimalField<Decimal64>(-5, 2)});
+}
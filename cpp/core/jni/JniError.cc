@@ -46,8 +46,15 @@ jclass gluten::JniErrorState::glutenExceptionClass() {
   return glutenExceptionClass_;
 }
 
+jclass gluten::JniErrorState::shuffleChecksumExceptionClass() {
+  assertInitialized();
+  return shuffleChecksumExceptionClass_;
+}
+
 void gluten::JniErrorState::initialize(JNIEnv* env) {
   glutenExceptionClass_ = createGlobalClassReference(env, "Lorg/apache/gluten/exception/GlutenException;");
+  shuffleChecksumExceptionClass_ =
+      createGlobalClassReference(env, "Lorg/apache/gluten/exception/ShuffleChecksumException;");
   ioExceptionClass_ = createGlobalClassReference(env, "Ljava/io/IOException;");
   runtimeExceptionClass_ = createGlobalClassReference(env, "Ljava/lang/RuntimeException;");
   unsupportedOperationExceptionClass_ = createGlobalClassReference(env, "Ljava/lang/UnsupportedOperationException;");
@@ -68,6 +75,7 @@ void gluten::JniErrorState::close() {
   JNIEnv* env = nullptr;
   attachCurrentThreadAsDaemonOrThrow(vm_, &env);
   env->DeleteGlobalRef(glutenExceptionClass_);
+  env->DeleteGlobalRef(shuffleChecksumExceptionClass_);
   env->DeleteGlobalRef(ioExceptionClass_);
   env->DeleteGlobalRef(runtimeExceptionClass_);
   env->DeleteGlobalRef(unsupportedOperationExceptionClass_);
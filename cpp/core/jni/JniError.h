@@ -28,11 +28,15 @@
 #endif
 
 #ifndef JNI_METHOD_END
-#define JNI_METHOD_END(fallback_expr)                                            \
-  }                                                                              \
-  catch (std::exception & e) {                                                   \
-    env->ThrowNew(gluten::getJniErrorState()->glutenExceptionClass(), e.what()); \
-    return fallback_expr;                                                        \
+#define JNI_METHOD_END(fallback_expr)                                                     \
+  }                                                                                       \
+  catch (gluten::ShuffleChecksumException & e) {                                          \
+    env->ThrowNew(gluten::getJniErrorState()->shuffleChecksumExceptionClass(), e.what()); \
+    return fallback_expr;                                                                 \
+  }                                                                                       \
+  catch (std::exception & e) {                                                            \
+    env->ThrowNew(gluten::getJniErrorState()->glutenExceptionClass(), e.what());          \
+    return fallback_expr;                                                                 \
   }
 // macro ended
 #endif
@@ -55,6 +59,8 @@ class JniErrorState {
 
   jclass glutenExceptionClass();
 
+  jclass shuffleChecksumExceptionClass();
+
  private:
   void initialize(JNIEnv* env);
 
@@ -64,6 +70,7 @@ class JniErrorState {
   jclass illegalAccessExceptionClass_ = nullptr;
   jclass illegalArgumentExceptionClass_ = nullptr;
   jclass glutenExceptionClass_ = nullptr;
+  jclass shuffleChecksumExceptionClass_ = nullptr;
   JavaVM* vm_;
   bool initialized_{false};
   bool closed_{false};
@@ -27,12 +27,14 @@
 
 #include <arrow/c/bridge.h>
 #include <google/protobuf/stubs/common.h>
+#include <deque>
 #include <optional>
 #include <string>
 #include "memory/AllocationListener.h"
 #include "memory/SplitAwareColumnarBatchIterator.h"
 #include "operators/serializer/ColumnarBatchSerializer.h"
 #include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/LocalSegmentReader.h"
 #include "shuffle/Partitioning.h"
 #include "shuffle/ShuffleReader.h"
 #include "shuffle/ShuffleWriter.h"
@@ -71,6 +73,11 @@ jmethodID shuffleReaderMetricsSetDeserializeTime;
 jclass shuffleStreamReaderClass;
 jmethodID shuffleStreamReaderNextStream;
 
+jclass lowCopyFileSegmentJniByteInputStreamClass;
+jmethodID lowCopyFileSegmentJniByteInputStreamPath;
+jmethodID lowCopyFileSegmentJniByteInputStreamOffset;
+jmethodID lowCopyFileSegmentJniByteInputStreamLength;
+
 class JavaInputStreamAdaptor final : public arrow::io::InputStream {
  public:
   JavaInputStreamAdaptor(JNIEnv* env, arrow::MemoryPool* pool, jobject jniIn) : pool_(pool) {
@@ -215,22 +222,80 @@ class ShuffleStreamReader : public StreamReader {
     env->DeleteGlobalRef(ref_);
   }
 
+  // Blocks on local disk are read natively by LocalSegmentReader. The next streams are pulled ahead from the JVM as long
+  // as they are file segments adjacent to the previous ones, so they could be read with one pread. Pulling the next
+  // stream closes the previous one on the JVM side, which is fine for file segments because the file is already opened
+  // natively when the segment is added.
+  // Pulling ahead stops at the first stream which is not a file segment, it's returned after the pending segments.
   std::shared_ptr<arrow::io::InputStream> readNextStream(arrow::MemoryPool* pool) override {
-    JNIEnv* env = nullptr;
-    attachCurrentThreadAsDaemonOrThrow(vm_, &env);
+    if (pendingStreams_.empty() && !reachedEos_) {
+      JNIEnv* env = nullptr;
+      attachCurrentThreadAsDaemonOrThrow(vm_, &env);
+
+      std::shared_ptr<arrow::io::InputStream> javaStream;
+      while (true) {
+        if (!nextSegment_.has_value()) {
+          jobject jniIn = env->CallObjectMethod(ref_, shuffleStreamReaderNextStream);
+          checkException(env);
+          if (jniIn == nullptr) {
+            reachedEos_ = true; // No more streams to read
+            break;
+          }
+          nextSegment_ = toFileSegment(env, jniIn);
+          if (!nextSegment_.has_value()) {
+            javaStream = std::make_shared<JavaInputStreamAdaptor>(env, pool, jniIn);
+            break;
+          }
+          env->DeleteLocalRef(jniIn);
+        }
+        if (!segmentReader_.tryAdd(*nextSegment_, pool)) {
+          break;
+        }
+        nextSegment_.reset();
+      }
 
-    jobject jniIn = env->CallObjectMethod(ref_, shuffleStreamReaderNextStream);
-    checkException(env);
-    if (jniIn == nullptr) {
-      return nullptr; // No more streams to read
+      for (auto& in : segmentReader_.readGroup()) {
+        pendingStreams_.push_back(std::move(in));
+      }
+      if (javaStream != nullptr) {
+        pendingStreams_.push_back(std::move(javaStream));
+      }
+    }
+
+    if (pendingStreams_.empty()) {
+      return nullptr;
     }
-    std::shared_ptr<arrow::io::InputStream> in = std::make_shared<JavaInputStreamAdaptor>(env, pool, jniIn);
+    auto in = std::move(pendingStreams_.front());
+    pendingStreams_.pop_front();
     return in;
   }
 
  private:
+  static std::optional<FileSegment> toFileSegment(JNIEnv* env, jobject jniIn) {
+    if (!env->IsInstanceOf(jniIn, lowCopyFileSegmentJniByteInputStreamClass)) {
+      return std::nullopt;
+    }
+    auto path = static_cast<jstring>(env->CallObjectMethod(jniIn, lowCopyFileSegmentJniByteInputStreamPath));
+    checkException(env);
+    if (path == nullptr) {
+      return std::nullopt;
+    }
+    FileSegment segment;
+    segment.path = jStringToCString(env, path);
+    env->DeleteLocalRef(path);
+    segment.offset = env->CallLongMethod(jniIn, lowCopyFileSegmentJniByteInputStreamOffset);
+    checkException(env);
+    segment.length = env->CallLongMethod(jniIn, lowCopyFileSegmentJniByteInputStreamLength);
+    checkException(env);
+    return segment;
+  }
+
   JavaVM* vm_;
   jobject ref_;
+  LocalSegmentReader segmentReader_;
+  std::optional<FileSegment> nextSegment_;
+  std::deque<std::shared_ptr<arrow::io::InputStream>> pendingStreams_;
+  bool reachedEos_{false};
 };
 
 } // namespace
@@ -265,7 +330,7 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   jniByteInputStreamClose = getMethodIdOrError(env, jniByteInputStreamClass, "close", "()V");
 
   splitResultClass = createGlobalClassReferenceOrError(env, "Lorg/apache/gluten/vectorized/GlutenSplitResult;");
-  splitResultConstructor = getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJJJJJDJ[J[J)V");
+  splitResultConstructor = getMethodIdOrError(env, splitResultClass, "<init>", "(JJJJJJJJJJDJJJ[J[J)V");
 
   metricsBuilderClass = createGlobalClassReferenceOrError(env, "Lorg/apache/gluten/metrics/Metrics;");
 
@@ -291,6 +356,15 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
   shuffleStreamReaderNextStream = getMethodIdOrError(
       env, shuffleStreamReaderClass, "nextStream", "()Lorg/apache/gluten/vectorized/JniByteInputStream;");
 
+  lowCopyFileSegmentJniByteInputStreamClass =
+      createGlobalClassReferenceOrError(env, "Lorg/apache/gluten/vectorized/LowCopyFileSegmentJniByteInputStream;");
+  lowCopyFileSegmentJniByteInputStreamPath =
+      getMethodIdOrError(env, lowCopyFileSegmentJniByteInputStreamClass, "path", "()Ljava/lang/String;");
+  lowCopyFileSegmentJniByteInputStreamOffset =
+      getMethodIdOrError(env, lowCopyFileSegmentJniByteInputStreamClass, "offset", "()J");
+  lowCopyFileSegmentJniByteInputStreamLength =
+      getMethodIdOrError(env, lowCopyFileSegmentJniByteInputStreamClass, "length", "()J");
+
   return jniVersion;
 }
 
@@ -303,6 +377,7 @@ void JNI_OnUnload(JavaVM* vm, void* reserved) {
   env->DeleteGlobalRef(byteArrayClass);
   env->DeleteGlobalRef(jniUnsafeByteBufferClass);
   env->DeleteGlobalRef(shuffleReaderMetricsClass);
+  env->DeleteGlobalRef(lowCopyFileSegmentJniByteInputStreamClass);
 
   getJniErrorState()->close();
   getJniCommonState()->close();
@@ -930,7 +1005,8 @@ Java_org_apache_gluten_vectorized_LocalPartitionWriterJniWrapper_createPartition
     jint shuffleFileBufferSize,
     jstring dataFileJstr,
     jstring localDirsJstr,
-    jboolean enableDictionary) {
+    jboolean enableDictionary,
+    jboolean enableChecksum) {
   JNI_METHOD_START
 
   const auto ctx = getRuntime(env, wrapper);
@@ -945,7 +1021,8 @@ Java_org_apache_gluten_vectorized_LocalPartitionWriterJniWrapper_createPartition
       mergeBufferSize,
       mergeThreshold,
       numSubDirs,
-      enableDictionary);
+      enableDictionary,
+      enableChecksum);
 
   auto partitionWriter = std::make_shared<LocalPartitionWriter>(
       numPartitions,
@@ -1025,6 +1102,7 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
     jint diskWriteBufferSize,
     jint initialSortBufferSize,
     jboolean useRadixSort,
+    jboolean columnarPayload,
     jlong partitionWriterHandle) {
   JNI_METHOD_START
   const auto ctx = getRuntime(env, wrapper);
@@ -1040,7 +1118,50 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
       startPartitionId,
       initialSortBufferSize,
       diskWriteBufferSize,
-      static_cast<bool>(useRadixSort));
+      static_cast<bool>(useRadixSort),
+      static_cast<bool>(columnarPayload));
+
+  return ctx->saveObject(ctx->createShuffleWriter(numPartitions, partitionWriter, shuffleWriterOptions));
+  JNI_METHOD_END(kInvalidObjectHandle)
+}
+
+JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrapper_createAdaptiveShuffleWriter(
+    JNIEnv* env,
+    jobject wrapper,
+    jint numPartitions,
+    jstring partitioningNameJstr,
+    jint startPartitionId,
+    jint splitBufferSize,
+    jdouble splitBufferReallocThreshold,
+    jint diskWriteBufferSize,
+    jint initialSortBufferSize,
+    jboolean useRadixSort,
+    jint sampleBatches,
+    jlong sortPartitionBytes,
+    jlong partitionWriterHandle) {
+  JNI_METHOD_START
+  const auto ctx = getRuntime(env, wrapper);
+
+  auto partitionWriter = ObjectStore::retrieve<PartitionWriter>(partitionWriterHandle);
+  if (partitionWriter == nullptr) {
+    throw GlutenException("Partition writer handle is invalid: " + std::to_string(partitionWriterHandle));
+  }
+  ObjectStore::release(partitionWriterHandle);
+
+  const auto partitioning = toPartitioning(jStringToCString(env, partitioningNameJstr));
+  auto shuffleWriterOptions = std::make_shared<AdaptiveShuffleWriterOptions>(
+      partitioning,
+      startPartitionId,
+      HashShuffleWriterOptions(partitioning, startPartitionId, splitBufferSize, splitBufferReallocThreshold),
+      SortShuffleWriterOptions(
+          partitioning,
+          startPartitionId,
+          initialSortBufferSize,
+          diskWriteBufferSize,
+          static_cast<bool>(useRadixSort),
+          true),
+      sampleBatches,
+      sortPartitionBytes);
 
   return ctx->saveObject(ctx->createShuffleWriter(numPartitions, partitionWriter, shuffleWriterOptions));
   JNI_METHOD_END(kInvalidObjectHandle)
@@ -1055,6 +1176,8 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
     jint splitBufferSize,
     jlong sortBufferMaxSize,
     jstring codecJstr,
+    jstring localSpillDirsJstr,
+    jlong spillMergePushSize,
     jlong partitionWriterHandle) {
   JNI_METHOD_START
   const auto ctx = getRuntime(env, wrapper);
@@ -1070,7 +1193,9 @@ JNIEXPORT jlong JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrappe
       startPartitionId,
       splitBufferSize,
       sortBufferMaxSize,
-      getCompressionType(env, codecJstr));
+      getCompressionType(env, codecJstr),
+      splitPaths(jStringToCString(env, localSpillDirsJstr)),
+      spillMergePushSize);
 
   return ctx->saveObject(ctx->createShuffleWriter(numPartitions, partitionWriter, shuffleWriterOptions));
   JNI_METHOD_END(kInvalidObjectHandle)
@@ -1152,6 +1277,8 @@ JNIEXPORT jobject JNICALL Java_org_apache_gluten_vectorized_ShuffleWriterJniWrap
       shuffleWriter->peakBytesAllocated(),
       shuffleWriter->avgDictionaryFields(),
       shuffleWriter->dictionarySize(),
+      shuffleWriter->totalBytesSpilled(),
+      shuffleWriter->totalSpillTime(),
       partitionLengthArr,
       rawPartitionLengthArr);
 
@@ -56,12 +56,14 @@ class LocalPartitionWriter::LocalSpiller {
       std::string spillFile,
       int32_t compressionBufferSize,
       arrow::MemoryPool* pool,
-      arrow::util::Codec* codec)
+      arrow::util::Codec* codec,
+      bool enableChecksum)
       : isFinal_(isFinal),
         os_(os),
         spillFile_(std::move(spillFile)),
         pool_(pool),
         codec_(codec),
+        enableChecksum_(enableChecksum),
         diskSpill_(std::make_unique<Spill>()) {
     if (codec_ != nullptr) {
       GLUTEN_ASSIGN_OR_THROW(
@@ -86,8 +88,16 @@ class LocalPartitionWriter::LocalSpiller {
     compressTime_ += payload->getCompressTime();
     spillTime_ += payload->getWriteTime();
 
+    // Payloads to be compressed are compressed and checksummed when merged into the final data file.
     diskSpill_->insertPayload(
-        partitionId, payload->type(), payload->numRows(), payload->isValidityBuffer(), end - start, pool_, codec_);
+        partitionId,
+        payload->type(),
+        payload->numRows(),
+        payload->isValidityBuffer(),
+        end - start,
+        pool_,
+        codec_,
+        enableChecksum_);
 
     return arrow::Status::OK();
   }
@@ -173,6 +183,7 @@ class LocalPartitionWriter::LocalSpiller {
   std::string spillFile_;
   arrow::MemoryPool* pool_;
   arrow::util::Codec* codec_;
+  bool enableChecksum_;
 
   std::shared_ptr<Spill> diskSpill_{nullptr};
 
@@ -297,12 +308,14 @@ class LocalPartitionWriter::PayloadCache {
       arrow::util::Codec* codec,
       int32_t compressionThreshold,
       bool enableDictionary,
+      bool enableChecksum,
       arrow::MemoryPool* pool,
       MemoryManager* memoryManager)
       : numPartitions_(numPartitions),
         codec_(codec),
         compressionThreshold_(compressionThreshold),
         enableDictionary_(enableDictionary),
+        enableChecksum_(enableChecksum),
         pool_(pool),
         memoryManager_(memoryManager) {}
 
@@ -323,7 +336,8 @@ class LocalPartitionWriter::PayloadCache {
     bool shouldCompress = codec_ != nullptr && payload->numRows() >= compressionThreshold_;
     ARROW_ASSIGN_OR_RAISE(
         auto block,
-        payload->toBlockPayload(shouldCompress ? Payload::kCompressed : Payload::kUncompressed, pool_, codec_));
+        payload->toBlockPayload(
+            shouldCompress ? Payload::kCompressed : Payload::kUncompressed, pool_, codec_, enableChecksum_));
 
     partitionCachedPayload_[partitionId].push_back(std::move(block));
 
@@ -483,6 +497,7 @@ class LocalPartitionWriter::PayloadCache {
   arrow::util::Codec* codec_;
   int32_t compressionThreshold_;
   bool enableDictionary_;
+  bool enableChecksum_;
   arrow::MemoryPool* pool_;
   MemoryManager* memoryManager_;
 
@@ -670,7 +685,13 @@ arrow::Status LocalPartitionWriter::requestSpill(bool isFinal) {
       ARROW_ASSIGN_OR_RAISE(os, openFile(spillFile, options_->shuffleFileBufferSize));
     }
     spiller_ = std::make_unique<LocalSpiller>(
-        isFinal, os, std::move(spillFile), options_->compressionBufferSize, payloadPool_.get(), codec_.get());
+        isFinal,
+        os,
+        std::move(spillFile),
+        options_->compressionBufferSize,
+        payloadPool_.get(),
+        codec_.get(),
+        options_->enableChecksum);
   }
   return arrow::Status::OK();
 }
@@ -695,6 +716,7 @@ arrow::Status LocalPartitionWriter::finishMerger() {
               codec_.get(),
               options_->compressionThreshold,
               options_->enableDictionary,
+              options_->enableChecksum,
               payloadPool_.get(),
               memoryManager_);
         }
@@ -744,6 +766,7 @@ arrow::Status LocalPartitionWriter::hashEvict(
           codec_.get(),
           options_->compressionThreshold,
           options_->enableDictionary,
+          options_->enableChecksum,
           payloadPool_.get(),
           memoryManager_);
     }
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/LocalSegmentReader.h"
+
+#include <arrow/io/memory.h>
+
+#include "utils/Exception.h"
+
+namespace gluten {
+
+bool LocalSegmentReader::tryAdd(const FileSegment& segment, arrow::MemoryPool* pool) {
+  if (!group_.empty()) {
+    const auto& last = group_.back();
+    if (segment.path != last.path || segment.offset != last.offset + last.length ||
+        groupBytes_ + segment.length > maxCoalescedBytes_) {
+      return false;
+    }
+  } else {
+    openFile(segment.path, pool);
+  }
+  group_.push_back(segment);
+  groupBytes_ += segment.length;
+  return true;
+}
+
+std::vector<std::shared_ptr<arrow::io::InputStream>> LocalSegmentReader::readGroup() {
+  std::vector<std::shared_ptr<arrow::io::InputStream>> streams;
+  if (group_.empty()) {
+    return streams;
+  }
+  // All the segments of the group are from the last opened file.
+  auto file = file_;
+
+  if (group_.size() == 1 && groupBytes_ > maxCoalescedBytes_) {
+    const auto& segment = group_.front();
+    GLUTEN_ASSIGN_OR_THROW(auto stream, arrow::io::RandomAccessFile::GetStream(file, segment.offset, segment.length));
+    streams.push_back(std::move(stream));
+  } else {
+    const auto groupOffset = group_.front().offset;
+    GLUTEN_ASSIGN_OR_THROW(auto buffer, file->ReadAt(groupOffset, groupBytes_));
+    if (buffer->size() != groupBytes_) {
+      throw GlutenException(
+          "Failed to read shuffle segments of " + filePath_ + " at offset " + std::to_string(groupOffset) + ", expected " +
+          std::to_string(groupBytes_) + " bytes but got " + std::to_string(buffer->size()));
+    }
+    streams.reserve(group_.size());
+    for (const auto& segment : group_) {
+      streams.push_back(std::make_shared<arrow::io::BufferReader>(
+          arrow::SliceBuffer(buffer, segment.offset - groupOffset, segment.length)));
+    }
+  }
+
+  group_.clear();
+  groupBytes_ = 0;
+  return streams;
+}
+
+std::shared_ptr<arrow::io::ReadableFile> LocalSegmentReader::openFile(const std::string& path, arrow::MemoryPool* pool) {
+  if (file_ == nullptr || filePath_ != path) {
+    // The previous file is closed once the streams still reading it are released.
+    GLUTEN_ASSIGN_OR_THROW(file_, arrow::io::ReadableFile::Open(path, pool));
+    filePath_ = path;
+  }
+  return file_;
+}
+
+} // namespace gluten
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <arrow/io/file.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/memory_pool.h>
+
+#include <string>
+#include <vector>
+
+namespace gluten {
+
+// A byte range of a local shuffle file which holds one shuffle block.
+struct FileSegment {
+  std::string path;
+  int64_t offset;
+  int64_t length;
+};
+
+// Reads local shuffle blocks directly from the files instead of pulling the bytes through the JVM input streams.
+// Segments are added in the order they are read. Adjacent segments of the same file are grouped and read with a single
+// pread, then each segment is served as its own stream from the shared buffer. A segment larger than the max coalesced
+// bytes is read lazily in chunks by the returned stream.
+class LocalSegmentReader {
+ public:
+  static constexpr int64_t kDefaultMaxCoalescedBytes = 4 << 20;
+
+  explicit LocalSegmentReader(int64_t maxCoalescedBytes = kDefaultMaxCoalescedBytes)
+      : maxCoalescedBytes_(maxCoalescedBytes) {}
+
+  // Adds the segment into the current group. Returns false if it can't be coalesced with the group, the group should be
+  // read before adding it again. The file is opened when its first segment is added, the caller may release the file
+  // (e.g. a fetched-to-disk block deleted by the JVM) once this returns true.
+  bool tryAdd(const FileSegment& segment, arrow::MemoryPool* pool);
+
+  bool empty() const {
+    return group_.empty();
+  }
+
+  // Reads the current group and returns one stream per segment, in the order they were added. The group is cleared.
+  std::vector<std::shared_ptr<arrow::io::InputStream>> readGroup();
+
+ private:
+  std::shared_ptr<arrow::io::ReadableFile> openFile(const std::string& path, arrow::MemoryPool* pool);
+
+  const int64_t maxCoalescedBytes_;
+  std::vector<FileSegment> group_;
+  int64_t groupBytes_{0};
+
+  // The last opened file, consecutive groups are usually from the same file.
+  std::string filePath_;
+  std::shared_ptr<arrow::io::ReadableFile> file_;
+};
+
+} // namespace gluten
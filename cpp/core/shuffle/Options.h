@@ -24,6 +24,10 @@
 #include <arrow/ipc/options.h>
 #include <arrow/util/compression.h>
 
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace gluten {
 
 static constexpr int16_t kDefaultBatchSize = 4096;
@@ -42,8 +46,12 @@ static constexpr int64_t kDefaultReadBufferSize = 1 << 20;
 static constexpr int64_t kDefaultDeserializerBufferSize = 1 << 20;
 static constexpr int64_t kDefaultShuffleFileBufferSize = 32 << 10;
 static constexpr bool kDefaultEnableDictionary = false;
+static constexpr bool kDefaultEnableChecksum = false;
+static constexpr int32_t kDefaultAdaptiveSampleBatches = 4;
+static constexpr int64_t kDefaultAdaptiveSortBytesPerPartition = 1024;
+static constexpr int64_t kDefaultRssSortSpillMergePushSize = 4 << 20;
 
-enum class ShuffleWriterType { kHashShuffle, kSortShuffle, kRssSortShuffle, kGpuHashShuffle };
+enum class ShuffleWriterType { kHashShuffle, kSortShuffle, kRssSortShuffle, kGpuHashShuffle, kAdaptiveShuffle };
 
 enum class PartitionWriterType { kLocal, kRss };
 
@@ -110,6 +118,9 @@ struct SortShuffleWriterOptions : ShuffleWriterOptions {
   int32_t initialSortBufferSize = kDefaultSortBufferSize; // spark.shuffle.sort.initialBufferSize
   int32_t diskWriteBufferSize = kDefaultDiskWriteBufferSize; // spark.shuffle.spill.diskWriteBufferSize
   bool useRadixSort = kDefaultUseRadixSort; // spark.shuffle.sort.useRadixSort
+  // Transpose the rows of each evicted partition into the column buffers of the hash shuffle payload. The output must
+  // be read by the hash shuffle reader.
+  bool columnarPayload = false;
 
   SortShuffleWriterOptions() : ShuffleWriterOptions(ShuffleWriterType::kSortShuffle) {}
 
@@ -118,17 +129,24 @@ struct SortShuffleWriterOptions : ShuffleWriterOptions {
       int32_t startPartitionId,
       int32_t initialSortBufferSize,
       int32_t diskWriteBufferSize,
-      bool useRadixSort)
+      bool useRadixSort,
+      bool columnarPayload)
       : ShuffleWriterOptions(ShuffleWriterType::kSortShuffle, partitioning, startPartitionId),
         initialSortBufferSize(initialSortBufferSize),
         diskWriteBufferSize(diskWriteBufferSize),
-        useRadixSort(useRadixSort) {}
+        useRadixSort(useRadixSort),
+        columnarPayload(columnarPayload) {}
 };
 
 struct RssSortShuffleWriterOptions : ShuffleWriterOptions {
   int32_t splitBufferSize = kDefaultShuffleWriterBufferSize;
   int64_t sortBufferMaxSize = kDefaultSortBufferThreshold;
   arrow::Compression::type compressionType = arrow::Compression::type::LZ4_FRAME;
+  // If not empty, the buffered rows evicted before stop() are spilled to these local directories as runs sorted by
+  // partition id instead of being pushed. stop() merges the runs by partition id into pushes of up to
+  // spillMergePushSize bytes.
+  std::vector<std::string> localSpillDirs{};
+  int64_t spillMergePushSize = kDefaultRssSortSpillMergePushSize;
 
   RssSortShuffleWriterOptions() : ShuffleWriterOptions(ShuffleWriterType::kRssSortShuffle) {}
 
@@ -137,11 +155,15 @@ struct RssSortShuffleWriterOptions : ShuffleWriterOptions {
       int32_t startPartitionId,
       int32_t splitBufferSize,
       int64_t sortBufferMaxSize,
-      arrow::Compression::type compressionType)
+      arrow::Compression::type compressionType,
+      std::vector<std::string> localSpillDirs = {},
+      int64_t spillMergePushSize = kDefaultRssSortSpillMergePushSize)
       : ShuffleWriterOptions(ShuffleWriterType::kRssSortShuffle, partitioning, startPartitionId),
         splitBufferSize(splitBufferSize),
         sortBufferMaxSize(sortBufferMaxSize),
-        compressionType(compressionType) {}
+        compressionType(compressionType),
+        localSpillDirs(std::move(localSpillDirs)),
+        spillMergePushSize(spillMergePushSize) {}
 };
 
 struct GpuHashShuffleWriterOptions : HashShuffleWriterOptions {
@@ -163,6 +185,34 @@ struct GpuHashShuffleWriterOptions : HashShuffleWriterOptions {
             partitionBufferReallocThreshold) {}
 };
 
+// Options of the shuffle writer that samples the first input batches and then delegates to either the hash or the
+// sort shuffle writer. Both delegates produce the payload layout of the hash shuffle writer, so the output is read
+// with the hash shuffle reader whichever is chosen.
+struct AdaptiveShuffleWriterOptions : ShuffleWriterOptions {
+  HashShuffleWriterOptions hashOptions{};
+  SortShuffleWriterOptions sortOptions{};
+
+  // Number of input batches to sample before choosing the writer.
+  int32_t sampleBatches = kDefaultAdaptiveSampleBatches;
+  // Use the sort shuffle writer if the average bytes of a partition in one input batch is below this value.
+  int64_t sortBytesPerPartition = kDefaultAdaptiveSortBytesPerPartition;
+
+  AdaptiveShuffleWriterOptions() : ShuffleWriterOptions(ShuffleWriterType::kAdaptiveShuffle) {}
+
+  AdaptiveShuffleWriterOptions(
+      Partitioning partitioning,
+      int32_t startPartitionId,
+      HashShuffleWriterOptions hashOptions,
+      SortShuffleWriterOptions sortOptions,
+      int32_t sampleBatches,
+      int64_t sortBytesPerPartition)
+      : ShuffleWriterOptions(ShuffleWriterType::kAdaptiveShuffle, partitioning, startPartitionId),
+        hashOptions(std::move(hashOptions)),
+        sortOptions(std::move(sortOptions)),
+        sampleBatches(sampleBatches),
+        sortBytesPerPartition(sortBytesPerPartition) {}
+};
+
 struct LocalPartitionWriterOptions {
   int64_t shuffleFileBufferSize = kDefaultShuffleFileBufferSize; // spark.shuffle.file.buffer
   int32_t compressionBufferSize =
@@ -176,6 +226,9 @@ struct LocalPartitionWriterOptions {
 
   bool enableDictionary = kDefaultEnableDictionary;
 
+  // Write a CRC32C checksum for each compressed buffer, verified by the shuffle reader.
+  bool enableChecksum = kDefaultEnableChecksum;
+
   LocalPartitionWriterOptions() = default;
 
   LocalPartitionWriterOptions(
@@ -185,14 +238,16 @@ struct LocalPartitionWriterOptions {
       int32_t mergeBufferSize,
       double mergeThreshold,
       int32_t numSubDirs,
-      bool enableDictionary)
+      bool enableDictionary,
+      bool enableChecksum)
       : shuffleFileBufferSize(shuffleFileBufferSize),
         compressionBufferSize(compressionBufferSize),
         compressionThreshold(compressionThreshold),
         mergeBufferSize(mergeBufferSize),
         mergeThreshold(mergeThreshold),
         numSubDirs(numSubDirs),
-        enableDictionary(enableDictionary) {}
+        enableDictionary(enableDictionary),
+        enableChecksum(enableChecksum) {}
 };
 
 struct RssPartitionWriterOptions {
@@ -200,6 +255,7 @@ struct RssPartitionWriterOptions {
       kDefaultCompressionBufferSize; // spark.io.compression.lz4.blockSize,spark.io.compression.zstd.bufferSize
   int64_t pushBufferMaxSize = kDefaultPushMemoryThreshold;
   int64_t sortBufferMaxSize = kDefaultSortBufferThreshold;
+  bool enableChecksum = kDefaultEnableChecksum;
 
   RssPartitionWriterOptions() = default;
 
@@ -209,6 +265,18 @@ struct RssPartitionWriterOptions {
         sortBufferMaxSize(sortBufferMaxSize) {}
 };
 
+// The writer chosen by the adaptive shuffle writer and the sampled statistics it was chosen from.
+struct AdaptiveShuffleWriterDecision {
+  ShuffleWriterType writerType{ShuffleWriterType::kHashShuffle};
+  int64_t sampledBatches{0};
+  int64_t sampledRows{0};
+  double avgRowBytes{0};
+  double avgPartitionsPerBatch{0};
+  double avgBytesPerPartitionPerBatch{0};
+  // Estimated memory of the hash shuffle writer's partition buffers, compared against the memory limit.
+  int64_t estimatedHashBufferBytes{0};
+};
+
 struct ShuffleWriterMetrics {
   int64_t totalBytesWritten{0};
   int64_t totalBytesEvicted{0};
@@ -216,9 +284,13 @@ struct ShuffleWriterMetrics {
   int64_t totalWriteTime{0};
   int64_t totalEvictTime{0};
   int64_t totalCompressTime{0};
+  // Bytes and time of the data spilled to local files by the shuffle writer before it's pushed to the remote shuffle service.
+  int64_t totalBytesSpilled{0};
+  int64_t totalSpillTime{0};
   double avgDictionaryFields{0};
   int64_t dictionarySize{0};
   std::vector<int64_t> partitionLengths{};
   std::vector<int64_t> rawPartitionLengths{}; // Uncompressed size.
+  std::optional<AdaptiveShuffleWriterDecision> adaptiveDecision{}; // Only set by the adaptive shuffle writer.
 };
 } // namespace gluten
@@ -24,6 +24,7 @@
 
 #include "shuffle/Options.h"
 #include "shuffle/Utils.h"
+#include "utils/Crc32c.h"
 #include "utils/Exception.h"
 #include "utils/Timer.h"
 
@@ -31,6 +32,7 @@ namespace gluten {
 namespace {
 
 static const Payload::Type kCompressedType = gluten::BlockPayload::kCompressed;
+static const Payload::Type kCompressedWithChecksumType = gluten::BlockPayload::kCompressedWithChecksum;
 static const Payload::Type kUncompressedType = gluten::BlockPayload::kUncompressed;
 
 static constexpr int64_t kZeroLengthBuffer = 0;
@@ -57,11 +59,14 @@ arrow::Result<uint8_t> readPayloadType(arrow::io::InputStream* is) {
   return type;
 }
 
+// Compressed buffer layout: | compressedLength | uncompressedLength | checksum (optional) | buffer |
+// The checksum is the CRC32C of the buffer bytes as they are stored, either compressed or not.
 arrow::Result<int64_t> compressBuffer(
     const std::shared_ptr<arrow::Buffer>& buffer,
     uint8_t* output,
     int64_t outputLength,
-    arrow::util::Codec* codec) {
+    arrow::util::Codec* codec,
+    bool checksum) {
   auto outputPtr = &output;
   if (!buffer) {
     write<int64_t>(outputPtr, kNullBuffer);
@@ -71,19 +76,26 @@ arrow::Result<int64_t> compressBuffer(
     write<int64_t>(outputPtr, kZeroLengthBuffer);
     return sizeof(int64_t);
   }
-  static const int64_t kCompressedBufferHeaderLength = 2 * sizeof(int64_t);
+  const int64_t headerLength = 2 * sizeof(int64_t) + (checksum ? sizeof(uint32_t) : 0);
   auto* compressedLengthPtr = advance<int64_t>(outputPtr);
   write(outputPtr, static_cast<int64_t>(buffer->size()));
+  auto* checksumPtr = checksum ? advance<uint32_t>(outputPtr) : nullptr;
   ARROW_ASSIGN_OR_RAISE(
       auto compressedLength, codec->Compress(buffer->size(), buffer->data(), outputLength, *outputPtr));
+  int64_t storedLength = compressedLength;
   if (compressedLength >= buffer->size()) {
     // Write uncompressed buffer.
     memcpy(*outputPtr, buffer->data(), buffer->size());
     *compressedLengthPtr = kUncompressedBuffer;
-    return kCompressedBufferHeaderLength + buffer->size();
+    storedLength = buffer->size();
+  } else {
+    *compressedLengthPtr = static_cast<int64_t>(compressedLength);
+  }
+  if (checksum) {
+    const uint32_t crc = crc32c(*outputPtr, storedLength);
+    memcpy(checksumPtr, &crc, sizeof(uint32_t));
   }
-  *compressedLengthPtr = static_cast<int64_t>(compressedLength);
-  return kCompressedBufferHeaderLength + compressedLength;
+  return headerLength + storedLength;
 }
 
 arrow::Status compressAndFlush(
@@ -91,6 +103,7 @@ arrow::Status compressAndFlush(
     arrow::io::OutputStream* outputStream,
     arrow::util::Codec* codec,
     arrow::MemoryPool* pool,
+    bool checksum,
     int64_t& compressTime,
     int64_t& writeTime) {
   if (!buffer) {
@@ -105,10 +118,10 @@ arrow::Status compressAndFlush(
   }
   ScopedTimer timer(&compressTime);
   auto maxCompressedLength = codec->MaxCompressedLen(buffer->size(), buffer->data());
-  ARROW_ASSIGN_OR_RAISE(
-      auto compressed, arrow::AllocateResizableBuffer(sizeof(int64_t) * 2 + maxCompressedLength, pool));
+  const int64_t headerLength = sizeof(int64_t) * 2 + (checksum ? sizeof(uint32_t) : 0);
+  ARROW_ASSIGN_OR_RAISE(auto compressed, arrow::AllocateResizableBuffer(headerLength + maxCompressedLength, pool));
   auto output = compressed->mutable_data();
-  ARROW_ASSIGN_OR_RAISE(auto compressedSize, compressBuffer(buffer, output, maxCompressedLength, codec));
+  ARROW_ASSIGN_OR_RAISE(auto compressedSize, compressBuffer(buffer, output, maxCompressedLength, codec, checksum));
 
   timer.switchTo(&writeTime);
   RETURN_NOT_OK(outputStream->Write(compressed->data(), compressedSize));
@@ -132,6 +145,7 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> readCompressedBuffer(
     arrow::io::InputStream* inputStream,
     const std::shared_ptr<arrow::util::Codec>& codec,
     arrow::MemoryPool* pool,
+    bool checksum,
     int64_t& deserializeTime,
     int64_t& decompressTime) {
   ScopedTimer timer(&deserializeTime);
@@ -146,13 +160,31 @@ arrow::Result<std::shared_ptr<arrow::Buffer>> readCompressedBuffer(
 
   int64_t uncompressedLength;
   RETURN_NOT_OK(inputStream->Read(sizeof(int64_t), &uncompressedLength));
+  uint32_t expectedChecksum = 0;
+  if (checksum) {
+    RETURN_NOT_OK(inputStream->Read(sizeof(uint32_t), &expectedChecksum));
+  }
+  auto verifyChecksum = [&](const uint8_t* data, int64_t length) {
+    if (!checksum) {
+      return;
+    }
+    const auto actualChecksum = crc32c(data, length);
+    if (actualChecksum != expectedChecksum) {
+      throw ShuffleChecksumException(
+          "Shuffle block is corrupted: checksum mismatch, expected " + std::to_string(expectedChecksum) + " but got " +
+          std::to_string(actualChecksum) + " for a buffer of " + std::to_string(length) + " bytes.");
+    }
+  };
   if (compressedLength == kUncompressedBuffer) {
     ARROW_ASSIGN_OR_RAISE(auto uncompressed, arrow::AllocateResizableBuffer(uncompressedLength, pool));
     RETURN_NOT_OK(inputStream->Read(uncompressedLength, uncompressed->mutable_data()));
+    verifyChecksum(uncompressed->data(), uncompressedLength);
     return uncompressed;
   }
   ARROW_ASSIGN_OR_RAISE(auto compressed, arrow::AllocateResizableBuffer(compressedLength, pool));
   RETURN_NOT_OK(inputStream->Read(compressedLength, compressed->mutable_data()));
+  // Verify before decompressing so that a corrupted block is not fed to the codec.
+  verifyChecksum(compressed->data(), compressedLength);
 
   timer.switchTo(&decompressTime);
   ARROW_ASSIGN_OR_RAISE(auto output, arrow::AllocateResizableBuffer(uncompressedLength, pool));
@@ -185,14 +217,15 @@ arrow::Result<std::unique_ptr<BlockPayload>> BlockPayload::fromBuffers(
     std::vector<std::shared_ptr<arrow::Buffer>> buffers,
     const std::vector<bool>* isValidityBuffer,
     arrow::MemoryPool* pool,
-    arrow::util::Codec* codec) {
+    arrow::util::Codec* codec,
+    bool checksum) {
   const uint32_t numBuffers = buffers.size();
 
   if (payloadType == Payload::Type::kCompressed) {
     Timer compressionTime;
     compressionTime.start();
     // Compress.
-    auto maxLength = maxCompressedLength(buffers, codec);
+    auto maxLength = maxCompressedLength(buffers, codec, checksum);
     std::shared_ptr<arrow::Buffer> compressedBuffer;
 
     ARROW_ASSIGN_OR_RAISE(compressedBuffer, arrow::AllocateResizableBuffer(maxLength, pool));
@@ -203,7 +236,8 @@ arrow::Result<std::unique_ptr<BlockPayload>> BlockPayload::fromBuffers(
     for (auto& buffer : buffers) {
       auto availableLength = maxLength - actualLength;
       // Release buffer after compression.
-      ARROW_ASSIGN_OR_RAISE(auto compressedSize, compressBuffer(std::move(buffer), output, availableLength, codec));
+      ARROW_ASSIGN_OR_RAISE(
+          auto compressedSize, compressBuffer(std::move(buffer), output, availableLength, codec, checksum));
       output += compressedSize;
       actualLength += compressedSize;
     }
@@ -214,7 +248,7 @@ arrow::Result<std::unique_ptr<BlockPayload>> BlockPayload::fromBuffers(
 
     compressionTime.stop();
     auto payload = std::unique_ptr<BlockPayload>(
-        new BlockPayload(Type::kCompressed, numRows, numBuffers, {compressedBuffer}, isValidityBuffer));
+        new BlockPayload(Type::kCompressed, numRows, numBuffers, {compressedBuffer}, isValidityBuffer, checksum));
     payload->setCompressionTime(compressionTime.realTimeUsed());
 
     return payload;
@@ -263,7 +297,7 @@ arrow::Status BlockPayload::serialize(arrow::io::OutputStream* outputStream) {
     } break;
     case Type::kCompressed: {
       ScopedTimer timer(&writeTime_);
-      RETURN_NOT_OK(outputStream->Write(&kCompressedType, sizeof(Type)));
+      RETURN_NOT_OK(outputStream->Write(checksum_ ? &kCompressedWithChecksumType : &kCompressedType, sizeof(Type)));
       RETURN_NOT_OK(outputStream->Write(&numRows_, sizeof(uint32_t)));
       RETURN_NOT_OK(outputStream->Write(&numBuffers_, sizeof(uint32_t)));
       RETURN_NOT_OK(outputStream->Write(std::move(buffers_[0])));
@@ -302,14 +336,15 @@ arrow::Result<std::vector<std::shared_ptr<arrow::Buffer>>> BlockPayload::deseria
   RETURN_NOT_OK(inputStream->Read(sizeof(uint32_t), &numBuffers));
   timer.reset();
 
-  bool isCompressionEnabled = type == Type::kCompressed;
+  const bool hasChecksum = type == Type::kCompressedWithChecksum;
+  const bool isCompressionEnabled = type == Type::kCompressed || hasChecksum;
   std::vector<std::shared_ptr<arrow::Buffer>> buffers;
   buffers.reserve(numBuffers);
   for (auto i = 0; i < numBuffers; ++i) {
     buffers.emplace_back();
     if (isCompressionEnabled) {
       ARROW_ASSIGN_OR_RAISE(
-          buffers.back(), readCompressedBuffer(inputStream, codec, pool, deserializeTime, decompressTime));
+          buffers.back(), readCompressedBuffer(inputStream, codec, pool, hasChecksum, deserializeTime, decompressTime));
     } else {
       ARROW_ASSIGN_OR_RAISE(buffers.back(), readUncompressedBuffer(inputStream, pool, deserializeTime));
     }
@@ -327,9 +362,11 @@ int64_t BlockPayload::rawSize() {
 
 int64_t BlockPayload::maxCompressedLength(
     const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::util::Codec* codec) {
-  // Compressed buffer layout: | buffer1 compressedLength | buffer1 uncompressedLength | buffer1 | ...
-  const auto metadataLength = sizeof(int64_t) * 2 * buffers.size();
+    arrow::util::Codec* codec,
+    bool checksum) {
+  // Compressed buffer layout:
+  // | buffer1 compressedLength | buffer1 uncompressedLength | buffer1 checksum (optional) | buffer1 | ...
+  const auto metadataLength = (sizeof(int64_t) * 2 + (checksum ? sizeof(uint32_t) : 0)) * buffers.size();
   int64_t totalCompressedLength =
       std::accumulate(buffers.begin(), buffers.end(), 0LL, [&](auto sum, const auto& buffer) {
         if (!buffer) {
@@ -416,9 +453,13 @@ arrow::Result<std::unique_ptr<InMemoryPayload>> InMemoryPayload::merge(
   return std::make_unique<InMemoryPayload>(mergedRows, isValidityBuffer, source->schema(), std::move(merged));
 }
 
-arrow::Result<std::unique_ptr<BlockPayload>>
-InMemoryPayload::toBlockPayload(Payload::Type payloadType, arrow::MemoryPool* pool, arrow::util::Codec* codec) {
-  return BlockPayload::fromBuffers(payloadType, numRows_, std::move(buffers_), isValidityBuffer_, pool, codec);
+arrow::Result<std::unique_ptr<BlockPayload>> InMemoryPayload::toBlockPayload(
+    Payload::Type payloadType,
+    arrow::MemoryPool* pool,
+    arrow::util::Codec* codec,
+    bool checksum) {
+  return BlockPayload::fromBuffers(
+      payloadType, numRows_, std::move(buffers_), isValidityBuffer_, pool, codec, checksum);
 }
 
 arrow::Status InMemoryPayload::serialize(arrow::io::OutputStream* outputStream) {
@@ -486,12 +527,14 @@ UncompressedDiskBlockPayload::UncompressedDiskBlockPayload(
     arrow::io::InputStream*& inputStream,
     uint64_t rawSize,
     arrow::MemoryPool* pool,
-    arrow::util::Codec* codec)
+    arrow::util::Codec* codec,
+    bool checksum)
     : Payload(type, numRows, isValidityBuffer),
       inputStream_(inputStream),
       rawSize_(rawSize),
       pool_(pool),
-      codec_(codec) {}
+      codec_(codec),
+      checksum_(checksum) {}
 
 arrow::Status UncompressedDiskBlockPayload::serialize(arrow::io::OutputStream* outputStream) {
   ARROW_RETURN_IF(
@@ -516,7 +559,8 @@ arrow::Status UncompressedDiskBlockPayload::serialize(arrow::io::OutputStream* o
 
   RETURN_NOT_OK(outputStream->Write(&blockType, sizeof(blockType)));
 
-  RETURN_NOT_OK(outputStream->Write(&kCompressedType, sizeof(kCompressedType)));
+  const auto* payloadType = checksum_ ? &kCompressedWithChecksumType : &kCompressedType;
+  RETURN_NOT_OK(outputStream->Write(payloadType, sizeof(Payload::Type)));
   RETURN_NOT_OK(outputStream->Write(&numRows_, sizeof(uint32_t)));
 
   uint32_t numBuffers = 0;
@@ -533,7 +577,8 @@ arrow::Status UncompressedDiskBlockPayload::serialize(arrow::io::OutputStream* o
   while (pos - start < rawBufferSize) {
     ARROW_ASSIGN_OR_RAISE(auto uncompressed, readUncompressedBuffer());
     ARROW_ASSIGN_OR_RAISE(pos, inputStream_->Tell());
-    RETURN_NOT_OK(compressAndFlush(std::move(uncompressed), outputStream, codec_, pool_, compressTime_, writeTime_));
+    RETURN_NOT_OK(
+        compressAndFlush(std::move(uncompressed), outputStream, codec_, pool_, checksum_, compressTime_, writeTime_));
   }
 
   GLUTEN_CHECK(pos - start == rawBufferSize, "Not all data is read from input stream.");
@@ -29,7 +29,15 @@ namespace gluten {
 
 class Payload {
  public:
-  enum Type : uint8_t { kCompressed = 1, kUncompressed = 2, kToBeCompressed = 3, kRaw = 4 };
+  // kCompressedWithChecksum is only written as the type of a serialized compressed payload that carries a CRC32C
+  // checksum for each buffer. In memory such a payload is still kCompressed.
+  enum Type : uint8_t {
+    kCompressed = 1,
+    kUncompressed = 2,
+    kToBeCompressed = 3,
+    kRaw = 4,
+    kCompressedWithChecksum = 5
+  };
 
   Payload(Type type, uint32_t numRows, const std::vector<bool>* isValidityBuffer);
 
@@ -79,8 +87,10 @@ class BlockPayload final : public Payload {
       std::vector<std::shared_ptr<arrow::Buffer>> buffers,
       const std::vector<bool>* isValidityBuffer,
       arrow::MemoryPool* pool,
-      arrow::util::Codec* codec);
+      arrow::util::Codec* codec,
+      bool checksum = false);
 
+  // Throws ShuffleChecksumException if a buffer of a checksummed payload doesn't match its checksum.
   static arrow::Result<std::vector<std::shared_ptr<arrow::Buffer>>> deserialize(
       arrow::io::InputStream* inputStream,
       const std::shared_ptr<arrow::util::Codec>& codec,
@@ -91,7 +101,8 @@ class BlockPayload final : public Payload {
 
   static int64_t maxCompressedLength(
       const std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-      arrow::util::Codec* codec);
+      arrow::util::Codec* codec,
+      bool checksum = false);
 
   arrow::Status serialize(arrow::io::OutputStream* outputStream) override;
 
@@ -105,13 +116,19 @@ class BlockPayload final : public Payload {
       uint32_t numRows,
       uint32_t numBuffers,
       std::vector<std::shared_ptr<arrow::Buffer>> buffers,
-      const std::vector<bool>* isValidityBuffer)
-      : Payload(type, numRows, isValidityBuffer), numBuffers_(numBuffers), buffers_(std::move(buffers)) {}
+      const std::vector<bool>* isValidityBuffer,
+      bool checksum = false)
+      : Payload(type, numRows, isValidityBuffer),
+        numBuffers_(numBuffers),
+        buffers_(std::move(buffers)),
+        checksum_(checksum) {}
 
   void setCompressionTime(int64_t compressionTime);
 
   uint32_t numBuffers_;
   std::vector<std::shared_ptr<arrow::Buffer>> buffers_;
+  // Whether the compressed buffers carry checksums.
+  bool checksum_;
 };
 
 class InMemoryPayload final : public Payload {
@@ -134,8 +151,11 @@ class InMemoryPayload final : public Payload {
 
   arrow::Result<std::shared_ptr<arrow::Buffer>> readBufferAt(uint32_t index);
 
-  arrow::Result<std::unique_ptr<BlockPayload>>
-  toBlockPayload(Payload::Type payloadType, arrow::MemoryPool* pool, arrow::util::Codec* codec);
+  arrow::Result<std::unique_ptr<BlockPayload>> toBlockPayload(
+      Payload::Type payloadType,
+      arrow::MemoryPool* pool,
+      arrow::util::Codec* codec,
+      bool checksum = false);
 
   arrow::Status copyBuffers(arrow::MemoryPool* pool);
 
@@ -166,7 +186,8 @@ class UncompressedDiskBlockPayload final : public Payload {
       arrow::io::InputStream*& inputStream,
       uint64_t rawSize,
       arrow::MemoryPool* pool,
-      arrow::util::Codec* codec);
+      arrow::util::Codec* codec,
+      bool checksum = false);
 
   arrow::Status serialize(arrow::io::OutputStream* outputStream) override;
 
@@ -177,6 +198,7 @@ class UncompressedDiskBlockPayload final : public Payload {
   int64_t rawSize_;
   arrow::MemoryPool* pool_;
   arrow::util::Codec* codec_;
+  bool checksum_;
 
   arrow::Result<std::shared_ptr<arrow::Buffer>> readUncompressedBuffer();
 };
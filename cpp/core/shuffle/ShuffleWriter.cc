@@ -25,6 +25,7 @@ const std::string kHashShuffleName = "hash";
 const std::string kSortShuffleName = "sort";
 const std::string kRssSortShuffleName = "rss_sort";
 const std::string kGpuHashShuffleName = "gpu_hash";
+const std::string kAdaptiveShuffleName = "adaptive";
 } // namespace
 
 ShuffleWriterType ShuffleWriter::stringToType(const std::string& typeString) {
@@ -40,6 +41,9 @@ ShuffleWriterType ShuffleWriter::stringToType(const std::string& typeString) {
   if (typeString == kGpuHashShuffleName) {
     return ShuffleWriterType::kGpuHashShuffle;
   }
+  if (typeString == kAdaptiveShuffleName) {
+    return ShuffleWriterType::kAdaptiveShuffle;
+  }
   throw GlutenException("Unrecognized shuffle writer type: " + typeString);
 }
 
@@ -53,6 +57,8 @@ std::string ShuffleWriter::typeToString(ShuffleWriterType type) {
       return kRssSortShuffleName;
     case ShuffleWriterType::kGpuHashShuffle:
       return kGpuHashShuffleName;
+    case ShuffleWriterType::kAdaptiveShuffle:
+      return kAdaptiveShuffleName;
   }
   GLUTEN_UNREACHABLE();
 }
@@ -85,6 +91,14 @@ int64_t ShuffleWriter::totalCompressTime() const {
   return metrics_.totalCompressTime;
 }
 
+int64_t ShuffleWriter::totalBytesSpilled() const {
+  return metrics_.totalBytesSpilled;
+}
+
+int64_t ShuffleWriter::totalSpillTime() const {
+  return metrics_.totalSpillTime;
+}
+
 int64_t ShuffleWriter::totalSortTime() const {
   return 0;
 }
@@ -109,6 +123,10 @@ const std::vector<int64_t>& ShuffleWriter::rawPartitionLengths() const {
   return metrics_.rawPartitionLengths;
 }
 
+const ShuffleWriterMetrics& ShuffleWriter::metrics() const {
+  return metrics_;
+}
+
 ShuffleWriter::ShuffleWriter(int32_t numPartitions, Partitioning partitioning)
     : numPartitions_(numPartitions), partitioning_(partitioning) {}
 } // namespace gluten
@@ -53,6 +53,10 @@ class ShuffleWriter : public Reclaimable {
 
   int64_t totalCompressTime() const;
 
+  int64_t totalBytesSpilled() const;
+
+  int64_t totalSpillTime() const;
+
   virtual int64_t peakBytesAllocated() const = 0;
 
   virtual int64_t totalSortTime() const;
@@ -67,6 +71,8 @@ class ShuffleWriter : public Reclaimable {
 
   const std::vector<int64_t>& rawPartitionLengths() const;
 
+  const ShuffleWriterMetrics& metrics() const;
+
  protected:
   ShuffleWriter(int32_t numPartitions, Partitioning partitioning);
 
@@ -47,14 +47,15 @@ void Spill::insertPayload(
     const std::vector<bool>* isValidityBuffer,
     int64_t rawSize,
     arrow::MemoryPool* pool,
-    arrow::util::Codec* codec) {
+    arrow::util::Codec* codec,
+    bool checksum) {
   switch (payloadType) {
     case Payload::Type::kUncompressed:
     case Payload::Type::kToBeCompressed:
       partitionPayloads_.push_back(
           {partitionId,
            std::make_unique<UncompressedDiskBlockPayload>(
-               payloadType, numRows, isValidityBuffer, rawIs_, rawSize, pool, codec)});
+               payloadType, numRows, isValidityBuffer, rawIs_, rawSize, pool, codec, checksum)});
       break;
     case Payload::Type::kCompressed:
     case Payload::Type::kRaw:
@@ -44,7 +44,8 @@ class Spill final {
       const std::vector<bool>* isValidityBuffer,
       int64_t rawSize,
       arrow::MemoryPool* pool,
-      arrow::util::Codec* codec);
+      arrow::util::Codec* codec,
+      bool checksum = false);
 
   void setSpillFile(const std::string& spillFile);
 
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/LocalSegmentReader.h"
+
+#include <arrow/io/file.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "utils/Exception.h"
+
+namespace gluten {
+
+class LocalSegmentReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = (std::filesystem::temp_directory_path() / ("local_segment_reader_test_" + std::to_string(getpid()))).string();
+    for (auto i = 0; i < 1000; ++i) {
+      content_.push_back(static_cast<char>(i % 127));
+    }
+    std::ofstream out(path_, std::ios::binary);
+    out.write(content_.data(), content_.size());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  std::string readAll(const std::shared_ptr<arrow::io::InputStream>& in) {
+    std::string result;
+    while (true) {
+      GLUTEN_ASSIGN_OR_THROW(auto buffer, in->Read(7));
+      if (buffer->size() == 0) {
+        break;
+      }
+      result.append(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+    }
+    return result;
+  }
+
+  std::string path_;
+  std::string content_;
+};
+
+TEST_F(LocalSegmentReaderTest, coalesceAdjacentSegments) {
+  LocalSegmentReader reader(300);
+  ASSERT_TRUE(reader.tryAdd({path_, 0, 100}, arrow::default_memory_pool()));
+  ASSERT_TRUE(reader.tryAdd({path_, 100, 50}, arrow::default_memory_pool()));
+  // Not adjacent.
+  ASSERT_FALSE(reader.tryAdd({path_, 200, 50}, arrow::default_memory_pool()));
+
+  auto streams = reader.readGroup();
+  ASSERT_TRUE(reader.empty());
+  ASSERT_EQ(streams.size(), 2);
+  ASSERT_EQ(readAll(streams[0]), content_.substr(0, 100));
+  ASSERT_EQ(readAll(streams[1]), content_.substr(100, 50));
+
+  ASSERT_TRUE(reader.tryAdd({path_, 200, 200}, arrow::default_memory_pool()));
+  // Exceeds the max coalesced bytes.
+  ASSERT_FALSE(reader.tryAdd({path_, 400, 200}, arrow::default_memory_pool()));
+  streams = reader.readGroup();
+  ASSERT_EQ(streams.size(), 1);
+  ASSERT_EQ(readAll(streams[0]), content_.substr(200, 200));
+}
+
+TEST_F(LocalSegmentReaderTest, readLargeSegmentLazily) {
+  LocalSegmentReader reader(100);
+  ASSERT_TRUE(reader.tryAdd({path_, 10, 900}, arrow::default_memory_pool()));
+  auto streams = reader.readGroup();
+  ASSERT_EQ(streams.size(), 1);
+  ASSERT_EQ(readAll(streams[0]), content_.substr(10, 900));
+}
+
+} // namespace gluten
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/Payload.h"
+
+#include <arrow/io/memory.h>
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "utils/Compression.h"
+#include "utils/Crc32c.h"
+#include "utils/Exception.h"
+
+namespace gluten {
+
+class PayloadChecksumTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    codec_ = createCompressionCodec(arrow::Compression::LZ4_FRAME, CodecBackend::NONE);
+  }
+
+  std::vector<std::shared_ptr<arrow::Buffer>> makeBuffers() {
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    // Null validity buffer.
+    buffers.push_back(nullptr);
+    // Compressible.
+    GLUTEN_ASSIGN_OR_THROW(std::shared_ptr<arrow::Buffer> repeated, arrow::AllocateBuffer(4096));
+    for (auto i = 0; i < repeated->size(); ++i) {
+      repeated->mutable_data()[i] = static_cast<uint8_t>(i % 8);
+    }
+    buffers.push_back(repeated);
+    // Incompressible, written as is.
+    GLUTEN_ASSIGN_OR_THROW(std::shared_ptr<arrow::Buffer> random, arrow::AllocateBuffer(4096));
+    std::mt19937 gen(42);
+    for (auto i = 0; i < random->size(); ++i) {
+      random->mutable_data()[i] = static_cast<uint8_t>(gen());
+    }
+    buffers.push_back(random);
+    // Empty.
+    buffers.push_back(zeroLengthNullBuffer());
+    return buffers;
+  }
+
+  std::shared_ptr<arrow::Buffer> serialize(bool checksum) {
+    GLUTEN_ASSIGN_OR_THROW(
+        auto payload,
+        BlockPayload::fromBuffers(
+            Payload::kCompressed, kNumRows, makeBuffers(), &isValidityBuffer_, pool_, codec_.get(), checksum));
+    GLUTEN_ASSIGN_OR_THROW(auto out, arrow::io::BufferOutputStream::Create(1024, pool_));
+    GLUTEN_THROW_NOT_OK(payload->serialize(out.get()));
+    GLUTEN_ASSIGN_OR_THROW(auto serialized, out->Finish());
+    return serialized;
+  }
+
+  std::vector<std::shared_ptr<arrow::Buffer>> deserialize(const std::shared_ptr<arrow::Buffer>& serialized) {
+    arrow::io::BufferReader in(serialized);
+    uint32_t numRows = 0;
+    int64_t deserializeTime = 0;
+    int64_t decompressTime = 0;
+    GLUTEN_ASSIGN_OR_THROW(
+        auto buffers, BlockPayload::deserialize(&in, codec_, pool_, numRows, deserializeTime, decompressTime));
+    EXPECT_EQ(numRows, kNumRows);
+    return buffers;
+  }
+
+  static constexpr uint32_t kNumRows = 1024;
+
+  arrow::MemoryPool* pool_ = arrow::default_memory_pool();
+  std::shared_ptr<arrow::util::Codec> codec_;
+  std::vector<bool> isValidityBuffer_{true, false, false, false};
+};
+
+TEST_F(PayloadChecksumTest, crc32c) {
+  const std::string data = "123456789";
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+  ASSERT_EQ(crc32c(bytes, data.size()), 0xe3069283);
+  // Chained.
+  ASSERT_EQ(crc32c(bytes + 4, data.size() - 4, crc32c(bytes, 4)), 0xe3069283);
+}
+
+TEST_F(PayloadChecksumTest, roundTrip) {
+  auto expected = makeBuffers();
+  for (auto checksum : {false, true}) {
+    auto serialized = serialize(checksum);
+    ASSERT_EQ(serialized->data()[0], checksum ? Payload::kCompressedWithChecksum : Payload::kCompressed);
+
+    auto buffers = deserialize(serialized);
+    ASSERT_EQ(buffers.size(), expected.size());
+    ASSERT_EQ(buffers[0], nullptr);
+    for (auto i = 1; i < expected.size(); ++i) {
+      ASSERT_TRUE(buffers[i]->Equals(*expected[i])) << "buffer " << i;
+    }
+  }
+  // Each non-empty buffer has a 4-byte checksum.
+  ASSERT_EQ(serialize(true)->size(), serialize(false)->size() + 2 * sizeof(uint32_t));
+}
+
+TEST_F(PayloadChecksumTest, corruption) {
+  auto serialized = serialize(true);
+  // The compressed buffer follows the payload header, the null buffer and its own header. The incompressible buffer is
+  // followed by the 8-byte length of the empty buffer.
+  constexpr int64_t kCompressedOffset = 1 + 2 * sizeof(uint32_t) + 3 * sizeof(int64_t) + sizeof(uint32_t);
+  const int64_t uncompressedOffset = serialized->size() - sizeof(int64_t) - 1;
+  // Flip one bit in the compressed and in the uncompressed buffer.
+  for (auto offset : {kCompressedOffset, uncompressedOffset}) {
+    GLUTEN_ASSIGN_OR_THROW(std::shared_ptr<arrow::Buffer> corrupted, arrow::AllocateBuffer(serialized->size()));
+    memcpy(corrupted->mutable_data(), serialized->data(), serialized->size());
+    corrupted->mutable_data()[offset] ^= 0x10;
+    ASSERT_THROW(deserialize(corrupted), ShuffleChecksumException);
+  }
+
+  // Without checksums the corruption of an uncompressed buffer is not detected.
+  auto plain = serialize(false);
+  GLUTEN_ASSIGN_OR_THROW(std::shared_ptr<arrow::Buffer> corrupted, arrow::AllocateBuffer(plain->size()));
+  memcpy(corrupted->mutable_data(), plain->data(), plain->size());
+  corrupted->mutable_data()[plain->size() - sizeof(int64_t) - 1] ^= 0x10;
+  ASSERT_NO_THROW(deserialize(corrupted));
+}
+
+} // namespace gluten
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/Crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace gluten {
+namespace {
+
+#if !defined(__SSE4_2__) && !defined(__ARM_FEATURE_CRC32)
+constexpr uint32_t kCastagnoliPolynomial = 0x82f63b78;
+
+constexpr std::array<uint32_t, 256> makeTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    auto crc = i;
+    for (auto bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? kCastagnoliPolynomial : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr auto kTable = makeTable();
+#endif
+
+inline uint32_t crc32cByte(uint32_t crc, uint8_t value) {
+#if defined(__SSE4_2__)
+  return _mm_crc32_u8(crc, value);
+#elif defined(__ARM_FEATURE_CRC32)
+  return __crc32cb(crc, value);
+#else
+  return kTable[(crc ^ value) & 0xff] ^ (crc >> 8);
+#endif
+}
+
+} // namespace
+
+uint32_t crc32c(const uint8_t* data, int64_t length, uint32_t crc) {
+  crc = ~crc;
+#if defined(__SSE4_2__) || defined(__ARM_FEATURE_CRC32)
+  uint64_t crc64 = crc;
+  while (length >= static_cast<int64_t>(sizeof(uint64_t))) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+#if defined(__SSE4_2__)
+    crc64 = _mm_crc32_u64(crc64, word);
+#else
+    crc64 = __crc32cd(static_cast<uint32_t>(crc64), word);
+#endif
+    data += sizeof(word);
+    length -= sizeof(word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+#endif
+  while (length-- > 0) {
+    crc = crc32cByte(crc, *data++);
+  }
+  return ~crc;
+}
+
+} // namespace gluten
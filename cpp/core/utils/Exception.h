@@ -59,4 +59,11 @@ class GlutenException final : public std::runtime_error {
   explicit GlutenException(const std::string& arg) : runtime_error(arg) {}
 };
 
+// A shuffle block doesn't match its checksum. Thrown to the JVM as ShuffleChecksumException, which is reported as a
+// fetch failure so that the block is produced and fetched again.
+class ShuffleChecksumException final : public std::runtime_error {
+ public:
+  explicit ShuffleChecksumException(const std::string& arg) : runtime_error(arg) {}
+};
+
 } // namespace gluten
@@ -53,7 +53,7 @@ DEFINE_string(save_output, "", "Path to parquet file for saving the task output
 DEFINE_bool(with_shuffle, false, "Add shuffle split at end.");
 DEFINE_bool(run_shuffle, false, "Only run shuffle write.");
 DEFINE_bool(run_shuffle_read, false, "Whether to run shuffle read when run_shuffle is true.");
-DEFINE_string(shuffle_writer, "hash", "Shuffle writer type. Can be hash or sort");
+DEFINE_string(shuffle_writer, "hash", "Shuffle writer type. Can be hash, sort or adaptive");
 DEFINE_string(
     partitioning,
     "rr",
@@ -62,6 +62,10 @@ DEFINE_bool(rss, false, "Mocking rss.");
 DEFINE_string(compression, "lz4", "Specify the compression codec. Valid options are none, lz4, zstd");
 DEFINE_int32(shuffle_partitions, 200, "Number of shuffle split (reducer) partitions");
 DEFINE_bool(shuffle_dictionary, false, "Whether to enable dictionary encoding for shuffle write.");
+DEFINE_bool(
+    sort_columnar_payload,
+    false,
+    "Whether the sort shuffle writer transposes rows into columnar payloads. The output is read by the hash reader.");
 
 DEFINE_string(plan, "", "Path to input json file of the substrait plan.");
 DEFINE_string(
@@ -212,12 +216,17 @@ std::shared_ptr<ShuffleWriterOptions> createShuffleWriterOptions() {
     case ShuffleWriterType::kHashShuffle:
       options = std::make_shared<HashShuffleWriterOptions>();
       break;
-    case ShuffleWriterType::kSortShuffle:
-      options = std::make_shared<SortShuffleWriterOptions>();
-      break;
+    case ShuffleWriterType::kSortShuffle: {
+      auto sortOptions = std::make_shared<SortShuffleWriterOptions>();
+      sortOptions->columnarPayload = FLAGS_sort_columnar_payload;
+      options = sortOptions;
+    } break;
     case ShuffleWriterType::kRssSortShuffle:
       options = std::make_shared<RssSortShuffleWriterOptions>();
       break;
+    case ShuffleWriterType::kAdaptiveShuffle:
+      options = std::make_shared<AdaptiveShuffleWriterOptions>();
+      break;
     default:
       throw GlutenException("Unsupported shuffle writer type: " + FLAGS_shuffle_writer);
   }
@@ -237,7 +246,10 @@ std::shared_ptr<VeloxShuffleWriter> createShuffleWriter(
 
 std::shared_ptr<ShuffleReader> createShuffleReader(Runtime* runtime, const std::shared_ptr<arrow::Schema>& schema) {
   auto readerOptions = ShuffleReaderOptions{};
-  readerOptions.shuffleWriterType = ShuffleWriter::stringToType(FLAGS_shuffle_writer),
+  readerOptions.shuffleWriterType = ShuffleWriter::stringToType(FLAGS_shuffle_writer);
+  if (readerOptions.shuffleWriterType == ShuffleWriterType::kSortShuffle && FLAGS_sort_columnar_payload) {
+    readerOptions.shuffleWriterType = ShuffleWriterType::kHashShuffle;
+  }
   setCompressionTypeFromFlag(readerOptions.compressionType, readerOptions.codecBackend);
   return runtime->createShuffleReader(schema, readerOptions);
 }
@@ -24,6 +24,9 @@
 #include "operators/reader/ParquetReaderIterator.h"
 #include "operators/writer/VeloxParquetDataSource.h"
 #include "utils/VeloxArrowUtils.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
 
 namespace gluten {
 
@@ -105,6 +108,94 @@ class GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark {
   std::string outputPath_;
 };
 
+// Writes generated batches of low-cardinality string columns wrapped in dictionaries, and a constant column.
+// Args: {cardinality, flatten}. With flatten = 1 the batches are flattened in Gluten before writing, otherwise only the
+// Arrow export in the Velox Parquet writer flattens them.
+class GoogleBenchmarkVeloxParquetWriteDictionaryBenchmark {
+ public:
+  explicit GoogleBenchmarkVeloxParquetWriteDictionaryBenchmark(const std::string& outputPath) : outputPath_(outputPath) {}
+
+  void operator()(benchmark::State& state) {
+    const auto cardinality = static_cast<vector_size_t>(state.range(0));
+    const bool flatten = state.range(1) != 0;
+    constexpr int32_t kNumStringColumns = 8;
+    constexpr int32_t kNumBatches = 100;
+    constexpr vector_size_t kNumRows = 4096;
+
+    auto memoryManager = getDefaultMemoryManager();
+    auto runtime = Runtime::create(kVeloxBackendKind, memoryManager);
+    auto veloxPool = memoryManager->getAggregateMemoryPool();
+    auto pool = memoryManager->getLeafMemoryPool();
+
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    std::vector<VectorPtr> dictionaries;
+    for (auto i = 0; i < kNumStringColumns; ++i) {
+      names.push_back("s" + std::to_string(i));
+      types.push_back(VARCHAR());
+      auto dictionary = BaseVector::create<FlatVector<StringView>>(VARCHAR(), cardinality, pool.get());
+      for (auto j = 0; j < cardinality; ++j) {
+        dictionary->set(j, StringView(fmt::format("category_{}_value_{:08d}", i, j)));
+      }
+      dictionaries.push_back(dictionary);
+    }
+    names.push_back("c");
+    types.push_back(BIGINT());
+    auto rowType = ROW(std::move(names), std::move(types));
+
+    std::vector<std::shared_ptr<VeloxColumnarBatch>> batches;
+    for (auto b = 0; b < kNumBatches; ++b) {
+      std::vector<VectorPtr> children;
+      for (auto i = 0; i < kNumStringColumns; ++i) {
+        auto indices = allocateIndices(kNumRows, pool.get());
+        auto* rawIndices = indices->asMutable<vector_size_t>();
+        for (auto r = 0; r < kNumRows; ++r) {
+          rawIndices[r] = (r * 7919 + b * 31 + i) % cardinality;
+        }
+        children.push_back(BaseVector::wrapInDictionary(nullptr, indices, kNumRows, dictionaries[i]));
+      }
+      children.push_back(BaseVector::createConstant(BIGINT(), variant(int64_t(b)), kNumRows, pool.get()));
+      batches.push_back(std::make_shared<VeloxColumnarBatch>(
+          std::make_shared<RowVector>(pool.get(), rowType, nullptr, kNumRows, std::move(children))));
+    }
+
+    int64_t writeTime = 0;
+    for (auto _ : state) {
+      auto veloxParquetDataSource = std::make_unique<gluten::VeloxParquetDataSource>(
+          outputPath_ + "/velox_parquet_write_dictionary.parquet",
+          veloxPool->addAggregateChild("writer_benchmark"),
+          veloxPool->addLeafChild("sink_pool"),
+          toArrowSchema(rowType, pool.get()));
+      veloxParquetDataSource->init(runtime->getConfMap());
+
+      ScopedTimer timer(&writeTime);
+      for (const auto& batch : batches) {
+        if (flatten) {
+          // Flatten a copy so that every iteration starts from the encoded batches.
+          auto copy = std::make_shared<VeloxColumnarBatch>(std::make_shared<RowVector>(
+              pool.get(), rowType, nullptr, kNumRows, batch->getRowVector()->children()));
+          copy->getFlattenedRowVector();
+          veloxParquetDataSource->write(copy);
+        } else {
+          veloxParquetDataSource->write(batch);
+        }
+      }
+      veloxParquetDataSource->close();
+    }
+
+    state.counters["cardinality"] = benchmark::Counter(cardinality);
+    state.counters["num_rows"] = benchmark::Counter(
+        kNumRows * kNumBatches, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
+    state.counters["write_time"] =
+        benchmark::Counter(writeTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
+    state.counters["peak_memory"] = benchmark::Counter(veloxPool->peakBytes(), benchmark::Counter::kAvgThreads);
+    Runtime::release(runtime);
+  }
+
+ private:
+  std::string outputPath_;
+};
+
 } // namespace gluten
 
 // GoogleBenchmarkVeloxParquetWriteCacheScanBenchmark usage
@@ -150,6 +241,16 @@ int main(int argc, char** argv) {
       ->MeasureProcessCPUTime()
       ->Unit(benchmark::kSecond);
 
+  gluten::GoogleBenchmarkVeloxParquetWriteDictionaryBenchmark dictionaryBck(output);
+
+  benchmark::RegisterBenchmark("GoogleBenchmarkParquetWrite::Dictionary", dictionaryBck)
+      ->ArgsProduct({{16, 1024}, {0, 1}})
+      ->Iterations(iterations)
+      ->Threads(threads)
+      ->ReportAggregatesOnly(false)
+      ->MeasureProcessCPUTime()
+      ->Unit(benchmark::kMillisecond);
+
   benchmark::Initialize(&argc, argv);
   benchmark::RunSpecifiedBenchmarks();
   benchmark::Shutdown();
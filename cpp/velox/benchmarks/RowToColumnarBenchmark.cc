@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks/common/BenchmarkUtils.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryManager.h"
+#include "operators/serializer/VeloxColumnarToRowConverter.h"
+#include "operators/serializer/VeloxRowToColumnarConverter.h"
+#include "utils/VeloxArrowUtils.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+// Converts unsafe rows of a flat schema and of nested schemas back to columnar batches. The flat schema has the types
+// of VeloxRowToColumnarTest, and the nested schemas wrap some of them in arrays, maps and structs.
+// Args: {schema}, where 0 is flat, 1 is arrays, 2 is maps and 3 is structs.
+class GoogleBenchmarkRowToColumnar {
+ public:
+  void operator()(benchmark::State& state) {
+    constexpr vector_size_t kNumRows = 4096;
+    auto memoryManager = getDefaultMemoryManager();
+    auto pool = memoryManager->getLeafMemoryPool();
+
+    VectorFuzzer::Options options;
+    options.vectorSize = kNumRows;
+    options.nullRatio = 0.1;
+    options.containerLength = 8;
+    options.stringLength = 20;
+    VectorFuzzer fuzzer(options, pool.get(), 42);
+    auto input = fuzzer.fuzzInputFlatRow(schema(state.range(0)));
+
+    auto columnarToRow = std::make_shared<VeloxColumnarToRowConverter>(pool, 64 << 20);
+    columnarToRow->convert(std::make_shared<VeloxColumnarBatch>(input));
+    const auto& lengths = columnarToRow->getLengths();
+    std::vector<int64_t> rowLengths(lengths.begin(), lengths.end());
+    int64_t bytes = 0;
+    for (const auto length : rowLengths) {
+      bytes += length;
+    }
+
+    ArrowSchema cSchema;
+    toArrowSchema(input->type(), pool.get(), &cSchema);
+    VeloxRowToColumnarConverter rowToColumnar(&cSchema, pool);
+
+    // The rows converted at once are bounded by the memory threshold of the columnar to row converter.
+    const int64_t numRowsPerBatch = rowLengths.size();
+    int64_t numRows = 0;
+    for (auto _ : state) {
+      auto batch = rowToColumnar.convert(numRowsPerBatch, rowLengths.data(), columnarToRow->getBufferAddress());
+      benchmark::DoNotOptimize(batch);
+      numRows += numRowsPerBatch;
+    }
+
+    state.counters["rows_per_second"] =
+        benchmark::Counter(numRows, benchmark::Counter::kIsRate, benchmark::Counter::OneK::kIs1000);
+    state.counters["bytes_per_second"] = benchmark::Counter(
+        bytes * state.iterations(), benchmark::Counter::kIsRate, benchmark::Counter::OneK::kIs1024);
+  }
+
+ private:
+  static RowTypePtr schema(int64_t kind) {
+    switch (kind) {
+      case 0:
+        return ROW(
+            {TINYINT(), INTEGER(), BIGINT(), DOUBLE(), VARCHAR(), DECIMAL(38, 2), DECIMAL(12, 3), TIMESTAMP()});
+      case 1:
+        return ROW({ARRAY(INTEGER()), ARRAY(BIGINT()), ARRAY(DOUBLE()), ARRAY(VARCHAR()), ARRAY(DECIMAL(38, 2))});
+      case 2:
+        return ROW({MAP(INTEGER(), BIGINT()), MAP(VARCHAR(), DOUBLE()), MAP(BIGINT(), ARRAY(VARCHAR()))});
+      default:
+        return ROW(
+            {ROW({INTEGER(), VARCHAR(), DOUBLE()}),
+             ROW({BIGINT(), ARRAY(INTEGER())}),
+             ARRAY(ROW({VARCHAR(), BIGINT()}))});
+    }
+  }
+};
+
+} // namespace gluten
+
+// ./row_to_columnar_benchmark --iterations 100
+int main(int argc, char** argv) {
+  gluten::initVeloxBackend();
+  uint32_t iterations = 100;
+
+  for (int i = 0; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0) {
+      iterations = atol(argv[i + 1]);
+    }
+  }
+  LOG(INFO) << "iterations = " << iterations;
+
+  gluten::GoogleBenchmarkRowToColumnar bck;
+
+  benchmark::RegisterBenchmark("GoogleBenchmarkRowToColumnar::Convert", bck)
+      ->ArgsProduct({{0, 1, 2, 3}})
+      ->Iterations(iterations)
+      ->ReportAggregatesOnly(false)
+      ->MeasureProcessCPUTime()
+      ->Unit(benchmark::kMicrosecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
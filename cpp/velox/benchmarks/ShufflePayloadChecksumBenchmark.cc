@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/io/memory.h>
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "benchmarks/common/BenchmarkUtils.h"
+#include "shuffle/Payload.h"
+#include "utils/Compression.h"
+#include "utils/Timer.h"
+
+namespace gluten {
+
+// Compresses, serializes and deserializes one payload of 16 buffers with and without CRC32C checksums, to measure the
+// overhead of computing the checksums when compressing and verifying them when reading.
+// Args: {bufferSize, checksum}.
+class GoogleBenchmarkShufflePayloadChecksum {
+ public:
+  void operator()(benchmark::State& state) {
+    const auto bufferSize = state.range(0);
+    const bool checksum = state.range(1) != 0;
+    constexpr int32_t kNumBuffers = 16;
+    constexpr uint32_t kNumRows = 4096;
+
+    auto* pool = arrow::default_memory_pool();
+    std::shared_ptr<arrow::util::Codec> codec =
+        createCompressionCodec(arrow::Compression::LZ4_FRAME, CodecBackend::NONE);
+
+    // Half compressible, half random buffers, so that both the compressed and the uncompressed fallback are covered.
+    std::mt19937 gen(42);
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    for (auto i = 0; i < kNumBuffers; ++i) {
+      GLUTEN_ASSIGN_OR_THROW(std::shared_ptr<arrow::Buffer> buffer, arrow::AllocateBuffer(bufferSize, pool));
+      for (auto j = 0; j < bufferSize; ++j) {
+        buffer->mutable_data()[j] = static_cast<uint8_t>(i % 2 == 0 ? gen() % 16 : gen());
+      }
+      buffers.push_back(std::move(buffer));
+    }
+    std::vector<bool> isValidityBuffer(kNumBuffers, false);
+
+    int64_t compressTime = 0;
+    int64_t readTime = 0;
+    int64_t bytes = 0;
+    for (auto _ : state) {
+      std::shared_ptr<arrow::Buffer> serialized;
+      {
+        ScopedTimer timer(&compressTime);
+        GLUTEN_ASSIGN_OR_THROW(
+            auto payload,
+            BlockPayload::fromBuffers(
+                Payload::kCompressed, kNumRows, buffers, &isValidityBuffer, pool, codec.get(), checksum));
+        GLUTEN_ASSIGN_OR_THROW(auto out, arrow::io::BufferOutputStream::Create(bufferSize * kNumBuffers, pool));
+        GLUTEN_THROW_NOT_OK(payload->serialize(out.get()));
+        GLUTEN_ASSIGN_OR_THROW(serialized, out->Finish());
+      }
+      {
+        ScopedTimer timer(&readTime);
+        arrow::io::BufferReader in(serialized);
+        uint32_t numRows = 0;
+        int64_t deserializeTime = 0;
+        int64_t decompressTime = 0;
+        GLUTEN_ASSIGN_OR_THROW(
+            auto result, BlockPayload::deserialize(&in, codec, pool, numRows, deserializeTime, decompressTime));
+        benchmark::DoNotOptimize(result);
+      }
+      bytes += bufferSize * kNumBuffers;
+    }
+
+    state.counters["compress_time"] =
+        benchmark::Counter(compressTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+    state.counters["read_time"] =
+        benchmark::Counter(readTime, benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1000);
+    state.counters["bytes_per_second"] =
+        benchmark::Counter(bytes, benchmark::Counter::kIsRate, benchmark::Counter::OneK::kIs1024);
+  }
+};
+
+} // namespace gluten
+
+// ./shuffle_payload_checksum_benchmark --iterations 100
+int main(int argc, char** argv) {
+  uint32_t iterations = 100;
+
+  for (int i = 0; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0) {
+      iterations = atol(argv[i + 1]);
+    }
+  }
+  LOG(INFO) << "iterations = " << iterations;
+
+  gluten::GoogleBenchmarkShufflePayloadChecksum bck;
+
+  benchmark::RegisterBenchmark("GoogleBenchmarkShufflePayload::Checksum", bck)
+      ->ArgsProduct({{4 << 10, 64 << 10, 1 << 20}, {0, 1}})
+      ->Iterations(iterations)
+      ->ReportAggregatesOnly(false)
+      ->MeasureProcessCPUTime()
+      ->Unit(benchmark::kMicrosecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <numeric>
+
+#include "benchmarks/common/BenchmarkUtils.h"
+#include "memory/VeloxColumnarBatch.h"
+#include "memory/VeloxMemoryManager.h"
+#include "shuffle/LocalPartitionWriter.h"
+#include "shuffle/VeloxShuffleWriter.h"
+#include "utils/Timer.h"
+#include "velox/vector/FlatVector.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+// Writes generated batches into the sort shuffle writer with random partitioning, so that the sorted rows are gathered
+// from random page offsets, and measures stop() which sorts and evicts all buffered rows.
+// Args: {numPartitions, numBigintColumns}.
+class GoogleBenchmarkSortShuffleEvictBenchmark {
+ public:
+  explicit GoogleBenchmarkSortShuffleEvictBenchmark(const std::string& outputPath) : outputPath_(outputPath) {}
+
+  void operator()(benchmark::State& state) {
+    const auto numPartitions = static_cast<uint32_t>(state.range(0));
+    const auto numBigintColumns = static_cast<int32_t>(state.range(1));
+    constexpr int32_t kNumBatches = 256;
+    constexpr vector_size_t kNumRows = 4096;
+
+    auto memoryManager = getDefaultMemoryManager();
+    auto pool = memoryManager->getLeafMemoryPool();
+
+    std::vector<std::string> names;
+    std::vector<TypePtr> types;
+    std::vector<VectorPtr> children;
+    for (auto i = 0; i < numBigintColumns; ++i) {
+      names.push_back("l" + std::to_string(i));
+      types.push_back(BIGINT());
+      auto column = BaseVector::create<FlatVector<int64_t>>(BIGINT(), kNumRows, pool.get());
+      for (auto r = 0; r < kNumRows; ++r) {
+        column->set(r, r * 7919L + i);
+      }
+      children.push_back(column);
+    }
+    names.push_back("s");
+    types.push_back(VARCHAR());
+    auto strings = BaseVector::create<FlatVector<StringView>>(VARCHAR(), kNumRows, pool.get());
+    for (auto r = 0; r < kNumRows; ++r) {
+      strings->set(r, StringView(fmt::format("value_{:016d}", r)));
+    }
+    children.push_back(strings);
+    auto batch = std::make_shared<VeloxColumnarBatch>(std::make_shared<RowVector>(
+        pool.get(), ROW(std::move(names), std::move(types)), nullptr, kNumRows, std::move(children)));
+
+    int64_t evictTime = 0;
+    int64_t sortTime = 0;
+    int64_t rawBytes = 0;
+    for (auto _ : state) {
+      auto partitionWriter = std::make_shared<LocalPartitionWriter>(
+          numPartitions,
+          nullptr,
+          memoryManager,
+          std::make_shared<LocalPartitionWriterOptions>(),
+          outputPath_ + "/sort_shuffle_evict.data",
+          std::vector<std::string>{outputPath_});
+      auto options = std::make_shared<SortShuffleWriterOptions>();
+      options->partitioning = Partitioning::kRandom;
+      GLUTEN_ASSIGN_OR_THROW(
+          auto shuffleWriter,
+          VeloxShuffleWriter::create(
+              ShuffleWriterType::kSortShuffle, numPartitions, partitionWriter, options, memoryManager));
+
+      for (auto b = 0; b < kNumBatches; ++b) {
+        GLUTEN_THROW_NOT_OK(shuffleWriter->write(batch, std::numeric_limits<int64_t>::max()));
+      }
+      {
+        ScopedTimer timer(&evictTime);
+        GLUTEN_THROW_NOT_OK(shuffleWriter->stop());
+      }
+      sortTime += shuffleWriter->totalSortTime();
+      const auto& lengths = shuffleWriter->rawPartitionLengths();
+      rawBytes += std::accumulate(lengths.begin(), lengths.end(), 0L);
+    }
+
+    state.counters["num_partitions"] = benchmark::Counter(numPartitions);
+    state.counters["num_rows"] = benchmark::Counter(
+        kNumRows * kNumBatches, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
+    state.counters["evict_time"] =
+        benchmark::Counter(evictTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
+    // The sort time includes gathering the sorted rows into the disk write buffer.
+    state.counters["sort_time"] =
+        benchmark::Counter(sortTime, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1000);
+    const double bytesPerSecond = evictTime > 0 ? rawBytes * 1e9 / evictTime : 0;
+    state.counters["evict_bytes_per_second"] =
+        benchmark::Counter(bytesPerSecond, benchmark::Counter::kAvgThreads, benchmark::Counter::OneK::kIs1024);
+  }
+
+ private:
+  std::string outputPath_;
+};
+
+} // namespace gluten
+
+// ./sort_shuffle_evict_benchmark --iterations 3 --output /tmp
+int main(int argc, char** argv) {
+  gluten::initVeloxBackend();
+  uint32_t iterations = 1;
+  std::string output = "/tmp";
+
+  for (int i = 0; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0) {
+      iterations = atol(argv[i + 1]);
+    } else if (strcmp(argv[i], "--output") == 0) {
+      output = argv[i + 1];
+    }
+  }
+  LOG(INFO) << "iterations = " << iterations;
+  LOG(INFO) << "output = " << output;
+
+  gluten::GoogleBenchmarkSortShuffleEvictBenchmark bck(output);
+
+  benchmark::RegisterBenchmark("GoogleBenchmarkSortShuffle::Evict", bck)
+      ->ArgsProduct({{16, 1000, 10000}, {2, 16}})
+      ->Iterations(iterations)
+      ->ReportAggregatesOnly(false)
+      ->MeasureProcessCPUTime()
+      ->Unit(benchmark::kMillisecond);
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+}
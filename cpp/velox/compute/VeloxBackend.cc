@@ -230,6 +230,11 @@ void VeloxBackend::init(
   // after the memory manager instanced
   initCache();
 
+  auto planCacheSize = backendConf_->get<int32_t>(kVeloxPlanCacheSize, kVeloxPlanCacheSizeDefault);
+  if (planCacheSize > 0) {
+    planCache_ = std::make_unique<VeloxPlanCache>(planCacheSize);
+  }
+
   registerShuffleDictionaryWriterFactory([](MemoryManager* memoryManager, arrow::util::Codec* codec) {
     return std::make_unique<ArrowShuffleDictionaryWriter>(memoryManager, codec);
   });
@@ -315,6 +320,11 @@ void VeloxBackend::initConnector(const std::shared_ptr<velox::config::ConfigBase
   if (ioThreads > 0) {
     ioExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(ioThreads);
   }
+  auto parquetWriteIOThreads =
+      backendConf_->get<int32_t>(kVeloxParquetWriteIOThreads, kVeloxParquetWriteIOThreadsDefault);
+  if (parquetWriteIOThreads > 0) {
+    parquetWriteExecutor_ = std::make_unique<folly::IOThreadPoolExecutor>(parquetWriteIOThreads);
+  }
   velox::connector::registerConnector(
       std::make_shared<velox::connector::hive::HiveConnector>(kHiveConnectorId, hiveConf, ioExecutor_.get()));
   
@@ -367,6 +377,14 @@ void VeloxBackend::tearDown() {
   // On threads exit, thread local variables can be constructed with referencing global variables.
   // So, we need to destruct IOThreadPoolExecutor and stop the threads before global variables get destructed.
   ioExecutor_.reset();
+  parquetWriteExecutor_.reset();
+  if (planCache_ != nullptr) {
+    auto stats = planCache_->stats();
+    LOG(INFO) << "Velox plan cache stats: hits " << stats.numHits << ", misses " << stats.numMisses << ", evictions "
+              << stats.numEvictions << ", conversion time " << stats.conversionNanos / 1000000 << " ms";
+    // The cached plans may hold vectors allocated from the memory pools, release them before the memory manager.
+    planCache_.reset();
+  }
   globalMemoryManager_.reset();
 
   // dump cache stats on exit if enabled
@@ -28,6 +28,7 @@
 #include "velox/common/config/Config.h"
 #include "velox/common/memory/MmapAllocator.h"
 
+#include "compute/VeloxPlanCache.h"
 #include "memory/VeloxMemoryManager.h"
 
 namespace gluten {
@@ -56,6 +57,16 @@ class VeloxBackend {
     return globalMemoryManager_.get();
   }
 
+  // The executor shared by the Parquet writers to write their output asynchronously, nullptr if it's disabled.
+  folly::Executor* getParquetWriteExecutor() const {
+    return parquetWriteExecutor_.get();
+  }
+
+  // The cache of the converted Velox plans shared by the tasks, nullptr if it's disabled.
+  VeloxPlanCache* getPlanCache() const {
+    return planCache_.get();
+  }
+
   void tearDown();
 
  private:
@@ -86,6 +97,8 @@ class VeloxBackend {
 
   std::unique_ptr<folly::IOThreadPoolExecutor> ssdCacheExecutor_;
   std::unique_ptr<folly::IOThreadPoolExecutor> ioExecutor_;
+  std::unique_ptr<folly::IOThreadPoolExecutor> parquetWriteExecutor_;
+  std::unique_ptr<VeloxPlanCache> planCache_;
   std::shared_ptr<facebook::velox::memory::MmapAllocator> cacheAllocator_;
 
   std::string cachePathPrefix_;
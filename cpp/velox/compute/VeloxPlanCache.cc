@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VeloxPlanCache.h"
+
+#include <folly/hash/SpookyHashV2.h>
+
+#include "config/GlutenConfig.h"
+#include "config/VeloxConfig.h"
+
+namespace gluten {
+
+namespace {
+// The session configs read while converting the Substrait plan. The configs only used by the task at runtime don't
+// change the converted plan, so they are left out of the fingerprint to let the tasks with different runtime configs
+// share the plan.
+const std::vector<std::string>& planConversionConfs() {
+  static const std::vector<std::string> confs = {
+      kCaseSensitive, kCudfEnabled, kCudfEnableTableScan, kQueryTraceEnabled};
+  return confs;
+}
+} // namespace
+
+uint64_t VeloxPlanCache::fingerprint(std::string_view planBytes, uint64_t confFingerprint) {
+  return folly::hash::SpookyHashV2::Hash64(planBytes.data(), planBytes.size(), confFingerprint);
+}
+
+uint64_t VeloxPlanCache::confFingerprint(const std::unordered_map<std::string, std::string>& conf) {
+  uint64_t hash = 0;
+  for (const auto& key : planConversionConfs()) {
+    auto it = conf.find(key);
+    if (it == conf.end()) {
+      continue;
+    }
+    hash = folly::hash::SpookyHashV2::Hash64(key.data(), key.size(), hash);
+    hash = folly::hash::SpookyHashV2::Hash64(it->second.data(), it->second.size(), hash);
+  }
+  return hash;
+}
+
+std::shared_ptr<const VeloxPlanCache::Entry> VeloxPlanCache::get(uint64_t fingerprint, std::string_view planBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(fingerprint);
+  if (it == index_.end() || it->second->planBytes != planBytes) {
+    ++stats_.numMisses;
+    return nullptr;
+  }
+  slots_.splice(slots_.begin(), slots_, it->second);
+  ++stats_.numHits;
+  return it->second->entry;
+}
+
+void VeloxPlanCache::put(uint64_t fingerprint, std::string planBytes, std::shared_ptr<const Entry> entry) {
+  if (capacity_ == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(fingerprint);
+  if (it != index_.end()) {
+    // Another task of the same stage may have converted the plan concurrently, or a colliding plan is replaced.
+    it->second->planBytes = std::move(planBytes);
+    it->second->entry = std::move(entry);
+    slots_.splice(slots_.begin(), slots_, it->second);
+    return;
+  }
+  if (slots_.size() >= capacity_) {
+    index_.erase(slots_.back().fingerprint);
+    slots_.pop_back();
+    ++stats_.numEvictions;
+  }
+  slots_.push_front(Slot{fingerprint, std::move(planBytes), std::move(entry)});
+  index_.emplace(fingerprint, slots_.begin());
+}
+
+void VeloxPlanCache::recordConversion(int64_t nanos) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.conversionNanos += nanos;
+}
+
+size_t VeloxPlanCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return slots_.size();
+}
+
+VeloxPlanCache::Stats VeloxPlanCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace gluten
@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <velox/core/PlanNode.h>
+
+#include "substrait/SubstraitToVeloxPlan.h"
+
+namespace gluten {
+
+// A bounded LRU cache of the converted Velox plans shared by all the tasks of the executor. The tasks of one stage send
+// the same Substrait plan and only differ in the splits, so a cached plan is reused by binding the split infos of the new
+// task to the scan nodes. The cached plans are immutable and must not refer to any task's resources.
+class VeloxPlanCache {
+ public:
+  struct Entry {
+    std::shared_ptr<const facebook::velox::core::PlanNode> plan;
+    // The ids of the scan nodes, in the order of the split infos parsed from the task's local files.
+    std::vector<facebook::velox::core::PlanNodeId> scanNodeIds;
+    // The table schemas the scan nodes were converted with, in the same order as scanNodeIds. nullptr if the split info
+    // didn't carry a schema.
+    std::vector<facebook::velox::RowTypePtr> tableSchemas;
+    // The split infos of the leaf nodes reading from the input iterators, they don't change between tasks.
+    std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> streamSplitInfos;
+  };
+
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvictions{0};
+    // Total time spent on converting the plans which were not found in the cache.
+    int64_t conversionNanos{0};
+  };
+
+  explicit VeloxPlanCache(size_t capacity) : capacity_(capacity) {}
+
+  // Combines the serialized Substrait plan and the session config into the key of the cache.
+  static uint64_t fingerprint(std::string_view planBytes, uint64_t confFingerprint);
+
+  // Hashes the session configs that affect the plan conversion, the other configs are ignored.
+  static uint64_t confFingerprint(const std::unordered_map<std::string, std::string>& conf);
+
+  // Returns the cached entry, or nullptr if not found. planBytes is compared to rule out hash collisions.
+  std::shared_ptr<const Entry> get(uint64_t fingerprint, std::string_view planBytes);
+
+  void put(uint64_t fingerprint, std::string planBytes, std::shared_ptr<const Entry> entry);
+
+  void recordConversion(int64_t nanos);
+
+  size_t size() const;
+
+  Stats stats() const;
+
+ private:
+  struct Slot {
+    uint64_t fingerprint;
+    std::string planBytes;
+    std::shared_ptr<const Entry> entry;
+  };
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Slot> slots_;
+  std::unordered_map<uint64_t, std::list<Slot>::iterator> index_;
+  Stats stats_;
+};
+
+} // namespace gluten
@@ -16,6 +16,7 @@
  */
 
 #include "VeloxPlanConverter.h"
+#include <algorithm>
 #include <filesystem>
 
 #include "config/GlutenConfig.h"
@@ -126,29 +127,46 @@ std::shared_ptr<SplitInfo> parseScanSplitInfo(
   return splitInfo;
 }
 
-void parseLocalFileNodes(
-    SubstraitToVeloxPlanConverter* planConverter,
+} // namespace
+
+std::vector<std::shared_ptr<SplitInfo>> VeloxPlanConverter::parseSplitInfos(
     const facebook::velox::config::ConfigBase* veloxCfg,
-    std::vector<::substrait::ReadRel_LocalFiles>& localFiles) {
+    const std::vector<::substrait::ReadRel_LocalFiles>& localFiles) {
   std::vector<std::shared_ptr<SplitInfo>> splitInfos;
   splitInfos.reserve(localFiles.size());
   for (const auto& localFile : localFiles) {
     const auto& fileList = localFile.items();
     splitInfos.push_back(parseScanSplitInfo(veloxCfg, fileList));
   }
-
-  planConverter->setSplitInfos(std::move(splitInfos));
+  return splitInfos;
 }
-} // namespace
 
 std::shared_ptr<const facebook::velox::core::PlanNode> VeloxPlanConverter::toVeloxPlan(
     const ::substrait::Plan& substraitPlan,
     std::vector<::substrait::ReadRel_LocalFiles> localFiles) {
-  if (!validationMode_) {
-    parseLocalFileNodes(&substraitVeloxPlanConverter_, veloxCfg_, localFiles);
+  if (validationMode_) {
+    return substraitVeloxPlanConverter_.toVeloxPlan(substraitPlan);
   }
+  return toVeloxPlan(substraitPlan, parseSplitInfos(veloxCfg_, localFiles));
+}
 
+std::shared_ptr<const facebook::velox::core::PlanNode> VeloxPlanConverter::toVeloxPlan(
+    const ::substrait::Plan& substraitPlan,
+    std::vector<std::shared_ptr<SplitInfo>> scanSplitInfos) {
+  scanSplitInfos_ = std::move(scanSplitInfos);
+  substraitVeloxPlanConverter_.setSplitInfos(scanSplitInfos_);
   return substraitVeloxPlanConverter_.toVeloxPlan(substraitPlan);
 }
 
+std::vector<facebook::velox::core::PlanNodeId> VeloxPlanConverter::scanNodeIds() const {
+  std::vector<facebook::velox::core::PlanNodeId> nodeIds(scanSplitInfos_.size());
+  for (const auto& [nodeId, splitInfo] : substraitVeloxPlanConverter_.splitInfos()) {
+    auto it = std::find(scanSplitInfos_.begin(), scanSplitInfos_.end(), splitInfo);
+    if (it != scanSplitInfos_.end()) {
+      nodeIds[it - scanSplitInfos_.begin()] = nodeId;
+    }
+  }
+  return nodeIds;
+}
+
 } // namespace gluten
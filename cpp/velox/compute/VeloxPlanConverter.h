@@ -41,10 +41,23 @@ class VeloxPlanConverter {
       const ::substrait::Plan& substraitPlan,
       std::vector<::substrait::ReadRel_LocalFiles> localFiles);
 
+  /// Same as above, with the split infos already parsed from the local files by parseSplitInfos.
+  std::shared_ptr<const facebook::velox::core::PlanNode> toVeloxPlan(
+      const ::substrait::Plan& substraitPlan,
+      std::vector<std::shared_ptr<SplitInfo>> scanSplitInfos);
+
   const std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfos() {
     return substraitVeloxPlanConverter_.splitInfos();
   }
 
+  /// The ids of the scan nodes bound to the split infos of the local files, in the order of the local files. The id is
+  /// empty if the split info is not bound to a scan node.
+  std::vector<facebook::velox::core::PlanNodeId> scanNodeIds() const;
+
+  static std::vector<std::shared_ptr<SplitInfo>> parseSplitInfos(
+      const facebook::velox::config::ConfigBase* veloxCfg,
+      const std::vector<::substrait::ReadRel_LocalFiles>& localFiles);
+
   /// The input iterators not inlined to VeloxPlan. They should be then manually added to the Velox task
   /// via WholeStageResultIterator#addIteratorSplits. Empty if no input iterators remaining.
   const std::vector<std::shared_ptr<ResultIterator>>& remainingInputIterators() const {
@@ -56,6 +69,7 @@ class VeloxPlanConverter {
 
   const facebook::velox::config::ConfigBase* veloxCfg_;
   SubstraitToVeloxPlanConverter substraitVeloxPlanConverter_;
+  std::vector<std::shared_ptr<SplitInfo>> scanSplitInfos_;
 };
 
 } // namespace gluten
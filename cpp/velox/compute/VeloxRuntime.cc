@@ -31,6 +31,7 @@
 #include "shuffle/VeloxShuffleReader.h"
 #include "shuffle/VeloxShuffleWriter.h"
 #include "utils/ConfigExtractor.h"
+#include "utils/Timer.h"
 #include "utils/VeloxArrowUtils.h"
 #include "utils/VeloxWholeStageDumper.h"
 
@@ -99,6 +100,11 @@ void VeloxRuntime::parsePlan(const uint8_t* data, int32_t size) {
   }
 
   GLUTEN_CHECK(parseProtobuf(data, size, &substraitPlan_) == true, "Parse substrait plan failed");
+
+  if (VeloxBackend::get()->getPlanCache() != nullptr) {
+    planBytes_.assign(reinterpret_cast<const char*>(data), size);
+    planFingerprint_ = VeloxPlanCache::fingerprint(planBytes_, VeloxPlanCache::confFingerprint(confMap_));
+  }
 }
 
 void VeloxRuntime::parseSplitInfo(const uint8_t* data, int32_t size, int32_t splitIndex) {
@@ -146,6 +152,88 @@ void VeloxRuntime::getInfoAndIds(
   }
 }
 
+namespace {
+bool hasTableWriteNode(const velox::core::PlanNode& node) {
+  if (dynamic_cast<const velox::core::TableWriteNode*>(&node) != nullptr) {
+    return true;
+  }
+  return std::any_of(node.sources().begin(), node.sources().end(), [](const auto& source) {
+    return hasTableWriteNode(*source);
+  });
+}
+} // namespace
+
+bool VeloxRuntime::toCachedVeloxPlan(
+    const std::vector<std::shared_ptr<ResultIterator>>& inputs,
+    std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap,
+    std::vector<std::shared_ptr<ResultIterator>>& remainingInputIterators) {
+  auto* planCache = VeloxBackend::get()->getPlanCache();
+  // Query trace inlines the input data into the plan, and cuDF chooses the table handle by the splits.
+  if (planCache == nullptr || planBytes_.empty() || veloxCfg_->get<bool>(kQueryTraceEnabled, false) ||
+      veloxCfg_->get<bool>(kCudfEnabled, false)) {
+    return false;
+  }
+
+  auto splitInfos = VeloxPlanConverter::parseSplitInfos(veloxCfg_.get(), localFiles_);
+  if (auto entry = planCache->get(planFingerprint_, planBytes_)) {
+    // The table schema of the scan comes from the split, the cached plan is only valid if the schemas are the same.
+    bool matched = entry->scanNodeIds.size() == splitInfos.size();
+    for (size_t i = 0; matched && i < splitInfos.size(); ++i) {
+      const auto& expected = entry->tableSchemas[i];
+      const auto& actual = splitInfos[i]->tableSchema;
+      matched = expected == nullptr ? actual == nullptr : actual != nullptr && *expected == *actual;
+    }
+    if (matched) {
+      veloxPlan_ = entry->plan;
+      splitInfoMap = entry->streamSplitInfos;
+      for (size_t i = 0; i < splitInfos.size(); ++i) {
+        splitInfoMap[entry->scanNodeIds[i]] = splitInfos[i];
+      }
+      // The input iterators are never inlined into a cacheable plan.
+      remainingInputIterators = inputs;
+      localFiles_.clear();
+      return true;
+    }
+  }
+
+  int64_t conversionNanos = 0;
+  {
+    ScopedTimer timer(&conversionNanos);
+    // The memory of the conversion is accounted to the task. A plan holding the task's memory, e.g. the vectors of a
+    // values node, can't outlive the task, so it's only cached if the conversion left nothing allocated in the pool.
+    auto veloxPool = memoryManager()->getLeafMemoryPool();
+    const auto usedBytes = veloxPool->usedBytes();
+    VeloxPlanConverter veloxPlanConverter(
+        veloxPool.get(), veloxCfg_.get(), inputs, *localWriteFilesTempPath(), *localWriteFileName());
+    veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_, splitInfos);
+    localFiles_.clear();
+    splitInfoMap = veloxPlanConverter.splitInfos();
+    remainingInputIterators = veloxPlanConverter.remainingInputIterators();
+
+    auto entry = std::make_shared<VeloxPlanCache::Entry>();
+    entry->plan = veloxPlan_;
+    entry->scanNodeIds = veloxPlanConverter.scanNodeIds();
+    // The write path and file name are bound to the task, so are the inlined input iterators.
+    bool cacheable = veloxPool->usedBytes() == usedBytes && !hasTableWriteNode(*veloxPlan_) &&
+        remainingInputIterators.size() == inputs.size() &&
+        std::none_of(entry->scanNodeIds.begin(), entry->scanNodeIds.end(), [](const auto& id) { return id.empty(); });
+    if (cacheable) {
+      for (const auto& splitInfo : splitInfos) {
+        entry->tableSchemas.push_back(splitInfo->tableSchema);
+      }
+      for (const auto& [nodeId, splitInfo] : splitInfoMap) {
+        if (splitInfo->isStream) {
+          entry->streamSplitInfos.emplace(nodeId, splitInfo);
+        }
+      }
+      planCache->put(planFingerprint_, planBytes_, std::move(entry));
+    }
+  }
+  planCache->recordConversion(conversionNanos);
+  VLOG(1) << "Velox plan cache miss, conversion took " << conversionNanos / 1000 << " us";
+  return true;
+}
+
 std::string VeloxRuntime::planString(bool details, const std::unordered_map<std::string, std::string>& sessionConf) {
   auto veloxMemoryPool = gluten::defaultLeafVeloxMemoryPool();
   VeloxPlanConverter veloxPlanConverter(veloxMemoryPool.get(), veloxCfg_.get(), {}, std::nullopt, std::nullopt, true);
@@ -164,13 +252,19 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
     const std::vector<std::shared_ptr<ResultIterator>>& inputs) {
   LOG_IF(INFO, debugModeEnabled_) << "VeloxRuntime session config:" << printConfig(confMap_);
 
-  VeloxPlanConverter veloxPlanConverter(
-      memoryManager()->getLeafMemoryPool().get(),
-      veloxCfg_.get(),
-      inputs,
-      *localWriteFilesTempPath(),
-      *localWriteFileName());
-  veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_, std::move(localFiles_));
+  std::unordered_map<velox::core::PlanNodeId, std::shared_ptr<SplitInfo>> splitInfoMap;
+  std::vector<std::shared_ptr<ResultIterator>> remainingInputIterators;
+  if (!toCachedVeloxPlan(inputs, splitInfoMap, remainingInputIterators)) {
+    VeloxPlanConverter veloxPlanConverter(
+        memoryManager()->getLeafMemoryPool().get(),
+        veloxCfg_.get(),
+        inputs,
+        *localWriteFilesTempPath(),
+        *localWriteFileName());
+    veloxPlan_ = veloxPlanConverter.toVeloxPlan(substraitPlan_, std::move(localFiles_));
+    splitInfoMap = veloxPlanConverter.splitInfos();
+    remainingInputIterators = veloxPlanConverter.remainingInputIterators();
+  }
   LOG_IF(INFO, debugModeEnabled_ && taskInfo_.has_value())
       << "############### Velox plan for task " << taskInfo_.value() << " ###############" << std::endl
       << veloxPlan_->toString(true, true);
@@ -181,7 +275,7 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
   std::vector<velox::core::PlanNodeId> streamIds;
 
   // Separate the scan ids and stream ids, and get the scan infos.
-  getInfoAndIds(veloxPlanConverter.splitInfos(), veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
+  getInfoAndIds(splitInfoMap, veloxPlan_->leafPlanNodeIds(), scanInfos, scanIds, streamIds);
 
   auto wholeStageIter = std::make_unique<WholeStageResultIterator>(
       memoryManager(),
@@ -193,7 +287,6 @@ std::shared_ptr<ResultIterator> VeloxRuntime::createResultIterator(
       veloxCfg_,
       taskInfo_.has_value() ? taskInfo_.value() : SparkTaskInfo{});
 
-  auto remainingInputIterators = veloxPlanConverter.remainingInputIterators();
   if (!remainingInputIterators.empty()) {
   // Converts remaining input iterators to splits and add them to the task.
     wholeStageIter->addIteratorSplits(remainingInputIterators);
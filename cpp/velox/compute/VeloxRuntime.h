@@ -122,9 +122,19 @@ class VeloxRuntime final : public Runtime {
       std::vector<facebook::velox::core::PlanNodeId>& streamIds);
 
  private:
+  // Looks up the plan in the per-executor plan cache and binds the task's split infos to it, or converts and caches the
+  // plan on a miss. Returns false if the cache is not applicable, then the caller converts the plan itself.
+  bool toCachedVeloxPlan(
+      const std::vector<std::shared_ptr<ResultIterator>>& inputs,
+      std::unordered_map<facebook::velox::core::PlanNodeId, std::shared_ptr<SplitInfo>>& splitInfoMap,
+      std::vector<std::shared_ptr<ResultIterator>>& remainingInputIterators);
+
   std::shared_ptr<const facebook::velox::core::PlanNode> veloxPlan_;
   std::shared_ptr<facebook::velox::config::ConfigBase> veloxCfg_;
   bool debugModeEnabled_{false};
+  // The serialized Substrait plan and its fingerprint, only kept when the plan cache is enabled.
+  std::string planBytes_;
+  uint64_t planFingerprint_{0};
 
   std::unordered_map<int32_t, std::shared_ptr<VeloxColumnarBatch>> emptySchemaBatchLoopUp_;
 };
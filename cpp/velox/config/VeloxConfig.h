@@ -131,6 +131,17 @@ const std::string kVeloxSsdCheckSumReadVerificationEnabled =
 // async
 const std::string kVeloxIOThreads = "spark.gluten.sql.columnar.backend.velox.IOThreads";
 const uint32_t kVeloxIOThreadsDefault = 0;
+// Threads of the shared executor which writes the output of Parquet writers asynchronously. 0 means writing synchronously
+// on the task thread.
+const std::string kVeloxParquetWriteIOThreads = "spark.gluten.sql.columnar.backend.velox.parquetWriteIOThreads";
+const uint32_t kVeloxParquetWriteIOThreadsDefault = 0;
+// The max bytes of one Parquet writer's output which are handed over to the executor but not written yet.
+const std::string kParquetWriteMaxInFlightBytes = "spark.gluten.sql.columnar.backend.velox.parquetWriteMaxInFlightBytes";
+const std::string kParquetWriteMaxInFlightBytesDefault = "64MB";
+// The max number of converted Velox plans cached per executor, they are reused by the tasks sending the same Substrait
+// plan and session config. 0 means the plans are converted for every task.
+const std::string kVeloxPlanCacheSize = "spark.gluten.sql.columnar.backend.velox.planCacheSize";
+const uint32_t kVeloxPlanCacheSizeDefault = 0;
 const std::string kVeloxAsyncTimeoutOnTaskStopping =
     "spark.gluten.sql.columnar.backend.velox.asyncTimeoutOnTaskStopping";
 const int32_t kVeloxAsyncTimeoutOnTaskStoppingDefault = 30000; // 30s
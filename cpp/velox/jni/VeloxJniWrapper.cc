@@ -17,6 +17,7 @@
 
 #include <jni.h>
 
+#include <folly/container/F14Map.h>
 #include <glog/logging.h>
 #include <jni/JniCommon.h>
 #include <velox/connectors/hive/PartitionIdGenerator.h>
@@ -36,6 +37,7 @@
 #include "substrait/SubstraitToVeloxPlanValidator.h"
 #include "utils/ObjectStore.h"
 #include "utils/VeloxBatchResizer.h"
+#include "utils/VeloxWriterUtils.h"
 #include "velox/common/base/BloomFilter.h"
 #include "velox/common/file/FileSystems.h"
 
@@ -60,6 +62,9 @@ jmethodID blockStripesConstructor;
 
 jclass batchWriteMetricsClass;
 jmethodID batchWriteMetricsConstructor;
+
+jclass dataSourceWriteMetricsClass;
+jmethodID dataSourceWriteMetricsConstructor;
 } // namespace
 
 #ifdef __cplusplus
@@ -88,6 +93,10 @@ jint JNI_OnLoad(JavaVM* vm, void*) {
     createGlobalClassReferenceOrError(env, "Lorg/apache/gluten/metrics/BatchWriteMetrics;");
   batchWriteMetricsConstructor = getMethodIdOrError(env, batchWriteMetricsClass, "<init>", "(JIJJ)V");
 
+  dataSourceWriteMetricsClass =
+      createGlobalClassReferenceOrError(env, "Lorg/apache/gluten/metrics/DataSourceWriteMetrics;");
+  dataSourceWriteMetricsConstructor = getMethodIdOrError(env, dataSourceWriteMetricsClass, "<init>", "(JJJJ)V");
+
   DLOG(INFO) << "Loaded Velox backend.";
 
   return jniVersion;
@@ -97,6 +106,7 @@ void JNI_OnUnload(JavaVM* vm, void*) {
   JNIEnv* env;
   vm->GetEnv(reinterpret_cast<void**>(&env), jniVersion);
 
+  env->DeleteGlobalRef(dataSourceWriteMetricsClass);
   env->DeleteGlobalRef(blockStripesClass);
   env->DeleteGlobalRef(infoCls);
 
@@ -523,15 +533,23 @@ JNIEXPORT void JNICALL Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapp
   JNI_METHOD_END()
 }
 
-JNIEXPORT void JNICALL Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapper_close( // NOLINT
+JNIEXPORT jobject JNICALL Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapper_close( // NOLINT
     JNIEnv* env,
     jobject wrapper,
     jlong dsHandle) {
   JNI_METHOD_START
   auto datasource = ObjectStore::retrieve<VeloxDataSource>(dsHandle);
   datasource->close();
+  const auto metrics = datasource->writeMetrics();
   ObjectStore::release(dsHandle);
-  JNI_METHOD_END()
+  return env->NewObject(
+      dataSourceWriteMetricsClass,
+      dataSourceWriteMetricsConstructor,
+      static_cast<jlong>(metrics.numFlushWaits),
+      static_cast<jlong>(metrics.flushWaitNanos),
+      static_cast<jlong>(metrics.closeWaitNanos),
+      static_cast<jlong>(metrics.peakInFlightBytes));
+  JNI_METHOD_END(nullptr)
 }
 
 JNIEXPORT void JNICALL Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapper_writeBatch( // NOLINT
@@ -552,11 +570,10 @@ Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapper_splitBlockByPartitio
     jobject wrapper,
     jlong batchHandle,
     jintArray partitionColIndices,
-    jboolean hasBucket) {
+    jboolean hasBucket,
+    jintArray bucketColIndices,
+    jint numBuckets) {
   JNI_METHOD_START
-
-  GLUTEN_CHECK(!hasBucket, "Bucketing not supported by splitBlockByPartitionAndBucket");
-
   const auto ctx = gluten::getRuntime(env, wrapper);
   const auto batch = ObjectStore::retrieve<ColumnarBatch>(batchHandle);
 
@@ -582,17 +599,44 @@ Java_org_apache_gluten_datasource_VeloxDataSourceJniWrapper_splitBlockByPartitio
   const auto inputRowVector = veloxBatch->getRowVector();
   const auto numRows = inputRowVector->size();
 
-  connector::hive::PartitionIdGenerator idGen(
-      asRowType(inputRowVector->type()), partitionColIndicesVec, 65536, pool.get()
+  raw_vector<uint64_t> partitionIds{};
+  int32_t numPartitions = 1;
+  if (partitionColIndicesVec.empty()) {
+    partitionIds.resize(numRows);
+    std::fill(partitionIds.begin(), partitionIds.end(), 0);
+  } else {
+    connector::hive::PartitionIdGenerator idGen(
+        asRowType(inputRowVector->type()), partitionColIndicesVec, 65536, pool.get()
 #ifdef GLUTEN_ENABLE_ENHANCED_FEATURES
-      ,
-      true
-#endif    
+        ,
+        true
+#endif
     );
-  raw_vector<uint64_t> partitionIds{};
-  idGen.run(inputRowVector, partitionIds);
+    idGen.run(inputRowVector, partitionIds);
+    numPartitions = static_cast<int32_t>(idGen.numPartitions());
+  }
   GLUTEN_CHECK(partitionIds.size() == numRows, "Mismatched number of partition ids");
-  const auto numPartitions = static_cast<int32_t>(idGen.numPartitions());
+
+  if (hasBucket) {
+    // Split by (partition, bucket). The bucket ids are computed over the whole batch, then each distinct pair of
+    // partition and bucket id is assigned a dense stripe id in the order of appearance.
+    auto bucketKeyArray = gluten::getIntArrayElementsSafe(env, bucketColIndices);
+    std::vector<column_index_t> bucketColIndicesVec;
+    for (int i = 0; i < bucketKeyArray.length(); ++i) {
+      const auto bucketColumnIndex = bucketKeyArray.elems()[i];
+      GLUTEN_CHECK(bucketColumnIndex < batch->numColumns(), "Bucket column index overflow");
+      bucketColIndicesVec.emplace_back(bucketColumnIndex);
+    }
+    std::vector<int32_t> bucketIds;
+    computeBucketIds(inputRowVector, bucketColIndicesVec, numBuckets, pool.get(), bucketIds);
+
+    folly::F14FastMap<uint64_t, uint64_t> stripeIds;
+    for (auto row = 0; row < numRows; ++row) {
+      const auto key = partitionIds[row] * numBuckets + bucketIds[row];
+      partitionIds[row] = stripeIds.try_emplace(key, stripeIds.size()).first->second;
+    }
+    numPartitions = static_cast<int32_t>(stripeIds.size());
+  }
 
   std::vector<vector_size_t> partitionSizes(numPartitions);
   std::vector<BufferPtr> partitionRows(numPartitions);
@@ -92,6 +92,28 @@ velox::RowVectorPtr VeloxColumnarBatch::getFlattenedRowVector() {
   return rowVector_;
 }
 
+velox::RowVectorPtr VeloxColumnarBatch::getLoadedRowVector() const {
+  if (flattened_) {
+    return rowVector_;
+  }
+  bool changed = false;
+  std::vector<VectorPtr> children;
+  children.reserve(rowVector_->childrenSize());
+  for (const auto& child : rowVector_->children()) {
+    auto loaded = BaseVector::loadedVectorShared(child);
+    if (loaded->size() > rowVector_->size()) {
+      loaded = loaded->slice(0, rowVector_->size());
+    }
+    changed |= loaded != child;
+    children.push_back(std::move(loaded));
+  }
+  if (!changed) {
+    return rowVector_;
+  }
+  return std::make_shared<RowVector>(
+      rowVector_->pool(), rowVector_->type(), rowVector_->nulls(), rowVector_->size(), std::move(children));
+}
+
 std::shared_ptr<VeloxColumnarBatch> VeloxColumnarBatch::from(
     facebook::velox::memory::MemoryPool* pool,
     std::shared_ptr<ColumnarBatch> cb) {
@@ -58,6 +58,9 @@ class VeloxColumnarBatch final : public ColumnarBatch {
       const std::vector<int32_t>& columnIndices);
   facebook::velox::RowVectorPtr getRowVector() const;
   facebook::velox::RowVectorPtr getFlattenedRowVector();
+  // Returns the row vector with lazy children loaded and sliced to the row count, but keeps the dictionary and constant
+  // encodings of the children. The batch itself is not changed.
+  facebook::velox::RowVectorPtr getLoadedRowVector() const;
 
  private:
   void ensureFlattened();
@@ -17,9 +17,9 @@
 
 #include "VeloxRowToColumnarConverter.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "velox/vector/ComplexVector.h"
 #include "velox/vector/FlatVector.h"
 #include "velox/vector/arrow/Bridge.h"
-#include "velox/row/UnsafeRowFast.h"
 
 using namespace facebook::velox;
 namespace gluten {
@@ -33,10 +33,10 @@ inline int64_t getFieldOffset(int64_t nullBitsetWidthInBytes, int32_t index) {
   return nullBitsetWidthInBytes + 8L * index;
 }
 
-inline bool isNull(uint8_t* buffer_address, int32_t index) {
+inline bool isNull(const uint8_t* buffer_address, int32_t index) {
   int64_t mask = 1L << (static_cast<int64_t>(index) & 0x3f); // mod 64 and shift
   int64_t wordOffset = (static_cast<int64_t>(index) >> 6) * 8;
-  int64_t value = *reinterpret_cast<int64_t*>(buffer_address + wordOffset);
+  int64_t value = *reinterpret_cast<const int64_t*>(buffer_address + wordOffset);
   return (value & mask) != 0;
 }
 
@@ -241,19 +241,389 @@ VectorPtr createFlatVector<TypeKind::UNKNOWN>(
       std::vector<BufferPtr>{}); // stringBuffers
 }
 
-bool supporteType(const RowTypePtr rowType) {
-  for (auto i = 0; i < rowType->size(); i++) {
-    auto kind = rowType->childAt(i)->kind();
-    switch (kind) {
-      case TypeKind::ARRAY:
-      case TypeKind::MAP:
-      case TypeKind::ROW:
-        return false;
-      default:
-        break;
+bool isNestedType(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::ARRAY:
+    case TypeKind::MAP:
+    case TypeKind::ROW:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline int64_t readInt64(const uint8_t* address) {
+  int64_t value;
+  memcpy(&value, address, sizeof(int64_t));
+  return value;
+}
+
+// Locations of the values of one nested column, or of the elements and fields nested in it. The values are decoded
+// column at a time, so that each level of the nesting is scanned once for all rows.
+struct ValueLocations {
+  explicit ValueLocations(vector_size_t size) : slots(size), bases(size) {}
+
+  vector_size_t size() const {
+    return slots.size();
+  }
+
+  bool isNullAt(vector_size_t i) const {
+    return nulls != nullptr && bits::isBitNull(nulls->as<uint64_t>(), i);
+  }
+
+  void setNull(vector_size_t i, memory::MemoryPool* pool) {
+    if (nulls == nullptr) {
+      nulls = allocateNulls(size(), pool);
+    }
+    bits::setNull(nulls->asMutable<uint64_t>(), i);
+  }
+
+  // The fixed-width slot of each value. Variable-length values store their offset and size in the slot.
+  std::vector<const uint8_t*> slots;
+  // The start of the unsafe row or array that holds each value. Offsets of variable-length values are relative to it.
+  std::vector<const uint8_t*> bases;
+  // Velox nulls of the values, nullptr if there is no null.
+  BufferPtr nulls;
+};
+
+VectorPtr decodeColumn(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool);
+
+// The size of an element in the fixed-width region of an unsafe array.
+int32_t elementWidth(const TypePtr& type) {
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::REAL:
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+inline int64_t arrayHeaderSize(int64_t numElements) {
+  return 8 + calculateBitSetWidthInBytes(numElements);
+}
+
+// Returns the address of the variable-length value at `i`.
+inline const uint8_t* variableLengthAddress(const ValueLocations& locations, vector_size_t i) {
+  return locations.bases[i] + (readInt64(locations.slots[i]) >> 32);
+}
+
+template <TypeKind Kind>
+VectorPtr decodeScalar(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  using T = typename TypeTraits<Kind>::NativeType;
+  const auto size = locations.size();
+  auto column = BaseVector::create<FlatVector<T>>(type, size, pool);
+  auto* rawValues = column->template mutableRawValues<uint8_t>();
+  for (auto i = 0; i < size; ++i) {
+    if (!locations.isNullAt(i)) {
+      memcpy(rawValues + i * sizeof(T), locations.slots[i], sizeof(T));
+    }
+  }
+  column->setNulls(locations.nulls);
+  return column;
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::BOOLEAN>(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto column = BaseVector::create<FlatVector<bool>>(type, size, pool);
+  auto* rawValues = column->mutableRawValues<uint64_t>();
+  for (auto i = 0; i < size; ++i) {
+    if (!locations.isNullAt(i)) {
+      bits::setBit(rawValues, i, *locations.slots[i] != 0);
+    }
+  }
+  column->setNulls(locations.nulls);
+  return column;
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::TIMESTAMP>(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto column = BaseVector::create<FlatVector<Timestamp>>(type, size, pool);
+  auto* rawValues = column->mutableRawValues();
+  for (auto i = 0; i < size; ++i) {
+    if (!locations.isNullAt(i)) {
+      rawValues[i] = Timestamp::fromMicros(readInt64(locations.slots[i]));
+    }
+  }
+  column->setNulls(locations.nulls);
+  return column;
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::HUGEINT>(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto column = BaseVector::create<FlatVector<int128_t>>(type, size, pool);
+  auto* rawValues = column->mutableRawValues<uint8_t>();
+  for (auto i = 0; i < size; ++i) {
+    if (locations.isNullAt(i)) {
+      continue;
+    }
+    // The unscaled value is stored as big-endian bytes of minimal length.
+    const int32_t length = static_cast<int32_t>(readInt64(locations.slots[i]));
+    GLUTEN_CHECK(length <= 16, "array out of bounds exception");
+    const auto* bytes = variableLengthAddress(locations, i);
+    uint8_t* dest = rawValues + i * sizeof(int128_t);
+    for (auto k = 0; k < length; ++k) {
+      dest[k] = bytes[length - 1 - k];
+    }
+    memset(dest + length, length > 0 && static_cast<int8_t>(bytes[0]) < 0 ? 255 : 0, sizeof(int128_t) - length);
+  }
+  column->setNulls(locations.nulls);
+  return column;
+}
+
+VectorPtr decodeStringView(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto column = BaseVector::create<FlatVector<StringView>>(type, size, pool);
+  size_t totalSize = 0;
+  for (auto i = 0; i < size; ++i) {
+    if (!locations.isNullAt(i)) {
+      const int32_t length = static_cast<int32_t>(readInt64(locations.slots[i]));
+      if (!StringView::isInline(length)) {
+        totalSize += length;
+      }
+    }
+  }
+  char* rawBuffer = column->getRawStringBufferWithSpace(totalSize, true);
+  auto* rawValues = column->mutableRawValues();
+  for (auto i = 0; i < size; ++i) {
+    if (locations.isNullAt(i)) {
+      continue;
+    }
+    const int32_t length = static_cast<int32_t>(readInt64(locations.slots[i]));
+    const auto* src = reinterpret_cast<const char*>(variableLengthAddress(locations, i));
+    if (StringView::isInline(length)) {
+      rawValues[i] = StringView(src, length);
+    } else {
+      memcpy(rawBuffer, src, length);
+      rawValues[i] = StringView(rawBuffer, length);
+      rawBuffer += length;
+    }
+  }
+  column->setNulls(locations.nulls);
+  return column;
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::VARCHAR>(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  return decodeStringView(type, locations, pool);
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::VARBINARY>(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  return decodeStringView(type, locations, pool);
+}
+
+template <>
+VectorPtr
+decodeScalar<TypeKind::UNKNOWN>(const TypePtr& /*type*/, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto nulls = allocateNulls(size, pool, bits::kNull);
+  return std::make_shared<FlatVector<UnknownValue>>(
+      pool,
+      UNKNOWN(),
+      nulls,
+      size,
+      nullptr, // values
+      std::vector<BufferPtr>{}); // stringBuffers
+}
+
+// Copies the fixed-width elements of the arrays into one flat vector with a memcpy per array. The value layout of an
+// unsafe array matches the flat vector for these types, only the null bits are inverted.
+template <typename T>
+VectorPtr copyFixedWidthElements(
+    const TypePtr& type,
+    const std::vector<const uint8_t*>& arrays,
+    vector_size_t numElements,
+    memory::MemoryPool* pool) {
+  auto column = BaseVector::create<FlatVector<T>>(type, numElements, pool);
+  auto* rawValues = column->mutableRawValues();
+  uint64_t* rawNulls = nullptr;
+  vector_size_t pos = 0;
+  for (const auto* array : arrays) {
+    const auto size = static_cast<vector_size_t>(readInt64(array));
+    const auto* nullWords = array + 8;
+    const auto nullBytes = calculateBitSetWidthInBytes(size);
+    memcpy(rawValues + pos, array + arrayHeaderSize(size), size * sizeof(T));
+    for (auto w = 0; w < nullBytes / 8; ++w) {
+      uint64_t word = readInt64(nullWords + w * 8);
+      while (word != 0) {
+        if (rawNulls == nullptr) {
+          rawNulls = column->mutableRawNulls();
+        }
+        bits::setNull(rawNulls, pos + w * 64 + __builtin_ctzll(word));
+        word &= word - 1;
+      }
+    }
+    pos += size;
+  }
+  return column;
+}
+
+// Decodes the elements of the non-null unsafe arrays into one vector of numElements values.
+VectorPtr decodeElements(
+    const TypePtr& elementType,
+    const std::vector<const uint8_t*>& arrays,
+    vector_size_t numElements,
+    memory::MemoryPool* pool) {
+  switch (elementType->kind()) {
+    case TypeKind::TINYINT:
+      return copyFixedWidthElements<int8_t>(elementType, arrays, numElements, pool);
+    case TypeKind::SMALLINT:
+      return copyFixedWidthElements<int16_t>(elementType, arrays, numElements, pool);
+    case TypeKind::INTEGER:
+      return copyFixedWidthElements<int32_t>(elementType, arrays, numElements, pool);
+    case TypeKind::BIGINT:
+      return copyFixedWidthElements<int64_t>(elementType, arrays, numElements, pool);
+    case TypeKind::REAL:
+      return copyFixedWidthElements<float>(elementType, arrays, numElements, pool);
+    case TypeKind::DOUBLE:
+      return copyFixedWidthElements<double>(elementType, arrays, numElements, pool);
+    default:
+      break;
+  }
+
+  const auto width = elementWidth(elementType);
+  ValueLocations elements(numElements);
+  vector_size_t pos = 0;
+  for (const auto* array : arrays) {
+    const auto size = readInt64(array);
+    const auto* values = array + arrayHeaderSize(size);
+    for (auto j = 0; j < size; ++j, ++pos) {
+      elements.slots[pos] = values + j * width;
+      elements.bases[pos] = array;
+      if (isNull(array + 8, j)) {
+        elements.setNull(pos, pool);
+      }
+    }
+  }
+  return decodeColumn(elementType, elements, pool);
+}
+
+VectorPtr decodeArray(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto offsets = allocateOffsets(size, pool);
+  auto sizes = allocateSizes(size, pool);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  std::vector<const uint8_t*> arrays;
+  arrays.reserve(size);
+  vector_size_t numElements = 0;
+  for (auto i = 0; i < size; ++i) {
+    rawOffsets[i] = numElements;
+    if (!locations.isNullAt(i)) {
+      const auto* array = variableLengthAddress(locations, i);
+      rawSizes[i] = static_cast<vector_size_t>(readInt64(array));
+      numElements += rawSizes[i];
+      arrays.push_back(array);
+    }
+  }
+  auto elements = decodeElements(type->childAt(0), arrays, numElements, pool);
+  return std::make_shared<ArrayVector>(
+      pool, type, locations.nulls, size, std::move(offsets), std::move(sizes), std::move(elements));
+}
+
+// An unsafe map is the size of the key array followed by the key array and the value array.
+VectorPtr decodeMap(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  auto offsets = allocateOffsets(size, pool);
+  auto sizes = allocateSizes(size, pool);
+  auto* rawOffsets = offsets->asMutable<vector_size_t>();
+  auto* rawSizes = sizes->asMutable<vector_size_t>();
+  std::vector<const uint8_t*> keyArrays;
+  std::vector<const uint8_t*> valueArrays;
+  keyArrays.reserve(size);
+  valueArrays.reserve(size);
+  vector_size_t numElements = 0;
+  for (auto i = 0; i < size; ++i) {
+    rawOffsets[i] = numElements;
+    if (!locations.isNullAt(i)) {
+      const auto* map = variableLengthAddress(locations, i);
+      const auto* keys = map + 8;
+      rawSizes[i] = static_cast<vector_size_t>(readInt64(keys));
+      numElements += rawSizes[i];
+      keyArrays.push_back(keys);
+      valueArrays.push_back(keys + readInt64(map));
     }
   }
-  return true;
+  auto keys = decodeElements(type->childAt(0), keyArrays, numElements, pool);
+  auto values = decodeElements(type->childAt(1), valueArrays, numElements, pool);
+  return std::make_shared<MapVector>(
+      pool, type, locations.nulls, size, std::move(offsets), std::move(sizes), std::move(keys), std::move(values));
+}
+
+VectorPtr decodeRow(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  const auto size = locations.size();
+  const auto numFields = type->size();
+  const auto nullBitsetWidthInBytes = calculateBitSetWidthInBytes(numFields);
+  std::vector<const uint8_t*> structs(size, nullptr);
+  for (auto i = 0; i < size; ++i) {
+    if (!locations.isNullAt(i)) {
+      structs[i] = variableLengthAddress(locations, i);
+    }
+  }
+
+  std::vector<VectorPtr> children(numFields);
+  for (auto field = 0; field < numFields; ++field) {
+    const auto fieldOffset = getFieldOffset(nullBitsetWidthInBytes, field);
+    ValueLocations fields(size);
+    for (auto i = 0; i < size; ++i) {
+      if (structs[i] == nullptr || isNull(structs[i], field)) {
+        fields.setNull(i, pool);
+        continue;
+      }
+      fields.slots[i] = structs[i] + fieldOffset;
+      fields.bases[i] = structs[i];
+    }
+    children[field] = decodeColumn(type->childAt(field), fields, pool);
+  }
+  return std::make_shared<RowVector>(pool, type, locations.nulls, size, std::move(children));
+}
+
+VectorPtr decodeColumn(const TypePtr& type, const ValueLocations& locations, memory::MemoryPool* pool) {
+  switch (type->kind()) {
+    case TypeKind::ARRAY:
+      return decodeArray(type, locations, pool);
+    case TypeKind::MAP:
+      return decodeMap(type, locations, pool);
+    case TypeKind::ROW:
+      return decodeRow(type, locations, pool);
+    default:
+      return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(decodeScalar, type->kind(), type, locations, pool);
+  }
+}
+
+VectorPtr createNestedVector(
+    const TypePtr& type,
+    int32_t columnIdx,
+    int32_t numRows,
+    int64_t fieldOffset,
+    std::vector<int64_t>& offsets,
+    uint8_t* memoryAddress,
+    memory::MemoryPool* pool) {
+  ValueLocations locations(numRows);
+  for (auto pos = 0; pos < numRows; pos++) {
+    auto* row = memoryAddress + offsets[pos];
+    if (isNull(row, columnIdx)) {
+      locations.setNull(pos, pool);
+      continue;
+    }
+    locations.slots[pos] = row + fieldOffset;
+    locations.bases[pos] = row;
+  }
+  return decodeColumn(type, locations, pool);
 }
 
 } // namespace
@@ -268,21 +638,6 @@ VeloxRowToColumnarConverter::VeloxRowToColumnarConverter(
 
 std::shared_ptr<ColumnarBatch>
 VeloxRowToColumnarConverter::convert(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
-  if (supporteType(asRowType(rowType_))) {
-    return convertPrimitive(numRows, rowLength, memoryAddress);
-  }
-  std::vector<char*> data;
-  int64_t offset = 0;
-  for (auto i = 0; i < numRows; i++) {
-    data.emplace_back(reinterpret_cast<char*>(memoryAddress + offset));
-    offset += rowLength[i];
-  }
-  auto vp = row::UnsafeRowFast::deserialize(data, asRowType(rowType_), pool_.get());
-  return std::make_shared<VeloxColumnarBatch>(std::dynamic_pointer_cast<RowVector>(vp));
-}
-
-std::shared_ptr<ColumnarBatch>
-VeloxRowToColumnarConverter::convertPrimitive(int64_t numRows, int64_t* rowLength, uint8_t* memoryAddress) {
   auto numFields = rowType_->size();
   int64_t nullBitsetWidthInBytes = calculateBitSetWidthInBytes(numFields);
   std::vector<int64_t> offsets;
@@ -297,6 +652,10 @@ VeloxRowToColumnarConverter::convertPrimitive(int64_t numRows, int64_t* rowLengt
   for (auto i = 0; i < numFields; i++) {
     auto fieldOffset = getFieldOffset(nullBitsetWidthInBytes, i);
     auto& type = rowType_->childAt(i);
+    if (isNestedType(type)) {
+      columns[i] = createNestedVector(type, i, numRows, fieldOffset, offsets, memoryAddress, pool_.get());
+      continue;
+    }
     columns[i] = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
         createFlatVector, type->kind(), type, i, numRows, fieldOffset, offsets, memoryAddress, pool_.get());
   }
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operators/writer/AsyncFileSink.h"
+
+#include "utils/Timer.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace gluten {
+
+namespace {
+uint64_t totalSize(const std::vector<DataBuffer<char>>& buffers) {
+  uint64_t size = 0;
+  for (const auto& buffer : buffers) {
+    size += buffer.size();
+  }
+  return size;
+}
+} // namespace
+
+AsyncFileSink::AsyncFileSink(
+    std::unique_ptr<FileSink> sink,
+    folly::Executor* executor,
+    uint64_t maxInFlightBytes,
+    memory::MemoryPool* pool)
+    : FileSink(sink->name(), {.pool = pool}),
+      sink_(std::move(sink)),
+      executor_(executor),
+      maxInFlightBytes_(maxInFlightBytes) {
+  VELOX_CHECK_NOT_NULL(executor_);
+}
+
+AsyncFileSink::~AsyncFileSink() {
+  // The pending task references this sink, wait for it even if the sink is not closed.
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return !draining_; });
+}
+
+void AsyncFileSink::write(std::vector<DataBuffer<char>>& buffers) {
+  const auto bytes = totalSize(buffers);
+  if (bytes == 0) {
+    buffers.clear();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  checkError();
+  // Always accept a write when nothing is in flight, so a single buffer larger than the limit doesn't block forever.
+  if (inFlightBytes_ > 0 && inFlightBytes_ + bytes > maxInFlightBytes_) {
+    ScopedTimer timer(&asyncStats_.flushWaitNanos);
+    ++asyncStats_.numFlushWaits;
+    cv_.wait(lock, [&] { return error_ != nullptr || inFlightBytes_ == 0 || inFlightBytes_ + bytes <= maxInFlightBytes_; });
+  }
+  checkError();
+
+  inFlightBytes_ += bytes;
+  size_ += bytes;
+  ++asyncStats_.numWrites;
+  asyncStats_.peakInFlightBytes = std::max(asyncStats_.peakInFlightBytes, inFlightBytes_);
+  pending_.push_back(std::move(buffers));
+  buffers.clear();
+
+  if (!draining_) {
+    draining_ = true;
+    lock.unlock();
+    executor_->add([this] { drain(); });
+  }
+}
+
+void AsyncFileSink::drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!pending_.empty()) {
+    auto buffers = std::move(pending_.front());
+    pending_.pop_front();
+    const auto bytes = totalSize(buffers);
+    const bool failed = error_ != nullptr;
+    lock.unlock();
+
+    std::exception_ptr error;
+    if (!failed) {
+      try {
+        sink_->write(buffers);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    // Release the buffers before waking up the writer.
+    buffers.clear();
+
+    lock.lock();
+    if (error && !error_) {
+      error_ = error;
+    }
+    inFlightBytes_ -= bytes;
+    cv_.notify_all();
+  }
+  draining_ = false;
+  cv_.notify_all();
+}
+
+void AsyncFileSink::waitForDrained(std::unique_lock<std::mutex>& lock) {
+  ScopedTimer timer(&asyncStats_.closeWaitNanos);
+  cv_.wait(lock, [this] { return !draining_ && pending_.empty(); });
+}
+
+void AsyncFileSink::checkError() {
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void AsyncFileSink::doClose() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waitForDrained(lock);
+    checkError();
+  }
+  sink_->close();
+}
+
+} // namespace gluten
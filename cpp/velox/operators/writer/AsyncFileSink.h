@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+#include <folly/Executor.h>
+
+#include "velox/dwio/common/FileSink.h"
+
+namespace gluten {
+
+// A FileSink which hands the buffers over to the wrapped sink on an I/O executor, so the Parquet writer could encode and
+// compress the next pages while the previous ones are being written. The buffers are written in order by at most one task
+// at a time. write() blocks when the bytes not written yet would exceed maxInFlightBytes, the blocked time is reported as
+// flush wait. Errors of the wrapped sink are rethrown by the next write() or close().
+class AsyncFileSink final : public facebook::velox::dwio::common::FileSink {
+ public:
+  struct Stats {
+    uint64_t numWrites{0};
+    uint64_t numFlushWaits{0};
+    int64_t flushWaitNanos{0};
+    int64_t closeWaitNanos{0};
+    uint64_t peakInFlightBytes{0};
+  };
+
+  AsyncFileSink(
+      std::unique_ptr<facebook::velox::dwio::common::FileSink> sink,
+      folly::Executor* executor,
+      uint64_t maxInFlightBytes,
+      facebook::velox::memory::MemoryPool* pool);
+
+  ~AsyncFileSink() override;
+
+  bool isBuffered() const override {
+    return false;
+  }
+
+  void write(std::vector<facebook::velox::dwio::common::DataBuffer<char>>& buffers) override;
+
+  Stats asyncStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return asyncStats_;
+  }
+
+ protected:
+  void doClose() override;
+
+ private:
+  void drain();
+
+  // Waits until all the pending buffers are written. Must be called with the lock held.
+  void waitForDrained(std::unique_lock<std::mutex>& lock);
+
+  void checkError();
+
+  std::unique_ptr<facebook::velox::dwio::common::FileSink> sink_;
+  folly::Executor* executor_;
+  const uint64_t maxInFlightBytes_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::vector<facebook::velox::dwio::common::DataBuffer<char>>> pending_;
+  uint64_t inFlightBytes_{0};
+  bool draining_{false};
+  std::exception_ptr error_;
+  Stats asyncStats_;
+};
+
+} // namespace gluten
@@ -27,6 +27,14 @@
 
 namespace gluten {
 
+// Metrics of writing one file, returned to the JVM when the data source is closed.
+struct DataSourceWriteMetrics {
+  uint64_t numFlushWaits{0};
+  int64_t flushWaitNanos{0};
+  int64_t closeWaitNanos{0};
+  uint64_t peakInFlightBytes{0};
+};
+
 class VeloxDataSource {
  public:
   VeloxDataSource(const std::string& filePath, std::shared_ptr<arrow::Schema> schema)
@@ -38,6 +46,9 @@ class VeloxDataSource {
   virtual void inspectSchema(struct ArrowSchema* out) = 0;
   virtual void write(const std::shared_ptr<ColumnarBatch>& cb) {}
   virtual void close() {}
+  virtual DataSourceWriteMetrics writeMetrics() const {
+    return {};
+  }
   virtual std::shared_ptr<arrow::Schema> getSchema() = 0;
 
  private:
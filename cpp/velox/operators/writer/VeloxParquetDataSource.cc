@@ -22,10 +22,14 @@
 #include <string>
 
 #include "arrow/c/bridge.h"
+#include "compute/VeloxBackend.h"
 #include "compute/VeloxRuntime.h"
+#include "config/VeloxConfig.h"
 
+#include "utils/ConfigExtractor.h"
 #include "utils/VeloxArrowUtils.h"
 #include "utils/VeloxWriterUtils.h"
+#include "velox/common/config/Config.h"
 
 using namespace facebook;
 using namespace facebook::velox::dwio::common;
@@ -44,6 +48,14 @@ void VeloxParquetDataSource::initSink(const std::unordered_map<std::string, std:
 
 void VeloxParquetDataSource::init(const std::unordered_map<std::string, std::string>& sparkConfs) {
   initSink(sparkConfs);
+  if (auto* executor = VeloxBackend::get()->getParquetWriteExecutor()) {
+    auto maxInFlightBytes = velox::config::toCapacity(
+        getConfigValue(sparkConfs, kParquetWriteMaxInFlightBytes, kParquetWriteMaxInFlightBytesDefault),
+        velox::config::CapacityUnit::BYTE);
+    auto asyncSink = std::make_unique<AsyncFileSink>(std::move(sink_), executor, maxInFlightBytes, sinkPool_.get());
+    asyncSink_ = asyncSink.get();
+    sink_ = std::move(asyncSink);
+  }
   auto schema = gluten::fromArrowSchema(schema_);
   const auto writeOption = gluten::makeParquetWriteOption(sparkConfs);
   parquetWriter_ = std::make_unique<velox::parquet::Writer>(std::move(sink_), *writeOption, pool_, asRowType(schema));
@@ -73,10 +85,24 @@ void VeloxParquetDataSource::close() {
   }
 }
 
+DataSourceWriteMetrics VeloxParquetDataSource::writeMetrics() const {
+  if (!asyncSink_) {
+    return {};
+  }
+  const auto stats = asyncSink_->asyncStats();
+  return {
+      .numFlushWaits = stats.numFlushWaits,
+      .flushWaitNanos = stats.flushWaitNanos,
+      .closeWaitNanos = stats.closeWaitNanos,
+      .peakInFlightBytes = stats.peakInFlightBytes};
+}
+
 void VeloxParquetDataSource::write(const std::shared_ptr<ColumnarBatch>& cb) {
   auto veloxBatch = std::dynamic_pointer_cast<VeloxColumnarBatch>(cb);
   VELOX_DCHECK(veloxBatch != nullptr, "Write batch should be VeloxColumnarBatch");
-  parquetWriter_->write(veloxBatch->getFlattenedRowVector());
+  // Only lazy children are loaded here, the input batch is not flattened. Note the Velox Parquet writer still flattens
+  // dictionary and constant vectors when exporting them to Arrow, so they are not written as dictionary pages as is.
+  parquetWriter_->write(veloxBatch->getLoadedRowVector());
 }
 
 } // namespace gluten
@@ -27,6 +27,7 @@
 
 #include "memory/ColumnarBatch.h"
 #include "memory/VeloxColumnarBatch.h"
+#include "operators/writer/AsyncFileSink.h"
 #include "operators/writer/VeloxDataSource.h"
 
 #include "velox/common/compression/Compression.h"
@@ -95,6 +96,7 @@ class VeloxParquetDataSource : public VeloxDataSource {
   void inspectSchema(struct ArrowSchema* out) override;
   void write(const std::shared_ptr<ColumnarBatch>& cb) override;
   void close() override;
+  DataSourceWriteMetrics writeMetrics() const override;
   std::shared_ptr<arrow::Schema> getSchema() override {
     return schema_;
   }
@@ -108,6 +110,8 @@ class VeloxParquetDataSource : public VeloxDataSource {
   std::shared_ptr<arrow::Schema> schema_;
   std::shared_ptr<facebook::velox::parquet::Writer> parquetWriter_;
   std::shared_ptr<facebook::velox::memory::MemoryPool> pool_;
+  // Owned by parquetWriter_, nullptr if the output is written synchronously.
+  AsyncFileSink* asyncSink_ = nullptr;
 };
 
 } // namespace gluten
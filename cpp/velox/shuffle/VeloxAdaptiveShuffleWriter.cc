@@ -0,0 +1,212 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shuffle/VeloxAdaptiveShuffleWriter.h"
+
+#include "memory/VeloxColumnarBatch.h"
+
+namespace gluten {
+
+arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxAdaptiveShuffleWriter::create(
+    uint32_t numPartitions,
+    const std::shared_ptr<PartitionWriter>& partitionWriter,
+    const std::shared_ptr<ShuffleWriterOptions>& options,
+    MemoryManager* memoryManager) {
+  if (auto adaptiveOptions = std::dynamic_pointer_cast<AdaptiveShuffleWriterOptions>(options)) {
+    ARROW_RETURN_IF(
+        adaptiveOptions->sampleBatches <= 0,
+        arrow::Status::Invalid("Adaptive shuffle writer requires at least one sample batch."));
+    return std::shared_ptr<VeloxShuffleWriter>(
+        new VeloxAdaptiveShuffleWriter(numPartitions, partitionWriter, adaptiveOptions, memoryManager));
+  }
+  return arrow::Status::Invalid("Error casting ShuffleWriterOptions to AdaptiveShuffleWriterOptions.");
+}
+
+VeloxAdaptiveShuffleWriter::VeloxAdaptiveShuffleWriter(
+    uint32_t numPartitions,
+    const std::shared_ptr<PartitionWriter>& partitionWriter,
+    const std::shared_ptr<AdaptiveShuffleWriterOptions>& options,
+    MemoryManager* memoryManager)
+    : VeloxShuffleWriter(numPartitions, partitionWriter, options, memoryManager),
+      options_(options),
+      memoryManager_(memoryManager) {}
+
+arrow::Status VeloxAdaptiveShuffleWriter::write(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) {
+  if (delegate_ != nullptr) {
+    RETURN_NOT_OK(delegate_->write(std::move(cb), memLimit));
+    writtenBytes_ = delegate_->bytesWritten();
+    return arrow::Status::OK();
+  }
+
+  writtenBytes_ = 0;
+  lastMemLimit_ = memLimit;
+  // The sort shuffle writer doesn't support single partition, so there is nothing to choose from.
+  if (partitioning_ != Partitioning::kSingle) {
+    RETURN_NOT_OK(sample(cb));
+  }
+  sampledBatches_.push_back(std::move(cb));
+  if (partitioning_ != Partitioning::kSingle && sampledBatches_.size() < static_cast<size_t>(options_->sampleBatches)) {
+    return arrow::Status::OK();
+  }
+  return createDelegate(memLimit);
+}
+
+arrow::Status VeloxAdaptiveShuffleWriter::stop() {
+  int64_t bytesWritten = 0;
+  if (delegate_ == nullptr) {
+    RETURN_NOT_OK(createDelegate(lastMemLimit_));
+    bytesWritten = writtenBytes_;
+  }
+  RETURN_NOT_OK(delegate_->stop());
+  writtenBytes_ = bytesWritten + delegate_->bytesWritten();
+
+  metrics_ = delegate_->metrics();
+  metrics_.adaptiveDecision = decision_;
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxAdaptiveShuffleWriter::reclaimFixedSize(int64_t size, int64_t* actual) {
+  // The sampled batches are bounded by the number of sample batches and are not reclaimable.
+  if (delegate_ == nullptr) {
+    *actual = 0;
+    return arrow::Status::OK();
+  }
+  return delegate_->reclaimFixedSize(size, actual);
+}
+
+int64_t VeloxAdaptiveShuffleWriter::peakBytesAllocated() const {
+  return delegate_ != nullptr ? delegate_->peakBytesAllocated() : VeloxShuffleWriter::peakBytesAllocated();
+}
+
+int64_t VeloxAdaptiveShuffleWriter::totalSortTime() const {
+  return delegate_ != nullptr ? delegate_->totalSortTime() : 0;
+}
+
+int64_t VeloxAdaptiveShuffleWriter::totalC2RTime() const {
+  return delegate_ != nullptr ? delegate_->totalC2RTime() : 0;
+}
+
+const uint64_t VeloxAdaptiveShuffleWriter::cachedPayloadSize() const {
+  return delegate_ != nullptr ? delegate_->cachedPayloadSize() : 0;
+}
+
+arrow::Status VeloxAdaptiveShuffleWriter::sample(const std::shared_ptr<ColumnarBatch>& cb) {
+  auto veloxColumnBatch = VeloxColumnarBatch::from(veloxPool_.get(), cb);
+  VELOX_CHECK_NOT_NULL(veloxColumnBatch);
+  // The batch is replayed into the chosen writer later, so it must not be flattened in place here.
+  auto rv = veloxColumnBatch->getLoadedRowVector();
+  const auto numRows = rv->size();
+  if (numRows == 0) {
+    return arrow::Status::OK();
+  }
+
+  if (partitioner_->hasPid()) {
+    // Only flatten a local reference of the partition id column.
+    auto pidColumn = rv->childAt(0);
+    facebook::velox::BaseVector::flattenVector(pidColumn);
+    auto pidVector = std::make_shared<facebook::velox::RowVector>(
+        veloxPool_.get(),
+        facebook::velox::ROW({pidColumn->type()}),
+        nullptr,
+        numRows,
+        std::vector<facebook::velox::VectorPtr>{pidColumn});
+    RETURN_NOT_OK(partitioner_->compute(getFirstColumn(*pidVector), numRows, row2Partition_));
+  } else {
+    RETURN_NOT_OK(partitioner_->compute(nullptr, numRows, row2Partition_));
+  }
+
+  if (partitionLastBatch_.empty()) {
+    partitionLastBatch_.resize(numPartitions_, 0);
+  }
+  const uint32_t batchIndex = sampledBatches_.size() + 1;
+  for (auto pid : row2Partition_) {
+    if (partitionLastBatch_[pid] != batchIndex) {
+      partitionLastBatch_[pid] = batchIndex;
+      ++sampledPartitions_;
+    }
+  }
+
+  sampledRows_ += numRows;
+  sampledBytes_ += rv->estimateFlatSize();
+  return arrow::Status::OK();
+}
+
+AdaptiveShuffleWriterDecision VeloxAdaptiveShuffleWriter::decide(int64_t memLimit) const {
+  AdaptiveShuffleWriterDecision decision;
+  decision.sampledBatches = sampledBatches_.size();
+  decision.sampledRows = sampledRows_;
+  if (partitioning_ == Partitioning::kSingle || sampledRows_ == 0) {
+    decision.writerType = ShuffleWriterType::kHashShuffle;
+    return decision;
+  }
+
+  decision.avgRowBytes = static_cast<double>(sampledBytes_) / sampledRows_;
+  decision.avgPartitionsPerBatch = static_cast<double>(sampledPartitions_) / sampledBatches_.size();
+  decision.avgBytesPerPartitionPerBatch = static_cast<double>(sampledBytes_) / sampledPartitions_;
+  // The hash shuffle writer keeps a split buffer for every partition. If they don't fit into the memory limit, the
+  // buffers are shrunk and evicted frequently, which ends up with excessive spills.
+  decision.estimatedHashBufferBytes =
+      static_cast<int64_t>(numPartitions_ * decision.avgRowBytes * options_->hashOptions.splitBufferSize);
+
+  if (decision.estimatedHashBufferBytes > memLimit ||
+      decision.avgBytesPerPartitionPerBatch < options_->sortBytesPerPartition) {
+    decision.writerType = ShuffleWriterType::kSortShuffle;
+  } else {
+    decision.writerType = ShuffleWriterType::kHashShuffle;
+  }
+  return decision;
+}
+
+arrow::Status VeloxAdaptiveShuffleWriter::createDelegate(int64_t memLimit) {
+  decision_ = decide(memLimit);
+
+  std::shared_ptr<ShuffleWriterOptions> options;
+  if (decision_.writerType == ShuffleWriterType::kSortShuffle) {
+    auto sortOptions = std::make_shared<SortShuffleWriterOptions>(options_->sortOptions);
+    // Keep the payload layout of the hash shuffle writer for the reader.
+    sortOptions->columnarPayload = true;
+    options = std::move(sortOptions);
+  } else {
+    options = std::make_shared<HashShuffleWriterOptions>(options_->hashOptions);
+  }
+  options->partitioning = options_->partitioning;
+  options->startPartitionId = options_->startPartitionId;
+
+  LOG(INFO) << "Adaptive shuffle writer chooses " << typeToString(decision_.writerType)
+            << " shuffle writer. sampledBatches: " << decision_.sampledBatches
+            << ", sampledRows: " << decision_.sampledRows << ", avgRowBytes: " << decision_.avgRowBytes
+            << ", avgPartitionsPerBatch: " << decision_.avgPartitionsPerBatch
+            << ", avgBytesPerPartitionPerBatch: " << decision_.avgBytesPerPartitionPerBatch
+            << ", estimatedHashBufferBytes: " << decision_.estimatedHashBufferBytes << ", memLimit: " << memLimit;
+
+  ARROW_ASSIGN_OR_RAISE(
+      delegate_,
+      VeloxShuffleWriter::create(decision_.writerType, numPartitions_, partitionWriter_, options, memoryManager_));
+
+  int64_t bytesWritten = 0;
+  for (auto& batch : sampledBatches_) {
+    RETURN_NOT_OK(delegate_->write(std::move(batch), memLimit));
+    bytesWritten += delegate_->bytesWritten();
+  }
+  sampledBatches_.clear();
+  partitionLastBatch_.clear();
+  partitionLastBatch_.shrink_to_fit();
+  writtenBytes_ = bytesWritten;
+  return arrow::Status::OK();
+}
+
+} // namespace gluten
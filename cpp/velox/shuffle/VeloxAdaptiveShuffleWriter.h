@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "shuffle/VeloxShuffleWriter.h"
+
+#include <arrow/status.h>
+#include <vector>
+
+namespace gluten {
+
+// Samples the first input batches to choose between the hash and the sort shuffle writer, then replays the sampled
+// batches into the chosen writer and delegates the rest of the input to it.
+//
+// The sort shuffle writer is chosen when the hash shuffle writer's partition buffers are not expected to fit into the
+// memory limit, or when a partition receives too few bytes per input batch for the per-partition split to pay off.
+// The sort shuffle writer is created with columnar payloads, so both choices produce the same payload layout and
+// are read with the hash shuffle reader.
+class VeloxAdaptiveShuffleWriter final : public VeloxShuffleWriter {
+ public:
+  static arrow::Result<std::shared_ptr<VeloxShuffleWriter>> create(
+      uint32_t numPartitions,
+      const std::shared_ptr<PartitionWriter>& partitionWriter,
+      const std::shared_ptr<ShuffleWriterOptions>& options,
+      MemoryManager* memoryManager);
+
+  arrow::Status write(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) override;
+
+  arrow::Status stop() override;
+
+  arrow::Status reclaimFixedSize(int64_t size, int64_t* actual) override;
+
+  int64_t peakBytesAllocated() const override;
+
+  int64_t totalSortTime() const override;
+
+  int64_t totalC2RTime() const override;
+
+  const uint64_t cachedPayloadSize() const override;
+
+ private:
+  VeloxAdaptiveShuffleWriter(
+      uint32_t numPartitions,
+      const std::shared_ptr<PartitionWriter>& partitionWriter,
+      const std::shared_ptr<AdaptiveShuffleWriterOptions>& options,
+      MemoryManager* memoryManager);
+
+  arrow::Status sample(const std::shared_ptr<ColumnarBatch>& cb);
+
+  AdaptiveShuffleWriterDecision decide(int64_t memLimit) const;
+
+  // Creates the chosen writer and replays the sampled batches into it.
+  arrow::Status createDelegate(int64_t memLimit);
+
+  std::shared_ptr<AdaptiveShuffleWriterOptions> options_;
+  MemoryManager* memoryManager_;
+
+  std::shared_ptr<VeloxShuffleWriter> delegate_;
+  AdaptiveShuffleWriterDecision decision_{};
+
+  std::vector<std::shared_ptr<ColumnarBatch>> sampledBatches_;
+  int64_t sampledRows_{0};
+  int64_t sampledBytes_{0};
+  // Sum of the number of distinct partitions over the sampled batches.
+  int64_t sampledPartitions_{0};
+  int64_t lastMemLimit_{ShuffleWriter::kMaxMemLimit};
+
+  std::vector<uint32_t> row2Partition_;
+  // Partition ID -> the last sampled batch (1-based) that has rows in the partition.
+  std::vector<uint32_t> partitionLastBatch_;
+};
+
+} // namespace gluten
@@ -82,75 +82,6 @@ class BinaryArrayResizeGuard {
   BinaryArrayResizeState& state_;
 };
 
-template <facebook::velox::TypeKind kind>
-arrow::Status collectFlatVectorBuffer(
-    facebook::velox::BaseVector* vector,
-    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::MemoryPool* pool) {
-  using T = typename facebook::velox::TypeTraits<kind>::NativeType;
-  auto flatVector = dynamic_cast<const facebook::velox::FlatVector<T>*>(vector);
-  buffers.emplace_back();
-  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->nulls(), pool));
-  buffers.emplace_back();
-  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->values(), pool));
-  return arrow::Status::OK();
-}
-
-arrow::Status collectFlatVectorBufferStringView(
-    facebook::velox::BaseVector* vector,
-    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::MemoryPool* pool) {
-  auto flatVector = dynamic_cast<const facebook::velox::FlatVector<facebook::velox::StringView>*>(vector);
-  buffers.emplace_back();
-  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->nulls(), pool));
-
-  auto rawValues = flatVector->rawValues();
-  // last offset is the totalStringSize
-  auto lengthBufferSize = sizeof(gluten::StringLengthType) * flatVector->size();
-  ARROW_ASSIGN_OR_RAISE(auto lengthBuffer, arrow::AllocateResizableBuffer(lengthBufferSize, pool));
-  auto* rawLength = reinterpret_cast<gluten::StringLengthType*>(lengthBuffer->mutable_data());
-  uint64_t offset = 0;
-  for (int32_t i = 0; i < flatVector->size(); i++) {
-    auto length = rawValues[i].size();
-    *rawLength++ = length;
-    offset += length;
-  }
-  buffers.push_back(std::move(lengthBuffer));
-
-  ARROW_ASSIGN_OR_RAISE(auto valueBuffer, arrow::AllocateResizableBuffer(offset, pool));
-  auto raw = reinterpret_cast<char*>(valueBuffer->mutable_data());
-  for (int32_t i = 0; i < flatVector->size(); i++) {
-    gluten::fastCopy(raw, rawValues[i].data(), rawValues[i].size());
-    raw += rawValues[i].size();
-  }
-  buffers.push_back(std::move(valueBuffer));
-  return arrow::Status::OK();
-}
-
-template <>
-arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::UNKNOWN>(
-    facebook::velox::BaseVector* vector,
-    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::MemoryPool* pool) {
-  return arrow::Status::OK();
-}
-
-template <>
-arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::VARCHAR>(
-    facebook::velox::BaseVector* vector,
-    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::MemoryPool* pool) {
-  return collectFlatVectorBufferStringView(vector, buffers, pool);
-}
-
-template <>
-arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::VARBINARY>(
-    facebook::velox::BaseVector* vector,
-    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
-    arrow::MemoryPool* pool) {
-  return collectFlatVectorBufferStringView(vector, buffers, pool);
-}
-
 } // namespace
 
 arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxHashShuffleWriter::create(
@@ -244,9 +175,7 @@ arrow::Status VeloxHashShuffleWriter::write(std::shared_ptr<ColumnarBatch> cb, i
     std::vector<facebook::velox::VectorPtr> complexChildren;
     for (auto& child : rv.children()) {
       if (child->encoding() == facebook::velox::VectorEncoding::Simple::FLAT) {
-        auto status = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(
-            collectFlatVectorBuffer, child->typeKind(), child.get(), buffers, partitionBufferPool_.get());
-        RETURN_NOT_OK(status);
+        RETURN_NOT_OK(collectFlatVectorBuffers(child.get(), buffers, partitionBufferPool_.get()));
       } else {
         complexChildren.emplace_back(child);
       }
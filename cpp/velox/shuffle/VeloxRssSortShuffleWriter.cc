@@ -21,6 +21,11 @@
 #include "shuffle/ShuffleSchema.h"
 #include "utils/Common.h"
 #include "utils/Macros.h"
+#include "utils/Timer.h"
+
+#include <arrow/io/buffered.h>
+#include <arrow/io/file.h>
+#include <filesystem>
 
 #include "velox/common/base/Nulls.h"
 #include "velox/type/Type.h"
@@ -28,6 +33,9 @@
 #include "velox/vector/VectorEncoding.h"
 
 namespace gluten {
+namespace {
+constexpr int64_t kSpillWriteBufferSize = 1 << 20;
+} // namespace
 
 arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxRssSortShuffleWriter::create(
     uint32_t numPartitions,
@@ -43,6 +51,20 @@ arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxRssSortShuffleWriter::cr
   return arrow::Status::Invalid("Error casting ShuffleWriterOptions to RssSortShuffleWriterOptions.");
 }
 
+VeloxRssSortShuffleWriter::~VeloxRssSortShuffleWriter() {
+  if (spillOs_ != nullptr) {
+    if (auto status = spillOs_->Close(); !status.ok()) {
+      LOG(WARNING) << "Failed to close the spill run: " << status.ToString();
+    }
+  }
+  for (const auto& run : spillRuns_) {
+    std::error_code ec;
+    if (!std::filesystem::remove(run.file, ec) && ec) {
+      LOG(WARNING) << "Failed to remove the spill run " << run.file << ": " << ec.message();
+    }
+  }
+}
+
 arrow::Status VeloxRssSortShuffleWriter::init() {
   rowVectorIndexMap_.reserve(numPartitions_);
   bufferOutputStream_ = std::make_unique<BufferOutputStream>(veloxPool_.get());
@@ -54,9 +76,7 @@ arrow::Status VeloxRssSortShuffleWriter::doSort(facebook::velox::RowVectorPtr rv
   calculateBatchesSize(rv);
   batches_.push_back(rv);
   if (currentInputColumnBytes_ > memLimit) {
-    for (auto pid = 0; pid < numPartitions(); ++pid) {
-      RETURN_NOT_OK(evictRowVector(pid));
-    }
+    RETURN_NOT_OK(evictAllPartitions());
     resetBatches();
   }
   setSortState(RssSortState::kSortInit);
@@ -123,14 +143,32 @@ arrow::Status VeloxRssSortShuffleWriter::write(std::shared_ptr<ColumnarBatch> cb
   return arrow::Status::OK();
 }
 
+arrow::Status VeloxRssSortShuffleWriter::push(uint32_t partitionId, const uint8_t* data, int64_t size) {
+  auto arrowBuffer = std::make_shared<arrow::Buffer>(data, size);
+  ARROW_ASSIGN_OR_RAISE(
+      auto payload, BlockPayload::fromBuffers(Payload::kRaw, 0, {std::move(arrowBuffer)}, nullptr, nullptr, nullptr));
+  return partitionWriter_->evict(partitionId, std::move(payload), stopped_, writtenBytes_);
+}
+
 arrow::Status VeloxRssSortShuffleWriter::evictBatch(uint32_t partitionId) {
   bufferOutputStream_->seekp(0);
   batch_->flush(bufferOutputStream_.get());
   auto buffer = bufferOutputStream_->getBuffer();
-  auto arrowBuffer = std::make_shared<arrow::Buffer>(buffer->as<uint8_t>(), buffer->size());
-  ARROW_ASSIGN_OR_RAISE(
-      auto payload, BlockPayload::fromBuffers(Payload::kRaw, 0, {std::move(arrowBuffer)}, nullptr, nullptr, nullptr));
-  RETURN_NOT_OK(partitionWriter_->evict(partitionId, std::move(payload), stopped_, writtenBytes_));
+  const auto* data = buffer->as<uint8_t>();
+  const int64_t size = buffer->size();
+  if (spillOs_ != nullptr) {
+    RETURN_NOT_OK(spillOs_->Write(data, size));
+    spillRuns_.back().pages.emplace_back(partitionId, size);
+  } else if (merging_) {
+    ARROW_ASSIGN_OR_RAISE(auto* dst, reserveMergeBuffer(partitionId, size));
+    if (dst != nullptr) {
+      memcpy(dst, data, size);
+    } else {
+      RETURN_NOT_OK(push(partitionId, data, size));
+    }
+  } else {
+    RETURN_NOT_OK(push(partitionId, data, size));
+  }
   batch_ = std::make_unique<facebook::velox::VectorStreamGroup>(veloxPool_.get(), serde_.get());
   batch_->createStreamTree(rowType_, splitBufferSize_, &serdeOptions_);
   return arrow::Status::OK();
@@ -194,11 +232,120 @@ arrow::Status VeloxRssSortShuffleWriter::evictRowVector(uint32_t partitionId) {
   return arrow::Status::OK();
 }
 
+arrow::Status VeloxRssSortShuffleWriter::evictAllPartitions() {
+  if (!localSpillDirs_.empty()) {
+    return spillRun();
+  }
+  for (auto pid = 0; pid < numPartitions(); ++pid) {
+    RETURN_NOT_OK(evictRowVector(pid));
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxRssSortShuffleWriter::spillRun() {
+  ScopedTimer timer(&metrics_.totalSpillTime);
+  ARROW_ASSIGN_OR_RAISE(auto spillFile, createTempShuffleFile(nextSpillDir()));
+  // Register the run before writing to it, so the file is removed if the writer fails in between.
+  spillRuns_.push_back({std::move(spillFile), {}});
+  ARROW_ASSIGN_OR_RAISE(auto fileOs, arrow::io::FileOutputStream::Open(spillRuns_.back().file));
+  ARROW_ASSIGN_OR_RAISE(
+      spillOs_, arrow::io::BufferedOutputStream::Create(kSpillWriteBufferSize, partitionBufferPool_.get(), fileOs));
+
+  for (auto pid = 0; pid < numPartitions(); ++pid) {
+    RETURN_NOT_OK(evictRowVector(pid));
+  }
+
+  ARROW_ASSIGN_OR_RAISE(auto spilledBytes, spillOs_->Tell());
+  RETURN_NOT_OK(spillOs_->Close());
+  spillOs_ = nullptr;
+  metrics_.totalBytesSpilled += spilledBytes;
+  return arrow::Status::OK();
+}
+
+arrow::Result<uint8_t*> VeloxRssSortShuffleWriter::reserveMergeBuffer(uint32_t partitionId, int64_t size) {
+  if (mergeBufferSize_ + size > spillMergePushSize_) {
+    RETURN_NOT_OK(flushMergeBuffer(partitionId));
+  }
+  if (size > spillMergePushSize_) {
+    return nullptr;
+  }
+  auto* dst = mergeBuffer_->asMutable<uint8_t>() + mergeBufferSize_;
+  mergeBufferSize_ += size;
+  return dst;
+}
+
+arrow::Status VeloxRssSortShuffleWriter::flushMergeBuffer(uint32_t partitionId) {
+  if (mergeBufferSize_ > 0) {
+    RETURN_NOT_OK(push(partitionId, mergeBuffer_->as<uint8_t>(), mergeBufferSize_));
+    mergeBufferSize_ = 0;
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxRssSortShuffleWriter::mergeSpillRuns() {
+  // Set before any allocation, so that a reclaim triggered by it doesn't spill another run while merging.
+  merging_ = true;
+  // Each run is sorted by partition id, so the runs are read sequentially while merging the partitions in order.
+  std::vector<std::shared_ptr<MmapFileStream>> inputs;
+  inputs.reserve(spillRuns_.size());
+  for (const auto& run : spillRuns_) {
+    ARROW_ASSIGN_OR_RAISE(auto in, MmapFileStream::open(run.file, kSpillWriteBufferSize));
+    inputs.push_back(std::move(in));
+  }
+  std::vector<size_t> nextPages(inputs.size(), 0);
+
+  mergeBuffer_ = facebook::velox::AlignedBuffer::allocate<uint8_t>(spillMergePushSize_, veloxPool_.get());
+  mergeBufferSize_ = 0;
+  for (uint32_t pid = 0; pid < numPartitions(); ++pid) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const auto& pages = spillRuns_[i].pages;
+      auto& next = nextPages[i];
+      for (; next < pages.size() && pages[next].first == pid; ++next) {
+        const auto size = pages[next].second;
+        ARROW_ASSIGN_OR_RAISE(auto* dst, reserveMergeBuffer(pid, size));
+        if (dst != nullptr) {
+          ARROW_ASSIGN_OR_RAISE(auto bytes, inputs[i]->Read(size, dst));
+          ARROW_RETURN_IF(bytes != size, arrow::Status::IOError("Unexpected end of spill file ", spillRuns_[i].file));
+        } else {
+          ARROW_ASSIGN_OR_RAISE(auto page, inputs[i]->Read(size));
+          RETURN_NOT_OK(push(pid, page->data(), page->size()));
+        }
+      }
+    }
+    // The rows buffered since the last spill are the last of this partition.
+    RETURN_NOT_OK(evictRowVector(pid));
+    RETURN_NOT_OK(flushMergeBuffer(pid));
+  }
+  merging_ = false;
+  mergeBuffer_ = nullptr;
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    GLUTEN_DCHECK(nextPages[i] == spillRuns_[i].pages.size(), "Not all pages are merged from the spill run.");
+    RETURN_NOT_OK(inputs[i]->Close());
+    std::filesystem::remove(spillRuns_[i].file);
+  }
+  spillRuns_.clear();
+  return arrow::Status::OK();
+}
+
+std::string VeloxRssSortShuffleWriter::nextSpillDir() {
+  const auto dirIndex = spillDirSelection_ % localSpillDirs_.size();
+  const auto subDirIndex = (spillDirSelection_ / localSpillDirs_.size()) % kDefaultNumSubDirs;
+  ++spillDirSelection_;
+  return getShuffleSpillDir(localSpillDirs_[dirIndex], subDirIndex);
+}
+
 arrow::Status VeloxRssSortShuffleWriter::stop() {
+  // The buffered rows are evicted or merged below. A reclaim in between must not evict them again.
+  EvictGuard evictGuard{evictState_};
   writtenBytes_ = 0;
   stopped_ = true;
-  for (auto pid = 0; pid < numPartitions(); ++pid) {
-    RETURN_NOT_OK(evictRowVector(pid));
+  if (spillRuns_.empty()) {
+    for (auto pid = 0; pid < numPartitions(); ++pid) {
+      RETURN_NOT_OK(evictRowVector(pid));
+    }
+  } else {
+    RETURN_NOT_OK(mergeSpillRuns());
   }
   batches_.clear();
   currentInputColumnBytes_ = 0;
@@ -230,10 +377,9 @@ arrow::Status VeloxRssSortShuffleWriter::reclaimFixedSize(int64_t size, int64_t*
   }
   EvictGuard evictGuard{evictState_};
 
-  if (sortState_ == RssSortState::kSortInit) {
-    for (auto pid = 0; pid < numPartitions(); ++pid) {
-      RETURN_NOT_OK(evictRowVector(pid));
-    }
+  // Not reentrant while spilling or merging the runs.
+  if (sortState_ == RssSortState::kSortInit && spillOs_ == nullptr && !merging_) {
+    RETURN_NOT_OK(evictAllPartitions());
     batches_.clear();
     *actual = currentInputColumnBytes_;
     currentInputColumnBytes_ = 0;
@@ -58,6 +58,9 @@ class VeloxRssSortShuffleWriter final : public VeloxShuffleWriter {
       const std::shared_ptr<ShuffleWriterOptions>& options,
       MemoryManager* memoryManager);
 
+  // Removes the spill runs left by a writer that is not stopped, e.g. when the task fails.
+  ~VeloxRssSortShuffleWriter() override;
+
   arrow::Status write(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) override;
 
   arrow::Status stop() override;
@@ -81,7 +84,16 @@ class VeloxRssSortShuffleWriter final : public VeloxShuffleWriter {
       : VeloxShuffleWriter(numPartitions, partitionWriter, options, memoryManager),
         splitBufferSize_(options->splitBufferSize),
         sortBufferMaxSize_(options->sortBufferMaxSize),
-        compressionKind_(arrowCompressionTypeToVelox(options->compressionType)) {}
+        compressionKind_(arrowCompressionTypeToVelox(options->compressionType)),
+        localSpillDirs_(options->localSpillDirs),
+        spillMergePushSize_(options->spillMergePushSize) {}
+
+  // Serialized pages spilled to a local file, in the order of partition id.
+  struct SpillRun {
+    std::string file;
+    // The partition id and the size of each page in the file.
+    std::vector<std::pair<uint32_t, int64_t>> pages;
+  };
 
   arrow::Status init();
 
@@ -93,6 +105,24 @@ class VeloxRssSortShuffleWriter final : public VeloxShuffleWriter {
 
   arrow::Status evictBatch(uint32_t partitionId);
 
+  // Evicts the buffered rows of all partitions, either by pushing them or by spilling them as a sorted run.
+  arrow::Status evictAllPartitions();
+
+  arrow::Status spillRun();
+
+  // Merges the spilled runs and the buffered rows by partition id into pushes of up to spillMergePushSize_ bytes.
+  arrow::Status mergeSpillRuns();
+
+  // Returns where to put a page of `size` bytes in the merge buffer, pushing the buffered pages first if it doesn't
+  // fit. Returns nullptr if the page is larger than the merge buffer and must be pushed on its own.
+  arrow::Result<uint8_t*> reserveMergeBuffer(uint32_t partitionId, int64_t size);
+
+  arrow::Status flushMergeBuffer(uint32_t partitionId);
+
+  arrow::Status push(uint32_t partitionId, const uint8_t* data, int64_t size);
+
+  std::string nextSpillDir();
+
   void stat() const;
 
   void calculateBatchesSize(const facebook::velox::RowVectorPtr& vector);
@@ -102,6 +132,8 @@ class VeloxRssSortShuffleWriter final : public VeloxShuffleWriter {
   int32_t splitBufferSize_;
   int64_t sortBufferMaxSize_;
   facebook::velox::common::CompressionKind compressionKind_;
+  std::vector<std::string> localSpillDirs_;
+  int64_t spillMergePushSize_;
 
   facebook::velox::RowTypePtr rowType_;
 
@@ -123,6 +155,15 @@ class VeloxRssSortShuffleWriter final : public VeloxShuffleWriter {
   folly::F14FastSet<facebook::velox::Buffer*> stringBuffers_;
 
   bool stopped_{false};
+
+  std::vector<SpillRun> spillRuns_;
+  uint32_t spillDirSelection_{0};
+  // Set while spilling a run. The evicted pages are written to it instead of being pushed.
+  std::shared_ptr<arrow::io::OutputStream> spillOs_{nullptr};
+  // Set while merging the spilled runs. The evicted pages are gathered in mergeBuffer_ instead of being pushed.
+  bool merging_{false};
+  facebook::velox::BufferPtr mergeBuffer_{nullptr};
+  int64_t mergeBufferSize_{0};
 }; // class VeloxSortBasedShuffleWriter
 
 } // namespace gluten
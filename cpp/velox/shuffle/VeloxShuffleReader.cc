@@ -827,6 +827,8 @@ std::unique_ptr<ColumnarBatchIterator> VeloxShuffleReaderDeserializerFactory::cr
           decompressTime_);
 #endif
     case ShuffleWriterType::kHashShuffle:
+    // The adaptive shuffle writer always produces the payload layout of the hash shuffle writer.
+    case ShuffleWriterType::kAdaptiveShuffle:
       return std::make_unique<VeloxHashShuffleReaderDeserializer>(
           streamReader,
           schema_,
@@ -16,15 +16,90 @@
  */
 
 #include "shuffle/VeloxShuffleWriter.h"
+#include "shuffle/VeloxAdaptiveShuffleWriter.h"
 #include "shuffle/VeloxHashShuffleWriter.h"
 #include "shuffle/VeloxRssSortShuffleWriter.h"
 #include "shuffle/VeloxSortShuffleWriter.h"
+#include "utils/Common.h"
+#include "utils/VeloxArrowUtils.h"
 
 #ifdef GLUTEN_ENABLE_GPU
 #include "VeloxGpuShuffleWriter.h"
 #endif
 
 namespace gluten {
+namespace {
+
+template <facebook::velox::TypeKind kind>
+arrow::Status collectFlatVectorBuffer(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  using T = typename facebook::velox::TypeTraits<kind>::NativeType;
+  auto flatVector = dynamic_cast<const facebook::velox::FlatVector<T>*>(vector);
+  buffers.emplace_back();
+  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->nulls(), pool));
+  buffers.emplace_back();
+  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->values(), pool));
+  return arrow::Status::OK();
+}
+
+arrow::Status collectFlatVectorBufferStringView(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  auto flatVector = dynamic_cast<const facebook::velox::FlatVector<facebook::velox::StringView>*>(vector);
+  buffers.emplace_back();
+  ARROW_ASSIGN_OR_RAISE(buffers.back(), toArrowBuffer(flatVector->nulls(), pool));
+
+  auto rawValues = flatVector->rawValues();
+  // last offset is the totalStringSize
+  auto lengthBufferSize = sizeof(gluten::StringLengthType) * flatVector->size();
+  ARROW_ASSIGN_OR_RAISE(auto lengthBuffer, arrow::AllocateResizableBuffer(lengthBufferSize, pool));
+  auto* rawLength = reinterpret_cast<gluten::StringLengthType*>(lengthBuffer->mutable_data());
+  uint64_t offset = 0;
+  for (int32_t i = 0; i < flatVector->size(); i++) {
+    auto length = rawValues[i].size();
+    *rawLength++ = length;
+    offset += length;
+  }
+  buffers.push_back(std::move(lengthBuffer));
+
+  ARROW_ASSIGN_OR_RAISE(auto valueBuffer, arrow::AllocateResizableBuffer(offset, pool));
+  auto raw = reinterpret_cast<char*>(valueBuffer->mutable_data());
+  for (int32_t i = 0; i < flatVector->size(); i++) {
+    gluten::fastCopy(raw, rawValues[i].data(), rawValues[i].size());
+    raw += rawValues[i].size();
+  }
+  buffers.push_back(std::move(valueBuffer));
+  return arrow::Status::OK();
+}
+
+template <>
+arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::UNKNOWN>(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  return arrow::Status::OK();
+}
+
+template <>
+arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::VARCHAR>(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  return collectFlatVectorBufferStringView(vector, buffers, pool);
+}
+
+template <>
+arrow::Status collectFlatVectorBuffer<facebook::velox::TypeKind::VARBINARY>(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  return collectFlatVectorBufferStringView(vector, buffers, pool);
+}
+
+} // namespace
 
 arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxShuffleWriter::create(
     ShuffleWriterType type,
@@ -40,6 +115,8 @@ arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxShuffleWriter::create(
       return VeloxSortShuffleWriter::create(numPartitions, std::move(partitionWriter), options, memoryManager);
     case ShuffleWriterType::kRssSortShuffle:
       return VeloxRssSortShuffleWriter::create(numPartitions, std::move(partitionWriter), options, memoryManager);
+    case ShuffleWriterType::kAdaptiveShuffle:
+      return VeloxAdaptiveShuffleWriter::create(numPartitions, std::move(partitionWriter), options, memoryManager);
 #ifdef GLUTEN_ENABLE_GPU
     case ShuffleWriterType::kGpuHashShuffle:
       return VeloxGpuHashShuffleWriter::create(numPartitions, std::move(partitionWriter), options, memoryManager);
@@ -49,4 +126,11 @@ arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxShuffleWriter::create(
   }
 }
 
+arrow::Status VeloxShuffleWriter::collectFlatVectorBuffers(
+    facebook::velox::BaseVector* vector,
+    std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+    arrow::MemoryPool* pool) {
+  return VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH_ALL(collectFlatVectorBuffer, vector->typeKind(), vector, buffers, pool);
+}
+
 } // namespace gluten
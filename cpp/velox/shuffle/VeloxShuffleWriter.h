@@ -129,6 +129,13 @@ class VeloxShuffleWriter : public ShuffleWriter {
 
   virtual ~VeloxShuffleWriter() = default;
 
+  // Appends the buffers of a flat vector in the layout of the hash shuffle payload: validity and values buffers, or
+  // validity, lengths and values buffers for strings.
+  static arrow::Status collectFlatVectorBuffers(
+      facebook::velox::BaseVector* vector,
+      std::vector<std::shared_ptr<arrow::Buffer>>& buffers,
+      arrow::MemoryPool* pool);
+
   // Memory Pool used to track memory usage of partition buffers.
   // The actual allocation is delegated to options_.memoryPool.
   std::shared_ptr<arrow::MemoryPool> partitionBufferPool_;
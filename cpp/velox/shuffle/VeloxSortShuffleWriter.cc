@@ -17,12 +17,15 @@
 
 #include "shuffle/VeloxSortShuffleWriter.h"
 
+#include "memory/ArrowMemory.h"
 #include "memory/VeloxColumnarBatch.h"
 #include "shuffle/RadixSort.h"
 #include "utils/Common.h"
 #include "utils/Timer.h"
+#include "utils/VeloxArrowUtils.h"
 
 #include <arrow/io/memory.h>
+#include <sys/mman.h>
 
 namespace gluten {
 namespace {
@@ -32,6 +35,12 @@ constexpr uint64_t kMaskLower40Bits = (1UL << 40) - 1;
 constexpr uint32_t kPartitionIdStartByteIndex = 5;
 constexpr uint32_t kPartitionIdEndByteIndex = 7;
 constexpr uint32_t kMaxPageNumber = (1 << 13) - 1; // 13-bit max = 8191
+// Number of rows to look ahead when gathering the sorted rows. Covers the memory latency of a random access with
+// copying rows of a few hundred bytes.
+constexpr size_t kPrefetchDistance = 16;
+// Pages of at least this size are advised to be backed by transparent huge pages, which reduces the TLB misses of the
+// random row gather.
+constexpr uint64_t kHugePageSize = 2UL * 1024 * 1024;
 
 uint64_t toCompactRowId(uint32_t partitionId, uint32_t pageNumber, uint32_t offsetInPage) {
   // |63 partitionId(24) |39 inputIndex(13) |26 rowIndex(27) |
@@ -46,6 +55,18 @@ std::pair<uint32_t, uint32_t> extractPageNumberAndOffset(uint64_t compactRowId)
   return {(compactRowId & kMaskLower40Bits) >> 27, compactRowId & kMaskLower27Bits};
 }
 
+void adviseHugePages(char* addr, uint64_t size) {
+#ifdef MADV_HUGEPAGE
+  auto begin = (reinterpret_cast<uintptr_t>(addr) + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  auto end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(kHugePageSize - 1);
+  if (begin < end) {
+    // Best effort. The page is zeroed right after, so huge pages don't increase the resident memory. Failure only means
+    // regular pages are used.
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+  }
+#endif
+}
+
 } // namespace
 
 arrow::Result<std::shared_ptr<VeloxShuffleWriter>> VeloxSortShuffleWriter::create(
@@ -70,12 +91,16 @@ VeloxSortShuffleWriter::VeloxSortShuffleWriter(
     : VeloxShuffleWriter(numPartitions, partitionWriter, options, memoryManager),
       useRadixSort_(options->useRadixSort),
       initialSortBufferSize_(options->initialSortBufferSize),
-      diskWriteBufferSize_(options->diskWriteBufferSize) {}
+      diskWriteBufferSize_(options->diskWriteBufferSize),
+      columnarPayload_(options->columnarPayload) {}
 
 arrow::Status VeloxSortShuffleWriter::write(std::shared_ptr<ColumnarBatch> cb, int64_t memLimit) {
   writtenBytes_ = 0;
   ARROW_ASSIGN_OR_RAISE(auto rv, getPeeledRowVector(cb));
   initRowType(rv);
+  if (columnarPayload_ && schema_ == nullptr) {
+    RETURN_NOT_OK(initColumnarPayload());
+  }
   RETURN_NOT_OK(insert(rv, memLimit));
   return arrow::Status::OK();
 }
@@ -249,12 +274,12 @@ arrow::Status VeloxSortShuffleWriter::evictAllPartitions() {
   while (++cur < end) {
     auto curPid = extractPartitionId(arrayPtr_[cur]);
     if (curPid != pid) {
-      RETURN_NOT_OK(evictPartition(pid, begin, cur));
+      RETURN_NOT_OK(columnarPayload_ ? evictPartitionColumnar(pid, begin, cur) : evictPartition(pid, begin, cur));
       pid = curPid;
       begin = cur;
     }
   }
-  RETURN_NOT_OK(evictPartition(pid, begin, cur));
+  RETURN_NOT_OK(columnarPayload_ ? evictPartitionColumnar(pid, begin, cur) : evictPartition(pid, begin, cur));
 
   if (!stopped_) {
     // Preserve the last page for use.
@@ -289,9 +314,12 @@ arrow::Status VeloxSortShuffleWriter::evictPartition(uint32_t partitionId, size_
   uint32_t recordSize;
 
   auto index = begin;
+  for (auto i = begin; i < std::min(begin + kPrefetchDistance, end); ++i) {
+    __builtin_prefetch(rowAddress(i));
+  }
   while (index < end) {
-    auto pageIndex = extractPageNumberAndOffset(arrayPtr_[index]);
-    addr = pageAddresses_[pageIndex.first] + pageIndex.second;
+    prefetchRow(index, end);
+    addr = rowAddress(index);
     recordSize = *(reinterpret_cast<RowSizeType*>(addr)) + sizeof(RowSizeType);
     if (offset + recordSize > diskWriteBufferSize_ && offset > 0) {
       sortTime.stop();
@@ -330,6 +358,20 @@ arrow::Status VeloxSortShuffleWriter::evictPartition(uint32_t partitionId, size_
   return arrow::Status::OK();
 }
 
+char* VeloxSortShuffleWriter::rowAddress(size_t index) const {
+  auto pageIndex = extractPageNumberAndOffset(arrayPtr_[index]);
+  return pageAddresses_[pageIndex.first] + pageIndex.second;
+}
+
+void VeloxSortShuffleWriter::prefetchRow(size_t index, size_t end) const {
+  if (index + kPrefetchDistance < end) {
+    auto* addr = rowAddress(index + kPrefetchDistance);
+    __builtin_prefetch(addr);
+    // Rows usually span more than one cache line.
+    __builtin_prefetch(addr + 64);
+  }
+}
+
 arrow::Status VeloxSortShuffleWriter::evictPartitionInternal(
     uint32_t partitionId,
     uint32_t numRows,
@@ -346,6 +388,129 @@ arrow::Status VeloxSortShuffleWriter::evictPartitionInternal(
   return arrow::Status::OK();
 }
 
+arrow::Status VeloxSortShuffleWriter::initColumnarPayload() {
+  schema_ = toArrowSchema(rowType_, veloxPool_.get());
+  ARROW_ASSIGN_OR_RAISE(auto arrowColumnTypes, toShuffleTypeId(schema_->fields()));
+
+  std::vector<std::string> complexNames;
+  std::vector<facebook::velox::TypePtr> complexChildren;
+  for (size_t i = 0; i < arrowColumnTypes.size(); ++i) {
+    switch (arrowColumnTypes[i]->id()) {
+      case arrow::BinaryType::type_id:
+      case arrow::StringType::type_id: {
+        isValidityBuffer_.push_back(true);
+        isValidityBuffer_.push_back(false);
+        isValidityBuffer_.push_back(false);
+      } break;
+      case arrow::StructType::type_id:
+      case arrow::MapType::type_id:
+      case arrow::ListType::type_id: {
+        complexNames.emplace_back(rowType_->nameOf(i));
+        complexChildren.emplace_back(rowType_->childAt(i));
+        hasComplexType_ = true;
+      } break;
+      case arrow::BooleanType::type_id: {
+        // Velox stores booleans as bits.
+        isValidityBuffer_.push_back(true);
+        isValidityBuffer_.push_back(true);
+      } break;
+      case arrow::NullType::type_id:
+        break;
+      default: {
+        isValidityBuffer_.push_back(true);
+        isValidityBuffer_.push_back(false);
+      } break;
+    }
+  }
+  if (hasComplexType_) {
+    isValidityBuffer_.push_back(false);
+  }
+  complexWriteType_ = std::make_shared<facebook::velox::RowType>(std::move(complexNames), std::move(complexChildren));
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxSortShuffleWriter::evictPartitionColumnar(uint32_t partitionId, size_t begin, size_t end) {
+  VELOX_DCHECK(begin < end);
+  std::vector<std::string_view> rows;
+  rows.reserve(std::min<size_t>(end - begin, kDefaultShuffleWriterBufferSize));
+  int64_t bytes = 0;
+  for (auto i = begin; i < std::min(begin + kPrefetchDistance, end); ++i) {
+    __builtin_prefetch(rowAddress(i));
+  }
+  for (auto index = begin; index < end; ++index) {
+    prefetchRow(index, end);
+    auto* addr = rowAddress(index);
+    auto rowSize = *(reinterpret_cast<RowSizeType*>(addr));
+    rows.emplace_back(addr + sizeof(RowSizeType), rowSize);
+    bytes += rowSize;
+    // Bound the payload by both the disk write buffer size and the row count of a hash shuffle split buffer.
+    if (bytes >= diskWriteBufferSize_ || rows.size() >= static_cast<size_t>(kDefaultShuffleWriterBufferSize)) {
+      RETURN_NOT_OK(evictColumnarRows(partitionId, rows));
+      rows.clear();
+      bytes = 0;
+    }
+  }
+  if (!rows.empty()) {
+    RETURN_NOT_OK(evictColumnarRows(partitionId, rows));
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status VeloxSortShuffleWriter::evictColumnarRows(
+    uint32_t partitionId,
+    const std::vector<std::string_view>& rows) {
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  {
+    ScopedTimer timer(&c2rTime_);
+    auto rv = facebook::velox::row::CompactRow::deserialize(rows, rowType_, veloxPool_.get());
+    std::vector<facebook::velox::VectorPtr> complexChildren;
+    for (auto child : rv->children()) {
+      switch (child->typeKind()) {
+        case facebook::velox::TypeKind::ROW:
+        case facebook::velox::TypeKind::MAP:
+        case facebook::velox::TypeKind::ARRAY:
+          complexChildren.emplace_back(std::move(child));
+          break;
+        default:
+          facebook::velox::BaseVector::flattenVector(child);
+          RETURN_NOT_OK(collectFlatVectorBuffers(child.get(), buffers, partitionBufferPool_.get()));
+          break;
+      }
+    }
+    if (hasComplexType_) {
+      auto complexVector = std::make_shared<facebook::velox::RowVector>(
+          veloxPool_.get(), complexWriteType_, nullptr, rv->size(), std::move(complexChildren));
+      buffers.emplace_back();
+      ARROW_ASSIGN_OR_RAISE(buffers.back(), serializeComplexColumns(complexVector));
+    }
+  }
+
+  auto payload = std::make_unique<InMemoryPayload>(
+      rows.size(), &isValidityBuffer_, schema_, std::move(buffers), hasComplexType_);
+  updateSpillMetrics(payload);
+  // Payloads evicted before stop are spilled right away to keep the memory footprint of the sort shuffle writer.
+  RETURN_NOT_OK(partitionWriter_->hashEvict(
+      partitionId, std::move(payload), stopped_ ? Evict::kCache : Evict::kSpill, false, writtenBytes_));
+  return arrow::Status::OK();
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> VeloxSortShuffleWriter::serializeComplexColumns(
+    const facebook::velox::RowVectorPtr& vector) {
+  facebook::velox::StreamArena arena(veloxPool_.get());
+  auto serializer = serde_.createIterativeSerializer(complexWriteType_, vector->size(), &arena, &serdeOptions_);
+  const facebook::velox::IndexRange allRows{0, vector->size()};
+  serializer->append(vector, folly::Range(&allRows, 1));
+
+  ARROW_ASSIGN_OR_RAISE(
+      std::shared_ptr<arrow::Buffer> valueBuffer,
+      arrow::AllocateBuffer(serializer->maxSerializedSize(), partitionBufferPool_.get()));
+  auto output = std::make_shared<arrow::io::FixedSizeBufferWriter>(valueBuffer);
+  facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+  ArrowFixedSizeBufferOutputStream out(output, &listener);
+  serializer->flush(&out);
+  return valueBuffer;
+}
+
 facebook::velox::vector_size_t VeloxSortShuffleWriter::maxRowsToInsert(
     facebook::velox::vector_size_t offset,
     facebook::velox::vector_size_t remainingRows) {
@@ -382,6 +547,9 @@ void VeloxSortShuffleWriter::acquireNewBuffer(uint64_t memLimit, uint64_t minSiz
 
   currentPage_ = newBuffer->asMutable<char>();
   currenPageSize_ = newBufferSize;
+  if (newBufferSize >= kHugePageSize) {
+    adviseHugePages(currentPage_, newBufferSize);
+  }
   memset(currentPage_, 0, newBufferSize);
 
   // If spill triggered, clear pages_.
@@ -20,6 +20,7 @@
 #include "shuffle/VeloxShuffleWriter.h"
 
 #include <arrow/status.h>
+#include <string_view>
 #include <vector>
 
 #include "velox/common/memory/HashStringAllocator.h"
@@ -77,6 +78,22 @@ class VeloxSortShuffleWriter final : public VeloxShuffleWriter {
 
   arrow::Status evictPartitionInternal(uint32_t partitionId, uint32_t numRows, uint8_t* buffer, int64_t rawLength);
 
+  char* rowAddress(size_t index) const;
+
+  // The sorted rows are gathered from random offsets of the pages. Prefetch the row kPrefetchDistance positions ahead
+  // of index so that its cache misses overlap with copying the current rows.
+  void prefetchRow(size_t index, size_t end) const;
+
+  arrow::Status initColumnarPayload();
+
+  // Transposes the rows in [begin, end) into the column buffers of the hash shuffle payload and evicts them.
+  arrow::Status evictPartitionColumnar(uint32_t partitionId, size_t begin, size_t end);
+
+  arrow::Status evictColumnarRows(uint32_t partitionId, const std::vector<std::string_view>& rows);
+
+  arrow::Result<std::shared_ptr<arrow::Buffer>> serializeComplexColumns(
+      const facebook::velox::RowVectorPtr& vector);
+
   facebook::velox::vector_size_t maxRowsToInsert(
       facebook::velox::vector_size_t offset,
       facebook::velox::vector_size_t remainingRows);
@@ -96,6 +113,7 @@ class VeloxSortShuffleWriter final : public VeloxShuffleWriter {
   bool useRadixSort_;
   int32_t initialSortBufferSize_;
   int32_t diskWriteBufferSize_;
+  bool columnarPayload_;
 
   // Stores compact row id -> row
   facebook::velox::BufferPtr array_;
@@ -127,6 +145,13 @@ class VeloxSortShuffleWriter final : public VeloxShuffleWriter {
   std::vector<RowSizeType> rowSize_;
   std::vector<uint64_t> rowSizePrefixSum_;
 
+  // Only used for columnar payloads.
+  std::shared_ptr<arrow::Schema> schema_;
+  std::vector<bool> isValidityBuffer_;
+  bool hasComplexType_{false};
+  facebook::velox::RowTypePtr complexWriteType_;
+  facebook::velox::serializer::presto::PrestoVectorSerde serde_;
+
   int64_t c2rTime_{0};
   int64_t sortTime_{0};
   bool stopped_{false};
@@ -1158,8 +1158,23 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(
   }
   const std::optional<std::string> rowNumberColumnName = std::nullopt;
 
+  // TopNRowNumber keeps a priority queue per partition in a hash table, the input doesn't need to be sorted.
+  auto rankFunction = core::TopNRowNumberNode::RankFunction::kRowNumber;
+  if (windowGroupLimitRel.has_advanced_extension()) {
+    const auto& extension = windowGroupLimitRel.advanced_extension();
+    if (SubstraitParser::configSetInOptimization(extension, "isRank=")) {
+      rankFunction = core::TopNRowNumberNode::RankFunction::kRank;
+    } else if (SubstraitParser::configSetInOptimization(extension, "isDenseRank=")) {
+      rankFunction = core::TopNRowNumberNode::RankFunction::kDenseRank;
+    }
+  }
+
   if (sortingKeys.empty()) {
     // Handle if all sorting keys are also used as partition keys.
+    if (rankFunction != core::TopNRowNumberNode::RankFunction::kRowNumber) {
+      // All rows of a partition are peers, so they all get rank 1.
+      return childNode;
+    }
 
     return std::make_shared<core::RowNumberNode>(
         nextPlanNodeId(),
@@ -1171,7 +1186,7 @@ core::PlanNodePtr SubstraitToVeloxPlanConverter::toVeloxPlan(
 
   return std::make_shared<core::TopNRowNumberNode>(
       nextPlanNodeId(),
-      core::TopNRowNumberNode::RankFunction::kRowNumber,
+      rankFunction,
       partitionKeys,
       sortingKeys,
       sortingOrders,
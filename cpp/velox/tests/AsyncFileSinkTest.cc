@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "operators/writer/AsyncFileSink.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <folly/executors/IOThreadPoolExecutor.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/memory/Memory.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+
+namespace gluten {
+
+namespace {
+class ThrowingSink final : public FileSink {
+ public:
+  explicit ThrowingSink(memory::MemoryPool* pool) : FileSink("throwing", {.pool = pool}) {}
+
+  bool isBuffered() const override {
+    return false;
+  }
+
+  void write(std::vector<DataBuffer<char>>& buffers) override {
+    buffers.clear();
+    VELOX_FAIL("Failed to write");
+  }
+};
+} // namespace
+
+class AsyncFileSinkTest : public ::testing::Test, public test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance(memory::MemoryManager::Options{});
+  }
+
+  std::vector<DataBuffer<char>> makeBuffers(char value, size_t size) {
+    std::vector<DataBuffer<char>> buffers;
+    buffers.emplace_back(*pool(), size);
+    std::memset(buffers.back().data(), value, size);
+    return buffers;
+  }
+
+  folly::IOThreadPoolExecutor executor_{2};
+};
+
+TEST_F(AsyncFileSinkTest, writeInOrder) {
+  auto path = std::filesystem::temp_directory_path() / ("async_file_sink_test_" + std::to_string(getpid()));
+  std::string expected;
+  {
+    // A small limit makes the writes wait for the in-flight buffers.
+    AsyncFileSink sink(FileSink::create("file:" + path.string(), {.pool = pool()}), &executor_, 4096, pool());
+    for (auto i = 0; i < 100; ++i) {
+      auto buffers = makeBuffers('a' + i % 26, 1000 + i);
+      sink.write(buffers);
+      ASSERT_TRUE(buffers.empty());
+      expected.append(1000 + i, 'a' + i % 26);
+    }
+    sink.close();
+    ASSERT_EQ(sink.size(), expected.size());
+    auto stats = sink.asyncStats();
+    ASSERT_EQ(stats.numWrites, 100);
+    ASSERT_LE(stats.peakInFlightBytes, 4096);
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  std::string actual((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(actual, expected);
+  std::filesystem::remove(path);
+}
+
+TEST_F(AsyncFileSinkTest, rethrowError) {
+  AsyncFileSink sink(std::make_unique<ThrowingSink>(pool()), &executor_, 1 << 20, pool());
+  auto buffers = makeBuffers('a', 100);
+  sink.write(buffers);
+  VELOX_ASSERT_THROW(sink.close(), "Failed to write");
+}
+
+} // namespace gluten
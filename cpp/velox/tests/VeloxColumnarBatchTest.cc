@@ -62,4 +62,23 @@ TEST_F(VeloxColumnarBatchTest, flattenTruncatedVector) {
   ASSERT_NO_THROW(batchOfMap->getFlattenedRowVector());
 }
 
+TEST_F(VeloxColumnarBatchTest, loadedVectorKeepsEncoding) {
+  vector_size_t numRows = 1'000;
+  auto dictionary = makeFlatVector<std::string>({"apple", "banana", "cherry"});
+  auto indices = makeIndices(numRows, [](auto row) { return row % 3; });
+  auto encoded = BaseVector::wrapInDictionary(nullptr, indices, numRows, dictionary);
+  auto constant = BaseVector::createConstant(BIGINT(), variant(int64_t(7)), numRows, pool());
+  auto input = makeRowVector({encoded, constant});
+
+  auto batch = std::make_shared<VeloxColumnarBatch>(input);
+  auto loaded = batch->getLoadedRowVector();
+  ASSERT_EQ(loaded->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  ASSERT_EQ(loaded->childAt(1)->encoding(), VectorEncoding::Simple::CONSTANT);
+  test::assertEqualVectors(input, loaded);
+
+  // The batch itself is not flattened.
+  ASSERT_EQ(batch->getRowVector()->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  test::assertEqualVectors(input, batch->getFlattenedRowVector());
+}
+
 } // namespace gluten
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compute/VeloxPlanCache.h"
+
+#include <gtest/gtest.h>
+
+#include "config/GlutenConfig.h"
+#include "velox/core/PlanNode.h"
+
+using namespace facebook::velox;
+
+namespace gluten {
+
+namespace {
+std::shared_ptr<const VeloxPlanCache::Entry> makeEntry(const std::string& nodeId) {
+  auto entry = std::make_shared<VeloxPlanCache::Entry>();
+  entry->plan = std::make_shared<core::ValuesNode>(nodeId, std::vector<RowVectorPtr>{});
+  return entry;
+}
+} // namespace
+
+TEST(VeloxPlanCacheTest, fingerprint) {
+  std::unordered_map<std::string, std::string> conf1{{kCaseSensitive, "false"}, {"a", "1"}};
+  // The configs not used by the plan conversion don't change the fingerprint.
+  std::unordered_map<std::string, std::string> conf2{{"a", "2"}, {kCaseSensitive, "false"}};
+  std::unordered_map<std::string, std::string> conf3{{kCaseSensitive, "true"}, {"a", "1"}};
+  ASSERT_EQ(VeloxPlanCache::confFingerprint(conf1), VeloxPlanCache::confFingerprint(conf2));
+  ASSERT_NE(VeloxPlanCache::confFingerprint(conf1), VeloxPlanCache::confFingerprint(conf3));
+
+  auto conf = VeloxPlanCache::confFingerprint(conf1);
+  ASSERT_EQ(VeloxPlanCache::fingerprint("plan", conf), VeloxPlanCache::fingerprint("plan", conf));
+  ASSERT_NE(VeloxPlanCache::fingerprint("plan", conf), VeloxPlanCache::fingerprint("plan2", conf));
+  ASSERT_NE(
+      VeloxPlanCache::fingerprint("plan", conf),
+      VeloxPlanCache::fingerprint("plan", VeloxPlanCache::confFingerprint(conf3)));
+}
+
+TEST(VeloxPlanCacheTest, hitAndMiss) {
+  VeloxPlanCache cache(2);
+  ASSERT_EQ(cache.get(1, "plan1"), nullptr);
+  cache.put(1, "plan1", makeEntry("1"));
+  auto entry = cache.get(1, "plan1");
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->plan->id(), "1");
+
+  // Same fingerprint but different plan bytes is a miss.
+  ASSERT_EQ(cache.get(1, "plan2"), nullptr);
+
+  auto stats = cache.stats();
+  ASSERT_EQ(stats.numHits, 1);
+  ASSERT_EQ(stats.numMisses, 2);
+}
+
+TEST(VeloxPlanCacheTest, evictLeastRecentlyUsed) {
+  VeloxPlanCache cache(2);
+  cache.put(1, "plan1", makeEntry("1"));
+  cache.put(2, "plan2", makeEntry("2"));
+  // Touch plan1 so plan2 becomes the least recently used one.
+  ASSERT_NE(cache.get(1, "plan1"), nullptr);
+  cache.put(3, "plan3", makeEntry("3"));
+
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_NE(cache.get(1, "plan1"), nullptr);
+  ASSERT_EQ(cache.get(2, "plan2"), nullptr);
+  ASSERT_NE(cache.get(3, "plan3"), nullptr);
+  ASSERT_EQ(cache.stats().numEvictions, 1);
+
+  // Putting an existing fingerprint replaces the entry without eviction.
+  cache.put(3, "plan3", makeEntry("4"));
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_EQ(cache.get(3, "plan3")->plan->id(), "4");
+  ASSERT_EQ(cache.stats().numEvictions, 1);
+}
+
+TEST(VeloxPlanCacheTest, zeroCapacity) {
+  VeloxPlanCache cache(0);
+  cache.put(1, "plan1", makeEntry("1"));
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_EQ(cache.get(1, "plan1"), nullptr);
+}
+
+} // namespace gluten
@@ -143,4 +143,46 @@ TEST_F(VeloxRowToColumnarTest, timestamp) {
   testRowVectorEqual(vector);
 }
 
+TEST_F(VeloxRowToColumnarTest, array) {
+  auto vector = makeRowVector({
+      makeNullableArrayVector<int32_t>({{{1, 2, std::nullopt}}, std::nullopt, {{}}, {{4, 5, 6, 7}}}),
+      makeNullableArrayVector<int8_t>({{{1, std::nullopt}}, {{-1}}, std::nullopt, {{3, 4, 5}}}),
+      makeNullableArrayVector<double>({{{0.5}}, {{}}, {{std::nullopt, 1.5}}, std::nullopt}),
+      makeNullableArrayVector<bool>({{{true, false, std::nullopt}}, {{false}}, std::nullopt, {{}}}),
+      makeNullableArrayVector<StringView>(
+          {{{"a", std::nullopt, "a long string value not inlined"}}, std::nullopt, {{"b"}}, {{}}}),
+      makeArrayVector<int64_t>({{1, 2}, {3}, {}, {4, 5, 6}}, DECIMAL(12, 3)),
+      makeArrayVector<int128_t>({{123456, HugeInt::build(1045, 1789)}, {-7}, {}, {0}}, DECIMAL(38, 2)),
+      makeArrayVector<Timestamp>({{Timestamp(946684800, 0)}, {}, {Timestamp(-7266, 0), Timestamp(0, 0)}, {}}),
+  });
+  testRowVectorEqual(vector);
+}
+
+TEST_F(VeloxRowToColumnarTest, map) {
+  auto vector = makeRowVector({
+      makeNullableMapVector<int32_t, int64_t>(
+          {{{{1, 10}, {2, std::nullopt}}}, std::nullopt, {{}}, {{{3, 30}}}}),
+      makeNullableMapVector<StringView, StringView>(
+          {{{{"key", "a long string value not inlined"}}}, {{}}, std::nullopt, {{{"k1", std::nullopt}, {"k2", "v"}}}}),
+  });
+  testRowVectorEqual(vector);
+}
+
+TEST_F(VeloxRowToColumnarTest, struct) {
+  auto vector = makeRowVector({
+      makeRowVector(
+          {makeNullableFlatVector<int32_t>({1, std::nullopt, 3, 4}),
+           makeNullableFlatVector<StringView>({"a", "b", std::nullopt, "a long string value not inlined"}),
+           makeArrayVector<int64_t>({{1, 2}, {}, {3}, {4, 5}})},
+          [](auto row) { return row == 1; }),
+      makeArrayOfRowVector(
+          ROW({INTEGER(), VARCHAR()}),
+          {{variant::row({1, "a"}), variant::row({2, "a long string value not inlined"})},
+           {},
+           {variant::row({3, "c"})},
+           {variant::null(TypeKind::ROW)}}),
+  });
+  testRowVectorEqual(vector);
+}
+
 } // namespace gluten
@@ -17,9 +17,13 @@
 
 #include <arrow/util/compression.h>
 
+#include <filesystem>
+#include <limits>
+
 #include "memory/VeloxMemoryManager.h"
 #include "shuffle/VeloxRssSortShuffleWriter.h"
 #include "tests/VeloxShuffleWriterTestBase.h"
+#include "tests/utils/LocalRssClient.h"
 #include "tests/utils/TestUtils.h"
 
 #include "velox/buffer/Buffer.h"
@@ -32,6 +36,38 @@ using namespace facebook::velox::test;
 
 namespace gluten {
 
+namespace {
+// Records the pushed bytes of each partition. If a shuffle writer is set, every push first asks it to reclaim memory,
+// like a reclaim triggered by an allocation while the writer is pushing.
+class ReclaimingRssClient : public RssClient {
+ public:
+  explicit ReclaimingRssClient(std::string dataFile) : delegate_(std::move(dataFile)) {}
+
+  int32_t pushPartitionData(int32_t partitionId, const char* bytes, int64_t size) override {
+    if (shuffleWriter_ != nullptr) {
+      int64_t actual = 0;
+      GLUTEN_THROW_NOT_OK(shuffleWriter_->reclaimFixedSize(std::numeric_limits<int64_t>::max(), &actual));
+      ++numReclaims_;
+      reclaimedBytes_ += actual;
+    }
+    pushedBytes_[partitionId] += size;
+    return delegate_.pushPartitionData(partitionId, bytes, size);
+  }
+
+  void stop() override {
+    delegate_.stop();
+  }
+
+  VeloxShuffleWriter* shuffleWriter_{nullptr};
+  int64_t numReclaims_{0};
+  int64_t reclaimedBytes_{0};
+  std::map<int32_t, int64_t> pushedBytes_;
+
+ private:
+  LocalRssClient delegate_;
+};
+} // namespace
+
 class VeloxRssSortShuffleWriterTest : public VeloxShuffleWriterTestBase, public testing::Test {
  protected:
   static void SetUpTestSuite() {
@@ -64,8 +100,99 @@ class VeloxRssSortShuffleWriterTest : public VeloxShuffleWriterTestBase, public
             numPartitions, std::move(partitionWriter), std::move(writerOptions), getDefaultMemoryManager()));
     return shuffleWriter;
   }
+
+  // Spills a sorted run for every input batch, and merges the runs into small pushes.
+  std::shared_ptr<VeloxShuffleWriter> createSpillingShuffleWriter(
+      uint32_t numPartitions,
+      std::unique_ptr<RssClient> rssClient) {
+    auto writerOptions = std::make_shared<RssSortShuffleWriterOptions>();
+    writerOptions->partitioning = Partitioning::kRoundRobin;
+    writerOptions->sortBufferMaxSize = 0;
+    writerOptions->spillMergePushSize = 512;
+    writerOptions->localSpillDirs = localDirs_;
+    GLUTEN_ASSIGN_OR_THROW(auto codec, arrow::util::Codec::Create(writerOptions->compressionType));
+    auto partitionWriter = std::make_shared<RssPartitionWriter>(
+        numPartitions,
+        std::move(codec),
+        getDefaultMemoryManager(),
+        std::make_shared<RssPartitionWriterOptions>(),
+        std::move(rssClient));
+    GLUTEN_ASSIGN_OR_THROW(
+        auto shuffleWriter,
+        VeloxRssSortShuffleWriter::create(
+            numPartitions, std::move(partitionWriter), std::move(writerOptions), getDefaultMemoryManager()));
+    return shuffleWriter;
+  }
+
+  int64_t countLocalFiles() const {
+    int64_t numFiles = 0;
+    for (const auto& dir : localDirs_) {
+      for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+        numFiles += entry.is_regular_file();
+      }
+    }
+    return numFiles;
+  }
 };
 
+TEST_F(VeloxRssSortShuffleWriterTest, reclaimWhileMergingSpillRuns) {
+  constexpr uint32_t kNumPartitions = 4;
+  auto writeSpillRuns = [&](bool reclaimOnPush) {
+    auto rssClient = std::make_unique<ReclaimingRssClient>(dataFile_);
+    auto* client = rssClient.get();
+    auto shuffleWriter = createSpillingShuffleWriter(kNumPartitions, std::move(rssClient));
+
+    for (int i = 0; i < 3; ++i) {
+      std::shared_ptr<ColumnarBatch> cb = std::make_shared<VeloxColumnarBatch>(inputVector1_);
+      GLUTEN_THROW_NOT_OK(shuffleWriter->write(cb, ShuffleWriter::kMinMemLimit));
+    }
+    // The pages are only pushed while stop() merges the spilled runs.
+    EXPECT_TRUE(client->pushedBytes_.empty());
+    if (reclaimOnPush) {
+      client->shuffleWriter_ = shuffleWriter.get();
+    }
+    GLUTEN_THROW_NOT_OK(shuffleWriter->stop());
+    if (reclaimOnPush) {
+      EXPECT_GT(client->numReclaims_, 0);
+      // Nothing could be reclaimed while stopping.
+      EXPECT_EQ(client->reclaimedBytes_, 0);
+    }
+    return client->pushedBytes_;
+  };
+
+  const auto expected = writeSpillRuns(false);
+  ASSERT_EQ(expected.size(), kNumPartitions);
+  ASSERT_EQ(writeSpillRuns(true), expected);
+}
+
+TEST_F(VeloxRssSortShuffleWriterTest, spillRunsMetricsAndCleanup) {
+  constexpr uint32_t kNumPartitions = 4;
+  const auto numFiles = countLocalFiles();
+  {
+    auto shuffleWriter = createSpillingShuffleWriter(kNumPartitions, std::make_unique<LocalRssClient>(dataFile_));
+    for (int i = 0; i < 3; ++i) {
+      std::shared_ptr<ColumnarBatch> cb = std::make_shared<VeloxColumnarBatch>(inputVector1_);
+      GLUTEN_THROW_NOT_OK(shuffleWriter->write(cb, ShuffleWriter::kMinMemLimit));
+    }
+    ASSERT_EQ(countLocalFiles(), numFiles + 3);
+    GLUTEN_THROW_NOT_OK(shuffleWriter->stop());
+    EXPECT_EQ(countLocalFiles(), numFiles);
+    EXPECT_GT(shuffleWriter->totalBytesSpilled(), 0);
+    EXPECT_GT(shuffleWriter->totalSpillTime(), 0);
+  }
+
+  // The runs of a writer that is never stopped, e.g. when the task fails, are removed when it's destroyed.
+  {
+    auto shuffleWriter = createSpillingShuffleWriter(kNumPartitions, std::make_unique<LocalRssClient>(dataFile_));
+    for (int i = 0; i < 3; ++i) {
+      std::shared_ptr<ColumnarBatch> cb = std::make_shared<VeloxColumnarBatch>(inputVector1_);
+      GLUTEN_THROW_NOT_OK(shuffleWriter->write(cb, ShuffleWriter::kMinMemLimit));
+    }
+    ASSERT_EQ(countLocalFiles(), numFiles + 3);
+  }
+  EXPECT_EQ(countLocalFiles(), numFiles);
+}
+
 TEST_F(VeloxRssSortShuffleWriterTest, calculateBatchesSize) {
   auto shuffleWriter = std::dynamic_pointer_cast<VeloxRssSortShuffleWriter>(createShuffleWriter(10));
   // Do not trigger resetBatches by shuffle writer.
@@ -18,6 +18,7 @@
 #include <arrow/c/bridge.h>
 #include <arrow/io/api.h>
 
+#include "shuffle/VeloxAdaptiveShuffleWriter.h"
 #include "shuffle/VeloxHashShuffleWriter.h"
 #include "shuffle/VeloxRssSortShuffleWriter.h"
 #include "shuffle/VeloxSortShuffleWriter.h"
@@ -44,6 +45,9 @@ struct ShuffleTestParams {
   bool useRadixSort{false};
   bool enableDictionary{false};
   int64_t deserializerBufferSize{0};
+  int64_t sortBytesPerPartition{0};
+  bool columnarPayload{false};
+  bool rssSortLocalSpill{false};
 
   std::string toString() const {
     std::ostringstream out;
@@ -54,7 +58,10 @@ struct ShuffleTestParams {
         << ", compressionBufferSize = " << diskWriteBufferSize
         << ", useRadixSort = " << (useRadixSort ? "true" : "false")
         << ", enableDictionary = " << (enableDictionary ? "true" : "false")
-        << ", deserializerBufferSize = " << deserializerBufferSize;
+        << ", deserializerBufferSize = " << deserializerBufferSize
+        << ", sortBytesPerPartition = " << sortBytesPerPartition
+        << ", columnarPayload = " << (columnarPayload ? "true" : "false")
+        << ", rssSortLocalSpill = " << (rssSortLocalSpill ? "true" : "false");
     return out.str();
   }
 };
@@ -121,11 +128,41 @@ std::vector<ShuffleTestParams> getTestParams() {
       }
     }
 
+    // Sort-based shuffle with columnar payloads.
+    for (const auto partitionWriterType : {PartitionWriterType::kLocal, PartitionWriterType::kRss}) {
+      for (const auto diskWriteBufferSize : {4, 32 * 1024}) {
+        params.push_back(ShuffleTestParams{
+            .shuffleWriterType = ShuffleWriterType::kSortShuffle,
+            .partitionWriterType = partitionWriterType,
+            .compressionType = compression,
+            .diskWriteBufferSize = diskWriteBufferSize,
+            .useRadixSort = true,
+            .columnarPayload = true});
+      }
+    }
+
+    // Adaptive shuffle. sortBytesPerPartition = 0 always chooses the hash shuffle writer, and the max value always
+    // chooses the sort shuffle writer.
+    for (const auto partitionWriterType : {PartitionWriterType::kLocal, PartitionWriterType::kRss}) {
+      for (const auto sortBytesPerPartition : {static_cast<int64_t>(0), std::numeric_limits<int64_t>::max()}) {
+        params.push_back(ShuffleTestParams{
+            .shuffleWriterType = ShuffleWriterType::kAdaptiveShuffle,
+            .partitionWriterType = partitionWriterType,
+            .compressionType = compression,
+            .mergeBufferSize = 4096,
+            .diskWriteBufferSize = kDefaultDiskWriteBufferSize,
+            .sortBytesPerPartition = sortBytesPerPartition});
+      }
+    }
+
     // Rss sort-based shuffle.
-    params.push_back(ShuffleTestParams{
-        .shuffleWriterType = ShuffleWriterType::kRssSortShuffle,
-        .partitionWriterType = PartitionWriterType::kRss,
-        .compressionType = compression});
+    for (const bool rssSortLocalSpill : {false, true}) {
+      params.push_back(ShuffleTestParams{
+          .shuffleWriterType = ShuffleWriterType::kRssSortShuffle,
+          .partitionWriterType = PartitionWriterType::kRss,
+          .compressionType = compression,
+          .rssSortLocalSpill = rssSortLocalSpill});
+    }
 
     // Hash-based shuffle.
     for (const auto compressionThreshold : compressionThresholds) {
@@ -214,14 +251,28 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
         auto sortOptions = std::make_shared<SortShuffleWriterOptions>();
         sortOptions->diskWriteBufferSize = params.diskWriteBufferSize;
         sortOptions->useRadixSort = params.useRadixSort;
+        sortOptions->columnarPayload = params.columnarPayload;
         options = sortOptions;
       } break;
       case ShuffleWriterType::kRssSortShuffle: {
         auto rssOptions = std::make_shared<RssSortShuffleWriterOptions>();
         rssOptions->splitBufferSize = splitBufferSize;
         rssOptions->compressionType = params.compressionType;
+        if (params.rssSortLocalSpill) {
+          // Spill a sorted run for every input batch, and merge the runs into small pushes.
+          rssOptions->sortBufferMaxSize = 0;
+          rssOptions->spillMergePushSize = 512;
+        }
         options = rssOptions;
       } break;
+      case ShuffleWriterType::kAdaptiveShuffle: {
+        auto adaptiveOptions = std::make_shared<AdaptiveShuffleWriterOptions>();
+        adaptiveOptions->hashOptions.splitBufferSize = splitBufferSize;
+        adaptiveOptions->sortOptions.diskWriteBufferSize = params.diskWriteBufferSize;
+        adaptiveOptions->sampleBatches = 2;
+        adaptiveOptions->sortBytesPerPartition = params.sortBytesPerPartition;
+        options = adaptiveOptions;
+      } break;
       default:
         throw GlutenException("Unreachable");
     }
@@ -240,6 +291,10 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
     }
 
     const auto& params = GetParam();
+    if (auto rssOptions = std::dynamic_pointer_cast<RssSortShuffleWriterOptions>(shuffleWriterOptions);
+        rssOptions != nullptr && params.rssSortLocalSpill) {
+      rssOptions->localSpillDirs = localDirs_;
+    }
     const auto partitionWriter = createPartitionWriter(
         params.partitionWriterType,
         numPartitions,
@@ -284,6 +339,15 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
     GLUTEN_ASSIGN_OR_THROW(file_, arrow::io::ReadableFile::Open(fileName))
   }
 
+  // Columnar payloads of the sort shuffle writer are read by the hash shuffle reader.
+  static ShuffleWriterType readerType() {
+    const auto& params = GetParam();
+    if (params.shuffleWriterType == ShuffleWriterType::kSortShuffle && params.columnarPayload) {
+      return ShuffleWriterType::kHashShuffle;
+    }
+    return params.shuffleWriterType;
+  }
+
   void getRowVectors(
       arrow::Compression::type compressionType,
       const RowTypePtr& rowType,
@@ -304,7 +368,7 @@ class VeloxShuffleWriterTest : public ::testing::TestWithParam<ShuffleTestParams
         kDefaultReadBufferSize,
         GetParam().deserializerBufferSize,
         getDefaultMemoryManager(),
-        GetParam().shuffleWriterType);
+        readerType());
 
     const auto reader = std::make_shared<VeloxShuffleReader>(std::move(deserializerFactory));
 
@@ -770,6 +834,67 @@ TEST_P(RoundRobinPartitioningShuffleWriterTest, sortSpill) {
   shuffleWriteReadMultiBlocks(*shuffleWriter, 2, {blockPid1, blockPid2});
 }
 
+TEST_P(RoundRobinPartitioningShuffleWriterTest, adaptiveSpill) {
+  if (GetParam().shuffleWriterType != ShuffleWriterType::kAdaptiveShuffle) {
+    return;
+  }
+  auto shuffleWriter = createShuffleWriter(2);
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  int64_t evicted;
+  ASSERT_NOT_OK(shuffleWriter->reclaimFixedSize(1024, &evicted));
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  auto blockPid1 =
+      takeRows({inputVector1_, inputVector1_, inputVector1_}, {{0, 2, 4, 6, 8}, {0, 2, 4, 6, 8}, {0, 2, 4, 6, 8}});
+  auto blockPid2 =
+      takeRows({inputVector1_, inputVector1_, inputVector1_}, {{1, 3, 5, 7, 9}, {1, 3, 5, 7, 9}, {1, 3, 5, 7, 9}});
+
+  // Stop and verify.
+  shuffleWriteReadMultiBlocks(*shuffleWriter, 2, {blockPid1, blockPid2});
+
+  const auto& decision = shuffleWriter->metrics().adaptiveDecision;
+  ASSERT_TRUE(decision.has_value());
+  ASSERT_EQ(
+      decision->writerType,
+      GetParam().sortBytesPerPartition > 0 ? ShuffleWriterType::kSortShuffle : ShuffleWriterType::kHashShuffle);
+  ASSERT_EQ(decision->sampledBatches, 2);
+  ASSERT_EQ(decision->sampledRows, 2 * inputVector1_->size());
+  ASSERT_EQ(decision->avgPartitionsPerBatch, 2);
+  ASSERT_GT(decision->avgRowBytes, 0);
+}
+
+TEST_P(RoundRobinPartitioningShuffleWriterTest, adaptiveSampleKeepsInputEncoding) {
+  if (GetParam().shuffleWriterType != ShuffleWriterType::kAdaptiveShuffle) {
+    return;
+  }
+  auto shuffleWriter = createShuffleWriter(2);
+
+  const auto numRows = inputVector1_->size();
+  auto indices = makeIndices(numRows, [](auto row) { return row; });
+  std::vector<VectorPtr> children;
+  for (const auto& child : inputVector1_->children()) {
+    children.push_back(BaseVector::wrapInDictionary(nullptr, indices, numRows, child));
+  }
+  auto dictionaryInput = makeRowVector(children);
+  auto cb = std::make_shared<VeloxColumnarBatch>(dictionaryInput);
+
+  // The first batch is only sampled, as the writer samples 2 batches before choosing.
+  ASSERT_NOT_OK(shuffleWriter->write(cb, ShuffleWriter::kMinMemLimit));
+  for (const auto& child : cb->getRowVector()->children()) {
+    ASSERT_EQ(child->encoding(), VectorEncoding::Simple::DICTIONARY);
+  }
+
+  ASSERT_NOT_OK(splitRowVector(*shuffleWriter, inputVector1_));
+
+  auto blockPid1 = takeRows({inputVector1_, inputVector1_}, {{0, 2, 4, 6, 8}, {0, 2, 4, 6, 8}});
+  auto blockPid2 = takeRows({inputVector1_, inputVector1_}, {{1, 3, 5, 7, 9}, {1, 3, 5, 7, 9}});
+  shuffleWriteReadMultiBlocks(*shuffleWriter, 2, {blockPid1, blockPid2});
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SinglePartitioningShuffleWriterGroup,
     SinglePartitioningShuffleWriterTest,
@@ -25,7 +25,11 @@
 
 #include "memory/VeloxMemoryManager.h"
 #include "velox/common/compression/Compression.h"
+#include "velox/core/Expressions.h"
+#include "velox/core/QueryCtx.h"
+#include "velox/expression/Expr.h"
 #include "velox/type/Type.h"
+#include "velox/vector/DecodedVector.h"
 
 namespace gluten {
 
@@ -36,6 +40,7 @@ using namespace facebook::velox::common;
 namespace {
 const int32_t kGzipWindowBits4k = 12;
 const int32_t kZSTDDefaultCompressionLevel = 3;
+const int32_t kSparkBucketHashSeed = 42;
 } // namespace
 
 std::unique_ptr<WriterOptions> makeParquetWriteOption(const std::unordered_map<std::string, std::string>& sparkConfs) {
@@ -113,4 +118,40 @@ std::unique_ptr<WriterOptions> makeParquetWriteOption(const std::unordered_map<s
   return writeOption;
 }
 
+void computeBucketIds(
+    const RowVectorPtr& input,
+    const std::vector<column_index_t>& bucketColumns,
+    int32_t numBuckets,
+    memory::MemoryPool* pool,
+    std::vector<int32_t>& bucketIds) {
+  GLUTEN_CHECK(numBuckets > 0, "Number of buckets must be positive");
+  GLUTEN_CHECK(!bucketColumns.empty(), "Bucket columns must not be empty");
+  const auto& rowType = asRowType(input->type());
+  std::vector<core::TypedExprPtr> hashArgs;
+  hashArgs.reserve(bucketColumns.size() + 1);
+  hashArgs.emplace_back(std::make_shared<core::ConstantTypedExpr>(INTEGER(), variant(kSparkBucketHashSeed)));
+  for (const auto column : bucketColumns) {
+    GLUTEN_CHECK(column < rowType->size(), "Bucket column index overflow");
+    hashArgs.emplace_back(
+        std::make_shared<core::FieldAccessTypedExpr>(rowType->childAt(column), rowType->nameOf(column)));
+  }
+  // The Spark murmur3 hash function, it's evaluated on the whole batch.
+  const auto hashExpr = std::make_shared<core::CallTypedExpr>(INTEGER(), std::move(hashArgs), "hash_with_seed");
+
+  const auto queryCtx = core::QueryCtx::create();
+  core::ExecCtx execCtx(pool, queryCtx.get());
+  exec::ExprSet exprSet({hashExpr}, &execCtx);
+  exec::EvalCtx evalCtx(&execCtx, &exprSet, input.get());
+  const SelectivityVector rows(input->size());
+  std::vector<VectorPtr> results(1);
+  exprSet.eval(rows, evalCtx, results);
+
+  const DecodedVector hashes(*results[0], rows);
+  bucketIds.resize(input->size());
+  for (vector_size_t row = 0; row < input->size(); ++row) {
+    const auto mod = hashes.valueAt<int32_t>(row) % numBuckets;
+    bucketIds[row] = mod < 0 ? mod + numBuckets : mod;
+  }
+}
+
 } // namespace gluten
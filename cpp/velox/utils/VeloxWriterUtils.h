@@ -20,10 +20,20 @@
 #pragma once
 
 #include "velox/dwio/parquet/writer/Writer.h"
+#include "velox/vector/ComplexVector.h"
 
 namespace gluten {
 
 std::unique_ptr<facebook::velox::parquet::WriterOptions> makeParquetWriteOption(
     const std::unordered_map<std::string, std::string>& sparkConfs);
 
+// Computes the bucket id of each row the same way as Spark bucketed tables, i.e. pmod(murmur3(bucket columns), numBuckets)
+// with the seed 42 used by Spark's HashPartitioning.
+void computeBucketIds(
+    const facebook::velox::RowVectorPtr& input,
+    const std::vector<facebook::velox::column_index_t>& bucketColumns,
+    int32_t numBuckets,
+    facebook::velox::memory::MemoryPool* pool,
+    std::vector<int32_t>& bucketIds);
+
 } // namespace gluten
@@ -31,6 +31,9 @@ public class GlutenSplitResult {
   private final long c2rTime;
   private final double avgDictionaryFields;
   private final long dictionarySize;
+  // Spilled to local files before pushing to the remote shuffle service.
+  private final long localBytesSpilled;
+  private final long localSpillTime;
 
   public GlutenSplitResult(
       long totalComputePidTime,
@@ -45,6 +48,8 @@ public class GlutenSplitResult {
       long peakBytes,
       double avgDictionaryFields,
       long dictionarySize,
+      long localBytesSpilled,
+      long localSpillTime,
       long[] partitionLengths,
       long[] rawPartitionLengths) {
     this.totalComputePidTime = totalComputePidTime;
@@ -61,6 +66,8 @@ public class GlutenSplitResult {
     this.c2rTime = totalC2RTime;
     this.avgDictionaryFields = avgDictionaryFields;
     this.dictionarySize = dictionarySize;
+    this.localBytesSpilled = localBytesSpilled;
+    this.localSpillTime = localSpillTime;
   }
 
   public long getTotalComputePidTime() {
@@ -122,4 +129,12 @@ public class GlutenSplitResult {
   public long getDictionarySize() {
     return dictionarySize;
   }
+
+  public long getLocalBytesSpilled() {
+    return localBytesSpilled;
+  }
+
+  public long getLocalSpillTime() {
+    return localSpillTime;
+  }
 }
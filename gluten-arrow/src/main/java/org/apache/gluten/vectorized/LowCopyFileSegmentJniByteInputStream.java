@@ -37,6 +37,7 @@ import java.nio.channels.FileChannel;
 public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream {
   private static final Field FIELD_FilterInputStream_in;
   private static final Field FIELD_LimitedInputStream_left;
+  private static final Field FIELD_FileInputStream_path;
 
   static {
     try {
@@ -44,6 +45,8 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
       FIELD_FilterInputStream_in.setAccessible(true);
       FIELD_LimitedInputStream_left = LimitedInputStream.class.getDeclaredField("left");
       FIELD_LimitedInputStream_left.setAccessible(true);
+      FIELD_FileInputStream_path = FileInputStream.class.getDeclaredField("path");
+      FIELD_FileInputStream_path.setAccessible(true);
     } catch (NoSuchFieldException e) {
       throw new GlutenException(e);
     }
@@ -51,6 +54,9 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
 
   private final InputStream in;
   private final FileChannel channel;
+  private final String path;
+  private final long offset;
+  private final long length;
 
   private long bytesRead = 0L;
   private long left;
@@ -71,6 +77,13 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
       throw new GlutenException(e);
     }
     channel = fin.getChannel();
+    try {
+      path = (String) FIELD_FileInputStream_path.get(fin);
+      offset = channel.position();
+    } catch (IllegalAccessException | IOException e) {
+      throw new GlutenException(e);
+    }
+    length = left;
   }
 
   public static boolean isSupported(InputStream in) {
@@ -111,6 +124,24 @@ public class LowCopyFileSegmentJniByteInputStream implements JniByteInputStream
     }
   }
 
+  /**
+   * The path of the file which holds this segment, or null if it's unknown. Called from native code
+   * to read the segment from the file directly.
+   */
+  public String path() {
+    return path;
+  }
+
+  /** The offset of this segment in the file. */
+  public long offset() {
+    return offset;
+  }
+
+  /** The length of this segment. */
+  public long length() {
+    return length;
+  }
+
   @Override
   public long tell() {
     return bytesRead;
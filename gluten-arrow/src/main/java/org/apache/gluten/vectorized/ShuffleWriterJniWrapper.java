@@ -52,6 +52,7 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
       int diskWriteBufferSize,
       int initialSortBufferSize,
       boolean useRadixSort,
+      boolean columnarPayload,
       long partitionWriterHandle);
 
   public native long createRssSortShuffleWriter(
@@ -61,6 +62,21 @@ public class ShuffleWriterJniWrapper implements RuntimeAware {
       int splitBufferSize,
       long sortBufferMaxSize,
       String codec,
+      String localSpillDirs,
+      long spillMergePushSize,
+      long partitionWriterHandle);
+
+  public native long createAdaptiveShuffleWriter(
+      int numPartitions,
+      String partitioningName,
+      int startPartitionId,
+      int splitBufferSize,
+      double splitBufferReallocThreshold,
+      int diskWriteBufferSize,
+      int initialSortBufferSize,
+      boolean useRadixSort,
+      int sampleBatches,
+      long sortPartitionBytes,
       long partitionWriterHandle);
 
   public native long createGpuHashShuffleWriter(
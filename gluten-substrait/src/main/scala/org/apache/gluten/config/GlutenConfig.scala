@@ -236,6 +236,9 @@ class GlutenConfig(conf: SQLConf) extends GlutenCoreConfig(conf) {
   def columnarShuffleEnableDictionary: Boolean =
     getConf(SHUFFLE_ENABLE_DICTIONARY)
 
+  def columnarShuffleEnableChecksum: Boolean =
+    getConf(SHUFFLE_ENABLE_CHECKSUM)
+
   def maxBatchSize: Int = getConf(COLUMNAR_MAX_BATCH_SIZE)
 
   def shuffleWriterBufferSize: Int = getConf(SHUFFLE_WRITER_BUFFER_SIZE)
@@ -1069,6 +1072,14 @@ object GlutenConfig extends ConfigRegistry {
       .booleanConf
       .createWithDefault(false)
 
+  val SHUFFLE_ENABLE_CHECKSUM =
+    buildConf("spark.gluten.sql.columnar.shuffle.checksum.enabled")
+      .doc(
+        "Write a CRC32C checksum for each compressed shuffle buffer and verify it when reading. " +
+          "A corrupted block is reported as a fetch failure so that the map output is recomputed.")
+      .booleanConf
+      .createWithDefault(false)
+
   val COLUMNAR_MAX_BATCH_SIZE =
     buildConf("spark.gluten.sql.columnar.maxBatchSize").intConf
       .checkValue(_ > 0, s"must be positive.")
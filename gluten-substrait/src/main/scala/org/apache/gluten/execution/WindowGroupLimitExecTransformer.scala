@@ -17,16 +17,19 @@
 package org.apache.gluten.execution
 
 import org.apache.gluten.backendsapi.BackendsApiManager
-import org.apache.gluten.expression.ExpressionConverter
+import org.apache.gluten.expression.{ConverterUtils, ExpressionConverter}
 import org.apache.gluten.metrics.MetricsUpdater
+import org.apache.gluten.substrait.`type`.TypeBuilder
 import org.apache.gluten.substrait.SubstraitContext
+import org.apache.gluten.substrait.extensions.ExtensionBuilder
 import org.apache.gluten.substrait.rel.{RelBuilder, RelNode}
 
-import org.apache.spark.sql.catalyst.expressions.{Ascending, Attribute, Expression, SortOrder}
+import org.apache.spark.sql.catalyst.expressions.{Ascending, Attribute, DenseRank, Expression, Rank, SortOrder}
 import org.apache.spark.sql.catalyst.plans.physical.{AllTuples, ClusteredDistribution, Distribution, Partitioning}
 import org.apache.spark.sql.execution.SparkPlan
 import org.apache.spark.sql.execution.window.{GlutenFinal, GlutenPartial, GlutenWindowGroupLimitMode}
 
+import com.google.protobuf.StringValue
 import io.substrait.proto.SortField
 
 import scala.collection.JavaConverters._
@@ -110,26 +113,41 @@ case class WindowGroupLimitExecTransformer(
           builder.setDirectionValue(SortExecTransformer.transformSortDirection(order))
           builder.build()
       }.asJava
+    // Pass the rank like function to the native side through the optimization extension.
+    val optimization = BackendsApiManager.getTransformerApiInstance.packPBMessage(
+      StringValue.newBuilder().setValue(formatExtOptimizationString).build())
     if (!validation) {
       RelBuilder.makeWindowGroupLimitRel(
         input,
         partitionsExpressions,
         sortFieldList,
         limit,
+        ExtensionBuilder.makeAdvancedExtension(optimization, null),
         context,
         operatorId)
     } else {
+      val inputTypeNodeList = originalInputAttributes
+        .map(attr => ConverterUtils.getTypeNode(attr.dataType, attr.nullable))
+        .asJava
+      val enhancement = BackendsApiManager.getTransformerApiInstance.packPBMessage(
+        TypeBuilder.makeStruct(false, inputTypeNodeList).toProtobuf)
       RelBuilder.makeWindowGroupLimitRel(
         input,
         partitionsExpressions,
         sortFieldList,
         limit,
-        RelBuilder.createExtensionNode(originalInputAttributes.asJava),
+        ExtensionBuilder.makeAdvancedExtension(optimization, enhancement),
         context,
         operatorId)
     }
   }
 
+  private def formatExtOptimizationString: String = {
+    val isRankStr = if (rankLikeFunction.isInstanceOf[Rank]) "1" else "0"
+    val isDenseRankStr = if (rankLikeFunction.isInstanceOf[DenseRank]) "1" else "0"
+    s"isRank=$isRankStr\nisDenseRank=$isDenseRankStr\n"
+  }
+
   override protected def doValidateInternal(): ValidationResult = {
     if (!BackendsApiManager.getSettings.supportWindowGroupLimitExec(rankLikeFunction)) {
       return ValidationResult
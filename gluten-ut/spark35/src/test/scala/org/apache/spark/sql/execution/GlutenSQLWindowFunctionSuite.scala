@@ -176,7 +176,7 @@ class GlutenSQLWindowFunctionSuite extends SQLWindowFunctionSuite with GlutenSQL
         )
       )
       assert(
-        !getExecutedPlan(df).exists {
+        getExecutedPlan(df).exists {
           case _: WindowGroupLimitExecTransformer => true
           case _ => false
         }
@@ -17,10 +17,11 @@
 package org.apache.gluten.execution.datasource
 
 import org.apache.spark.sql.SparkSession
+import org.apache.spark.sql.catalyst.expressions.{Attribute, Expression, Literal, Murmur3Hash, Pmod}
 import org.apache.spark.sql.catalyst.rules.Rule
 import org.apache.spark.sql.execution.SparkPlan
 import org.apache.spark.sql.execution.datasources.{BlockStripes, OutputWriter}
-import org.apache.spark.sql.types.StructType
+import org.apache.spark.sql.types.{IntegerType, StructType}
 import org.apache.spark.sql.vectorized.ColumnarBatch
 
 import org.apache.hadoop.fs.FileStatus
@@ -53,6 +54,20 @@ trait GlutenRowSplitter {
       partitionColIndice: Array[Int],
       hasBucket: Boolean,
       reservePartitionColumns: Boolean = false): BlockStripes
+
+  /** Whether the splitter could compute the bucket id of Spark bucketed tables by itself. */
+  def supportsNativeBucketId: Boolean = false
+
+  /**
+   * Splits the batch by the partition values and by the bucket id of Spark bucketed tables, i.e.
+   * pmod(murmur3(bucket columns), numBuckets), which is computed by the splitter.
+   */
+  def splitBlockByPartitionAndBucket(
+      batch: ColumnarBatch,
+      partitionColIndice: Array[Int],
+      bucketColIndice: Array[Int],
+      numBuckets: Int): BlockStripes =
+    throw new UnsupportedOperationException("Native bucket id is not supported by the splitter")
 }
 
 object GlutenFormatFactory {
@@ -93,4 +108,30 @@ object GlutenFormatFactory {
     }
     rowSplitterInstance
   }
+
+  /**
+   * Returns the bucket column indices in `columns` and the number of buckets if the bucket id is
+   * the one of Spark bucketed tables, pmod(murmur3(bucket columns), numBuckets), and the row
+   * splitter could compute it natively.
+   */
+  def nativeBucketSpec(
+      bucketIdExpression: Expression,
+      columns: Seq[Attribute]): Option[(Array[Int], Int)] = {
+    if (!rowSplitter.supportsNativeBucketId) {
+      return None
+    }
+    bucketIdExpression match {
+      case Pmod(Murmur3Hash(children, 42), Literal(numBuckets: Int, IntegerType), _) =>
+        val bucketColIndice = children.map {
+          case a: Attribute => columns.indexWhere(_.exprId == a.exprId)
+          case _ => -1
+        }
+        if (bucketColIndice.contains(-1)) {
+          None
+        } else {
+          Some((bucketColIndice.toArray, numBuckets))
+        }
+      case _ => None
+    }
+  }
 }
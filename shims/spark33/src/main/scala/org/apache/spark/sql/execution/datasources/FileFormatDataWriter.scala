@@ -53,6 +53,12 @@ class DynamicPartitionDataSingleWriter(
         }
     }.toArray
 
+  // Bucket column indices and number of buckets if the row splitter could compute the bucket id.
+  private val nativeBucketSpec: Option[(Array[Int], Int)] =
+    description.bucketSpec.flatMap {
+      spec => GlutenFormatFactory.nativeBucketSpec(spec.bucketIdExpression, description.allColumns)
+    }
+
   private def beforeWrite(record: InternalRow): Unit = {
     val nextPartitionValues = if (isPartitioned) Some(getPartitionValues(record)) else None
     val nextBucketId = if (isBucketed) Some(getBucketId(record)) else None
@@ -86,8 +92,19 @@ class DynamicPartitionDataSingleWriter(
           case terminalRow: TerminalRow =>
             val numRows = terminalRow.batch().numRows()
             if (numRows > 0) {
-              val blockStripes = GlutenFormatFactory.rowSplitter
-                .splitBlockByPartitionAndBucket(terminalRow.batch(), partitionColIndice, isBucketed)
+              val blockStripes = nativeBucketSpec match {
+                case Some((bucketColIndice, numBuckets)) =>
+                  GlutenFormatFactory.rowSplitter.splitBlockByPartitionAndBucket(
+                    terminalRow.batch(),
+                    partitionColIndice,
+                    bucketColIndice,
+                    numBuckets)
+                case None =>
+                  GlutenFormatFactory.rowSplitter.splitBlockByPartitionAndBucket(
+                    terminalRow.batch(),
+                    partitionColIndice,
+                    isBucketed)
+              }
               val iter = blockStripes.iterator()
               while (iter.hasNext) {
                 val blockStripe = iter.next()